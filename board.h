@@ -0,0 +1,365 @@
+/*
+ * FILE: board.h
+ * Board Support for MASTERCELL NGX
+ *
+ * Everything that depends on the processor rather than on the application:
+ * instruction clock, 1ms tick timer, data EEPROM (NVM) word access, CAN
+ * controller frame I/O and peripheral clock dividers. Application modules
+ * include this header instead of defining FCY themselves, and talk to the
+ * NVM and CAN controller only through the Board_xxx functions below.
+ *
+ * Each processor has its own implementation file (board_<part>.c) and
+ * exactly one is built. Retargeting to another part means adding a board
+ * section here and a new board_<part>.c - application modules do not change.
+ * board_host.c is the same for a gcc build on the host (BOARD_HOST, see
+ * host/Makefile), so the application modules can run against a simulated
+ * board.
+ */
+
+#ifndef BOARD_H
+#define BOARD_H
+
+#include <xc.h>
+#include <stdint.h>
+
+// Default board
+#if !defined(BOARD_DSPIC30F6012A) && !defined(BOARD_HOST)
+#define BOARD_DSPIC30F6012A
+#endif
+
+#if defined(BOARD_DSPIC30F6012A)
+
+// 8MHz crystal, XT_PLL8 = 64MHz, 4 clocks per instruction
+#define FCY                 16000000UL
+
+// SPI2 (MCP4341 digipot, 10MHz max): primary 1:1, secondary 2:1 = 8MHz
+#define BOARD_SPI2_PPRE     0b11
+#define BOARD_SPI2_SPRE     0b110
+
+// Timer1 counts per 1ms tick (1:64 prescale = 4us per count)
+#define BOARD_TICK_COUNTS   250
+#define BOARD_TICK_US       4
+
+// Watchdog period, also the Sleep wake-up period: WDT 2ms nominal x 8 x 16
+// (fuses in board_*.c)
+#define BOARD_SLEEP_WAKE_MS 256
+
+// Processor supply current estimates (datasheet typical, 5V, 16 MIPS),
+// excluding the LCD backlight, CAN transceiver and output drivers
+#define BOARD_IDD_RUN_UA    55000
+#define BOARD_IDD_IDLE_UA   35000
+#define BOARD_IPD_SLEEP_UA  25      // Includes the WDT
+
+// Program flash (48K instructions, 0x000000-0x017FFE). A received firmware
+// image is staged in the upper part, below the space kept for a boot block
+// at the top. The last staging row holds the install record, so an image
+// is at most BOARD_FLASH_STAGING_ROWS - 1 rows. board_<part>.c reserves
+// BOARD_FLASH_STAGING up to BOARD_FLASH_END from the linker, so the
+// application must link below BOARD_FLASH_STAGING.
+#define BOARD_FLASH_ROW_PC          64          // Address units per row (32 instructions)
+#define BOARD_FLASH_ROW_BYTES       96          // Row image: 3 bytes per instruction, low first
+#define BOARD_FLASH_STAGING         0x00C000UL
+#define BOARD_FLASH_STAGING_ROWS    752
+#define BOARD_FLASH_BOOT            0x017C00UL  // Boot block (not part of this project)
+#define BOARD_FLASH_END             0x018000UL
+
+// RAM left untouched by the startup code, survives a watchdog reset
+#define BOARD_PERSISTENT    __attribute__((persistent))
+
+#elif defined(BOARD_HOST)
+
+// Simulated board (board_host.c, built with gcc from host/): the
+// application modules against host/xc.h, with the dsPIC30F6012A clock,
+// tick and flash geometry so every timing constant and map stays valid.
+// Test hooks are in host/board_host.h.
+#define FCY                 16000000UL
+
+#define BOARD_SPI2_PPRE     0b11
+#define BOARD_SPI2_SPRE     0b110
+
+#define BOARD_TICK_COUNTS   250
+#define BOARD_TICK_US       4
+
+#define BOARD_SLEEP_WAKE_MS 256
+
+#define BOARD_IDD_RUN_UA    55000
+#define BOARD_IDD_IDLE_UA   35000
+#define BOARD_IPD_SLEEP_UA  25
+
+#define BOARD_FLASH_ROW_PC          64
+#define BOARD_FLASH_ROW_BYTES       96
+#define BOARD_FLASH_STAGING         0x00C000UL
+#define BOARD_FLASH_STAGING_ROWS    752
+#define BOARD_FLASH_BOOT            0x017C00UL
+#define BOARD_FLASH_END             0x018000UL
+
+// Host RAM is not preserved across a simulated reset
+#define BOARD_PERSISTENT
+
+#else
+#error "board.h: no board selected"
+#endif
+
+#include <libpic30.h>   // __delay_ms / __delay_us (needs FCY)
+
+// Data EEPROM size in bytes (byte addresses 0x000-0xFFF)
+#define BOARD_NVM_SIZE      0x1000
+
+// ============================================================================
+// CLOCK / TICK
+// ============================================================================
+
+/**
+ * Start the 1ms system tick (Timer1 interrupt, _T1Interrupt in main.c)
+ */
+void Board_InitTick(void);
+
+/**
+ * Timer1 count within the current 1ms tick
+ * If the tick interrupt is pending (masked), BOARD_TICK_COUNTS is added,
+ * so ms * BOARD_TICK_COUNTS + count never runs backwards.
+ */
+uint16_t Board_TickCount(void);
+
+// ============================================================================
+// POWER
+// ============================================================================
+
+// Board_ResetCause() results
+#define BOARD_RESET_COLD        0   // Power-on or brown-out
+#define BOARD_RESET_WATCHDOG    1   // Watchdog timeout while running
+#define BOARD_RESET_OTHER       2   // MCLR, trap, RESET instruction
+
+/**
+ * Why the processor last reset (call once, first thing in main)
+ * Clears the reset flags so the next reset reads correctly.
+ */
+uint8_t Board_ResetCause(void);
+
+/**
+ * Start the watchdog (BOARD_SLEEP_WAKE_MS period)
+ * Once started it stays on, including across Board_Sleep().
+ */
+void Board_WatchdogEnable(void);
+
+/**
+ * Restart the watchdog period
+ */
+void Board_WatchdogKick(void);
+
+/**
+ * Software reset (RESET instruction) - Board_ResetCause() reports OTHER
+ */
+void Board_Reset(void);
+
+// Board_Sleep() wake sources
+#define BOARD_WAKE_TIMER    0   // BOARD_SLEEP_WAKE_MS elapsed
+#define BOARD_WAKE_CAN      1   // Bus activity (Board_CANSetSleep(1) first)
+
+/**
+ * CPU Idle until the next interrupt (peripherals and Timer1 keep running)
+ */
+void Board_Idle(void);
+
+/**
+ * Sleep until bus activity or for BOARD_SLEEP_WAKE_MS, whichever is first
+ * Timer1 stops while asleep. Interrupts are not serviced on the way out.
+ * @return BOARD_WAKE_xxx
+ */
+uint8_t Board_Sleep(void);
+
+// ============================================================================
+// NVM (DATA EEPROM)
+// ============================================================================
+
+/**
+ * Read one 16-bit word
+ * @param address Byte address, even, < BOARD_NVM_SIZE
+ * @return Word value, 0xFFFF if address is invalid
+ */
+uint16_t Board_NVMReadWord(uint16_t address);
+
+/**
+ * Erase one word to 0xFFFF (blocks until complete)
+ * @param address Byte address, even, < BOARD_NVM_SIZE
+ * @return 1 on success, 0 on invalid address or timeout
+ */
+uint8_t Board_NVMEraseWord(uint16_t address);
+
+/**
+ * Program one previously erased word (blocks until complete, no verify)
+ * @param address Byte address, even, < BOARD_NVM_SIZE
+ * @return 1 on success, 0 on invalid address or timeout
+ */
+uint8_t Board_NVMProgramWord(uint16_t address, uint16_t data);
+
+// ============================================================================
+// PROGRAM FLASH (RTSP)
+// ============================================================================
+// Only rows inside the staging area can be erased or written, so the
+// running application and the boot block are never touched from here.
+// The CPU stalls for each erase or write (about 2ms); interrupts are
+// serviced late, and a CAN frame can be lost if more than two arrive.
+
+/**
+ * Erase one row to 0xFFFFFF
+ * @param address Row start, BOARD_FLASH_STAGING aligned to BOARD_FLASH_ROW_PC
+ * @return 1 on success, 0 on invalid address or timeout
+ */
+uint8_t Board_FlashEraseRow(uint32_t address);
+
+/**
+ * Program one previously erased row (no verify)
+ * @param address Row start, as for Board_FlashEraseRow()
+ * @param row BOARD_FLASH_ROW_BYTES bytes, 3 per instruction, low byte first
+ * @return 1 on success, 0 on invalid address or timeout
+ */
+uint8_t Board_FlashWriteRow(uint32_t address, const uint8_t *row);
+
+/**
+ * Read one row back in the Board_FlashWriteRow() format
+ * @param address Any row start in program flash
+ */
+void Board_FlashReadRow(uint32_t address, uint8_t *row);
+
+// ============================================================================
+// CAN CONTROLLER
+// ============================================================================
+
+/**
+ * Configure the CAN controller for 250kbit/s J1939 and go to normal mode
+ * Accepts every extended frame (filtering is done in software)
+ */
+void Board_CANInit(void);
+
+/**
+ * Reopen the acceptance filters to every extended frame
+ */
+void Board_CANAcceptAll(void);
+
+// Interrupt priority of both CAN controllers. _C1Interrupt and _C2Interrupt
+// share the receive FIFO (j1939.c) without a lock between them, which is
+// only safe while neither can preempt the other: keep them at one level.
+// Timer1 stays at its reset priority (4) as well, SPI2 runs below (3).
+#define BOARD_CAN_IPL       4
+
+/**
+ * Enable or disable the receive interrupts (_C1Interrupt, and _C2Interrupt
+ * once Board_CAN2Init() has run, both in j1939.c)
+ * Disabling is also the lock for data shared with the receive ISRs.
+ */
+void Board_CANSetRxInterrupt(uint8_t enable);
+
+/**
+ * Take one received frame out of the controller, if any
+ * Also acknowledges that buffer's receive interrupt flag.
+ * @param id 29-bit identifier
+ * @param data 8 data bytes
+ * @param dlc Data length (0-8)
+ * @return 1 if a frame was read, 0 if the receive buffers are empty
+ */
+uint8_t Board_CANReceive(uint32_t *id, uint8_t data[8], uint8_t *dlc);
+
+// Controller error states (Board_CANGetErrorState)
+#define BOARD_CAN_ERROR_ACTIVE      0   // TEC and REC < 96
+#define BOARD_CAN_ERROR_WARNING     1   // TEC or REC >= 96
+#define BOARD_CAN_ERROR_PASSIVE     2   // TEC or REC >= 128
+#define BOARD_CAN_BUS_OFF           3   // TEC > 255, transmitter disconnected
+
+/**
+ * Read the error counters and the fault confinement state
+ * @param tec Transmit error counter
+ * @param rec Receive error counter
+ * @return BOARD_CAN_ERROR_xxx / BOARD_CAN_BUS_OFF
+ */
+uint8_t Board_CANGetErrorState(uint8_t *tec, uint8_t *rec);
+
+/**
+ * Check and clear the error interrupt flag (called from _C1Interrupt)
+ * @return 1 if an error interrupt was pending
+ */
+uint8_t Board_CANAckErrorInterrupt(void);
+
+/**
+ * Leave bus-off: abort the pending transmission and restart the
+ * controller through configuration mode (resets TEC/REC)
+ */
+void Board_CANRestart(void);
+
+/**
+ * Put the CAN controller to sleep with wake-up on bus activity (1), or
+ * return it to normal mode (0). The frame that wakes it is lost.
+ */
+void Board_CANSetSleep(uint8_t sleep);
+
+/**
+ * Transmit identifier registers, encoded once per PGN/SA
+ */
+typedef struct {
+    uint16_t sid;
+    uint16_t eid;
+    uint16_t dlc;           // Includes DLC = 8
+} BoardCANTxImage;
+
+/**
+ * Encode a 29-bit identifier into transmit register images
+ */
+void Board_CANEncode(uint32_t id, BoardCANTxImage *image);
+
+/**
+ * As Board_CANEncode(), for a frame of dlc (0-8) bytes
+ */
+void Board_CANEncodeLength(uint32_t id, uint8_t dlc, BoardCANTxImage *image);
+
+/**
+ * Check whether the transmit buffer is free
+ */
+uint8_t Board_CANTxReady(void);
+
+/**
+ * Send an 8-byte frame from pre-encoded identifier registers
+ * Caller must check Board_CANTxReady() first
+ */
+void Board_CANTransmitImage(const BoardCANTxImage *image, const uint8_t data[8]);
+
+/**
+ * Check whether the priority transmit buffer is free
+ */
+uint8_t Board_CANPriorityTxReady(void);
+
+/**
+ * Send an 8-byte frame from the priority transmit buffer. It has the
+ * higher TXPRI, so it goes ahead of anything waiting in the other
+ * buffer and only waits for a frame already on the wire. A frame with
+ * the same identifier still waiting in the other buffer is withdrawn -
+ * it holds older data and would otherwise follow this one.
+ * Caller must check Board_CANPriorityTxReady() first
+ */
+void Board_CANTransmitPriority(const BoardCANTxImage *image, const uint8_t data[8]);
+
+// ============================================================================
+// SECOND CAN CONTROLLER
+// ============================================================================
+// Same bit timing, acceptance and frame format as the first. It only
+// runs when the gateway is enabled (gateway.h); the functions below
+// mirror their Board_CANxxx counterparts.
+
+/**
+ * Configure the second controller for 250kbit/s and go to normal mode
+ * From here on Board_CANSetRxInterrupt() covers its interrupt too.
+ */
+void Board_CAN2Init(void);
+
+/**
+ * @return 1 once Board_CAN2Init() has run
+ */
+uint8_t Board_CAN2Running(void);
+
+uint8_t Board_CAN2Receive(uint32_t *id, uint8_t data[8], uint8_t *dlc);
+uint8_t Board_CAN2GetErrorState(uint8_t *tec, uint8_t *rec);
+uint8_t Board_CAN2AckErrorInterrupt(void);
+void Board_CAN2Restart(void);
+uint8_t Board_CAN2TxReady(void);
+void Board_CAN2TransmitImage(const BoardCANTxImage *image, const uint8_t data[8]);
+
+#endif // BOARD_H
@@ -0,0 +1,625 @@
+/*
+ * FILE: board_dspic30f6012a.c
+ * Board Support - MASTERCELL NGX on dsPIC30F6012A
+ *
+ * Configuration fuses, Timer1 tick, data EEPROM and program flash table
+ * access and the CAN1/CAN2 module register layout.
+ */
+
+#include "board.h"
+
+#if defined(BOARD_DSPIC30F6012A)
+
+_FOSC(CSW_FSCM_OFF & XT_PLL8);
+_FWDT(WDT_OFF & WDTPSA_8 & WDTPSB_16);  // 256ms, enabled by software
+_FBORPOR(MCLR_EN & PWRT_OFF);
+_FGS(GWRP_OFF);
+_FICD(ICS_PGD);
+
+// Data EEPROM lives at 0x7FF000-0x7FFFFE: TBLPAG 0x7F, offset 0xF000
+#define NVM_TBLPAG          0x7F
+#define NVM_OFFSET          0xF000
+
+#define NVMCON_ERASE_WORD   0x4044
+#define NVMCON_WRITE_WORD   0x4004
+#define NVM_TIMEOUT         30000
+
+#define NVMCON_ERASE_ROW    0x4041  // Program flash, 32 instructions
+#define NVMCON_WRITE_ROW    0x4001
+
+// Staging area and boot block: allocated but never loaded, so the linker
+// cannot place application code or constants where update rows are
+// erased. An application that outgrows BOARD_FLASH_STAGING fails to link.
+// One 16-bit element per instruction word (two address units).
+const uint16_t board_flash_reserved[(BOARD_FLASH_END - BOARD_FLASH_STAGING) / 2]
+    __attribute__((space(prog), address(BOARD_FLASH_STAGING), noload, keep));
+
+// ============================================================================
+// CLOCK / TICK
+// ============================================================================
+
+void Board_InitTick(void) {
+    T1CON = 0x0000;
+    T1CONbits.TCKPS = 2;                    // 1:64
+    TMR1 = 0;
+    PR1 = (uint16_t)(FCY / 64 / 1000) - 1;  // 1ms
+    IFS0bits.T1IF = 0;
+    IEC0bits.T1IE = 1;
+    T1CONbits.TON = 1;
+}
+
+uint16_t Board_TickCount(void) {
+    uint16_t count = TMR1;
+
+    if(IFS0bits.T1IF) {
+        // Rolled over since the last tick was counted - re-read after it
+        count = TMR1 + BOARD_TICK_COUNTS;
+    }
+    return count;
+}
+
+// ============================================================================
+// POWER
+// ============================================================================
+
+uint8_t Board_ResetCause(void) {
+    uint8_t cause;
+
+    if(RCONbits.POR || RCONbits.BOR) {
+        cause = BOARD_RESET_COLD;
+    } else if(RCONbits.WDTO && !RCONbits.SLEEP) {
+        cause = BOARD_RESET_WATCHDOG;
+    } else {
+        cause = BOARD_RESET_OTHER;
+    }
+
+    RCONbits.POR = 0;
+    RCONbits.BOR = 0;
+    RCONbits.WDTO = 0;
+    RCONbits.SLEEP = 0;
+    RCONbits.IDLE = 0;
+    RCONbits.EXTR = 0;
+    RCONbits.SWR = 0;
+    RCONbits.TRAPR = 0;
+
+    return cause;
+}
+
+void Board_WatchdogEnable(void) {
+    ClrWdt();
+    RCONbits.SWDTEN = 1;
+}
+
+void Board_WatchdogKick(void) {
+    ClrWdt();
+}
+
+void Board_Reset(void) {
+    asm volatile ("reset");
+}
+
+void Board_Idle(void) {
+    Idle();
+}
+
+uint8_t Board_Sleep(void) {
+    uint16_t saved_ipl;
+    uint8_t source;
+    uint8_t watchdog_on = RCONbits.SWDTEN;
+
+    // CPU priority 7: the CAN wake-up interrupt still ends Sleep, but
+    // nothing is vectored until the flags below have been cleaned up
+    SET_AND_SAVE_CPU_IPL(saved_ipl, 7);
+
+    ClrWdt();
+    RCONbits.WDTO = 0;
+    RCONbits.SWDTEN = 1;
+    Sleep();
+    RCONbits.SWDTEN = watchdog_on;
+
+    // A wake-up timeout is not a reset - keep Board_ResetCause() honest
+    RCONbits.WDTO = 0;
+    RCONbits.SLEEP = 0;
+
+    source = C1INTFbits.WAKIF ? BOARD_WAKE_CAN : BOARD_WAKE_TIMER;
+    C1INTFbits.WAKIF = 0;
+    IFS1bits.C1IF = 0;
+
+    RESTORE_CPU_IPL(saved_ipl);
+    return source;
+}
+
+// ============================================================================
+// NVM (DATA EEPROM)
+// ============================================================================
+
+uint16_t Board_NVMReadWord(uint16_t address) {
+    if((address & 0x01) || address >= BOARD_NVM_SIZE) {
+        return 0xFFFF;
+    }
+
+    uint16_t old_tblpag = TBLPAG;
+    TBLPAG = NVM_TBLPAG;
+    uint16_t value = __builtin_tblrdl(NVM_OFFSET + address);
+    TBLPAG = old_tblpag;
+
+    return value;
+}
+
+/*
+ * Start the operation set up in NVMCON with the unlock sequence
+ * Returns 1 when the operation completed, 0 on timeout
+ */
+static uint8_t NVM_Unlock(uint16_t nvmcon) {
+    NVMCON = nvmcon;
+
+    // Unlock sequence
+    asm volatile ("disi #5");
+    asm volatile ("mov #0x55, W0");
+    asm volatile ("mov W0, NVMKEY");
+    asm volatile ("mov #0xAA, W0");
+    asm volatile ("mov W0, NVMKEY");
+    asm volatile ("bset NVMCON, #15");
+    asm volatile ("nop");
+    asm volatile ("nop");
+
+    uint16_t timeout = NVM_TIMEOUT;
+    while((NVMCON & 0x8000) && timeout > 0) {
+        timeout--;
+    }
+    return (timeout > 0);
+}
+
+/*
+ * Latch a word and run one data EEPROM operation
+ * Returns 1 when the operation completed, 0 on timeout
+ */
+static uint8_t NVM_Run(uint16_t address, uint16_t data, uint16_t nvmcon) {
+    TBLPAG = NVM_TBLPAG;
+    __builtin_tblwtl(NVM_OFFSET + address, data);
+
+    if(!NVM_Unlock(nvmcon)) {
+        return 0;
+    }
+
+    __delay_ms(3);
+    return 1;
+}
+
+uint8_t Board_NVMEraseWord(uint16_t address) {
+    if((address & 0x01) || address >= BOARD_NVM_SIZE) {
+        return 0;
+    }
+    return NVM_Run(address, 0xFFFF, NVMCON_ERASE_WORD);
+}
+
+uint8_t Board_NVMProgramWord(uint16_t address, uint16_t data) {
+    if((address & 0x01) || address >= BOARD_NVM_SIZE) {
+        return 0;
+    }
+    return NVM_Run(address, data, NVMCON_WRITE_WORD);
+}
+
+// ============================================================================
+// PROGRAM FLASH (RTSP)
+// ============================================================================
+
+static uint8_t FlashRowWritable(uint32_t address) {
+    return (address % BOARD_FLASH_ROW_PC) == 0 &&
+           address >= BOARD_FLASH_STAGING &&
+           address < BOARD_FLASH_BOOT;
+}
+
+uint8_t Board_FlashEraseRow(uint32_t address) {
+    if(!FlashRowWritable(address)) {
+        return 0;
+    }
+
+    NVMADRU = (uint16_t)(address >> 16);
+    NVMADR = (uint16_t)address;
+    return NVM_Unlock(NVMCON_ERASE_ROW);
+}
+
+uint8_t Board_FlashWriteRow(uint32_t address, const uint8_t *row) {
+    if(!FlashRowWritable(address)) {
+        return 0;
+    }
+
+    // Fill the 32 write latches - the last table write sets NVMADR
+    uint16_t old_tblpag = TBLPAG;
+    TBLPAG = (uint16_t)(address >> 16);
+    uint16_t offset = (uint16_t)address;
+    for(uint8_t i = 0; i < BOARD_FLASH_ROW_PC / 2; i++) {
+        __builtin_tblwtl(offset, row[0] | ((uint16_t)row[1] << 8));
+        __builtin_tblwth(offset, row[2]);
+        offset += 2;
+        row += 3;
+    }
+    TBLPAG = old_tblpag;
+
+    return NVM_Unlock(NVMCON_WRITE_ROW);
+}
+
+void Board_FlashReadRow(uint32_t address, uint8_t *row) {
+    uint16_t old_tblpag = TBLPAG;
+    TBLPAG = (uint16_t)(address >> 16);
+    uint16_t offset = (uint16_t)address;
+    for(uint8_t i = 0; i < BOARD_FLASH_ROW_PC / 2; i++) {
+        uint16_t low = __builtin_tblrdl(offset);
+        row[0] = (uint8_t)low;
+        row[1] = (uint8_t)(low >> 8);
+        row[2] = (uint8_t)__builtin_tblrdh(offset);
+        offset += 2;
+        row += 3;
+    }
+    TBLPAG = old_tblpag;
+}
+
+// ============================================================================
+// CAN CONTROLLER
+// ============================================================================
+
+static uint8_t can2_running = 0;
+
+static uint8_t CAN2_SetMode(uint8_t mode);
+
+/*
+ * Request a CAN1 operating mode and wait for it
+ * Returns 1 if the module entered the mode, 0 on timeout
+ */
+static uint8_t CAN_SetMode(uint8_t mode) {
+    uint16_t timeout = 10000;
+
+    C1CTRLbits.REQOP = mode;
+    while(C1CTRLbits.OPMODE != mode && timeout > 0) timeout--;
+
+    return (timeout > 0);
+}
+
+void Board_CANInit(void) {
+    if(!CAN_SetMode(4)) return;     // Configuration mode
+
+    // FCAN = 4 x FCY = 64MHz, TQ = 2 x (BRP + 1) / FCAN = 250ns
+    // 1 + 7 + 4 + 4 = 16 TQ = 4us = 250kbit/s
+    C1CFG1bits.BRP = 7;
+    C1CFG1bits.SJW = 0;
+
+    C1CFG2bits.PRSEG = 6;
+    C1CFG2bits.SEG1PH = 3;
+    C1CFG2bits.SEG2PHTS = 1;
+    C1CFG2bits.SEG2PH = 3;
+    C1CFG2bits.SAM = 0;
+
+    C1CTRLbits.CANCKS = 0;
+
+    // TX0 carries everything else, TX2 the frames that must not wait
+    // behind it (Board_CANTransmitPriority)
+    C1TX0CONbits.TXPRI = 0b10;
+    C1TX2CONbits.TXPRI = 0b11;
+
+    // Enable double buffering - RX0 and RX1 work as FIFO
+    // This gives us 2 hardware message slots instead of 1
+    // When RX0 is full, next message goes to RX1
+    C1RX0CONbits.DBEN = 1;
+
+    Board_CANAcceptAll();
+
+    // Both receive buffers raise the interrupt. Every RXnIF must be
+    // cleared along with RXFUL or C1IF re-asserts forever.
+    C1INTF = 0;
+    C1INTEbits.RX0IE = 1;
+    C1INTEbits.RX1IE = 1;
+    C1INTEbits.ERRIE = 1;           // Warning / passive / bus-off transitions
+
+    // Interrupt stays off until the application enables it
+    IPC6bits.C1IP = BOARD_CAN_IPL;
+    IFS1bits.C1IF = 0;
+    IEC1bits.C1IE = 0;
+
+    CAN_SetMode(0);                 // Normal mode
+
+    __delay_ms(10);
+}
+
+void Board_CANAcceptAll(void) {
+    uint8_t mode = C1CTRLbits.OPMODE;
+
+    if(mode != 4 && !CAN_SetMode(4)) return;
+
+    C1RXM0SID = 0x0000;
+    C1RXM0EIDH = 0x0000;
+    C1RXM0EIDL = 0x0000;
+    C1RXM1SID = 0x0000;
+    C1RXM1EIDH = 0x0000;
+    C1RXM1EIDL = 0x0000;
+
+    C1RXF0SID = 0x0001;             // EXIDE - extended frames
+    C1RXF0EIDH = 0x0000;
+    C1RXF0EIDL = 0x0000;
+
+    if(mode != 4) CAN_SetMode(mode);
+}
+
+/*
+ * Unpack one receive buffer
+ * C1RXnSID[12:2] = EID[28:18], C1RXnEID[11:0] = EID[17:6],
+ * C1RXnDLC[15:10] = EID[5:0], C1RXnDLC[3:0] = DLC
+ */
+static void CAN_Unpack(uint16_t sid_reg, uint16_t eid_reg, uint16_t dlc_reg,
+                       const uint16_t words[4],
+                       uint32_t *id, uint8_t data[8], uint8_t *dlc) {
+    *id = ((uint32_t)((sid_reg >> 2) & 0x7FF) << 18) |
+          ((uint32_t)(eid_reg & 0xFFF) << 6) |
+          ((dlc_reg >> 10) & 0x3F);
+
+    *dlc = dlc_reg & 0x0F;
+    if(*dlc > 8) *dlc = 8;
+
+    for(uint8_t i = 0; i < 4; i++) {
+        uint16_t data_word = words[i];
+        data[i * 2] = data_word & 0xFF;
+        data[i * 2 + 1] = (data_word >> 8) & 0xFF;
+    }
+}
+
+void Board_CANSetRxInterrupt(uint8_t enable) {
+    IEC1bits.C1IE = enable ? 1 : 0;
+    if(can2_running) {
+        IEC2bits.C2IE = enable ? 1 : 0;
+    }
+}
+
+uint8_t Board_CANReceive(uint32_t *id, uint8_t data[8], uint8_t *dlc) {
+    // With DBEN=1, RX0 fills first and RX1 takes the overflow
+    if(C1RX0CONbits.RXFUL) {
+        uint16_t words[4] = { C1RX0B1, C1RX0B2, C1RX0B3, C1RX0B4 };
+        CAN_Unpack(C1RX0SID, C1RX0EID, C1RX0DLC, words, id, data, dlc);
+        C1RX0CONbits.RXFUL = 0;
+        C1INTFbits.RX0IF = 0;
+        return 1;
+    }
+
+    if(C1RX1CONbits.RXFUL) {
+        uint16_t words[4] = { C1RX1B1, C1RX1B2, C1RX1B3, C1RX1B4 };
+        CAN_Unpack(C1RX1SID, C1RX1EID, C1RX1DLC, words, id, data, dlc);
+        C1RX1CONbits.RXFUL = 0;
+        C1INTFbits.RX1IF = 0;
+        return 1;
+    }
+
+    return 0;
+}
+
+uint8_t Board_CANGetErrorState(uint8_t *tec, uint8_t *rec) {
+    *tec = C1ECbits.TERRCNT;
+    *rec = C1ECbits.RERRCNT;
+
+    if(C1INTFbits.TXBO) return BOARD_CAN_BUS_OFF;
+    if(C1INTFbits.TXEP || C1INTFbits.RXEP) return BOARD_CAN_ERROR_PASSIVE;
+    if(C1INTFbits.EWARN) return BOARD_CAN_ERROR_WARNING;
+    return BOARD_CAN_ERROR_ACTIVE;
+}
+
+uint8_t Board_CANAckErrorInterrupt(void) {
+    if(!C1INTFbits.ERRIF) {
+        return 0;
+    }
+    C1INTFbits.ERRIF = 0;
+    return 1;
+}
+
+void Board_CANRestart(void) {
+    C1TX0CONbits.TXREQ = 0;         // Abort - frames are resent after recovery
+    C1TX2CONbits.TXREQ = 0;
+
+    CAN_SetMode(4);
+    CAN_SetMode(0);
+}
+
+void Board_CANSetSleep(uint8_t sleep) {
+    if(sleep) {
+        C1INTFbits.WAKIF = 0;
+        C1INTEbits.WAKIE = 1;
+        CAN_SetMode(1);             // Disable mode - wake-up on bus activity
+        if(can2_running) {
+            CAN2_SetMode(1);        // Gateway segment does not wake us
+        }
+    } else {
+        C1INTEbits.WAKIE = 0;
+        CAN_SetMode(0);
+        C1INTFbits.WAKIF = 0;
+        IFS1bits.C1IF = 0;
+        if(can2_running) {
+            CAN2_SetMode(0);
+        }
+    }
+}
+
+uint8_t Board_CANTxReady(void) {
+    return (C1TX0CONbits.TXREQ == 0);
+}
+
+void Board_CANEncode(uint32_t id, BoardCANTxImage *image) {
+    Board_CANEncodeLength(id, 8, image);
+}
+
+void Board_CANEncodeLength(uint32_t id, uint8_t dlc, BoardCANTxImage *image) {
+    uint16_t sid = (id >> 18) & 0x7FF;
+    uint32_t eid = id & 0x3FFFF;
+
+    // C1TX0SID: SID[10:6] at 15:11, SID[5:0] at 7:2, SRR, TXIDE
+    image->sid = ((uint16_t)((sid >> 6) & 0x1F) << 11) |
+                 ((uint16_t)(sid & 0x3F) << 2) |
+                 (1 << 1) |
+                 (1 << 0);
+
+    // C1TX0EID: EID[17:14] at 15:12, EID[13:6] at 7:0
+    image->eid = ((uint16_t)((eid >> 14) & 0x0F) << 12) |
+                 ((uint16_t)((eid >> 6) & 0xFF) << 0);
+
+    // C1TX0DLC: EID[5:0] at 15:10, DLC at 6:3
+    image->dlc = ((uint16_t)(eid & 0x3F) << 10) |
+                 ((uint16_t)((dlc > 8) ? 8 : dlc) << 3);
+}
+
+void Board_CANTransmitImage(const BoardCANTxImage *image, const uint8_t data[8]) {
+    C1TX0SID = image->sid;
+    C1TX0EID = image->eid;
+    C1TX0DLC = image->dlc;
+
+    C1TX0B1 = ((uint16_t)data[1] << 8) | data[0];
+    C1TX0B2 = ((uint16_t)data[3] << 8) | data[2];
+    C1TX0B3 = ((uint16_t)data[5] << 8) | data[4];
+    C1TX0B4 = ((uint16_t)data[7] << 8) | data[6];
+
+    C1TX0CONbits.TXREQ = 1;
+}
+
+uint8_t Board_CANPriorityTxReady(void) {
+    return (C1TX2CONbits.TXREQ == 0);
+}
+
+void Board_CANTransmitPriority(const BoardCANTxImage *image, const uint8_t data[8]) {
+    // Clearing TXREQ does not stop a frame already on the wire - that one
+    // goes first either way
+    if(C1TX0CONbits.TXREQ && C1TX0SID == image->sid && C1TX0EID == image->eid &&
+       (C1TX0DLC & 0xFC00) == (image->dlc & 0xFC00)) {
+        C1TX0CONbits.TXREQ = 0;
+    }
+
+    C1TX2SID = image->sid;
+    C1TX2EID = image->eid;
+    C1TX2DLC = image->dlc;
+
+    C1TX2B1 = ((uint16_t)data[1] << 8) | data[0];
+    C1TX2B2 = ((uint16_t)data[3] << 8) | data[2];
+    C1TX2B3 = ((uint16_t)data[5] << 8) | data[4];
+    C1TX2B4 = ((uint16_t)data[7] << 8) | data[6];
+
+    C1TX2CONbits.TXREQ = 1;
+}
+
+// ============================================================================
+// SECOND CAN CONTROLLER
+// ============================================================================
+
+static uint8_t CAN2_SetMode(uint8_t mode) {
+    uint16_t timeout = 10000;
+
+    C2CTRLbits.REQOP = mode;
+    while(C2CTRLbits.OPMODE != mode && timeout > 0) timeout--;
+
+    return (timeout > 0);
+}
+
+void Board_CAN2Init(void) {
+    if(!CAN2_SetMode(4)) return;    // Configuration mode
+
+    // Bit timing as Board_CANInit()
+    C2CFG1bits.BRP = 7;
+    C2CFG1bits.SJW = 0;
+
+    C2CFG2bits.PRSEG = 6;
+    C2CFG2bits.SEG1PH = 3;
+    C2CFG2bits.SEG2PHTS = 1;
+    C2CFG2bits.SEG2PH = 3;
+    C2CFG2bits.SAM = 0;
+
+    C2CTRLbits.CANCKS = 0;
+
+    C2TX0CONbits.TXPRI = 0b11;
+    C2RX0CONbits.DBEN = 1;
+
+    // Every extended frame - the forwarding table filters in software
+    C2RXM0SID = 0x0000;
+    C2RXM0EIDH = 0x0000;
+    C2RXM0EIDL = 0x0000;
+    C2RXM1SID = 0x0000;
+    C2RXM1EIDH = 0x0000;
+    C2RXM1EIDL = 0x0000;
+
+    C2RXF0SID = 0x0001;
+    C2RXF0EIDH = 0x0000;
+    C2RXF0EIDL = 0x0000;
+
+    C2INTF = 0;
+    C2INTEbits.RX0IE = 1;
+    C2INTEbits.RX1IE = 1;
+    C2INTEbits.ERRIE = 1;
+
+    // Same priority as C1, so the two receive ISRs never nest
+    IPC9bits.C2IP = BOARD_CAN_IPL;
+    IFS2bits.C2IF = 0;
+    IEC2bits.C2IE = 0;
+
+    CAN2_SetMode(0);                // Normal mode
+    can2_running = 1;
+}
+
+uint8_t Board_CAN2Running(void) {
+    return can2_running;
+}
+
+uint8_t Board_CAN2Receive(uint32_t *id, uint8_t data[8], uint8_t *dlc) {
+    if(C2RX0CONbits.RXFUL) {
+        uint16_t words[4] = { C2RX0B1, C2RX0B2, C2RX0B3, C2RX0B4 };
+        CAN_Unpack(C2RX0SID, C2RX0EID, C2RX0DLC, words, id, data, dlc);
+        C2RX0CONbits.RXFUL = 0;
+        C2INTFbits.RX0IF = 0;
+        return 1;
+    }
+
+    if(C2RX1CONbits.RXFUL) {
+        uint16_t words[4] = { C2RX1B1, C2RX1B2, C2RX1B3, C2RX1B4 };
+        CAN_Unpack(C2RX1SID, C2RX1EID, C2RX1DLC, words, id, data, dlc);
+        C2RX1CONbits.RXFUL = 0;
+        C2INTFbits.RX1IF = 0;
+        return 1;
+    }
+
+    return 0;
+}
+
+uint8_t Board_CAN2GetErrorState(uint8_t *tec, uint8_t *rec) {
+    *tec = C2ECbits.TERRCNT;
+    *rec = C2ECbits.RERRCNT;
+
+    if(C2INTFbits.TXBO) return BOARD_CAN_BUS_OFF;
+    if(C2INTFbits.TXEP || C2INTFbits.RXEP) return BOARD_CAN_ERROR_PASSIVE;
+    if(C2INTFbits.EWARN) return BOARD_CAN_ERROR_WARNING;
+    return BOARD_CAN_ERROR_ACTIVE;
+}
+
+uint8_t Board_CAN2AckErrorInterrupt(void) {
+    if(!C2INTFbits.ERRIF) {
+        return 0;
+    }
+    C2INTFbits.ERRIF = 0;
+    return 1;
+}
+
+void Board_CAN2Restart(void) {
+    C2TX0CONbits.TXREQ = 0;
+
+    CAN2_SetMode(4);
+    CAN2_SetMode(0);
+}
+
+uint8_t Board_CAN2TxReady(void) {
+    return (C2TX0CONbits.TXREQ == 0);
+}
+
+void Board_CAN2TransmitImage(const BoardCANTxImage *image, const uint8_t data[8]) {
+    C2TX0SID = image->sid;
+    C2TX0EID = image->eid;
+    C2TX0DLC = image->dlc;
+
+    C2TX0B1 = ((uint16_t)data[1] << 8) | data[0];
+    C2TX0B2 = ((uint16_t)data[3] << 8) | data[2];
+    C2TX0B3 = ((uint16_t)data[5] << 8) | data[4];
+    C2TX0B4 = ((uint16_t)data[7] << 8) | data[6];
+
+    C2TX0CONbits.TXREQ = 1;
+}
+
+#endif // BOARD_DSPIC30F6012A
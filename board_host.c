@@ -0,0 +1,704 @@
+/*
+ * FILE: board_host.c
+ * Board Support - Simulated Board for Host Builds
+ *
+ * board.h on the host, for building and running the application modules
+ * under gcc (host/Makefile). Registers the modules touch directly are
+ * variables declared in host/xc.h; the NVM, program flash, CAN controllers
+ * and the 1ms tick are modelled here closely enough for the timing and
+ * buffering to mean something. The test side is host/board_host.h.
+ */
+
+#include "board.h"
+
+#if defined(BOARD_HOST)
+
+#include "board_host.h"
+#include <string.h>
+
+// ============================================================================
+// REGISTERS (host/xc.h)
+// ============================================================================
+
+volatile IEC0BITS IEC0bits;
+volatile IEC1BITS IEC1bits;
+volatile IEC2BITS IEC2bits;
+volatile IFS0BITS IFS0bits;
+volatile IFS1BITS IFS1bits;
+volatile IFS2BITS IFS2bits;
+volatile IPC6BITS IPC6bits;
+volatile IPC9BITS IPC9bits;
+
+volatile SPI2STATBITS SPI2STATbits;
+volatile SPI2CONBITS SPI2CONbits;
+volatile uint16_t SPI2BUF;
+
+volatile uint16_t PORTB, LATB, TRISB;
+volatile uint16_t PORTC, LATC, TRISC;
+volatile uint16_t PORTD, LATD, TRISD;
+volatile uint16_t PORTF, LATF, TRISF;
+volatile uint16_t PORTG, LATG, TRISG;
+volatile uint16_t ADPCFG;
+
+// Interrupt service routines of the application, if linked
+void _T1Interrupt(void) __attribute__((weak));
+void _C1Interrupt(void) __attribute__((weak));
+void _C2Interrupt(void) __attribute__((weak));
+void _SPI2Interrupt(void) __attribute__((weak));
+
+// SPI2BUF holds this while the shift register is idle; a write (bytes
+// only) replaces it and is shifted out on the next time step
+#define SPI_IDLE            0xFFFF
+#define SPI_BYTE_NS         1000
+
+#define TX_BUFFERS          3
+#define TX_LOG_SIZE         64
+
+// ============================================================================
+// SIMULATED STATE
+// ============================================================================
+
+typedef struct {
+    uint8_t full;
+    uint32_t id;
+    uint8_t dlc;
+    uint8_t data[8];
+} HostRxBuffer;
+
+typedef struct {
+    uint8_t request;            // TXREQ
+    uint8_t priority;           // TXPRI
+    BoardCANTxImage image;
+    uint8_t data[8];
+    uint64_t queued_ns;
+} HostTxBuffer;
+
+typedef struct {
+    HostRxBuffer rx[2];
+    uint16_t rx_overflows;
+    uint8_t error_pending;      // ERRIF
+    HostTxBuffer tx[TX_BUFFERS];
+    int8_t tx_active;           // Buffer on the wire, -1 = bus idle
+    uint64_t tx_end_ns;
+    uint8_t ack;
+    uint8_t state;
+    uint8_t tec;
+    uint8_t rec;
+    BoardHostFrame log[TX_LOG_SIZE];
+    uint8_t log_head;
+    uint8_t log_count;
+} HostCAN;
+
+static uint64_t now_ns = 0;
+static uint64_t next_tick_ns = 1000000;
+static uint64_t spi_done_ns = 0;
+static uint8_t in_isr = 0;
+
+static uint8_t reset_cause = BOARD_RESET_COLD;
+static uint16_t reset_count = 0;
+
+static uint16_t nvm[BOARD_NVM_SIZE / 2];
+
+// Staging area and boot block only - the application rows are not modelled
+#define FLASH_ROWS  ((BOARD_FLASH_END - BOARD_FLASH_STAGING) / BOARD_FLASH_ROW_PC)
+static uint8_t flash[FLASH_ROWS][BOARD_FLASH_ROW_BYTES];
+
+static HostCAN can[2];
+static uint8_t can2_running = 0;
+
+// ============================================================================
+// TIME
+// ============================================================================
+
+static void RunISR(void (*isr)(void)) {
+    if (isr == NULL || in_isr) {
+        return;
+    }
+    in_isr = 1;
+    isr();
+    in_isr = 0;
+}
+
+static uint8_t CANPending(uint8_t bus) {
+    return can[bus].rx[0].full || can[bus].rx[1].full || can[bus].error_pending;
+}
+
+/*
+ * Vector whatever is enabled and pending - the application may have
+ * just unmasked it
+ */
+static void ServiceInterrupts(void) {
+    if (in_isr) {
+        return;
+    }
+    if (IFS0bits.T1IF && IEC0bits.T1IE) {
+        IFS0bits.T1IF = 0;
+        RunISR(_T1Interrupt);
+    }
+    if (IEC1bits.C1IE && CANPending(BOARD_HOST_CAN1)) {
+        IFS1bits.C1IF = 1;
+        RunISR(_C1Interrupt);
+    }
+    if (IEC2bits.C2IE && CANPending(BOARD_HOST_CAN2)) {
+        IFS2bits.C2IF = 1;
+        RunISR(_C2Interrupt);
+    }
+}
+
+static void DecodeImage(const BoardCANTxImage *image, uint32_t *id, uint8_t *dlc) {
+    uint16_t sid = ((image->sid >> 11) & 0x1F) << 6 | ((image->sid >> 2) & 0x3F);
+    uint32_t eid = ((uint32_t)((image->eid >> 12) & 0x0F) << 14) |
+                   ((uint32_t)(image->eid & 0xFF) << 6) |
+                   ((image->dlc >> 10) & 0x3F);
+
+    *id = ((uint32_t)sid << 18) | eid;
+    *dlc = (image->dlc >> 3) & 0x0F;
+}
+
+/*
+ * Bus arbitration between the controller's own buffers: highest TXPRI
+ * first, the higher buffer number on a tie (as the ECAN module does)
+ */
+static void CANStartNext(uint8_t bus) {
+    HostCAN *c = &can[bus];
+    int8_t best = -1;
+
+    if (!c->ack || c->state == BOARD_CAN_BUS_OFF) {
+        return;
+    }
+    for (int8_t i = 0; i < TX_BUFFERS; i++) {
+        if (c->tx[i].request &&
+            (best < 0 || c->tx[i].priority >= c->tx[best].priority)) {
+            best = i;
+        }
+    }
+    if (best < 0) {
+        return;
+    }
+
+    uint32_t id;
+    uint8_t dlc;
+    DecodeImage(&c->tx[best].image, &id, &dlc);
+    c->tx_active = best;
+    c->tx_end_ns = now_ns + (uint64_t)BOARD_HOST_FRAME_BITS(dlc) * BOARD_HOST_BIT_NS;
+}
+
+static void CANFinish(uint8_t bus) {
+    HostCAN *c = &can[bus];
+    HostTxBuffer *tx = &c->tx[c->tx_active];
+    BoardHostFrame *f = &c->log[(c->log_head + c->log_count) % TX_LOG_SIZE];
+
+    DecodeImage(&tx->image, &f->id, &f->dlc);
+    memcpy(f->data, tx->data, 8);
+    f->buffer = (uint8_t)c->tx_active;
+    f->queued_ns = tx->queued_ns;
+    f->sent_ns = c->tx_end_ns;
+
+    // A full log drops the oldest frame
+    if (c->log_count < TX_LOG_SIZE) {
+        c->log_count++;
+    } else {
+        c->log_head = (c->log_head + 1) % TX_LOG_SIZE;
+    }
+
+    tx->request = 0;
+    c->tx_active = -1;
+}
+
+/*
+ * Move time to target, handling every event on the way in order
+ */
+static void RunUntil(uint64_t target) {
+    // An ISR run below may spend time itself (busy-waits) and move now_ns
+    // past target - time never runs backwards
+    while (now_ns < target) {
+        uint64_t next = target;
+
+        for (uint8_t bus = 0; bus < 2; bus++) {
+            if (can[bus].tx_active < 0) {
+                CANStartNext(bus);
+            }
+            if (can[bus].tx_active >= 0 && can[bus].tx_end_ns < next) {
+                next = can[bus].tx_end_ns;
+            }
+        }
+        if (next_tick_ns < next) {
+            next = next_tick_ns;
+        }
+        if (SPI2BUF != SPI_IDLE && SPI2STATbits.SPIEN) {
+            if (spi_done_ns <= now_ns) {
+                spi_done_ns = now_ns + SPI_BYTE_NS;
+            }
+            if (spi_done_ns < next) {
+                next = spi_done_ns;
+            }
+        }
+        if (next > target) {
+            break;
+        }
+
+        if (next > now_ns) {
+            now_ns = next;
+        }
+
+        for (uint8_t bus = 0; bus < 2; bus++) {
+            if (can[bus].tx_active >= 0 && can[bus].tx_end_ns <= now_ns) {
+                CANFinish(bus);
+            }
+        }
+        if (next_tick_ns <= now_ns) {
+            next_tick_ns += 1000000;
+            IFS0bits.T1IF = 1;
+        }
+        if (SPI2BUF != SPI_IDLE && spi_done_ns <= now_ns) {
+            SPI2BUF = SPI_IDLE;
+            IFS1bits.SPI2IF = 1;
+            if (IEC1bits.SPI2IE) {
+                RunISR(_SPI2Interrupt);
+            }
+        }
+        ServiceInterrupts();
+    }
+}
+
+void Board_HostAdvanceNs(uint32_t ns) {
+    RunUntil(now_ns + ns);
+}
+
+void Board_HostAdvanceUs(uint32_t us) {
+    RunUntil(now_ns + (uint64_t)us * 1000);
+}
+
+void Board_HostDelayUs(uint32_t us) {
+    Board_HostAdvanceUs(us);
+}
+
+uint64_t Board_HostTimeNs(void) {
+    return now_ns;
+}
+
+void Board_HostReset(void) {
+    now_ns = 0;
+    next_tick_ns = 1000000;
+    spi_done_ns = 0;
+    in_isr = 0;
+    reset_cause = BOARD_RESET_COLD;
+    reset_count = 0;
+
+    memset(nvm, 0xFF, sizeof(nvm));
+    memset(flash, 0xFF, sizeof(flash));
+    memset(can, 0, sizeof(can));
+    for (uint8_t bus = 0; bus < 2; bus++) {
+        can[bus].tx_active = -1;
+        can[bus].ack = 1;
+        can[bus].state = BOARD_CAN_ERROR_ACTIVE;
+    }
+    can2_running = 0;
+
+    // Everything masked, as out of reset
+    memset((void *)&IEC0bits, 0, sizeof(IEC0bits));
+    memset((void *)&IEC1bits, 0, sizeof(IEC1bits));
+    memset((void *)&IEC2bits, 0, sizeof(IEC2bits));
+    memset((void *)&IFS0bits, 0, sizeof(IFS0bits));
+    memset((void *)&IFS1bits, 0, sizeof(IFS1bits));
+    memset((void *)&IFS2bits, 0, sizeof(IFS2bits));
+    IPC6bits.SPI2IP = 4;
+    IPC6bits.C1IP = 4;
+    IPC9bits.C2IP = 4;
+    SPI2BUF = SPI_IDLE;
+}
+
+// ============================================================================
+// CLOCK / TICK
+// ============================================================================
+
+void Board_InitTick(void) {
+    next_tick_ns = now_ns + 1000000;
+    IFS0bits.T1IF = 0;
+    IEC0bits.T1IE = 1;
+}
+
+uint16_t Board_TickCount(void) {
+    uint64_t into_tick = 1000000 - (next_tick_ns - now_ns);
+    uint16_t count = (uint16_t)(into_tick / (BOARD_TICK_US * 1000));
+
+    if (IFS0bits.T1IF) {
+        count += BOARD_TICK_COUNTS;
+    }
+    return count;
+}
+
+// ============================================================================
+// POWER
+// ============================================================================
+
+uint8_t Board_ResetCause(void) {
+    uint8_t cause = reset_cause;
+
+    reset_cause = BOARD_RESET_OTHER;
+    return cause;
+}
+
+void Board_WatchdogEnable(void) {
+}
+
+void Board_WatchdogKick(void) {
+}
+
+void Board_Reset(void) {
+    // The test bench decides what a reset means - count it and go on
+    reset_count++;
+    reset_cause = BOARD_RESET_OTHER;
+}
+
+void Board_Idle(void) {
+    // Until the next tick
+    RunUntil(next_tick_ns);
+}
+
+uint8_t Board_Sleep(void) {
+    // Timer1 stops while asleep: the tick resumes where it left off
+    uint64_t tick_left = next_tick_ns - now_ns;
+    uint64_t wake = now_ns + (uint64_t)BOARD_SLEEP_WAKE_MS * 1000000;
+    uint8_t source = CANPending(BOARD_HOST_CAN1) ? BOARD_WAKE_CAN : BOARD_WAKE_TIMER;
+
+    if (source == BOARD_WAKE_TIMER) {
+        now_ns = wake;
+    }
+    next_tick_ns = now_ns + tick_left;
+    return source;
+}
+
+// ============================================================================
+// NVM (DATA EEPROM)
+// ============================================================================
+
+uint16_t Board_NVMReadWord(uint16_t address) {
+    if ((address & 0x01) || address >= BOARD_NVM_SIZE) {
+        return 0xFFFF;
+    }
+    return nvm[address / 2];
+}
+
+uint8_t Board_NVMEraseWord(uint16_t address) {
+    if ((address & 0x01) || address >= BOARD_NVM_SIZE) {
+        return 0;
+    }
+    nvm[address / 2] = 0xFFFF;
+    Board_HostAdvanceUs(3000);
+    return 1;
+}
+
+uint8_t Board_NVMProgramWord(uint16_t address, uint16_t data) {
+    if ((address & 0x01) || address >= BOARD_NVM_SIZE) {
+        return 0;
+    }
+    // Programming only clears bits
+    nvm[address / 2] &= data;
+    Board_HostAdvanceUs(3000);
+    return 1;
+}
+
+uint16_t *Board_HostNVM(void) {
+    return nvm;
+}
+
+// ============================================================================
+// PROGRAM FLASH (RTSP)
+// ============================================================================
+
+static uint8_t FlashRowWritable(uint32_t address) {
+    return (address % BOARD_FLASH_ROW_PC) == 0 &&
+           address >= BOARD_FLASH_STAGING &&
+           address < BOARD_FLASH_BOOT;
+}
+
+uint8_t *Board_HostFlashRow(uint32_t address) {
+    if (address < BOARD_FLASH_STAGING ||
+        (address - BOARD_FLASH_STAGING) / BOARD_FLASH_ROW_PC >= FLASH_ROWS) {
+        return NULL;
+    }
+    return flash[(address - BOARD_FLASH_STAGING) / BOARD_FLASH_ROW_PC];
+}
+
+uint8_t Board_FlashEraseRow(uint32_t address) {
+    if (!FlashRowWritable(address)) {
+        return 0;
+    }
+    memset(Board_HostFlashRow(address), 0xFF, BOARD_FLASH_ROW_BYTES);
+    Board_HostAdvanceUs(2000);
+    return 1;
+}
+
+uint8_t Board_FlashWriteRow(uint32_t address, const uint8_t *row) {
+    if (!FlashRowWritable(address)) {
+        return 0;
+    }
+    uint8_t *dest = Board_HostFlashRow(address);
+    for (uint8_t i = 0; i < BOARD_FLASH_ROW_BYTES; i++) {
+        dest[i] &= row[i];
+    }
+    Board_HostAdvanceUs(2000);
+    return 1;
+}
+
+void Board_FlashReadRow(uint32_t address, uint8_t *row) {
+    uint8_t *src = Board_HostFlashRow(address);
+
+    // The application itself reads as blank
+    if (src == NULL) {
+        memset(row, 0xFF, BOARD_FLASH_ROW_BYTES);
+        return;
+    }
+    memcpy(row, src, BOARD_FLASH_ROW_BYTES);
+}
+
+// ============================================================================
+// CAN CONTROLLER
+// ============================================================================
+
+static uint8_t CANReceive(uint8_t bus, uint32_t *id, uint8_t data[8], uint8_t *dlc) {
+    // RX0 fills first and RX1 takes the overflow
+    for (uint8_t i = 0; i < 2; i++) {
+        HostRxBuffer *rx = &can[bus].rx[i];
+        if (rx->full) {
+            *id = rx->id;
+            *dlc = rx->dlc;
+            memcpy(data, rx->data, 8);
+            rx->full = 0;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static uint8_t CANErrorState(uint8_t bus, uint8_t *tec, uint8_t *rec) {
+    *tec = can[bus].tec;
+    *rec = can[bus].rec;
+    return can[bus].state;
+}
+
+static uint8_t CANAckError(uint8_t bus) {
+    if (!can[bus].error_pending) {
+        return 0;
+    }
+    can[bus].error_pending = 0;
+    return 1;
+}
+
+static void CANRestart(uint8_t bus) {
+    HostCAN *c = &can[bus];
+
+    // Abort everything - frames are resent after recovery
+    for (uint8_t i = 0; i < TX_BUFFERS; i++) {
+        c->tx[i].request = 0;
+    }
+    c->tx_active = -1;
+    c->state = BOARD_CAN_ERROR_ACTIVE;
+    c->tec = 0;
+    c->rec = 0;
+}
+
+static void CANTransmit(uint8_t bus, uint8_t buffer,
+                        const BoardCANTxImage *image, const uint8_t data[8]) {
+    HostTxBuffer *tx = &can[bus].tx[buffer];
+
+    tx->image = *image;
+    memcpy(tx->data, data, 8);
+    tx->queued_ns = now_ns;
+    tx->request = 1;
+}
+
+void Board_CANInit(void) {
+    can[BOARD_HOST_CAN1].tx[0].priority = 0b10;
+    can[BOARD_HOST_CAN1].tx[2].priority = 0b11;
+    IPC6bits.C1IP = BOARD_CAN_IPL;
+    IFS1bits.C1IF = 0;
+    IEC1bits.C1IE = 0;
+    Board_HostAdvanceUs(10000);
+}
+
+void Board_CANAcceptAll(void) {
+}
+
+void Board_CANSetRxInterrupt(uint8_t enable) {
+    IEC1bits.C1IE = enable ? 1 : 0;
+    if (can2_running) {
+        IEC2bits.C2IE = enable ? 1 : 0;
+    }
+    if (enable) {
+        ServiceInterrupts();
+    }
+}
+
+uint8_t Board_CANReceive(uint32_t *id, uint8_t data[8], uint8_t *dlc) {
+    return CANReceive(BOARD_HOST_CAN1, id, data, dlc);
+}
+
+uint8_t Board_CANGetErrorState(uint8_t *tec, uint8_t *rec) {
+    return CANErrorState(BOARD_HOST_CAN1, tec, rec);
+}
+
+uint8_t Board_CANAckErrorInterrupt(void) {
+    return CANAckError(BOARD_HOST_CAN1);
+}
+
+void Board_CANRestart(void) {
+    CANRestart(BOARD_HOST_CAN1);
+}
+
+void Board_CANSetSleep(uint8_t sleep) {
+    (void)sleep;
+}
+
+uint8_t Board_CANTxReady(void) {
+    // Every poll is one turn of the caller's busy-wait
+    Board_HostAdvanceNs(BOARD_HOST_POLL_NS);
+    return !can[BOARD_HOST_CAN1].tx[0].request;
+}
+
+void Board_CANEncode(uint32_t id, BoardCANTxImage *image) {
+    Board_CANEncodeLength(id, 8, image);
+}
+
+void Board_CANEncodeLength(uint32_t id, uint8_t dlc, BoardCANTxImage *image) {
+    uint16_t sid = (id >> 18) & 0x7FF;
+    uint32_t eid = id & 0x3FFFF;
+
+    // Same register images as the part
+    image->sid = ((uint16_t)((sid >> 6) & 0x1F) << 11) |
+                 ((uint16_t)(sid & 0x3F) << 2) |
+                 (1 << 1) |
+                 (1 << 0);
+    image->eid = ((uint16_t)((eid >> 14) & 0x0F) << 12) |
+                 ((uint16_t)((eid >> 6) & 0xFF) << 0);
+    image->dlc = ((uint16_t)(eid & 0x3F) << 10) |
+                 ((uint16_t)((dlc > 8) ? 8 : dlc) << 3);
+}
+
+void Board_CANTransmitImage(const BoardCANTxImage *image, const uint8_t data[8]) {
+    CANTransmit(BOARD_HOST_CAN1, 0, image, data);
+}
+
+uint8_t Board_CANPriorityTxReady(void) {
+    Board_HostAdvanceNs(BOARD_HOST_POLL_NS);
+    return !can[BOARD_HOST_CAN1].tx[2].request;
+}
+
+void Board_CANTransmitPriority(const BoardCANTxImage *image, const uint8_t data[8]) {
+    HostCAN *c = &can[BOARD_HOST_CAN1];
+
+    // A frame already on the wire is not stopped
+    if (c->tx[0].request && c->tx_active != 0 &&
+        c->tx[0].image.sid == image->sid && c->tx[0].image.eid == image->eid &&
+        (c->tx[0].image.dlc & 0xFC00) == (image->dlc & 0xFC00)) {
+        c->tx[0].request = 0;
+    }
+    CANTransmit(BOARD_HOST_CAN1, 2, image, data);
+}
+
+// ============================================================================
+// SECOND CAN CONTROLLER
+// ============================================================================
+
+void Board_CAN2Init(void) {
+    can[BOARD_HOST_CAN2].tx[0].priority = 0b11;
+    IPC9bits.C2IP = BOARD_CAN_IPL;
+    IFS2bits.C2IF = 0;
+    IEC2bits.C2IE = 0;
+    can2_running = 1;
+}
+
+uint8_t Board_CAN2Running(void) {
+    return can2_running;
+}
+
+uint8_t Board_CAN2Receive(uint32_t *id, uint8_t data[8], uint8_t *dlc) {
+    return CANReceive(BOARD_HOST_CAN2, id, data, dlc);
+}
+
+uint8_t Board_CAN2GetErrorState(uint8_t *tec, uint8_t *rec) {
+    return CANErrorState(BOARD_HOST_CAN2, tec, rec);
+}
+
+uint8_t Board_CAN2AckErrorInterrupt(void) {
+    return CANAckError(BOARD_HOST_CAN2);
+}
+
+void Board_CAN2Restart(void) {
+    CANRestart(BOARD_HOST_CAN2);
+}
+
+uint8_t Board_CAN2TxReady(void) {
+    Board_HostAdvanceNs(BOARD_HOST_POLL_NS);
+    return !can[BOARD_HOST_CAN2].tx[0].request;
+}
+
+void Board_CAN2TransmitImage(const BoardCANTxImage *image, const uint8_t data[8]) {
+    CANTransmit(BOARD_HOST_CAN2, 0, image, data);
+}
+
+// ============================================================================
+// TEST HOOKS (host/board_host.h)
+// ============================================================================
+
+uint8_t Board_HostCANInject(uint8_t bus, uint32_t id, uint8_t dlc, const uint8_t *data) {
+    HostCAN *c = &can[bus];
+    HostRxBuffer *rx = !c->rx[0].full ? &c->rx[0] : !c->rx[1].full ? &c->rx[1] : NULL;
+
+    if (rx == NULL) {
+        c->rx_overflows++;
+        return 0;
+    }
+
+    rx->id = id & 0x1FFFFFFF;
+    rx->dlc = (dlc > 8) ? 8 : dlc;
+    memset(rx->data, 0, 8);
+    memcpy(rx->data, data, rx->dlc);
+    rx->full = 1;
+
+    ServiceInterrupts();
+    return 1;
+}
+
+uint16_t Board_HostCANRxOverflows(uint8_t bus) {
+    return can[bus].rx_overflows;
+}
+
+uint8_t Board_HostCANSent(uint8_t bus, BoardHostFrame *frame) {
+    HostCAN *c = &can[bus];
+
+    if (c->log_count == 0) {
+        return 0;
+    }
+    *frame = c->log[c->log_head];
+    c->log_head = (c->log_head + 1) % TX_LOG_SIZE;
+    c->log_count--;
+    return 1;
+}
+
+void Board_HostCANSetAck(uint8_t bus, uint8_t ack) {
+    can[bus].ack = ack;
+}
+
+void Board_HostCANSetErrorState(uint8_t bus, uint8_t state, uint8_t tec, uint8_t rec) {
+    HostCAN *c = &can[bus];
+
+    if (state != c->state) {
+        c->error_pending = 1;
+    }
+    c->state = state;
+    c->tec = tec;
+    c->rec = rec;
+    ServiceInterrupts();
+}
+
+void Board_HostSetResetCause(uint8_t cause) {
+    reset_cause = cause;
+}
+
+uint16_t Board_HostResetCount(void) {
+    return reset_count;
+}
+
+#endif // BOARD_HOST
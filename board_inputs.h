@@ -0,0 +1,79 @@
+/*
+ * FILE: board_inputs.h
+ * MASTERCELL NGX Input Wiring
+ *
+ * Which multiplexer and channel each input is wired to, and which port
+ * pin each multiplexer output lands on. This is the only place the
+ * wiring is described - inputs.c generates its scan order, packed read
+ * and input names from these tables at compile time, and checks that
+ * every input appears exactly once.
+ *
+ * A board revision changes the entries below; Inputs_Scan() does not change.
+ */
+
+#ifndef BOARD_INPUTS_H
+#define BOARD_INPUTS_H
+
+#include "inputs.h"
+
+#define MUX_COUNT       6       // MUX01-MUX06
+#define MUX_CHANNELS    8       // S1-S8, selected by MUX_A0-MUX_A2
+
+/*
+ * Multiplexer output pins: X(mux, port, bit)
+ *   mux  - 1-6 (MUX01MC-MUX06MC)
+ *   port - B, C, D ... (PORTx / TRISx)
+ *   bit  - pin number within the port
+ */
+#define MUX_OUTPUT_PINS(X) \
+    X(1, D, 7)      /* MUX01MC = RD7  */ \
+    X(2, D, 9)      /* MUX02MC = RD9  */ \
+    X(3, D, 8)      /* MUX03MC = RD8  */ \
+    X(4, B, 14)     /* MUX04MC = RB14 */ \
+    X(5, C, 1)      /* MUX05MC = RC1  */ \
+    X(6, C, 2)      /* MUX06MC = RC2  */
+
+/*
+ * Input wiring: X(input, mux, channel)
+ *   input   - index define from inputs.h (IN01-IN38, HSIN01-HSIN06)
+ *   mux     - 1-6
+ *   channel - 0-7, corresponding to S1-S8
+ *
+ * Entries may be listed in any order.
+ */
+#define INPUT_MUX_MAP(X) \
+    /* IN01-IN04 on MUX01 S1-S4 */ \
+    X(IN01, 1, 0)   X(IN02, 1, 1)   X(IN03, 1, 2)   X(IN04, 1, 3) \
+    \
+    /* IN05-IN08 on MUX02 S4,S2,S7,S8 */ \
+    X(IN05, 2, 3)   X(IN06, 2, 1)   X(IN07, 2, 6)   X(IN08, 2, 7) \
+    \
+    /* IN09-IN12 on MUX03 S4,S3,S2,S1 */ \
+    X(IN09, 3, 3)   X(IN10, 3, 2)   X(IN11, 3, 1)   X(IN12, 3, 0) \
+    \
+    /* IN13-IN16 on MUX03 S8,S7,S6,S5 */ \
+    X(IN13, 3, 7)   X(IN14, 3, 6)   X(IN15, 3, 5)   X(IN16, 3, 4) \
+    \
+    /* IN17-IN20 on MUX01 S5-S8 */ \
+    X(IN17, 1, 4)   X(IN18, 1, 5)   X(IN19, 1, 6)   X(IN20, 1, 7) \
+    \
+    /* IN21-IN22 on MUX02 S3,S1 */ \
+    X(IN21, 2, 2)   X(IN22, 2, 0) \
+    \
+    /* IN23-IN26 on MUX04 S4,S3,S2,S1 (SWAPPED: IN23 and IN24 reversed in hardware) */ \
+    X(IN23, 4, 2)   X(IN24, 4, 3)   X(IN25, 4, 1)   X(IN26, 4, 0) \
+    \
+    /* IN27-IN30 on MUX06 S5,S6,S7,S8 */ \
+    X(IN27, 6, 4)   X(IN28, 6, 5)   X(IN29, 6, 6)   X(IN30, 6, 7) \
+    \
+    /* IN31-IN34 on MUX06 S4,S3,S2,S1 */ \
+    X(IN31, 6, 3)   X(IN32, 6, 2)   X(IN33, 6, 1)   X(IN34, 6, 0) \
+    \
+    /* IN35-IN38 on MUX05 S5,S6,S8,S7 */ \
+    X(IN35, 5, 4)   X(IN36, 5, 5)   X(IN37, 5, 7)   X(IN38, 5, 6) \
+    \
+    /* HSIN01-HSIN06 on MUX02 S5,S6 and MUX04 S5,S6,S7,S8 */ \
+    X(HSIN01, 2, 4) X(HSIN02, 2, 5) \
+    X(HSIN03, 4, 4) X(HSIN04, 4, 5) X(HSIN05, 4, 6) X(HSIN06, 4, 7)
+
+#endif // BOARD_INPUTS_H
@@ -4,12 +4,33 @@
 
 #include "buttons.h"
 
-// Define FCY for delay macros
-#define FCY 16000000UL
-#include <libpic30.h>
+// Event queue depth (power of 2)
+#define BUTTON_EVENT_QUEUE_SIZE 8
 
-// Debounce delay in milliseconds
-#define DEBOUNCE_DELAY 20
+// Bitmask bit → button ID (bit0=RADIO, bit1=HOME, bit2=DOWN, bit3=UP, bit4=SELECT)
+static const uint8_t bit_to_id[5] = {
+    BTN_ID_RADIO, BTN_ID_HOME, BTN_ID_DOWN, BTN_ID_UP, BTN_ID_SELECT
+};
+
+// Buttons that auto-repeat instead of reporting long-press
+#define BUTTON_REPEAT_MASK  0x0C    // DOWN, UP
+
+// Debounce state (vertical counter)
+static volatile uint8_t debounced = 0;
+static uint8_t vc_bit0 = 0xFF;
+static uint8_t vc_bit1 = 0xFF;
+static uint8_t sample_divider = 0;
+
+// Hold tracking for the most recently pressed button
+static uint8_t held_bit = 0;
+static uint16_t held_ms = 0;
+static uint16_t next_repeat_ms = 0;
+static uint8_t long_sent = 0;
+
+// Event ring buffer (written in ISR, read in main loop)
+static volatile uint8_t event_queue[BUTTON_EVENT_QUEUE_SIZE];
+static volatile uint8_t event_head = 0;
+static volatile uint8_t event_tail = 0;
 
 // Initialize button pins
 void Buttons_Init(void) {
@@ -30,59 +51,106 @@ void Buttons_DetectStuck(void) {
     stuck_buttons = Buttons_GetRawState();
 }
 
-// Clear a button from stuck list when it's released
-static void UpdateStuckButtons(void) {
-    uint8_t current = Buttons_GetRawState();
-    // If a button was stuck but is now released, remove from stuck list
-    stuck_buttons &= current;
-}
-
-// Scan for button press and return button ID
-// Returns BTN_ID_NONE if no button pressed
-// Buttons are active LOW (pressed = 0, not pressed = 1)
-// NON-BLOCKING version - ignores stuck buttons
-uint8_t Buttons_Scan(void) {
-    // Update stuck button tracking
-    UpdateStuckButtons();
-    
-    // Check each button (active low), skipping stuck ones
-    // Check in order: HOME, DOWN, UP, SELECT (skip RADIO if stuck)
-    
-    if ((stuck_buttons & 0x02) == 0 && BTN_HOME_PIN == 0) {
-        __delay_ms(DEBOUNCE_DELAY);
-        if (BTN_HOME_PIN == 0) {
-            return BTN_ID_HOME;
+// Queue an event for a bitmask bit; drops the event if the queue is full
+static void QueueEvent(uint8_t type, uint8_t bit_mask) {
+    uint8_t id = BTN_ID_NONE;
+    for (uint8_t i = 0; i < 5; i++) {
+        if (bit_mask & (1 << i)) {
+            id = bit_to_id[i];
+            break;
         }
     }
     
-    if ((stuck_buttons & 0x04) == 0 && BTN_DOWN_PIN == 0) {
-        __delay_ms(DEBOUNCE_DELAY);
-        if (BTN_DOWN_PIN == 0) {
-            return BTN_ID_DOWN;
-        }
+    uint8_t next = (event_head + 1) & (BUTTON_EVENT_QUEUE_SIZE - 1);
+    if (next != event_tail) {
+        event_queue[event_head] = type | id;
+        event_head = next;
+    }
+}
+
+// Called every 1ms from Timer1 ISR
+void Buttons_Tick(void) {
+    if (held_bit) {
+        held_ms++;
     }
     
-    if ((stuck_buttons & 0x08) == 0 && BTN_UP_PIN == 0) {
-        __delay_ms(DEBOUNCE_DELAY);
-        if (BTN_UP_PIN == 0) {
-            return BTN_ID_UP;
-        }
+    if (++sample_divider < BUTTON_SAMPLE_MS) {
+        return;
     }
+    sample_divider = 0;
     
-    if ((stuck_buttons & 0x10) == 0 && BTN_SELECT_PIN == 0) {
-        __delay_ms(DEBOUNCE_DELAY);
-        if (BTN_SELECT_PIN == 0) {
-            return BTN_ID_SELECT;
+    uint8_t sample = Buttons_GetRawState();
+    
+    // If a button was stuck but is now released, remove from stuck list
+    stuck_buttons &= sample;
+    sample &= ~stuck_buttons;
+    
+    // 2-bit vertical counter: a bit toggles after 4 consecutive differing samples
+    uint8_t delta = debounced ^ sample;
+    vc_bit0 = ~(vc_bit0 & delta);
+    vc_bit1 = vc_bit0 ^ (vc_bit1 & delta);
+    uint8_t toggled = delta & vc_bit0 & vc_bit1;
+    debounced ^= toggled;
+    
+    uint8_t pressed = toggled & debounced;
+    uint8_t released = toggled & ~debounced;
+    
+    for (uint8_t i = 0; i < 5; i++) {
+        uint8_t bit = 1 << i;
+        if (pressed & bit) {
+            QueueEvent(BTN_EVT_PRESS, bit);
+            held_bit = bit;
+            held_ms = 0;
+            next_repeat_ms = BUTTON_REPEAT_DELAY_MS;
+            long_sent = 0;
+        }
+        if (released & bit) {
+            QueueEvent(BTN_EVT_RELEASE, bit);
+            if (held_bit == bit) {
+                held_bit = 0;
+            }
         }
     }
     
-    // Check RADIO last (often stuck on some boards)
-    if ((stuck_buttons & 0x01) == 0 && BTN_RADIO_PIN == 0) {
-        __delay_ms(DEBOUNCE_DELAY);
-        if (BTN_RADIO_PIN == 0) {
-            return BTN_ID_RADIO;
+    // Long-press / auto-repeat on the held button
+    if (held_bit) {
+        if (held_bit & BUTTON_REPEAT_MASK) {
+            if (held_ms >= next_repeat_ms) {
+                QueueEvent(BTN_EVT_REPEAT, held_bit);
+                next_repeat_ms += BUTTON_REPEAT_RATE_MS;
+            }
+        } else if (!long_sent && held_ms >= BUTTON_LONG_PRESS_MS) {
+            QueueEvent(BTN_EVT_LONG, held_bit);
+            long_sent = 1;
         }
     }
+}
+
+uint8_t Buttons_GetEvent(void) {
+    if (event_tail == event_head) {
+        return BTN_EVENT_NONE;
+    }
+    
+    uint8_t event = event_queue[event_tail];
+    event_tail = (event_tail + 1) & (BUTTON_EVENT_QUEUE_SIZE - 1);
+    return event;
+}
+
+void Buttons_FlushEvents(void) {
+    event_tail = event_head;
+}
+
+// Return the currently held (debounced) button ID
+// Returns BTN_ID_NONE if no button pressed
+// Checked in order: HOME, DOWN, UP, SELECT, RADIO (often stuck on some boards)
+uint8_t Buttons_Scan(void) {
+    uint8_t state = debounced;
+    
+    if (state & 0x02) return BTN_ID_HOME;
+    if (state & 0x04) return BTN_ID_DOWN;
+    if (state & 0x08) return BTN_ID_UP;
+    if (state & 0x10) return BTN_ID_SELECT;
+    if (state & 0x01) return BTN_ID_RADIO;
     
     return BTN_ID_NONE;
 }
@@ -100,6 +168,10 @@ uint8_t Buttons_GetRawState(void) {
     return state;
 }
 
+uint8_t Buttons_GetDebouncedState(void) {
+    return debounced;
+}
+
 // Get button name string
 const char* Buttons_GetName(uint8_t button) {
     switch(button) {
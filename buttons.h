@@ -1,6 +1,11 @@
 /*
  * Button Handler for MASTERCELL NGX
  * 5 buttons below LCD screen
+ * 
+ * Buttons are sampled from the Timer1 tick into a packed bitmask and
+ * debounced with a 2-bit vertical counter (4 agreeing samples). Edges
+ * are queued as events for the UI: press, release, long-press, and
+ * auto-repeat for the scroll buttons. Nothing here ever blocks.
  */
 
 #ifndef BUTTONS_H
@@ -33,11 +38,45 @@
 #define BTN_ID_UP       4
 #define BTN_ID_SELECT   5
 
+// Event types (upper nibble of an event, button ID in lower nibble)
+#define BTN_EVENT_NONE      0x00
+#define BTN_EVT_PRESS       0x10
+#define BTN_EVT_RELEASE     0x20
+#define BTN_EVT_LONG        0x30    // Held for BUTTON_LONG_PRESS_MS
+#define BTN_EVT_REPEAT      0x40    // Auto-repeat while UP/DOWN held
+
+#define BTN_EVENT_TYPE(e)   ((e) & 0xF0)
+#define BTN_EVENT_ID(e)     ((e) & 0x0F)
+
+// Timing (milliseconds)
+#define BUTTON_SAMPLE_MS        5       // Sample period; 4 samples = 20ms debounce
+#define BUTTON_LONG_PRESS_MS    1000
+#define BUTTON_REPEAT_DELAY_MS  500     // First auto-repeat
+#define BUTTON_REPEAT_RATE_MS   150     // Subsequent auto-repeats
+
 // Function prototypes
 void Buttons_Init(void);
 void Buttons_DetectStuck(void);     // Call after init to detect stuck buttons
-uint8_t Buttons_Scan(void);
+
+/**
+ * Sample and debounce the buttons - call every 1ms from the Timer1 ISR
+ */
+void Buttons_Tick(void);
+
+/**
+ * Get the next queued button event
+ * @return Event (BTN_EVT_xxx | BTN_ID_xxx), or BTN_EVENT_NONE if queue empty
+ */
+uint8_t Buttons_GetEvent(void);
+
+/**
+ * Discard any queued events
+ */
+void Buttons_FlushEvents(void);
+
+uint8_t Buttons_Scan(void);         // Debounced: highest-priority held button
 uint8_t Buttons_GetRawState(void);  // Non-blocking raw pin state
+uint8_t Buttons_GetDebouncedState(void);  // Debounced bitmask (same bits as raw)
 const char* Buttons_GetName(uint8_t button);
 
 #endif // BUTTONS_H
\ No newline at end of file
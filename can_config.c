@@ -11,18 +11,13 @@
 #include "eeprom_config.h"
 #include "j1939.h"
 #include "eeprom_init.h"  // For working EEPROM_Init_WriteByte function
+#include "climate.h"
+#include "inreserve.h"
+#include "eeprom_cases.h"
+#include "inputs.h"
+#include "gateway.h"
 #include <string.h>
 
-// Cached configuration values (loaded from EEPROM)
-static uint16_t cached_read_pgn;
-static uint16_t cached_write_pgn;
-static uint16_t cached_response_pgn;
-static uint8_t cached_read_sa;
-static uint8_t cached_write_sa;
-static uint8_t cached_response_sa;
-static uint8_t cached_fw_major;
-static uint8_t cached_fw_minor;
-
 // Diagnostic counters
 static uint32_t read_request_count = 0;
 static uint32_t write_request_count = 0;
@@ -40,19 +35,11 @@ void CAN_Config_Init(void) {
 
 /**
  * Reload configuration from EEPROM
+ * Request/response PGN/SA values are read from the config header shadow
+ * on use; only the heartbeat identifier is pre-encoded.
  */
 void CAN_Config_Reload(void) {
-    // Read PGN/SA values from EEPROM
-    cached_read_pgn = EEPROM_Config_ReadPGN(EEPROM_CFG_READ_REQ_PGN_A);
-    cached_write_pgn = EEPROM_Config_ReadPGN(EEPROM_CFG_WRITE_REQ_PGN_A);
-    cached_response_pgn = EEPROM_Config_ReadPGN(EEPROM_CFG_RESPONSE_PGN_A);
-    
-    cached_read_sa = EEPROM_Config_ReadByte(EEPROM_CFG_READ_REQ_SA);
-    cached_write_sa = EEPROM_Config_ReadByte(EEPROM_CFG_WRITE_REQ_SA);
-    cached_response_sa = EEPROM_Config_ReadByte(EEPROM_CFG_RESPONSE_SA);
-    
-    cached_fw_major = EEPROM_Config_ReadByte(EEPROM_CFG_FW_MAJOR);
-    cached_fw_minor = EEPROM_Config_ReadByte(EEPROM_CFG_FW_MINOR);
+    J1939_LoadHeartbeatConfig();
 }
 
 /**
@@ -100,8 +87,7 @@ uint32_t CAN_Config_BuildCANID(uint8_t priority, uint16_t pgn, uint8_t source_ad
 uint8_t CAN_Config_IsReadRequest(uint32_t can_id) {
     uint16_t pgn = CAN_Config_ExtractPGN(can_id);
     // Only check PGN, accept from any SA
-    // (cached_read_sa is kept for backwards compatibility but not used for filtering)
-    return (pgn == cached_read_pgn);
+    return (pgn == EEPROM_Config_ReadPGN(EEPROM_CFG_READ_REQ_PGN_A));
 }
 
 /**
@@ -111,8 +97,7 @@ uint8_t CAN_Config_IsReadRequest(uint32_t can_id) {
 uint8_t CAN_Config_IsWriteRequest(uint32_t can_id) {
     uint16_t pgn = CAN_Config_ExtractPGN(can_id);
     // Only check PGN, accept from any SA
-    // (cached_write_sa is kept for backwards compatibility but not used for filtering)
-    return (pgn == cached_write_pgn);
+    return (pgn == EEPROM_Config_ReadPGN(EEPROM_CFG_WRITE_REQ_PGN_A));
 }
 
 /**
@@ -217,6 +202,33 @@ void CAN_Config_HandleWriteRequest(CAN_Message *msg) {
         CAN_Config_Reload();
     }
     
+    // Climate slew/curve bytes and custom curve table take effect immediately
+    if (addr == EEPROM_CFG_CLIMATE_SLEW || addr == EEPROM_CFG_CLIMATE_CURVES ||
+        (addr >= EEPROM_CLIMATE_LUT_START && addr < EEPROM_CLIMATE_LUT_START + EEPROM_CLIMATE_LUT_SIZE)) {
+        Climate_LoadConfig();
+    }
+    
+    // inRESERVE stage 0 bytes and ladder table rebuild the ladder
+    if (addr == EEPROM_CFG_INRESERVE_1 || addr == EEPROM_CFG_INRESERVE_2 ||
+        (addr >= EEPROM_INRESERVE_LADDER_START && addr < EEPROM_INRESERVE_LADDER_START + EEPROM_INRESERVE_LADDER_SIZE)) {
+        InReserve_LoadConfig();
+    }
+    
+    // Debounce table and adaptive switch apply from the next scan
+    if (addr >= EEPROM_DEBOUNCE_START && addr <= EEPROM_DEBOUNCE_MODE) {
+        Inputs_LoadDebounce();
+    }
+    
+    // Gateway route enables and rate codes
+    if (addr >= EEPROM_GATEWAY_ROUTES && addr < EEPROM_GATEWAY_RATES + 4) {
+        Gateway_LoadConfig();
+    }
+    
+    // Case region: patch active copies of the edited case, no input toggle needed
+    if (addr >= EEPROM_CASES_START && addr < EEPROM_CASES_END) {
+        EEPROM_Cases_ApplyWrite(addr);
+    }
+    
     // Send response with success status
     CAN_Config_SendResponse(addr, verify_value, CAN_CONFIG_STATUS_SUCCESS);
 }
@@ -228,8 +240,8 @@ void CAN_Config_SendResponse(uint16_t addr, uint8_t value, uint8_t status) {
     uint8_t response_data[8];
     
     // Build response message
-    response_data[0] = cached_fw_major;         // Firmware major version
-    response_data[1] = cached_fw_minor;         // Firmware minor version
+    response_data[0] = EEPROM_Config_ReadByte(EEPROM_CFG_FW_MAJOR);
+    response_data[1] = EEPROM_Config_ReadByte(EEPROM_CFG_FW_MINOR);
     response_data[2] = value;                   // Value read or written
     response_data[3] = (uint8_t)(addr & 0xFF);  // Address LSB
     response_data[4] = (uint8_t)(addr >> 8);    // Address MSB
@@ -239,49 +251,50 @@ void CAN_Config_SendResponse(uint16_t addr, uint8_t value, uint8_t status) {
     
     // Send via J1939
     // Use priority 3 for response messages
-    J1939_TransmitMessage(3, cached_response_pgn, cached_response_sa, response_data);
+    J1939_TransmitMessage(3, EEPROM_Config_ReadPGN(EEPROM_CFG_RESPONSE_PGN_A),
+                          EEPROM_Config_ReadByte(EEPROM_CFG_RESPONSE_SA), response_data);
 }
 
 /**
- * Get current cached Read Request PGN
+ * Get current Read Request PGN
  */
 uint16_t CAN_Config_GetReadPGN(void) {
-    return cached_read_pgn;
+    return EEPROM_Config_ReadPGN(EEPROM_CFG_READ_REQ_PGN_A);
 }
 
 /**
- * Get current cached Write Request PGN
+ * Get current Write Request PGN
  */
 uint16_t CAN_Config_GetWritePGN(void) {
-    return cached_write_pgn;
+    return EEPROM_Config_ReadPGN(EEPROM_CFG_WRITE_REQ_PGN_A);
 }
 
 /**
- * Get current cached Response PGN
+ * Get current Response PGN
  */
 uint16_t CAN_Config_GetResponsePGN(void) {
-    return cached_response_pgn;
+    return EEPROM_Config_ReadPGN(EEPROM_CFG_RESPONSE_PGN_A);
 }
 
 /**
- * Get current cached Read Request SA
+ * Get current Read Request SA
  */
 uint8_t CAN_Config_GetReadSA(void) {
-    return cached_read_sa;
+    return EEPROM_Config_ReadByte(EEPROM_CFG_READ_REQ_SA);
 }
 
 /**
- * Get current cached Write Request SA
+ * Get current Write Request SA
  */
 uint8_t CAN_Config_GetWriteSA(void) {
-    return cached_write_sa;
+    return EEPROM_Config_ReadByte(EEPROM_CFG_WRITE_REQ_SA);
 }
 
 /**
- * Get current cached Response SA
+ * Get current Response SA
  */
 uint8_t CAN_Config_GetResponseSA(void) {
-    return cached_response_sa;
+    return EEPROM_Config_ReadByte(EEPROM_CFG_RESPONSE_SA);
 }
 
 /**
@@ -305,4 +318,4 @@ uint16_t CAN_Config_GetVerifyFailCount(void) {
 
 uint16_t CAN_Config_GetAddrRangeErrorCount(void) {
     return addr_range_error_count;
-}
\ No newline at end of file
+}
\ No newline at end of file
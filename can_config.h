@@ -61,8 +61,11 @@
 // Memory map:
 //   0x0000-0x0016: Configuration bytes (23 bytes)
 //   0x0017-0x0021: Reserved (11 bytes)
-//   0x0022-0x0FE1: Case data (126 cases  32 bytes = 4032 bytes)
-//   0x0FE2-0x0FFF: Unused (30 bytes)
+//   0x0022-0x0FE1: Case slots (126  32 bytes = 4032 bytes): 106 ON cases,
+//                  19 OFF cases and the spare block at 0x0DE2
+//   0x0FE2-0x0FF8: Per-input debounce table and mode (EEPROM_DEBOUNCE_START)
+//   0x0FF9-0x0FFD: Gateway route enables and rate codes (EEPROM_GATEWAY_ROUTES)
+//   0x0FFE-0x0FFF: Unused (2 bytes)
 #define CAN_CONFIG_MAX_WRITE_ADDR   4095    // Can write entire EEPROM (0x0FFF)
 #define CAN_CONFIG_MAX_READ_ADDR    4095    // Can read entire EEPROM (0x0FFF)
 
@@ -159,42 +162,43 @@ uint8_t CAN_Config_IsWriteRequest(uint32_t can_id);
 /**
  * Reload configuration from EEPROM
  * Called after configuration bytes are modified via CAN
- * Updates cached PGN/SA values for read/write/response messages
+ * Re-encodes the heartbeat identifier (other PGN/SA values are read
+ * from the config header shadow on use)
  */
 void CAN_Config_Reload(void);
 
 /**
- * Get current cached Read Request PGN
+ * Get current Read Request PGN
  * @return 16-bit PGN
  */
 uint16_t CAN_Config_GetReadPGN(void);
 
 /**
- * Get current cached Write Request PGN
+ * Get current Write Request PGN
  * @return 16-bit PGN
  */
 uint16_t CAN_Config_GetWritePGN(void);
 
 /**
- * Get current cached Response PGN
+ * Get current Response PGN
  * @return 16-bit PGN
  */
 uint16_t CAN_Config_GetResponsePGN(void);
 
 /**
- * Get current cached Read Request SA
+ * Get current Read Request SA
  * @return 8-bit source address
  */
 uint8_t CAN_Config_GetReadSA(void);
 
 /**
- * Get current cached Write Request SA
+ * Get current Write Request SA
  * @return 8-bit source address
  */
 uint8_t CAN_Config_GetWriteSA(void);
 
 /**
- * Get current cached Response SA
+ * Get current Response SA
  * @return 8-bit source address
  */
 uint8_t CAN_Config_GetResponseSA(void);
@@ -16,21 +16,70 @@
  *   Wiper 1 → Blend physical pin
  *   Wiper 2 → NOT CONNECTED to external pin
  *   Wiper 3 → Temperature physical pin (middle)
+ * 
+ * SPI Engine:
+ *   inLINK rebroadcasts 0xAF00 continuously, so the setters only record the
+ *   requested value. A wiper is queued for writing when it differs from the
+ *   last value sent to the chip. Queued wipers are sent from the SPI2
+ *   interrupt as one chip-select frame of back-to-back 16-bit write
+ *   commands (MCP4341 continuous command mode). The caller never waits
+ *   on the bus.
+ * 
+ * Ramp Engine:
+ *   CAN values set a per-channel target (through the channel's response
+ *   curve). Climate_Tick() moves each output toward its target by the
+ *   configured slew rate, in 1/16 wiper step units, so the 4-bit CAN
+ *   steps become smooth voltage ramps. At most one SPI frame per tick.
  */
 
 #include "climate.h"
-
-#define FCY 16000000UL
-#include <libpic30.h>
+#include "eeprom_config.h"
+#include "board.h"
 
 // ============================================================================
 // PRIVATE VARIABLES
 // ============================================================================
 
-// Current wiper values (for diagnostic readback)
-static uint8_t current_temp_value = 0;
-static uint8_t current_fan_value = 0;
-static uint8_t current_blend_value = 0;
+// Ramp state per climate channel (positions in Q4: wiper value * 16)
+typedef struct {
+    uint16_t position;      // Current output, Q4
+    uint16_t target;        // Requested output, Q4
+    uint8_t wiper_addr;     // MCP4341 wiper driven by this channel
+    uint8_t curve;          // CLIMATE_CURVE_xxx
+} ClimateRamp;
+
+static ClimateRamp ramps[CLIMATE_CHANNEL_COUNT] = {
+    { 0, 0, CLIMATE_TEMP_WIPER,  CLIMATE_CURVE_LINEAR },
+    { 0, 0, CLIMATE_FAN_WIPER,   CLIMATE_CURVE_LINEAR },
+    { 0, 0, CLIMATE_BLEND_WIPER, CLIMATE_CURVE_LINEAR }
+};
+
+// Q4 wiper steps per tick (0 = jump straight to target)
+static uint8_t slew_rate = DEFAULT_CLIMATE_SLEW;
+
+// Fan-law curve: wiper = v^2 * 128 / 225 (gentle low end, full top end)
+static const uint8_t fan_law_curve[16] = {
+    0, 1, 2, 5, 9, 14, 20, 28, 36, 46, 57, 69, 82, 96, 112, 128
+};
+
+// Custom curve loaded from EEPROM_CLIMATE_LUT_START (0xFF = not programmed)
+static uint8_t custom_curve[16];
+
+// Wiper shadow, indexed by slot (see WiperSlot)
+static volatile uint8_t wiper_requested[MCP4341_WIPER_COUNT];
+static volatile uint8_t wiper_sent[MCP4341_WIPER_COUNT];
+static volatile uint8_t wiper_dirty_mask = 0;
+
+// Frame currently being clocked out by the SPI2 interrupt
+static volatile uint8_t spi_frame[MCP4341_WIPER_COUNT * 2];
+static volatile uint8_t spi_frame_len = 0;
+static volatile uint8_t spi_frame_pos = 0;
+static volatile uint8_t spi_busy = 0;
+
+// Slot → MCP4341 wiper address
+static const uint8_t wiper_slot_addr[MCP4341_WIPER_COUNT] = {
+    MCP4341_WIPER0, MCP4341_WIPER1, MCP4341_WIPER2, MCP4341_WIPER3
+};
 
 // ============================================================================
 // PRIVATE FUNCTIONS - SPI2 LOW-LEVEL
@@ -38,11 +87,12 @@ static uint8_t current_blend_value = 0;
 
 /**
  * Initialize SPI2 peripheral for MCP4341 communication
- * Mode 0,0 (CPOL=0, CPHA=0), 8-bit, Master mode
+ * Mode 0,0 (CPOL=0, CPHA=0), 8-bit, Master mode, interrupt per byte
  */
 static void SPI2_Init(void) {
     // Disable SPI2 during configuration
     SPI2STATbits.SPIEN = 0;
+    IEC1bits.SPI2IE = 0;
     
     // Configure SPI2 pins
     DIGIPOT_SCK_TRIS = 0;   // SCK2 as output
@@ -54,40 +104,26 @@ static void SPI2_Init(void) {
     // - 8-bit mode
     // - Clock idle low (CKP = 0)
     // - Data sampled at middle of data output time (CKE = 1)
-    // - Primary prescaler 64:1, secondary 1:1 → ~250kHz @ 16MHz FCY
+    // - SCK from the board's SPI2 prescalers (MCP4341 SPI write limit is 10MHz)
     SPI2CONbits.MSTEN = 1;      // Master mode
     SPI2CONbits.CKP = 0;        // Clock idle state is LOW
     SPI2CONbits.CKE = 1;        // Data changes on idle→active clock edge
     SPI2CONbits.SMP = 0;        // Sample at middle of data output time
     SPI2CONbits.MODE16 = 0;     // 8-bit mode
-    SPI2CONbits.PPRE = 0b00;    // Primary prescaler 64:1
-    SPI2CONbits.SPRE = 0b111;   // Secondary prescaler 1:1
+    SPI2CONbits.PPRE = BOARD_SPI2_PPRE;
+    SPI2CONbits.SPRE = BOARD_SPI2_SPRE;
     
     // Clear any pending data
     uint16_t dummy = SPI2BUF;
     (void)dummy;
     
+    // SPI2IF fires once per completed byte
+    IFS1bits.SPI2IF = 0;
+    IPC6bits.SPI2IP = 3;        // Below CAN/Timer1 (default 4)
+    
     // Enable SPI2
     SPI2STATbits.SPIEN = 1;
-}
-
-/**
- * Send a byte via SPI2 and receive response
- * @param data Byte to send
- * @return Received byte
- */
-static uint8_t SPI2_Transfer(uint8_t data) {
-    // Wait until TX buffer is empty
-    while (SPI2STATbits.SPITBF);
-    
-    // Send data
-    SPI2BUF = data;
-    
-    // Wait until RX buffer has data
-    while (!SPI2STATbits.SPIRBF);
-    
-    // Return received data
-    return (uint8_t)SPI2BUF;
+    IEC1bits.SPI2IE = 1;
 }
 
 // ============================================================================
@@ -95,42 +131,124 @@ static uint8_t SPI2_Transfer(uint8_t data) {
 // ============================================================================
 
 /**
- * Write a value to a MCP4341 wiper
+ * Map a MCP4341 wiper address to its shadow slot
+ * @param wiper_addr Wiper address (0x00, 0x01, 0x06, 0x07)
+ * @return Slot 0-3, or 0xFF if not a wiper address
+ */
+static uint8_t WiperSlot(uint8_t wiper_addr) {
+    switch (wiper_addr) {
+        case MCP4341_WIPER0: return 0;
+        case MCP4341_WIPER1: return 1;
+        case MCP4341_WIPER2: return 2;
+        case MCP4341_WIPER3: return 3;
+        default:             return 0xFF;
+    }
+}
+
+/**
+ * Build a frame from every dirty wiper and start clocking it out
  * 
- * Command format (16 bits total):
+ * Command format (16 bits per wiper, repeated while CS stays low):
  *   Byte 0: [AD3:AD0][C1:C0][D9:D8] = [Address][00][Data MSB]
  *   Byte 1: [D7:D0] = Data LSB
  * 
- * @param wiper_addr Wiper address (0x00, 0x01, 0x06, 0x07)
+ * Must be called with SPI2IE disabled or from the SPI2 interrupt.
+ */
+static void MCP4341_StartFrame(void) {
+    uint8_t len = 0;
+    
+    for (uint8_t slot = 0; slot < MCP4341_WIPER_COUNT; slot++) {
+        if (!(wiper_dirty_mask & (1 << slot))) {
+            continue;
+        }
+        
+        uint8_t value = wiper_requested[slot];
+        
+        // Address in bits 7:4, write command (00) in bits 3:2,
+        // D9:D8 in bits 1:0 (always 0 for 7-bit values)
+        spi_frame[len++] = (wiper_slot_addr[slot] << 4) | (MCP4341_CMD_WRITE << 2);
+        spi_frame[len++] = value;
+        wiper_sent[slot] = value;
+    }
+    wiper_dirty_mask = 0;
+    
+    if (len == 0) {
+        spi_busy = 0;
+        return;
+    }
+    
+    spi_frame_len = len;
+    spi_frame_pos = 1;
+    spi_busy = 1;
+    
+    // Assert chip select (active LOW); tCSSR is a few ns, one cycle is enough
+    DIGIPOT_CS = 0;
+    SPI2BUF = spi_frame[0];
+}
+
+/**
+ * Record a new value for a wiper and mark it dirty if it changed
+ * Must be called with SPI2IE disabled.
+ * @param slot Wiper slot (0-3)
  * @param value Wiper value (0-128)
  */
-static void MCP4341_WriteWiper(uint8_t wiper_addr, uint8_t value) {
+static void MCP4341_RecordWiper(uint8_t slot, uint8_t value) {
     // Clamp value to valid range
     if (value > MCP4341_WIPER_MAX) {
         value = MCP4341_WIPER_MAX;
     }
     
-    // Build command byte: [AD3:AD0][C1:C0][D9:D8]
-    // Address is in bits 7:4
-    // Command (write) is 00 in bits 3:2
-    // D9:D8 are in bits 1:0 (for 10-bit data, but we only use 7-bit so these are 0)
-    uint8_t cmd_byte = (wiper_addr << 4) | (MCP4341_CMD_WRITE << 2) | 0x00;
+    wiper_requested[slot] = value;
+    if (value != wiper_sent[slot]) {
+        wiper_dirty_mask |= (1 << slot);
+    } else {
+        wiper_dirty_mask &= ~(1 << slot);
+    }
+}
+
+/**
+ * Record a new value for a wiper and queue it if it changed
+ * @param slot Wiper slot (0-3)
+ * @param value Wiper value (0-128)
+ */
+static void MCP4341_QueueWiper(uint8_t slot, uint8_t value) {
+    IEC1bits.SPI2IE = 0;
     
-    // Data byte is just the value (D7:D0)
-    uint8_t data_byte = value;
+    MCP4341_RecordWiper(slot, value);
     
-    // Assert chip select (active LOW)
-    DIGIPOT_CS = 0;
-    __delay_us(1);
+    // Idle bus: kick the first byte here, the ISR sends the rest
+    if (!spi_busy) {
+        MCP4341_StartFrame();
+    }
+    
+    IEC1bits.SPI2IE = 1;
+}
+
+/**
+ * SPI2 interrupt - one byte finished shifting
+ * Sends the next byte of the frame, or closes the frame and
+ * starts another if wipers changed while it was in flight.
+ */
+void __attribute__((interrupt, no_auto_psv)) _SPI2Interrupt(void) {
+    IFS1bits.SPI2IF = 0;
+    
+    // Discard received byte (MCP4341 SDO is not used for writes)
+    uint16_t dummy = SPI2BUF;
+    (void)dummy;
     
-    // Send command and data
-    SPI2_Transfer(cmd_byte);
-    SPI2_Transfer(data_byte);
+    if (spi_frame_pos < spi_frame_len) {
+        SPI2BUF = spi_frame[spi_frame_pos++];
+        return;
+    }
     
-    // Deassert chip select
-    __delay_us(1);
+    // Frame complete - deassert chip select
     DIGIPOT_CS = 1;
-    __delay_us(1);
+    spi_busy = 0;
+    
+    if (wiper_dirty_mask) {
+        Nop();      // tCSHS: CS high for at least one cycle between frames
+        MCP4341_StartFrame();
+    }
 }
 
 // ============================================================================
@@ -162,9 +280,20 @@ void Climate_Init(void) {
     DIGIPOT_RESET = 1;
     __delay_ms(5);  // Wait for chip to stabilize after reset
     
+    // Shadow starts unknown so the first write of every wiper goes out
+    for (uint8_t slot = 0; slot < MCP4341_WIPER_COUNT; slot++) {
+        wiper_requested[slot] = 0;
+        wiper_sent[slot] = 0xFF;
+    }
+    wiper_dirty_mask = 0;
+    spi_busy = 0;
+    
     // Initialize SPI2 peripheral
     SPI2_Init();
     
+    // Slew rate and response curves
+    Climate_LoadConfig();
+    
     // TCON registers default to 0xFF (all terminals enabled)
     // No need to write to them - just set the wiper values
     
@@ -195,7 +324,7 @@ uint8_t Climate_ProcessMessage(uint32_t can_id, uint8_t *data) {
     uint8_t fan_value = data[1] & 0x0F;
     uint8_t blend_value = data[2] & 0x0F;
     
-    // Set the outputs
+    // Set the ramp targets (Climate_Tick moves the outputs)
     Climate_SetTemperature(temp_value);
     Climate_SetFanSpeed(fan_value);
     Climate_SetBlend(blend_value);
@@ -208,7 +337,11 @@ uint8_t Climate_ProcessMessage(uint32_t can_id, uint8_t *data) {
 // ============================================================================
 
 void Climate_SetWiper(uint8_t wiper_addr, uint8_t value) {
-    MCP4341_WriteWiper(wiper_addr, value);
+    uint8_t slot = WiperSlot(wiper_addr);
+    
+    if (slot != 0xFF) {
+        MCP4341_QueueWiper(slot, value);
+    }
 }
 
 /**
@@ -233,32 +366,122 @@ static uint8_t ScaleToWiper(uint8_t can_value) {
     return (uint8_t)scaled;
 }
 
+/**
+ * Map a CAN value (0-15) through a channel's response curve
+ * @param curve CLIMATE_CURVE_xxx
+ * @param can_value CAN value (0-15)
+ * @return Wiper value (0-128)
+ */
+static uint8_t ApplyCurve(uint8_t curve, uint8_t can_value) {
+    if (can_value > 15) {
+        can_value = 15;
+    }
+    
+    switch (curve) {
+        case CLIMATE_CURVE_FAN_LAW:
+            return fan_law_curve[can_value];
+            
+        case CLIMATE_CURVE_CUSTOM:
+            // Unprogrammed or out-of-range entries fall back to linear
+            if (custom_curve[can_value] <= MCP4341_WIPER_MAX) {
+                return custom_curve[can_value];
+            }
+            return ScaleToWiper(can_value);
+            
+        default:
+            return ScaleToWiper(can_value);
+    }
+}
+
+/**
+ * Set a channel's ramp target from a CAN value
+ * With slew disabled the output is written immediately.
+ */
+static void SetChannelTarget(uint8_t channel, uint8_t can_value) {
+    ClimateRamp *r = &ramps[channel];
+    
+    r->target = (uint16_t)ApplyCurve(r->curve, can_value) << 4;
+    
+    if (slew_rate == 0 && r->position != r->target) {
+        r->position = r->target;
+        Climate_SetWiper(r->wiper_addr, (uint8_t)(r->position >> 4));
+    }
+}
+
 void Climate_SetTemperature(uint8_t value) {
-    uint8_t wiper_value = ScaleToWiper(value);
-    current_temp_value = wiper_value;
-    MCP4341_WriteWiper(CLIMATE_TEMP_WIPER, wiper_value);
+    SetChannelTarget(CLIMATE_CHANNEL_TEMP, value);
 }
 
 void Climate_SetFanSpeed(uint8_t value) {
-    uint8_t wiper_value = ScaleToWiper(value);
-    current_fan_value = wiper_value;
-    MCP4341_WriteWiper(CLIMATE_FAN_WIPER, wiper_value);
+    SetChannelTarget(CLIMATE_CHANNEL_FAN, value);
 }
 
 void Climate_SetBlend(uint8_t value) {
-    uint8_t wiper_value = ScaleToWiper(value);
-    current_blend_value = wiper_value;
-    MCP4341_WriteWiper(CLIMATE_BLEND_WIPER, wiper_value);
+    SetChannelTarget(CLIMATE_CHANNEL_BLEND, value);
 }
 
 void Climate_SetAllOff(void) {
-    current_temp_value = 0;
-    current_fan_value = 0;
-    current_blend_value = 0;
+    // Off is immediate - no ramp down
+    for (uint8_t ch = 0; ch < CLIMATE_CHANNEL_COUNT; ch++) {
+        ramps[ch].position = 0;
+        ramps[ch].target = 0;
+        Climate_SetWiper(ramps[ch].wiper_addr, 0);
+    }
+}
+
+// ============================================================================
+// PUBLIC FUNCTIONS - RAMP ENGINE
+// ============================================================================
+
+void Climate_Tick(void) {
+    // Record every channel first and start one frame at the end, so the
+    // wipers that moved this tick go out under a single chip select
+    IEC1bits.SPI2IE = 0;
     
-    MCP4341_WriteWiper(CLIMATE_TEMP_WIPER, 0);
-    MCP4341_WriteWiper(CLIMATE_FAN_WIPER, 0);
-    MCP4341_WriteWiper(CLIMATE_BLEND_WIPER, 0);
+    for (uint8_t ch = 0; ch < CLIMATE_CHANNEL_COUNT; ch++) {
+        ClimateRamp *r = &ramps[ch];
+        
+        if (r->position == r->target) {
+            continue;
+        }
+        
+        if (r->position < r->target) {
+            uint16_t gap = r->target - r->position;
+            r->position += (gap > slew_rate) ? slew_rate : gap;
+        } else {
+            uint16_t gap = r->position - r->target;
+            r->position -= (gap > slew_rate) ? slew_rate : gap;
+        }
+        
+        // Change-only queue: sub-step moves cost no SPI traffic
+        uint8_t slot = WiperSlot(r->wiper_addr);
+        if (slot != 0xFF) {
+            MCP4341_RecordWiper(slot, (uint8_t)(r->position >> 4));
+        }
+    }
+    
+    // A frame still in flight picks the new values up when it closes
+    if (!spi_busy) {
+        MCP4341_StartFrame();
+    }
+    
+    IEC1bits.SPI2IE = 1;
+}
+
+void Climate_LoadConfig(void) {
+    uint8_t slew = EEPROM_Config_ReadByte(EEPROM_CFG_CLIMATE_SLEW);
+    uint8_t curves = EEPROM_Config_ReadByte(EEPROM_CFG_CLIMATE_CURVES);
+    
+    slew_rate = (slew == 0xFF) ? DEFAULT_CLIMATE_SLEW : slew;
+    
+    // Curve select 3 (erased) is linear
+    for (uint8_t ch = 0; ch < CLIMATE_CHANNEL_COUNT; ch++) {
+        ramps[ch].curve = (curves >> (ch * 2)) & 0x03;
+    }
+    
+    for (uint8_t i = 0; i < EEPROM_CLIMATE_LUT_SIZE; i++) {
+        custom_curve[i] = EEPROM_Config_ReadByte(EEPROM_CLIMATE_LUT_START + i);
+    }
 }
 
 // ============================================================================
@@ -266,14 +489,17 @@ void Climate_SetAllOff(void) {
 // ============================================================================
 
 uint8_t Climate_GetTemperature(void) {
-    return current_temp_value;
+    return (uint8_t)(ramps[CLIMATE_CHANNEL_TEMP].position >> 4);
 }
 
 uint8_t Climate_GetFanSpeed(void) {
-    return current_fan_value;
+    return (uint8_t)(ramps[CLIMATE_CHANNEL_FAN].position >> 4);
 }
 
 uint8_t Climate_GetBlend(void) {
-    return current_blend_value;
+    return (uint8_t)(ramps[CLIMATE_CHANNEL_BLEND].position >> 4);
 }
 
+uint8_t Climate_IsBusy(void) {
+    return (spi_busy || wiper_dirty_mask) ? 1 : 0;
+}
@@ -40,6 +40,7 @@
 #define MCP4341_WIPER1          0x01    // Volatile Wiper 1
 #define MCP4341_WIPER2          0x06    // Volatile Wiper 2
 #define MCP4341_WIPER3          0x07    // Volatile Wiper 3
+#define MCP4341_WIPER_COUNT     4
 
 // Command codes (bits 3:2 of command byte)
 #define MCP4341_CMD_WRITE       0x00    // Write data
@@ -66,6 +67,17 @@
 #define CLIMATE_BLEND_WIPER     MCP4341_WIPER1  // Blend Position → Wiper 1
 // Wiper 2 is not connected to external pin
 
+// Ramp channel indices
+#define CLIMATE_CHANNEL_TEMP    0
+#define CLIMATE_CHANNEL_FAN     1
+#define CLIMATE_CHANNEL_BLEND   2
+#define CLIMATE_CHANNEL_COUNT   3
+
+// Response curves (EEPROM_CFG_CLIMATE_CURVES, 2 bits per channel)
+#define CLIMATE_CURVE_LINEAR    0       // Straight 0-15 → 0-128 (3 = erased, also linear)
+#define CLIMATE_CURVE_FAN_LAW   1       // Square law, finer control at low speed
+#define CLIMATE_CURVE_CUSTOM    2       // 16-entry table at EEPROM_CLIMATE_LUT_START
+
 // ============================================================================
 // PIN DEFINITIONS
 // ============================================================================
@@ -108,7 +120,9 @@ void Climate_Init(void);
 uint8_t Climate_ProcessMessage(uint32_t can_id, uint8_t *data);
 
 /**
- * Set a specific wiper to a value
+ * Set a specific wiper to a value (raw, bypasses the ramp)
+ * Non-blocking: the write is queued to the SPI2 interrupt engine and
+ * skipped entirely if the wiper already holds this value.
  * 
  * @param wiper_addr Wiper address (MCP4341_WIPER0, WIPER1, WIPER2, WIPER3)
  * @param value Wiper value (0-128, where 0=0V, 128=5V)
@@ -117,48 +131,69 @@ void Climate_SetWiper(uint8_t wiper_addr, uint8_t value);
 
 /**
  * Set temperature output (convenience function)
- * @param value CAN value (0-15), automatically scaled to 0-128
+ * The output ramps toward the new value on Climate_Tick().
+ * @param value CAN value (0-15), mapped through the channel curve to 0-128
  */
 void Climate_SetTemperature(uint8_t value);
 
 /**
  * Set fan speed output (convenience function)
- * @param value CAN value (0-15), automatically scaled to 0-128
+ * The output ramps toward the new value on Climate_Tick().
+ * @param value CAN value (0-15), mapped through the channel curve to 0-128
  */
 void Climate_SetFanSpeed(uint8_t value);
 
 /**
  * Set blend position output (convenience function)
- * @param value CAN value (0-15), automatically scaled to 0-128
+ * The output ramps toward the new value on Climate_Tick().
+ * @param value CAN value (0-15), mapped through the channel curve to 0-128
  */
 void Climate_SetBlend(uint8_t value);
 
 /**
  * Set all climate outputs to 0V (default/off state)
+ * Takes effect immediately, bypassing the ramp.
  */
 void Climate_SetAllOff(void);
 
+/**
+ * Advance the output ramps by one step
+ * Call from the 10ms scan. Queues at most one SPI frame.
+ */
+void Climate_Tick(void);
+
+/**
+ * Reload slew rate and response curves from EEPROM
+ */
+void Climate_LoadConfig(void);
+
 // ============================================================================
 // DIAGNOSTIC FUNCTIONS
 // ============================================================================
 
 /**
- * Get current temperature wiper value
+ * Get current temperature wiper value (ramp position)
  * @return Current wiper value (0-128)
  */
 uint8_t Climate_GetTemperature(void);
 
 /**
- * Get current fan speed wiper value
+ * Get current fan speed wiper value (ramp position)
  * @return Current wiper value (0-128)
  */
 uint8_t Climate_GetFanSpeed(void);
 
 /**
- * Get current blend position wiper value
+ * Get current blend position wiper value (ramp position)
  * @return Current wiper value (0-128)
  */
 uint8_t Climate_GetBlend(void);
 
+/**
+ * Check whether wiper writes are still queued or in flight on SPI2
+ * @return 1 if busy, 0 if all wipers match the requested values
+ */
+uint8_t Climate_IsBusy(void);
+
 #endif // CLIMATE_H
 
@@ -18,9 +18,14 @@
  #include "eeprom_cases.h"
  #include "inputs.h"
  #include "inlink.h"
+ #include "inreserve.h"
+ #include "board.h"
+ #include "supervisor.h"
+ #include "j1939.h"
  #include <string.h>
+ #include <stddef.h>
  
- // Case count lookup tables - RESTRUCTURED LAYOUT (106 ON + 20 OFF)
+ // Case count lookup tables - RESTRUCTURED LAYOUT (106 ON + 19 OFF)
  const uint8_t input_on_case_count[TOTAL_INPUTS] = {
      4, 2, 4, 4, 2, 6, 1, 6,      // IN01-IN08: Ignition, Starter, Turns, Headlights, Parking, High, 4-Ways
      1, 2, 2, 2, 2, 2, 6, 2,      // IN09-IN16: Horn, Fan, Brakes, Fuel, Open, OneButton, Neutral
@@ -34,7 +39,7 @@
      2, 2, 0, 0, 0, 0, 0, 0,      // IN01-IN08: Ignition & Starter have OFF cases
      0, 0, 0, 0, 0, 0, 0, 0,      // IN09-IN16: No OFF cases
      0, 0, 0, 0, 0, 0, 0, 0,      // IN17-IN24: No OFF cases
-     2, 2, 2, 2, 2, 2, 2, 2,      // IN25-IN32: All window controls have OFF cases
+     2, 2, 2, 2, 2, 2, 2, 1,      // IN25-IN32: Window controls (IN32: 1, see off_case_offsets)
      0, 0, 0, 0, 0, 0,            // IN33-IN38: No OFF cases
      0, 0, 0, 0, 0, 0             // HSIN01-HSIN06: No OFF cases
  };
@@ -50,7 +55,10 @@
      3264, 3296, 3328, 3360
  };
  
- // OFF cases start at 0x0D62, total 20 cases (640 bytes)
+ // OFF cases start at 0x0D62, 20 slots (640 bytes) to 0x0FE1: 19 cases and the
+ // spare block at 0x0DE2 (EEPROM_SPARE_BLOCK_START). IN32 has one OFF case - a
+ // second would start at 0x0FE2, where the debounce and gateway tables are,
+ // and run past the end of EEPROM.
  // Note: There's a 32-byte offset in EEPROM - IN25-32 start 32 bytes later than originally calculated
  static const uint16_t off_case_offsets[TOTAL_INPUTS] = {
      0, 64, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF,
@@ -68,14 +76,89 @@
  // Pattern timers for each input (0-43)
  static PatternTimer pattern_timers[TOTAL_INPUTS];
  
+ // Warm restart copy of the pattern phases (EEPROM_Pattern_SaveWarm)
+ typedef struct {
+     uint16_t signature;
+     PatternTimer timers[TOTAL_INPUTS];
+     uint16_t checksum;
+ } PatternWarmState;
+ 
+ static PatternWarmState pattern_warm BOARD_PERSISTENT;
+ 
  // Diagnostic counters
  static uint16_t eeprom_read_count = 0;
  static uint16_t bounds_errors = 0;
  
+ // Set when a case write patched an active case (EEPROM_ActiveCasesEdited)
+ static uint8_t active_cases_edited = 0;
+ 
+// Case whose header (bytes 0-23) is being rewritten, applied once its
+// last byte is written (EEPROM_Cases_ApplyWrite); 0xFFFF = none
+static uint16_t pending_case_address = 0xFFFF;
+static uint8_t pending_writes = 0;      // Bumped on every write held back
+static uint8_t pending_writes_seen = 0; // As of the last service pass
+static uint32_t pending_quiet_ms = 0;   // When the writes were last seen to move
+ 
+ // One-button start inputs: case 1 with B0-B7 cleared and the B0 masks
+ // for the ignition and starter bits, read once by EEPROM_LoadManualCases
+ // so a latch change never touches EEPROM
+ typedef struct {
+     uint8_t input_num;
+     uint8_t ignition_mask;      // 0 = B0 of case 1 does not name exactly one bit
+     uint8_t starter_mask;
+     CaseData base;
+ } ManualCase;
+ 
+ static ManualCase manual_cases[MAX_MANUAL_CASES];
+ static uint8_t manual_case_count = 0;
+ 
+ // Fast path: bits the plain ON / OFF cases of an input set in one PGN/SA
+ // (EEPROM_LoadFastPath)
+ typedef struct {
+     uint8_t input_num;
+     uint16_t pgn;
+     uint8_t source_addr;
+     uint8_t on_mask[CASE_DATA_SIZE];
+     uint8_t off_mask[CASE_DATA_SIZE];
+ } FastPathFrame;
+ 
+ static FastPathFrame fast_frames[MAX_FAST_PATH_FRAMES];
+ static uint8_t fast_frame_count = 0;
+ 
+ // Timed cases (EEPROM_LoadTimedCases) and the wheel of their deadlines:
+ // each slot heads a list linked through next, rounds counts the extra
+ // turns of the wheel before the deadline is due
+ #define TIMED_NONE  0xFF
+ 
+ typedef struct {
+     uint8_t input_num;
+     uint8_t case_num;
+     uint8_t mode;               // TIMED_MODE_xxx
+     uint16_t duration;          // 250ms ticks
+     uint8_t active;             // 1 = ORed into the aggregated frames
+     uint8_t in_wheel;           // 1 = deadline pending
+     uint8_t slot;
+     uint8_t rounds;
+     uint8_t next;
+     CaseData case_data;
+ } TimedCase;
+ 
+ static TimedCase timed_cases[MAX_TIMED_CASES];
+ static uint8_t timed_case_count = 0;
+ static uint8_t timed_wheel[TIMED_WHEEL_SLOTS];
+ static uint8_t timed_wheel_pos = 0;
+ static uint8_t timed_pending = 0;
+ static uint8_t timed_cases_changed = 0;
+ 
+ static TimedCase* FindTimedCase(uint8_t input_num, uint8_t case_num);
+ static void TimedInputEdge(uint8_t input_num, uint8_t new_state);
+static void ReloadTimedCase(uint16_t address, uint8_t input_num, uint8_t case_num);
+ 
  void EEPROM_Cases_Init(void) {
      EEPROM_ClearActiveCases();
      eeprom_read_count = 0;
      bounds_errors = 0;
+    pending_case_address = 0xFFFF;
      
      // Initialize all pattern timers to inactive
      for(uint8_t i = 0; i < TOTAL_INPUTS; i++) {
@@ -133,6 +216,12 @@
  // COMMENTED OUT:             }
  // COMMENTED OUT:         }
  // COMMENTED OUT:     }
+     
+     EEPROM_LoadManualCases();
+     EEPROM_LoadFastPath();
+     
+     timed_case_count = 0;
+     EEPROM_LoadTimedCases();
  }
  
  uint16_t EEPROM_GetCaseAddress(uint8_t input_num, uint8_t case_num, uint8_t is_on_case) {
@@ -189,45 +278,20 @@
  }
  
  /*
-  * CRITICAL FIX: Corrected EEPROM read function
-  * 
-  * dsPIC30F EEPROM memory map:
-  * - EEPROM is at 0x7FF000 to 0x7FFFFE
-  * - TBLPAG must be 0x7F
-  * - Offset within page is 0xF000 to 0xFFFF
+  * Read the EEPROM word containing a byte address
   */
  static uint16_t ReadEEPROMWord(uint16_t byte_address) {
      // CRITICAL: Bounds check FIRST
-     if(byte_address >= 0x1000) {
+     if(byte_address >= BOARD_NVM_SIZE) {
          bounds_errors++;
          return 0xFFFF;
      }
      
-     // Round down to even address (word boundary)
-     uint16_t word_address = byte_address & 0xFFFE;
-     
      // Increment read counter
      eeprom_read_count++;
      
-     // Set up EEPROM access
-     uint16_t old_tblpag = TBLPAG;
-     TBLPAG = 0x7F;
-     
-     // Calculate offset within page
-     uint16_t offset = 0xF000 + word_address;
-     
-     // Read word using table read
-     uint16_t result;
-     __asm__ volatile (
-         "tblrdl [%1], %0"
-         : "=r" (result)
-         : "r" (offset)
-     );
-     
-     // Restore TBLPAG
-     TBLPAG = old_tblpag;
-     
-     return result;
+     // Round down to even address (word boundary)
+     return Board_NVMReadWord(byte_address & 0xFFFE);
  }
  
  uint8_t ReadEEPROMByte(uint16_t byte_address) {
@@ -302,6 +366,13 @@
          return 0;  // Invalid case, not an error
      }
      
+     // PGN 0xFFFF is the "all outputs" request - a case cannot use it,
+     // or a request for its PGN would stream every slot instead
+     if(pgn_high == (J1939_PGN_ALL_OUTPUTS >> 8) && pgn_low == (J1939_PGN_ALL_OUTPUTS & 0xFF)) {
+         bounds_errors++;
+         return 0;
+     }
+     
     // Read configuration byte (byte 4)
     uint8_t config_byte = ReadEEPROMByte(address + CASE_OFFSET_CONFIG);
     
@@ -457,6 +528,11 @@
                  break;  // Can't add more cases
              }
              
+             // Timed cases follow their own timer (TimedInputEdge below)
+             if(FindTimedCase(input_num, i) != NULL) {
+                 continue;
+             }
+             
              // Get ON case address
              uint16_t addr = EEPROM_GetCaseAddress(input_num, i, 1);
              
@@ -659,6 +735,10 @@
              }
          }
      }
+     
+     // After the input's cases were replaced, so a clearing case from a
+     // timed case going inactive on this edge survives
+     TimedInputEdge(input_num, new_state);
  }
 
 // ============================================================================
@@ -918,6 +998,39 @@ uint8_t EEPROM_GetAggregatedMessages(AggregatedMessage *messages, uint8_t max_me
         }
     }
     
+    // PASS 3: Active timed cases - conditions apply, no pattern or override
+    for(uint8_t i = 0; i < timed_case_count; i++) {
+        TimedCase *tc = &timed_cases[i];
+        
+        if(!tc->active ||
+           !CheckInputConditions(tc->case_data.must_be_on, tc->case_data.must_be_off)) {
+            continue;
+        }
+        
+        uint8_t found = 0;
+        for(uint8_t j = 0; j < msg_count; j++) {
+            if(messages[j].pgn == tc->case_data.pgn &&
+               messages[j].source_addr == tc->case_data.source_addr) {
+                for(uint8_t k = 0; k < 8; k++) {
+                    messages[j].data[k] |= tc->case_data.data[k];
+                }
+                found = 1;
+                break;
+            }
+        }
+        
+        if(!found && msg_count < max_messages) {
+            messages[msg_count].priority = tc->case_data.priority;
+            messages[msg_count].pgn = tc->case_data.pgn;
+            messages[msg_count].source_addr = tc->case_data.source_addr;
+            for(uint8_t k = 0; k < 8; k++) {
+                messages[msg_count].data[k] = tc->case_data.data[k];
+            }
+            messages[msg_count].valid = 1;
+            msg_count++;
+        }
+    }
+    
    // STEP 2: Aggregate inLINK messages
     // FIX: Iterate over all possible indices, not just count
     // InLink_GetMessageCount returns the number of valid messages, but they
@@ -956,6 +1069,42 @@ uint8_t EEPROM_GetAggregatedMessages(AggregatedMessage *messages, uint8_t max_me
          }
      }
      
+     // STEP 3: Apply inRESERVE load shedding to PowerCell command frames
+     // Cut stages clear output bits, assert stages set them (after all ORing)
+     for(uint8_t i = 0; i < INRESERVE_MAX_CELLS; i++) {
+         InReserveShed* shed = InReserve_GetShed(i);
+         
+         if(shed == NULL) {
+             continue;
+         }
+         
+         uint8_t found = 0;
+         for(uint8_t j = 0; j < msg_count; j++) {
+             if(messages[j].pgn == shed->pgn &&
+                messages[j].source_addr == shed->source_addr) {
+                 for(uint8_t k = 0; k < 2; k++) {
+                     messages[j].data[k] = (messages[j].data[k] & ~shed->clear_mask[k]) | shed->set_mask[k];
+                 }
+                 found = 1;
+                 break;
+             }
+         }
+         
+         // No case drives this PowerCell - send the assert bits on their own
+         if(!found && shed->announce && msg_count < max_messages) {
+             messages[msg_count].priority = 6;
+             messages[msg_count].pgn = shed->pgn;
+             messages[msg_count].source_addr = shed->source_addr;
+             for(uint8_t k = 0; k < 8; k++) {
+                 messages[msg_count].data[k] = 0;
+             }
+             messages[msg_count].data[0] = shed->set_mask[0];
+             messages[msg_count].data[1] = shed->set_mask[1];
+             messages[msg_count].valid = 1;
+             msg_count++;
+         }
+     }
+     
      return msg_count;
  }
  
@@ -980,6 +1129,735 @@ uint8_t EEPROM_GetAggregatedMessages(AggregatedMessage *messages, uint8_t max_me
      active_case_count = write_idx;
  }
  
+// ============================================================================
+// HOT-APPLY OF CASE WRITES
+// ============================================================================
+
+/*
+ * Map an EEPROM byte address to the case that contains it
+ * Returns the case start address, 0xFFFF if the byte is not in a case
+ */
+static uint16_t FindCaseAtAddress(uint16_t byte_addr, uint8_t *input_num,
+                                  uint8_t *case_num, uint8_t *is_on_case) {
+    for(uint8_t on = 0; on < 2; on++) {
+        for(uint8_t input = 0; input < TOTAL_INPUTS; input++) {
+            uint8_t count = on ? input_on_case_count[input] : input_off_case_count[input];
+            if(count == 0) {
+                continue;
+            }
+            
+            uint16_t first = EEPROM_GetCaseAddress(input, 0, on);
+            if(first == 0xFFFF || byte_addr < first ||
+               byte_addr >= first + (uint16_t)count * CASE_SIZE) {
+                continue;
+            }
+            
+            *input_num = input;
+            *case_num = (byte_addr - first) / CASE_SIZE;
+            *is_on_case = on;
+            return first + (uint16_t)*case_num * CASE_SIZE;
+        }
+    }
+    return 0xFFFF;
+}
+
+static uint8_t FindFastPathInput(uint8_t input_num);
+
+/*
+ * Data byte (24-31) of a case: PGN/SA and conditions are unchanged, so
+ * the byte goes straight into every copy of the case
+ */
+static uint8_t PatchCaseData(uint16_t byte_addr, uint16_t address, uint8_t input_num,
+                             uint8_t case_num, uint8_t is_on_case) {
+    uint8_t index = byte_addr - address - CASE_OFFSET_DATA_START;
+    uint8_t value = ReadEEPROMByte(byte_addr);
+    uint8_t patched = 0;
+    
+    // Tables built from the data bytes
+    if(is_on_case && case_num == 0) {
+        EEPROM_LoadManualCases();
+    }
+    if(FindFastPathInput(input_num)) {
+        EEPROM_LoadFastPath();
+    }
+    if(EEPROM_IsOneButtonStartInput(input_num)) {
+        return 0;
+    }
+    
+    TimedCase *tc = is_on_case ? FindTimedCase(input_num, case_num) : NULL;
+    if(tc != NULL) {
+        tc->case_data.data[index] = value;
+        if(tc->active) {
+            timed_cases_changed = 1;
+            patched++;
+        }
+    }
+    
+    for(uint8_t i = 0; i < active_case_count; i++) {
+        ActiveCase *ac = &active_cases[i];
+        if(ac->input_num == input_num && ac->case_num == case_num &&
+           ac->is_on_case == is_on_case && !ac->needs_removal_after_send) {
+            ac->case_data.data[index] = value;
+            patched++;
+        }
+    }
+    
+    if(patched != 0) {
+        active_cases_edited = 1;
+    }
+    return patched;
+}
+
+/*
+ * Whole case re-read: header, conditions and data
+ */
+static uint8_t ApplyCase(uint16_t address, uint8_t input_num, uint8_t case_num,
+                         uint8_t is_on_case) {
+    // Case 1 carries the one-button flag and template - refresh them; a
+    // one-button input builds its own B0, picked up on its next latch change
+    if(is_on_case && case_num == 0) {
+        EEPROM_LoadManualCases();
+    }
+    if((is_on_case && case_num == 0) || FindFastPathInput(input_num)) {
+        EEPROM_LoadFastPath();
+    }
+    if(is_on_case) {
+        ReloadTimedCase(address, input_num, case_num);
+    }
+    if(EEPROM_IsOneButtonStartInput(input_num)) {
+        return 0;
+    }
+    
+    CaseData case_data;
+    EEPROM_ReadCase(address, &case_data);
+    
+    uint8_t patched = 0;
+    uint8_t count = active_case_count;
+    for(uint8_t i = 0; i < count; i++) {
+        ActiveCase *ac = &active_cases[i];
+        
+        // Clearing cases only carry a PGN/SA and go away after one frame
+        if(ac->input_num != input_num || ac->case_num != case_num ||
+           ac->is_on_case != is_on_case || ac->needs_removal_after_send) {
+            continue;
+        }
+        
+        if(!case_data.valid || case_data.pgn != ac->case_data.pgn ||
+           case_data.source_addr != ac->case_data.source_addr) {
+            // Moved or erased - send a clearing frame on the old PGN/SA
+            if(active_case_count < MAX_ACTIVE_CASES) {
+                ActiveCase *clearing = &active_cases[active_case_count++];
+                *clearing = *ac;
+                clearing->needs_removal_after_send = 1;
+                memset(clearing->case_data.data, 0, CASE_DATA_SIZE);
+                memset(clearing->case_data.must_be_on, 0, sizeof(clearing->case_data.must_be_on));
+                memset(clearing->case_data.must_be_off, 0, sizeof(clearing->case_data.must_be_off));
+            }
+            if(!case_data.valid) {
+                ac->needs_removal_after_send = 1;
+                ac->case_data.valid = 0;
+            }
+        }
+        
+        if(case_data.valid) {
+            ac->case_data = case_data;
+        }
+        patched++;
+    }
+    
+    if(patched == 0) {
+        return 0;
+    }
+    
+    // Case 1 of an ON input sets the pattern for the whole input
+    if(is_on_case && case_num == 0) {
+        uint8_t has_pattern = case_data.valid &&
+                              (case_data.pattern_on_time != 0 || case_data.pattern_off_time != 0);
+        
+        IEC0bits.T1IE = 0;
+        PatternTimer *pt = &pattern_timers[input_num];
+        if(has_pattern) {
+            if(!pt->has_pattern) {
+                pt->state = PATTERN_STATE_ON_PHASE;
+                pt->timer = case_data.pattern_on_time;
+            }
+            pt->has_pattern = 1;
+            pt->on_time = case_data.pattern_on_time;
+            pt->off_time = case_data.pattern_off_time;
+        } else if(pt->has_pattern) {
+            pt->has_pattern = 0;
+            pt->state = PATTERN_STATE_INACTIVE;
+            pt->timer = 0;
+        }
+        IEC0bits.T1IE = 1;
+    }
+    
+    active_cases_edited = 1;
+    return patched;
+}
+
+/*
+ * Apply the held-back case as it stands
+ */
+static uint8_t FlushPendingCase(void) {
+    uint8_t input_num, case_num, is_on_case;
+    uint16_t address = pending_case_address;
+    
+    pending_case_address = 0xFFFF;
+    if(FindCaseAtAddress(address, &input_num, &case_num, &is_on_case) != address) {
+        return 0;
+    }
+    return ApplyCase(address, input_num, case_num, is_on_case);
+}
+
+uint8_t EEPROM_Cases_ApplyWrite(uint16_t byte_addr) {
+    uint8_t input_num, case_num, is_on_case;
+    uint8_t patched = 0;
+    uint16_t address;
+    
+    // A tool that moved on from a half-written header: apply it as it stands
+    if(pending_case_address != 0xFFFF &&
+       (byte_addr < pending_case_address || byte_addr >= pending_case_address + CASE_SIZE)) {
+        patched = FlushPendingCase();
+    }
+    
+    address = FindCaseAtAddress(byte_addr, &input_num, &case_num, &is_on_case);
+    if(address == 0xFFFF) {
+        return patched;
+    }
+    
+    // Header bytes wait for the rest of the case, so a case being rewritten
+    // never goes out with a new PGN/SA and the old data (or the reverse)
+    uint8_t offset = byte_addr - address;
+    if(offset < CASE_OFFSET_DATA_START || pending_case_address == address) {
+        if(offset < CASE_SIZE - 1) {
+            pending_case_address = address;
+            pending_writes++;
+            return patched;
+        }
+        pending_case_address = 0xFFFF;
+        return patched + ApplyCase(address, input_num, case_num, is_on_case);
+    }
+    
+    return patched + PatchCaseData(byte_addr, address, input_num, case_num, is_on_case);
+}
+
+void EEPROM_Cases_ServicePending(uint32_t now_ms) {
+    if(pending_case_address == 0xFFFF) {
+        return;
+    }
+    
+    // A tool that stopped short of byte 31 (only byte 4 or the SA changed):
+    // apply the case once its writes have been quiet for a while
+    if(pending_writes != pending_writes_seen) {
+        pending_writes_seen = pending_writes;
+        pending_quiet_ms = now_ms;
+    } else if(now_ms - pending_quiet_ms >= CASE_PENDING_QUIET_MS) {
+        FlushPendingCase();
+    }
+}
+
+uint8_t EEPROM_ActiveCasesEdited(void) {
+    uint8_t edited = active_cases_edited;
+    active_cases_edited = 0;
+    return edited;
+}
+
+// ============================================================================
+// FAST PATH
+// ============================================================================
+
+static uint8_t FindFastPathInput(uint8_t input_num) {
+    for(uint8_t i = 0; i < fast_frame_count; i++) {
+        if(fast_frames[i].input_num == input_num) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * OR a plain case into the input's fast path frame for its PGN/SA
+ * Returns 0 if the table is full
+ */
+static uint8_t AddFastPathCase(uint8_t input_num, uint16_t address, uint8_t is_on_case) {
+    CaseData case_data;
+    uint8_t config_byte = ReadEEPROMByte(address + CASE_OFFSET_CONFIG);
+    
+    if(!EEPROM_ReadCase(address, &case_data) || case_data.can_be_overridden ||
+       (config_byte & CONFIG_IGNITION_MODE_MASK) != 0 ||
+       (is_on_case && (config_byte & CONFIG_FAST_PATH_MASK) == CONFIG_TIMED_VALUE)) {
+        return 1;
+    }
+    for(uint8_t k = 0; k < 8; k++) {
+        if(case_data.must_be_on[k] || case_data.must_be_off[k]) {
+            return 1;  // Conditional - aggregation only
+        }
+    }
+    
+    FastPathFrame *frame = NULL;
+    for(uint8_t i = 0; i < fast_frame_count; i++) {
+        if(fast_frames[i].input_num == input_num && fast_frames[i].pgn == case_data.pgn &&
+           fast_frames[i].source_addr == case_data.source_addr) {
+            frame = &fast_frames[i];
+            break;
+        }
+    }
+    if(frame == NULL) {
+        if(fast_frame_count >= MAX_FAST_PATH_FRAMES) {
+            return 0;
+        }
+        frame = &fast_frames[fast_frame_count++];
+        frame->input_num = input_num;
+        frame->pgn = case_data.pgn;
+        frame->source_addr = case_data.source_addr;
+        memset(frame->on_mask, 0, CASE_DATA_SIZE);
+        memset(frame->off_mask, 0, CASE_DATA_SIZE);
+    }
+    
+    uint8_t *mask = is_on_case ? frame->on_mask : frame->off_mask;
+    for(uint8_t k = 0; k < CASE_DATA_SIZE; k++) {
+        mask[k] |= case_data.data[k];
+    }
+    return 1;
+}
+
+void EEPROM_LoadFastPath(void) {
+    fast_frame_count = 0;
+    
+    for(uint8_t input_num = 0; input_num < TOTAL_INPUTS; input_num++) {
+        uint16_t base_address = EEPROM_GetCaseAddress(input_num, 0, 1);
+        if(base_address == 0xFFFF) {
+            continue;
+        }
+        
+        // Flag in case 1; a pattern in case 1 makes every case of the input flash
+        uint8_t config_byte = ReadEEPROMByte(base_address + CASE_OFFSET_CONFIG);
+        if((config_byte & CONFIG_FAST_PATH_MASK) != CONFIG_FAST_PATH_VALUE ||
+           (config_byte & CONFIG_ONE_BUTTON_MASK) == CONFIG_ONE_BUTTON_VALUE ||
+           ReadEEPROMByte(base_address + CASE_OFFSET_PATTERN_TIMING) != 0x00) {
+            continue;
+        }
+        
+        for(uint8_t on = 0; on < 2; on++) {
+            uint8_t count = on ? input_on_case_count[input_num] : input_off_case_count[input_num];
+            for(uint8_t i = 0; i < count; i++) {
+                uint16_t address = EEPROM_GetCaseAddress(input_num, i, on);
+                if(address != 0xFFFF && !AddFastPathCase(input_num, address, on)) {
+                    return;  // Table full - later inputs use aggregation only
+                }
+            }
+        }
+    }
+}
+
+uint8_t EEPROM_GetFastPathFrame(uint8_t entry, uint8_t *input_num,
+                                uint16_t *pgn, uint8_t *source_addr) {
+    if(entry >= fast_frame_count) {
+        return 0;
+    }
+    
+    *input_num = fast_frames[entry].input_num;
+    *pgn = fast_frames[entry].pgn;
+    *source_addr = fast_frames[entry].source_addr;
+    return 1;
+}
+
+void EEPROM_FastPathUpdate(uint8_t entry, uint8_t new_state, uint8_t *data) {
+    if(entry >= fast_frame_count) {
+        return;
+    }
+    
+    FastPathFrame *frame = &fast_frames[entry];
+    const uint8_t *set = new_state ? frame->on_mask : frame->off_mask;
+    const uint8_t *clear = new_state ? frame->off_mask : frame->on_mask;
+    
+    // Bits other inputs, timed cases or inLINK drive stay on - the aggregated pass
+    // decides about them (pattern phase, conditions). Only an edge that
+    // clears bits needs them; a press with no OFF case bits skips the scan.
+    uint8_t held[CASE_DATA_SIZE] = {0, 0, 0, 0, 0, 0, 0, 0};
+    uint8_t clearing = 0;
+    for(uint8_t k = 0; k < CASE_DATA_SIZE; k++) {
+        clearing |= clear[k];
+    }
+    for(uint8_t i = 0; clearing && i < active_case_count; i++) {
+        ActiveCase *ac = &active_cases[i];
+        if(ac->input_num != frame->input_num && ac->case_data.valid &&
+           ac->case_data.pgn == frame->pgn && ac->case_data.source_addr == frame->source_addr) {
+            for(uint8_t k = 0; k < CASE_DATA_SIZE; k++) {
+                held[k] |= ac->case_data.data[k];
+            }
+        }
+    }
+    for(uint8_t i = 0; clearing && i < timed_case_count; i++) {
+        TimedCase *tc = &timed_cases[i];
+        if(tc->active && tc->case_data.pgn == frame->pgn &&
+           tc->case_data.source_addr == frame->source_addr) {
+            for(uint8_t k = 0; k < CASE_DATA_SIZE; k++) {
+                held[k] |= tc->case_data.data[k];
+            }
+        }
+    }
+    for(uint8_t i = 0; clearing && i < MAX_INLINK_MESSAGES; i++) {
+        InLinkMessage* inlink_msg = InLink_GetMessage(i);
+        if(inlink_msg != NULL && inlink_msg->valid && inlink_msg->pgn == frame->pgn &&
+           inlink_msg->source_addr == frame->source_addr) {
+            for(uint8_t k = 0; k < CASE_DATA_SIZE; k++) {
+                held[k] |= inlink_msg->data[k];
+            }
+        }
+    }
+    
+    for(uint8_t k = 0; k < CASE_DATA_SIZE; k++) {
+        data[k] = (data[k] & ~(clear[k] & ~held[k])) | set[k];
+    }
+    
+    // inRESERVE shedding, as in EEPROM_GetAggregatedMessages()
+    for(uint8_t i = 0; i < INRESERVE_MAX_CELLS; i++) {
+        InReserveShed* shed = InReserve_GetShed(i);
+        if(shed != NULL && shed->pgn == frame->pgn && shed->source_addr == frame->source_addr) {
+            for(uint8_t k = 0; k < 2; k++) {
+                data[k] = (data[k] & ~shed->clear_mask[k]) | shed->set_mask[k];
+            }
+            break;
+        }
+    }
+}
+
+// ============================================================================
+// TIMED CASES
+// ============================================================================
+
+static TimedCase* FindTimedCase(uint8_t input_num, uint8_t case_num) {
+    for(uint8_t i = 0; i < timed_case_count; i++) {
+        if(timed_cases[i].input_num == input_num && timed_cases[i].case_num == case_num) {
+            return &timed_cases[i];
+        }
+    }
+    return NULL;
+}
+
+static void TimedActivate(TimedCase *tc) {
+    if(!tc->active) {
+        tc->active = 1;
+        timed_cases_changed = 1;
+    }
+}
+
+/*
+ * Stop ORing the case in and send one all-zero frame on its PGN/SA
+ */
+static void TimedDeactivate(TimedCase *tc) {
+    if(!tc->active) {
+        return;
+    }
+    tc->active = 0;
+    timed_cases_changed = 1;
+    
+    if(active_case_count < MAX_ACTIVE_CASES) {
+        ActiveCase *clearing = &active_cases[active_case_count++];
+        clearing->input_num = tc->input_num;
+        clearing->case_num = tc->case_num;
+        clearing->is_on_case = 0;
+        clearing->needs_removal_after_send = 1;
+        clearing->case_data = tc->case_data;
+        memset(clearing->case_data.data, 0, CASE_DATA_SIZE);
+        memset(clearing->case_data.must_be_on, 0, sizeof(clearing->case_data.must_be_on));
+        memset(clearing->case_data.must_be_off, 0, sizeof(clearing->case_data.must_be_off));
+        clearing->case_data.pattern_on_time = 0;
+        clearing->case_data.pattern_off_time = 0;
+        clearing->case_data.can_be_overridden = 0;
+    }
+}
+
+static void TimedCancel(TimedCase *tc) {
+    if(!tc->in_wheel) {
+        return;
+    }
+    
+    uint8_t index = tc - timed_cases;
+    uint8_t *link = &timed_wheel[tc->slot];
+    while(*link != TIMED_NONE) {
+        if(*link == index) {
+            *link = tc->next;
+            break;
+        }
+        link = &timed_cases[*link].next;
+    }
+    tc->in_wheel = 0;
+    timed_pending--;
+}
+
+/*
+ * Due after duration ticks (at least one): the slot that many positions
+ * ahead, after (duration - 1) / TIMED_WHEEL_SLOTS further turns
+ */
+static void TimedSchedule(TimedCase *tc) {
+    uint16_t ticks = (tc->duration == 0) ? 1 : tc->duration;
+    
+    TimedCancel(tc);
+    tc->slot = (timed_wheel_pos + ticks) & (TIMED_WHEEL_SLOTS - 1);
+    tc->rounds = (ticks - 1) / TIMED_WHEEL_SLOTS;
+    tc->next = timed_wheel[tc->slot];
+    timed_wheel[tc->slot] = tc - timed_cases;
+    tc->in_wheel = 1;
+    timed_pending++;
+}
+
+static void TimedExpire(TimedCase *tc) {
+    if(tc->mode == TIMED_MODE_DELAY_ON) {
+        TimedActivate(tc);
+    } else {
+        TimedDeactivate(tc);
+    }
+}
+
+static void TimedInputEdge(uint8_t input_num, uint8_t new_state) {
+    for(uint8_t i = 0; i < timed_case_count; i++) {
+        TimedCase *tc = &timed_cases[i];
+        if(tc->input_num != input_num) {
+            continue;
+        }
+        
+        switch(tc->mode) {
+            case TIMED_MODE_DELAY_ON:
+                if(new_state) {
+                    TimedSchedule(tc);
+                } else {
+                    TimedCancel(tc);
+                    TimedDeactivate(tc);
+                }
+                break;
+            
+            case TIMED_MODE_DELAY_OFF:
+                if(new_state) {
+                    TimedCancel(tc);
+                    TimedActivate(tc);
+                } else if(tc->active) {
+                    TimedSchedule(tc);
+                }
+                break;
+            
+            case TIMED_MODE_TOGGLE:
+                if(new_state) {
+                    if(tc->active) {
+                        TimedDeactivate(tc);
+                    } else {
+                        TimedActivate(tc);
+                    }
+                }
+                break;
+            
+            case TIMED_MODE_ONE_SHOT:
+                // Not retriggered while the pulse runs
+                if(new_state && !tc->active) {
+                    TimedActivate(tc);
+                    TimedSchedule(tc);
+                }
+                break;
+            
+            default:
+                break;
+        }
+    }
+}
+
+/*
+ * Read an ON case as a timed case, idle
+ * Returns 0 if it is not one (or cannot be read)
+ */
+static uint8_t ReadTimedCase(uint16_t address, uint8_t input_num, uint8_t case_num,
+                             TimedCase *tc) {
+    if(EEPROM_IsOneButtonStartInput(input_num)) {
+        return 0;
+    }
+    
+    uint8_t config_byte = ReadEEPROMByte(address + CASE_OFFSET_CONFIG);
+    if((config_byte & CONFIG_FAST_PATH_MASK) != CONFIG_TIMED_VALUE ||
+       (config_byte & CONFIG_IGNITION_MODE_MASK) != 0) {
+        return 0;
+    }
+    
+    uint8_t mode_byte = ReadEEPROMByte(address + CASE_OFFSET_TIMED_MODE);
+    uint8_t mode = mode_byte & TIMED_MODE_MASK;
+    if(mode < TIMED_MODE_DELAY_ON || mode > TIMED_MODE_ONE_SHOT) {
+        return 0;
+    }
+    if(!EEPROM_ReadCase(address, &tc->case_data)) {
+        return 0;
+    }
+    
+    tc->input_num = input_num;
+    tc->case_num = case_num;
+    tc->mode = mode;
+    tc->duration = ReadEEPROMByte(address + CASE_OFFSET_TIMED_DURATION);
+    if(mode_byte & TIMED_SCALE_SECONDS) {
+        tc->duration *= 4;
+    }
+    tc->active = 0;
+    tc->in_wheel = 0;
+    tc->next = TIMED_NONE;
+    return 1;
+}
+
+/*
+ * Drop a case (not in the wheel) from the table; the last entry takes
+ * its place and the wheel link to it follows
+ */
+static void TimedRemove(TimedCase *tc) {
+    uint8_t index = tc - timed_cases;
+    uint8_t last = --timed_case_count;
+    
+    if(index == last) {
+        return;
+    }
+    
+    TimedCase *moved = &timed_cases[last];
+    if(moved->in_wheel) {
+        uint8_t *link = &timed_wheel[moved->slot];
+        while(*link != last) {
+            link = &timed_cases[*link].next;
+        }
+        *link = index;
+    }
+    *tc = *moved;
+}
+
+/*
+ * One ON case was rewritten: reload just that timed case, the others
+ * keep running. The case is then settled against the input as it is
+ * now, so a delay held ON restarts instead of waiting for the next edge.
+ */
+static void ReloadTimedCase(uint16_t address, uint8_t input_num, uint8_t case_num) {
+    TimedCase *tc = FindTimedCase(input_num, case_num);
+    TimedCase loaded;
+    uint8_t is_timed = ReadTimedCase(address, input_num, case_num, &loaded);
+    
+    if(tc != NULL) {
+        TimedCancel(tc);
+        
+        // Moved, erased or no longer timed: clear the old PGN/SA
+        if(!is_timed || loaded.case_data.pgn != tc->case_data.pgn ||
+           loaded.case_data.source_addr != tc->case_data.source_addr) {
+            TimedDeactivate(tc);
+        }
+        if(!is_timed) {
+            TimedRemove(tc);
+            return;
+        }
+        loaded.active = tc->active;
+        *tc = loaded;
+    } else {
+        if(!is_timed || timed_case_count >= MAX_TIMED_CASES) {
+            return;
+        }
+        tc = &timed_cases[timed_case_count++];
+        *tc = loaded;
+    }
+    
+    uint8_t input_on = Inputs_GetState(input_num);
+    switch(tc->mode) {
+        case TIMED_MODE_DELAY_ON:
+            if(!input_on) {
+                TimedDeactivate(tc);
+            } else if(!tc->active) {
+                TimedSchedule(tc);
+            }
+            break;
+        
+        case TIMED_MODE_DELAY_OFF:
+            if(input_on) {
+                TimedActivate(tc);
+            } else if(tc->active) {
+                TimedSchedule(tc);
+            }
+            break;
+        
+        case TIMED_MODE_ONE_SHOT:
+            // The pulse that was running ends with the edit
+            TimedDeactivate(tc);
+            break;
+        
+        default:
+            break;  // Toggle keeps its state
+    }
+    
+    // New data on the bus
+    if(tc->active) {
+        timed_cases_changed = 1;
+    }
+}
+
+void EEPROM_LoadTimedCases(void) {
+    // Whatever was on goes out as a clearing frame
+    for(uint8_t i = 0; i < timed_case_count; i++) {
+        TimedDeactivate(&timed_cases[i]);
+    }
+    
+    timed_case_count = 0;
+    timed_pending = 0;
+    timed_wheel_pos = 0;
+    memset(timed_wheel, TIMED_NONE, sizeof(timed_wheel));
+    
+    for(uint8_t input_num = 0; input_num < TOTAL_INPUTS; input_num++) {
+        uint8_t count = input_on_case_count[input_num];
+        if(count > MAX_ON_CASES_PER_INPUT) {
+            count = MAX_ON_CASES_PER_INPUT;
+        }
+        
+        for(uint8_t i = 0; i < count; i++) {
+            uint16_t address = EEPROM_GetCaseAddress(input_num, i, 1);
+            if(address == 0xFFFF) {
+                continue;
+            }
+            if(timed_case_count >= MAX_TIMED_CASES) {
+                return;  // Table full - later timed cases stay off
+            }
+            if(ReadTimedCase(address, input_num, i, &timed_cases[timed_case_count])) {
+                timed_case_count++;
+            }
+        }
+    }
+}
+
+void EEPROM_Timed_Tick(void) {
+    // Nothing due - the wheel position only matters relative to pending entries
+    if(timed_pending == 0) {
+        return;
+    }
+    
+    timed_wheel_pos = (timed_wheel_pos + 1) & (TIMED_WHEEL_SLOTS - 1);
+    
+    // Take the slot's list; entries with turns left go back on it
+    uint8_t index = timed_wheel[timed_wheel_pos];
+    timed_wheel[timed_wheel_pos] = TIMED_NONE;
+    
+    while(index != TIMED_NONE) {
+        TimedCase *tc = &timed_cases[index];
+        index = tc->next;
+        
+        if(tc->rounds > 0) {
+            tc->rounds--;
+            tc->next = timed_wheel[timed_wheel_pos];
+            timed_wheel[timed_wheel_pos] = tc - timed_cases;
+        } else {
+            tc->in_wheel = 0;
+            timed_pending--;
+            TimedExpire(tc);
+        }
+    }
+}
+
+uint8_t EEPROM_TimedCasesChanged(void) {
+    uint8_t changed = timed_cases_changed;
+    timed_cases_changed = 0;
+    return changed;
+}
+
+uint8_t EEPROM_TimedCasesPending(void) {
+    return timed_pending;
+}
+
  // Diagnostic functions
  uint16_t EEPROM_GetReadCount(void) {
      return eeprom_read_count;
@@ -1029,6 +1907,33 @@ void EEPROM_Pattern_UpdateTimers(void) {
     }
 }
  
+void EEPROM_Pattern_SaveWarm(void) {
+    memcpy(pattern_warm.timers, pattern_timers, sizeof(pattern_timers));
+    pattern_warm.signature = SUPERVISOR_SIGNATURE;
+    pattern_warm.checksum = Supervisor_Checksum(&pattern_warm, offsetof(PatternWarmState, checksum));
+}
+
+uint8_t EEPROM_Pattern_RestoreWarm(void) {
+    if(pattern_warm.signature != SUPERVISOR_SIGNATURE ||
+       pattern_warm.checksum != Supervisor_Checksum(&pattern_warm, offsetof(PatternWarmState, checksum))) {
+        return 0;
+    }
+    
+    // Only resume a phase where the rebuilt cases run the same pattern
+    for(uint8_t i = 0; i < TOTAL_INPUTS; i++) {
+        PatternTimer *saved = &pattern_warm.timers[i];
+        PatternTimer *live = &pattern_timers[i];
+        
+        if(live->has_pattern && saved->has_pattern &&
+           saved->state != PATTERN_STATE_INACTIVE &&
+           saved->on_time == live->on_time && saved->off_time == live->off_time) {
+            live->state = saved->state;
+            live->timer = saved->timer;
+        }
+    }
+    return 1;
+}
+ 
  uint8_t EEPROM_Pattern_IsInOnPhase(uint8_t input_num) {
      // Validate input number
      if(input_num >= TOTAL_INPUTS) {
@@ -1077,91 +1982,114 @@ void EEPROM_Pattern_UpdateTimers(void) {
      return 0xFF;  // Invalid - no bit or multiple bits set
  }
  
- uint8_t EEPROM_IsOneButtonStartInput(uint8_t input_num) {
-     // Validate input number
-     if(input_num >= TOTAL_INPUTS) {
-         return 0;
+ static ManualCase* FindManualCase(uint8_t input_num) {
+     for(uint8_t i = 0; i < manual_case_count; i++) {
+         if(manual_cases[i].input_num == input_num) {
+             return &manual_cases[i];
+         }
      }
+     return NULL;
+ }
+ 
+ void EEPROM_LoadManualCases(void) {
+     manual_case_count = 0;
      
-     // Get the address of the first ON case for this input
-     uint16_t base_address = EEPROM_GetCaseAddress(input_num, 0, 1);
-     if(base_address == 0xFFFF) {
-         return 0;  // Invalid address
+     for(uint8_t input_num = 0; input_num < TOTAL_INPUTS; input_num++) {
+         uint16_t base_address = EEPROM_GetCaseAddress(input_num, 0, 1);
+         if(base_address == 0xFFFF) {
+             continue;
+         }
+         
+         // Byte 4 bits 4-5 = 0x01 (0x10 in place): one-button start
+         if((ReadEEPROMByte(base_address + 4) & 0x30) != 0x10) {
+             continue;
+         }
+         if(manual_case_count >= MAX_MANUAL_CASES) {
+             break;
+         }
+         
+         ManualCase *manual = &manual_cases[manual_case_count++];
+         manual->input_num = input_num;
+         manual->ignition_mask = 0;
+         manual->starter_mask = 0;
+         
+         if(!EEPROM_ReadCase(base_address, &manual->base)) {
+             continue;  // Still one-button, but nothing to send
+         }
+         
+         // Starter is always one bit position higher (wraps from 0 to 7)
+         uint8_t ignition_bit = GetIgnitionBitPosition(&manual->base);
+         if(ignition_bit != 0xFF) {
+             manual->ignition_mask = 1 << ignition_bit;
+             manual->starter_mask = 1 << ((ignition_bit == 0) ? 7 : ignition_bit - 1);
+         }
+         memset(manual->base.data, 0, CASE_DATA_SIZE);
      }
-     
-     // Read byte 4 (configuration byte)
-     uint8_t config_byte = ReadEEPROMByte(base_address + 4);
-     
-     // Check if bits 4-5 equal 0x01 (which is 0x10 when shifted to bits 4-5)
-     // Bits 4-5 mask: 0x30
-     // One-button start value: 0x10 (binary: 0001 0000)
-     uint8_t one_button_bits = config_byte & 0x30;
-     
-     return (one_button_bits == 0x10) ? 1 : 0;
  }
  
- uint8_t EEPROM_SetManualCase(uint8_t input_num, uint8_t ignition_on, uint8_t starter_on) {
-     // Validate input number
-     if(input_num >= TOTAL_INPUTS) {
-         bounds_errors++;
+ uint8_t EEPROM_IsOneButtonStartInput(uint8_t input_num) {
+     return FindManualCase(input_num) != NULL;
+ }
+ 
+ uint8_t EEPROM_GetManualFrame(uint8_t input_num, uint16_t *pgn, uint8_t *source_addr,
+                               uint8_t *ignition_mask, uint8_t *starter_mask) {
+     ManualCase *manual = FindManualCase(input_num);
+     if(manual == NULL || manual->ignition_mask == 0) {
          return 0;
      }
      
-     // STEP 1: Remove any existing active cases for this input
-     EEPROM_ClearManualCase(input_num);
-     
-     // STEP 2: Read the case configuration from EEPROM
-     uint16_t base_address = EEPROM_GetCaseAddress(input_num, 0, 1);
-     if(base_address == 0xFFFF) {
-         return 0;  // Invalid address
-     }
-     
-     CaseData case_data;
-     if(!EEPROM_ReadCase(base_address, &case_data)) {
-         return 0;  // Failed to read case
-     }
-     
-     // STEP 3: Determine the ignition and starter bit positions
-     uint8_t ignition_bit = GetIgnitionBitPosition(&case_data);
-     if(ignition_bit == 0xFF) {
-         return 0;  // Error: can't determine ignition bit
-     }
-     
-     // Starter is always one bit position higher (wraps from 0 to 7)
-     uint8_t starter_bit;
-     if(ignition_bit == 0) {
-         starter_bit = 7;  // Wrap around
-     } else {
-         starter_bit = ignition_bit - 1;
+     *pgn = manual->base.pgn;
+     *source_addr = manual->base.source_addr;
+     *ignition_mask = manual->ignition_mask;
+     *starter_mask = manual->starter_mask;
+     return 1;
+ }
+ 
+ uint8_t EEPROM_SetManualCase(uint8_t input_num, uint8_t ignition_on, uint8_t starter_on) {
+     ManualCase *manual = FindManualCase(input_num);
+     if(manual == NULL || manual->ignition_mask == 0) {
+         return 0;  // Not one-button, or can't determine ignition bit
      }
      
-     // STEP 4: Build the desired data byte B0
-     case_data.data[0] = 0x00;  // Clear all bits first
+     uint8_t data_b0 = (ignition_on ? manual->ignition_mask : 0) |
+                       (starter_on ? manual->starter_mask : 0);
      
-     if(ignition_on) {
-         case_data.data[0] |= (1 << ignition_bit);
+     // Latch already set: just change B0 (ignition -> starter and back)
+     for(uint8_t i = 0; i < active_case_count; i++) {
+         ActiveCase *ac = &active_cases[i];
+         if(ac->input_num == input_num && ac->is_on_case && !ac->needs_removal_after_send) {
+             ac->case_data.data[0] = data_b0;
+             return 1;
+         }
      }
      
-     if(starter_on) {
-         case_data.data[0] |= (1 << starter_bit);
+     // Remove whatever is left for this input (clearing case from the last release)
+     uint8_t write_idx = 0;
+     for(uint8_t read_idx = 0; read_idx < active_case_count; read_idx++) {
+         if(active_cases[read_idx].input_num != input_num) {
+             if(write_idx != read_idx) {
+                 active_cases[write_idx] = active_cases[read_idx];
+             }
+             write_idx++;
+         }
      }
+     active_case_count = write_idx;
      
-     // Clear all other data bytes (B1-B7)
-     for(uint8_t i = 1; i < 8; i++) {
-         case_data.data[i] = 0x00;
-     }
+     pattern_timers[input_num].state = PATTERN_STATE_INACTIVE;
+     pattern_timers[input_num].has_pattern = 0;
+     pattern_timers[input_num].timer = 0;
      
-     // STEP 5: Add the modified case to active cases list
      if(active_case_count >= MAX_ACTIVE_CASES) {
          return 0;  // No room for more cases
      }
      
-     active_cases[active_case_count].input_num = input_num;
-     active_cases[active_case_count].case_num = 0;
-     active_cases[active_case_count].is_on_case = 1;
-     active_cases[active_case_count].needs_removal_after_send = 0;  // Keep until manually cleared
-     active_cases[active_case_count].case_data = case_data;
-     active_case_count++;
+     ActiveCase *ac = &active_cases[active_case_count++];
+     ac->input_num = input_num;
+     ac->case_num = 0;
+     ac->is_on_case = 1;
+     ac->needs_removal_after_send = 0;  // Keep until manually cleared
+     ac->case_data = manual->base;
+     ac->case_data.data[0] = data_b0;
      
      return 1;  // Success
  }
@@ -1188,34 +2116,21 @@ void EEPROM_Pattern_UpdateTimers(void) {
      
      // STEP 2: Add a CLEARING case with all zeros
      // This ensures the CAN bus gets an explicit "turn off" message
-     // Read the case configuration to get PGN, SA, priority
-     uint16_t base_address = EEPROM_GetCaseAddress(input_num, 0, 1);
-     if(base_address != 0xFFFF) {
-         CaseData clearing_case;
-         if(EEPROM_ReadCase(base_address, &clearing_case)) {
-             // Keep the PGN, SA, and priority, but clear all data bytes
-             for(uint8_t i = 0; i < 8; i++) {
-                 clearing_case.data[i] = 0x00;
-             }
-             
-             // Add the clearing case to active list if we have room
-             if(active_case_count < MAX_ACTIVE_CASES) {
-                 active_cases[active_case_count].input_num = input_num;
-                 active_cases[active_case_count].case_num = 0;
-                 active_cases[active_case_count].is_on_case = 0;  // Mark as OFF case
-                 active_cases[active_case_count].needs_removal_after_send = 1;  // Remove after transmission
-                 active_cases[active_case_count].case_data = clearing_case;
-                 active_case_count++;
-             }
-         }
+     // (PGN, SA and priority from the template, data bytes already clear)
+     ManualCase *manual = FindManualCase(input_num);
+     if(manual != NULL && manual->base.valid && active_case_count < MAX_ACTIVE_CASES) {
+         active_cases[active_case_count].input_num = input_num;
+         active_cases[active_case_count].case_num = 0;
+         active_cases[active_case_count].is_on_case = 0;  // Mark as OFF case
+         active_cases[active_case_count].needs_removal_after_send = 1;  // Remove after transmission
+         active_cases[active_case_count].case_data = manual->base;
+         active_case_count++;
      }
      
      // STEP 3: Clear pattern timer for this input
-     if(input_num < TOTAL_INPUTS) {
-         pattern_timers[input_num].state = PATTERN_STATE_INACTIVE;
-         pattern_timers[input_num].has_pattern = 0;
-         pattern_timers[input_num].timer = 0;
-     }
+     pattern_timers[input_num].state = PATTERN_STATE_INACTIVE;
+     pattern_timers[input_num].has_pattern = 0;
+     pattern_timers[input_num].timer = 0;
  }
  
  // ============================================================================
@@ -17,6 +17,7 @@
 #define EEPROM_RESERVED_START       0x0017
 #define EEPROM_RESERVED_SIZE        10
 #define EEPROM_CASES_START          0x0022  // Must be word-aligned (even address)
+#define EEPROM_CASES_END            0x0FE2  // First byte after the last OFF case slot
 
 // Case structure size
 #define CASE_SIZE                   32
@@ -27,6 +28,8 @@
 #define CASE_OFFSET_PGN_LOW         2
 #define CASE_OFFSET_SOURCE_ADDR     3
 #define CASE_OFFSET_CONFIG          4   // Byte 4: Configuration byte
+#define CASE_OFFSET_TIMED_MODE      5   // Byte 5: Timed mode (bits 6-7 of byte 4 = 10)
+#define CASE_OFFSET_TIMED_DURATION  6   // Byte 6: Timed duration
 #define CASE_OFFSET_PATTERN_TIMING  7   // Byte 7: Upper nibble = ON time, Lower nibble = OFF time
 #define CASE_OFFSET_DATA_START      24  // CAN data is in bytes 24-31
 #define CASE_DATA_SIZE              8
@@ -40,7 +43,10 @@
 #define CONFIG_CAN_BE_OVERRIDDEN_VALUE  0x04  // Bits 2-3 = 01 for can be overridden
 #define CONFIG_ONE_BUTTON_MASK          0x30  // Bits 4-5: One-button start mode
 #define CONFIG_ONE_BUTTON_VALUE         0x10  // Bits 4-5 = 01 for one-button start
-// Bits 6-7: Reserved for future use (e.g., Toggle mode)
+#define CONFIG_FAST_PATH_MASK           0xC0  // Bits 6-7: Fast path (case 1 of the input)
+#define CONFIG_FAST_PATH_VALUE          0x40  // Bits 6-7 = 01: frames sent straight from the edge
+#define CONFIG_TIMED_VALUE              0x80  // Bits 6-7 = 10: timed case (bytes 5-6)
+// Bits 6-7 = 11: Reserved for future use
 
 // Pattern states for inputs
 #define PATTERN_STATE_INACTIVE      0   // Input is off, no pattern running
@@ -130,7 +136,8 @@ uint16_t EEPROM_GetCaseAddress(uint8_t input_num, uint8_t case_num, uint8_t is_o
  * Read a case from EEPROM with comprehensive bounds checking
  * @param address EEPROM address of the case
  * @param case_data Pointer to CaseData structure to fill
- * @return 1 if valid case, 0 if invalid (all 0xFF)
+ * @return 1 if valid case, 0 if invalid (all 0xFF, or the reserved
+ *         PGN J1939_PGN_ALL_OUTPUTS)
  */
 uint8_t EEPROM_ReadCase(uint16_t address, CaseData *case_data);
 
@@ -160,6 +167,132 @@ void EEPROM_ClearActiveCases(void);
  */
 void EEPROM_RemoveMarkedCases(void);
 
+/**
+ * Apply a byte just written to EEPROM to every active instance of the
+ * case containing it. Data bytes (24-31) are patched in place at once.
+ * A header byte (0-23: PGN/SA, config, conditions) holds the case back
+ * until its last byte (31) is written, a write lands outside it, or the
+ * writes stop (EEPROM_Cases_ServicePending); then the whole case is
+ * re-read. If it moved to another PGN/SA or was
+ * erased, a clearing frame goes out on the old one.
+ * @param byte_addr EEPROM byte address that was written
+ * @return Number of active cases patched (0 = not a case, not active,
+ *         or header still being written)
+ */
+uint8_t EEPROM_Cases_ApplyWrite(uint16_t byte_addr);
+
+#define CASE_PENDING_QUIET_MS   1000    // Held-back header applied after this without writes
+
+/**
+ * Apply a held-back case header once its writes have stopped
+ * A tool that only changes byte 4 or the SA never writes byte 31. Call
+ * from the main loop housekeeping; EEPROM_ActiveCasesEdited() reports
+ * the case if it is active.
+ * @param now_ms Current system time
+ */
+void EEPROM_Cases_ServicePending(uint32_t now_ms);
+
+/**
+ * Check and clear the "active case edited" flag
+ * @return 1 if EEPROM_Cases_ApplyWrite() changed an active case since the last call
+ */
+uint8_t EEPROM_ActiveCasesEdited(void);
+
+// ============================================================================
+// FAST PATH
+// ============================================================================
+// An input whose case 1 has CONFIG_FAST_PATH_VALUE gets its frames updated
+// from precomputed bit masks on the debounced edge, ahead of the aggregated
+// transmit. Only plain cases are in the masks: no pattern (case 1), no
+// must-be-on/off conditions, not overridable, no ignition mode. Anything
+// else on the input is left to the aggregated pass, which follows anyway.
+
+#define MAX_FAST_PATH_FRAMES    16  // PGN/SA per fast input, all inputs together
+
+/**
+ * Build the fast path masks from EEPROM
+ * Called from EEPROM_Cases_Init() and when a case of a fast input, or
+ * case 1 of any input, is written over CAN
+ */
+void EEPROM_LoadFastPath(void);
+
+/**
+ * Get a fast path frame
+ * @param entry 0 to MAX_FAST_PATH_FRAMES - 1
+ * @return 1 if the entry exists (entries are contiguous from 0)
+ */
+uint8_t EEPROM_GetFastPathFrame(uint8_t entry, uint8_t *input_num,
+                                uint16_t *pgn, uint8_t *source_addr);
+
+/**
+ * Apply a fast path edge to the last frame sent for that entry's PGN/SA
+ * Sets the bits of the cases now active, clears those of the cases going
+ * away unless another input, a timed case or inLINK still drives them,
+ * then applies inRESERVE shedding. Call before EEPROM_HandleInputChange()
+ * for the edge.
+ * 
+ * Those other contributors are not cached: an edge that clears bits
+ * scans up to MAX_ACTIVE_CASES + MAX_TIMED_CASES + MAX_INLINK_MESSAGES
+ * entries (88, around 2000 cycles = 125us at 16 MIPS, estimated from
+ * the loop bodies). They change from too many places to keep a
+ * per-PGN/SA table in step, and a stale one would clear a bit another
+ * input still holds.
+ * 
+ * @param entry Entry from EEPROM_GetFastPathFrame()
+ * @param new_state New stable input state
+ * @param data 8 data bytes, updated in place
+ */
+void EEPROM_FastPathUpdate(uint8_t entry, uint8_t new_state, uint8_t *data);
+
+// ============================================================================
+// TIMED CASES
+// ============================================================================
+// An ON case with bits 6-7 of byte 4 = 10 is not loaded with the other
+// cases of its input; its input edges drive a small state machine instead:
+//   Byte 5 bits 0-2  mode (TIMED_MODE_xxx)
+//   Byte 5 bit 7     duration counts in seconds instead of 250ms
+//   Byte 6           duration
+// Pending deadlines sit in a timing wheel advanced on the 250ms pattern
+// tick, so a tick only looks at the cases due in that slot. Active timed
+// cases are ORed into the aggregated frames (conditions apply, no pattern
+// or override), and a case that goes inactive leaves a clearing case.
+// Ignition-mode and one-button cases are never timed.
+
+#define TIMED_MODE_DELAY_ON     1   // Active once the input has been ON for the duration
+#define TIMED_MODE_DELAY_OFF    2   // Active while ON and for the duration after release
+#define TIMED_MODE_TOGGLE       3   // Each press flips it on/off (duration unused)
+#define TIMED_MODE_ONE_SHOT     4   // Active for the duration from the press
+#define TIMED_MODE_MASK         0x07
+#define TIMED_SCALE_SECONDS     0x80
+
+#define MAX_TIMED_CASES         8   // All inputs together
+#define TIMED_WHEEL_SLOTS       16  // 250ms each, must be a power of 2
+
+/**
+ * Read the timed cases of every input into RAM
+ * Called from EEPROM_Cases_Init(). Active cases are cleared first and
+ * every case starts idle. A case written over CAN reloads only itself
+ * (EEPROM_Cases_ApplyWrite); the others keep their state.
+ */
+void EEPROM_LoadTimedCases(void);
+
+/**
+ * Advance the timing wheel by one 250ms tick
+ * Call from the main loop on the pattern tick (not the ISR)
+ */
+void EEPROM_Timed_Tick(void);
+
+/**
+ * Check and clear the "timed case changed" flag
+ * @return 1 if a timed case went active or inactive on a tick
+ */
+uint8_t EEPROM_TimedCasesChanged(void);
+
+/**
+ * @return Number of timed cases waiting for a deadline
+ */
+uint8_t EEPROM_TimedCasesPending(void);
+
 /**
  * Get diagnostic information - number of EEPROM reads performed
  * @return Total EEPROM read operations since init
@@ -195,19 +328,42 @@ void EEPROM_Pattern_UpdateTimers(void);
  */
 uint8_t EEPROM_Pattern_IsInOnPhase(uint8_t input_num);
 
+/**
+ * Save pattern phases to persistent RAM (after each 250ms tick)
+ * Shares pattern_timers with the Timer1 ISR - call with T1IE cleared.
+ */
+void EEPROM_Pattern_SaveWarm(void);
+
+/**
+ * Resume the saved pattern phases after a watchdog reset
+ * Call once the cases for the restored inputs have been re-activated.
+ * @return 1 if a valid copy was found, 0 otherwise
+ */
+uint8_t EEPROM_Pattern_RestoreWarm(void);
+
 // ============================================================================
 // ONE-BUTTON START MANUAL CASE CONTROL FUNCTIONS
 // ============================================================================
 
+// One-button start inputs kept in RAM (EEPROM_LoadManualCases)
+#define MAX_MANUAL_CASES    8
+
+/**
+ * Read case 1 of every one-button start input into RAM
+ * Keeps its PGN, SA and priority, and the B0 masks of the ignition bit
+ * (the single bit set in B0) and the starter bit (one position higher).
+ * Called from EEPROM_Cases_Init() and again when case 1 of an input is
+ * written over CAN; the functions below never read EEPROM.
+ */
+void EEPROM_LoadManualCases(void);
+
 /**
  * Set a manual case for one-button start control
  * This allows direct control of what data is broadcast, independent of physical input state
  * 
- * This function:
- * 1. Removes any existing active cases for this input
- * 2. Reads the case configuration from EEPROM (PGN, SA, priority)
- * 3. Modifies the CAN data bytes based on ignition_on/starter_on parameters
- * 4. Adds the modified case to the active cases list
+ * If the input's manual case is already active only its B0 is rewritten;
+ * otherwise any leftover cases for the input are removed and the RAM copy
+ * of case 1 is added with the new B0. No EEPROM access either way.
  * 
  * The case will remain active until cleared with EEPROM_ClearManualCase() or
  * updated with another call to EEPROM_SetManualCase()
@@ -215,7 +371,7 @@ uint8_t EEPROM_Pattern_IsInOnPhase(uint8_t input_num);
  * @param input_num Input number (0-43) - must be configured as one-button start
  * @param ignition_on 1 to set ignition bit, 0 to clear it
  * @param starter_on 1 to set starter bit, 0 to clear it
- * @return 1 if successful, 0 if failed (invalid input, EEPROM read error, etc.)
+ * @return 1 if successful, 0 if failed (not one-button, no single ignition bit, list full)
  */
 uint8_t EEPROM_SetManualCase(uint8_t input_num, uint8_t ignition_on, uint8_t starter_on);
 
@@ -230,13 +386,23 @@ void EEPROM_ClearManualCase(uint8_t input_num);
 
 /**
  * Check if an input is configured as a one-button start input
- * Reads byte 4 of the input's first ON case from EEPROM
+ * Byte 4 of the input's first ON case, as loaded by EEPROM_LoadManualCases()
  * 
  * @param input_num Input number (0-43)
  * @return 1 if configured as one-button start (bits 4-5 = 0x01), 0 otherwise
  */
 uint8_t EEPROM_IsOneButtonStartInput(uint8_t input_num);
 
+/**
+ * Get the output frame a one-button start input drives
+ * B0 of that frame = (B0 & ~(ignition_mask | starter_mask)) | latch bits
+ * 
+ * @param input_num Input number (0-43)
+ * @return 1 if found, 0 if not one-button or no single ignition bit
+ */
+uint8_t EEPROM_GetManualFrame(uint8_t input_num, uint16_t *pgn, uint8_t *source_addr,
+                              uint8_t *ignition_mask, uint8_t *starter_mask);
+
 // ============================================================================
 // TRACK IGNITION FUNCTIONS
 // ============================================================================
@@ -244,7 +410,7 @@ uint8_t EEPROM_IsOneButtonStartInput(uint8_t input_num);
 /**
  * Update all track ignition cases based on current ignition flag state
  * This function scans all inputs and cases for track ignition configuration.
- * Cases with track ignition set (byte 4 bits 6-7 = 0x01) will be activated
+ * Cases with track ignition set (byte 4 bits 0-1 = 0x02) will be activated
  * or deactivated based on the ignition_flag parameter.
  * 
  * Track ignition cases:
@@ -261,11 +427,11 @@ void EEPROM_UpdateIgnitionTrackedCases(uint8_t ignition_flag);
 
 /**
  * Check if a specific case is configured for track ignition mode
- * Reads byte 4 bits 6-7 from EEPROM for the specified case
+ * Reads byte 4 bits 0-1 from EEPROM for the specified case
  * 
  * @param input_num Input number (0-43)
  * @param case_num Case number for this input
- * @return 1 if track ignition is enabled (bits 6-7 = 0x01), 0 otherwise
+ * @return 1 if track ignition is enabled (bits 0-1 = 0x02), 0 otherwise
  */
 uint8_t EEPROM_IsTrackIgnitionCase(uint8_t input_num, uint8_t case_num);
 
@@ -11,10 +11,12 @@
  */
 
 #include "eeprom_config.h"
+#include "board.h"
 #include <string.h>
 
-#define FCY 16000000UL
-#include <libpic30.h>
+// RAM shadow of the configuration header
+static uint8_t header_shadow[EEPROM_CFG_HEADER_SIZE];
+static uint8_t header_loaded = 0;
 
 // Diagnostic counters
 static uint32_t byte_read_count = 0;
@@ -23,24 +25,12 @@ static uint16_t write_failures = 0;
 
 /*
  * Low-level word read from EEPROM
- * Reads a 16-bit word from EEPROM using Table Read
  * 
  * @param word_addr Word address (must be even)
  * @return 16-bit word value
  */
 static uint16_t EEPROM_ReadWord(uint16_t word_addr) {
-    // Validate word address is even
-    if (word_addr & 0x01) {
-        return 0xFFFF;  // Invalid address
-    }
-    
-    // Set up table page for EEPROM access (0x7F)
-    TBLPAG = 0x7F;
-    
-    // Read from EEPROM space (0xF000 offset + word address)
-    uint16_t value = __builtin_tblrdl(0xF000 + word_addr);
-    
-    return value;
+    return Board_NVMReadWord(word_addr);
 }
 
 /*
@@ -52,14 +42,12 @@ static uint16_t EEPROM_ReadWord(uint16_t word_addr) {
  * @return 1 if successful, 0 if failed
  */
 static uint8_t EEPROM_WriteWord(uint16_t word_addr, uint16_t data) {
-    uint16_t timeout;
-    
     // Validate word address is even and in valid range
     if (word_addr & 0x01) {
         write_failures++;
         return 0;
     }
-    if (word_addr >= 0x1000) {
+    if (word_addr >= BOARD_NVM_SIZE) {
         write_failures++;
         return 0;
     }
@@ -67,84 +55,65 @@ static uint8_t EEPROM_WriteWord(uint16_t word_addr, uint16_t data) {
     // ==========================================
     // STEP 1: ERASE the word
     // ==========================================
-    TBLPAG = 0x7F;
-    __builtin_tblwtl(0xF000 + word_addr, 0xFFFF);
-    
-    NVMCON = 0x4044;  // Word erase operation
-    
-    // Unlock sequence
-    asm volatile ("disi #5");
-    asm volatile ("mov #0x55, W0");
-    asm volatile ("mov W0, NVMKEY");
-    asm volatile ("mov #0xAA, W0");
-    asm volatile ("mov W0, NVMKEY");
-    asm volatile ("bset NVMCON, #15");
-    asm volatile ("nop");
-    asm volatile ("nop");
-    
-    // Wait for erase to complete
-    timeout = 30000;
-    while ((NVMCON & 0x8000) && timeout > 0) {
-        timeout--;
-    }
-    
-    if (timeout == 0) {
+    if (!Board_NVMEraseWord(word_addr)) {
         write_failures++;
         return 0;
     }
     
-    __delay_ms(3);  // Delay after erase
-    
     // ==========================================
     // STEP 2: WRITE the data
     // ==========================================
-    TBLPAG = 0x7F;
-    __builtin_tblwtl(0xF000 + word_addr, data);
-    
-    NVMCON = 0x4004;  // Word write operation
-    
-    // Unlock sequence
-    asm volatile ("disi #5");
-    asm volatile ("mov #0x55, W0");
-    asm volatile ("mov W0, NVMKEY");
-    asm volatile ("mov #0xAA, W0");
-    asm volatile ("mov W0, NVMKEY");
-    asm volatile ("bset NVMCON, #15");
-    asm volatile ("nop");
-    asm volatile ("nop");
-    
-    // Wait for write to complete
-    timeout = 30000;
-    while ((NVMCON & 0x8000) && timeout > 0) {
-        timeout--;
-    }
-    
-    if (timeout == 0) {
+    if (!Board_NVMProgramWord(word_addr, data)) {
         write_failures++;
         return 0;
     }
     
-    __delay_ms(3);  // Delay after write
-    
     // ==========================================
     // STEP 3: VERIFY the write
     // ==========================================
-    TBLPAG = 0x7F;
-    uint16_t verify = __builtin_tblrdl(0xF000 + word_addr);
+    uint16_t verify = Board_NVMReadWord(word_addr);
     
     if (verify != data) {
         write_failures++;
         return 0;
     }
     
+    EEPROM_Config_ShadowWord(word_addr, data);
     return 1;
 }
 
+/**
+ * Load the RAM shadow of the configuration header
+ */
+void EEPROM_Config_Load(void) {
+    for (uint16_t addr = 0; addr < EEPROM_CFG_HEADER_SIZE; addr += 2) {
+        uint16_t word_value = EEPROM_ReadWord(addr);
+        header_shadow[addr] = (uint8_t)(word_value & 0xFF);
+        header_shadow[addr + 1] = (uint8_t)(word_value >> 8);
+    }
+    header_loaded = 1;
+}
+
+/**
+ * Update the RAM shadow after a word write
+ */
+void EEPROM_Config_ShadowWord(uint16_t word_addr, uint16_t data) {
+    if (word_addr >= EEPROM_CFG_HEADER_SIZE) {
+        return;
+    }
+    header_shadow[word_addr] = (uint8_t)(data & 0xFF);
+    header_shadow[word_addr + 1] = (uint8_t)(data >> 8);
+}
+
 /**
  * Read a single byte from EEPROM
  * Converts byte address to word address and extracts LSB or MSB
  */
 uint8_t EEPROM_Config_ReadByte(uint16_t byte_addr) {
+    if (byte_addr < EEPROM_CFG_HEADER_SIZE && header_loaded) {
+        return header_shadow[byte_addr];
+    }
+    
     // Convert byte address to word address (clear LSB)
     uint16_t word_addr = byte_addr & 0xFFFE;
     
@@ -254,6 +223,15 @@ uint16_t EEPROM_Config_ReadPGN(uint16_t pgn_a_addr) {
     return ((uint16_t)pgn_a << 8) | (uint16_t)pgn_b;
 }
 
+/**
+ * Read one nibble of a packed configuration byte
+ */
+uint8_t EEPROM_Config_ReadNibble(uint16_t byte_addr, uint8_t upper) {
+    uint8_t value = EEPROM_Config_ReadByte(byte_addr);
+    
+    return upper ? (value >> 4) & 0x0F : value & 0x0F;
+}
+
 /**
  * Write a 16-bit PGN to two consecutive bytes
  */
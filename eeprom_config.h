@@ -5,6 +5,10 @@
  * Provides byte-level read/write access to configuration EEPROM
  * using read-modify-write operations on the underlying 16-bit word architecture.
  * 
+ * The configuration header (bytes 0-33) is shadowed in RAM: loaded once at
+ * boot by EEPROM_Config_Load() and updated by every word write that lands in
+ * it (EEPROM_Config_ShadowWord), so header reads never touch the EEPROM.
+ * 
  * EEPROM Configuration Map (Byte Addresses 0-26):
  * 0:  Bitrate (0x01=250k, 0x02=500k, 0x03=1M)
  * 1:  Heartbeat PGN A (high byte)
@@ -33,7 +37,12 @@
  * 24: Customer Name Character 2 (ASCII)
  * 25: Customer Name Character 3 (ASCII)
  * 26: Customer Name Character 4 (ASCII)
- * 27-33: Reserved (for word alignment)
+ * 27: Climate slew rate (wiper steps per 10ms tick, Q4; 0x00=instant, 0xFF=default)
+ * 28: Climate curve select (2 bits per channel: temp 1:0, fan 3:2, blend 5:4)
+ * 29: Pattern keepalive (250ms ticks, 0x00/0xFF = off)
+ * 30: Sleep delay (minutes idle with ignition off, 0x00 = never, 0xFF = default)
+ * 31: Gateway mode (GATEWAY_MODE_ON = second CAN controller runs, 0x00/0xFF = off)
+ * 32-33: Reserved (for word alignment)
  * 34+: Input Cases (32 bytes each, starting at word address 0x0022)
  */
 
@@ -75,8 +84,17 @@
 #define EEPROM_CFG_CUSTOMER_NAME_3      25
 #define EEPROM_CFG_CUSTOMER_NAME_4      26
 
+// Extended configuration (formerly reserved, erased value 0xFF = use default)
+#define EEPROM_CFG_CLIMATE_SLEW         27  // Q4 wiper steps per 10ms tick
+#define EEPROM_CFG_CLIMATE_CURVES       28  // Curve select, 2 bits per channel
+#define EEPROM_CFG_PATTERN_KEEPALIVE    29  // Unchanged pattern frame resend, 250ms ticks (0/0xFF = off)
+#define EEPROM_CFG_SLEEP_DELAY          30  // Minutes idle before Sleep (0 = never, 0xFF = default)
+#define EEPROM_CFG_GATEWAY              31  // Gateway mode, read at startup (gateway.h)
+#define EEPROM_CFG_DIAGNOSTIC_PERIOD    32  // Seconds between unsolicited diagnostic pages (0/0xFF = off)
+
 // Configuration value ranges
 #define EEPROM_CFG_SIZE                 27      // Total configuration bytes (0-26)
+#define EEPROM_CFG_HEADER_SIZE          34      // Shadowed bytes: config, extended, reserved (0-33)
 
 // Default configuration values
 #define DEFAULT_BITRATE                 0x01    // 250 kbps
@@ -110,6 +128,25 @@
 #define DEFAULT_INRESERVE_1             0x09    // PowerCell 0 (DISABLED), Output 9
 #define DEFAULT_INRESERVE_2             0x02    // 30 seconds (code 0), 12.3V (code 2)
 
+// Climate ramp defaults
+#define DEFAULT_CLIMATE_SLEW            0x20    // 2 steps/tick → full scale in ~640ms
+
+// Spare 32-byte case slot in the OFF case region (between IN02 and IN25 OFF cases)
+#define EEPROM_SPARE_BLOCK_START        0x0DE2
+#define EEPROM_CLIMATE_LUT_START        0x0DE2  // 16 bytes: custom curve, CAN 0-15 → wiper 0-128
+#define EEPROM_CLIMATE_LUT_SIZE         16
+#define EEPROM_INRESERVE_LADDER_START   0x0DF2  // 16 bytes: 4 inRESERVE ladder stages x 4 bytes
+#define EEPROM_INRESERVE_LADDER_SIZE    16
+
+// Tail after the last OFF case slot (0x0FE2-0x0FFF, EEPROM_CASES_END); IN32
+// has a single OFF case so that none runs into it
+#define EEPROM_DEBOUNCE_START           0x0FE2  // 22 bytes: debounce scans per input, IN01 = low nibble of byte 0
+#define EEPROM_DEBOUNCE_SIZE            22
+#define EEPROM_DEBOUNCE_MODE            0x0FF8  // EEPROM_DEBOUNCE_ADAPTIVE, anything else = fixed
+#define EEPROM_DEBOUNCE_ADAPTIVE        0x01
+#define EEPROM_GATEWAY_ROUTES           0x0FF9  // Route enable mask, bit n = route n (0xFF = all)
+#define EEPROM_GATEWAY_RATES            0x0FFA  // 4 bytes: rate code per route, route 0 = low nibble of byte 0
+
 // Bitrate codes
 #define BITRATE_250K                    0x01
 #define BITRATE_500K                    0x02
@@ -119,9 +156,24 @@
 #define REBROADCAST_EDGES               0x01    // Change-of-state only
 #define REBROADCAST_PERIODIC            0x02    // Rebroadcast every heartbeat
 
+/**
+ * Load the RAM shadow of the configuration header (once, at boot)
+ */
+void EEPROM_Config_Load(void);
+
+/**
+ * Keep the RAM shadow coherent with a word just written to EEPROM
+ * Called by every EEPROM word writer; words outside the header are ignored.
+ * 
+ * @param word_addr Word address (even)
+ * @param data Word value written
+ */
+void EEPROM_Config_ShadowWord(uint16_t word_addr, uint16_t data);
+
 /**
  * Read a single byte from EEPROM configuration area
- * Uses read-modify approach to access individual bytes from 16-bit words
+ * Header bytes come from the RAM shadow once it is loaded; other bytes use
+ * the read-modify approach to access individual bytes from 16-bit words
  * 
  * @param byte_addr Byte address (0-26 for config, 27+ for reserved/cases)
  * @return Byte value at the specified address
@@ -174,6 +226,15 @@ uint8_t EEPROM_Config_IsInitialized(void);
  */
 uint16_t EEPROM_Config_ReadPGN(uint16_t pgn_a_addr);
 
+/**
+ * Read one nibble of a packed configuration byte
+ * 
+ * @param byte_addr Byte address
+ * @param upper 1 = bits 7-4, 0 = bits 3-0
+ * @return Nibble value (0-15)
+ */
+uint8_t EEPROM_Config_ReadNibble(uint16_t byte_addr, uint8_t upper);
+
 /**
  * Write a 16-bit PGN to two consecutive bytes
  * 
@@ -184,8 +245,8 @@ uint16_t EEPROM_Config_ReadPGN(uint16_t pgn_a_addr);
 uint8_t EEPROM_Config_WritePGN(uint16_t pgn_a_addr, uint16_t pgn);
 
 /**
- * Get diagnostic information - number of byte read operations
- * @return Total byte reads since init
+ * Get diagnostic information - number of byte reads that went to EEPROM
+ * @return Total EEPROM byte reads since init (shadowed reads not counted)
  */
 uint32_t EEPROM_Config_GetByteReadCount(void);
 
@@ -201,4 +262,4 @@ uint32_t EEPROM_Config_GetByteWriteCount(void);
  */
 uint16_t EEPROM_Config_GetWriteFailures(void);
 
-#endif // EEPROM_CONFIG_H
\ No newline at end of file
+#endif // EEPROM_CONFIG_H
\ No newline at end of file
@@ -21,11 +21,9 @@
 #include "eeprom_init.h"
 #include "eeprom_cases.h"
 #include "eeprom_config.h"
+#include "board.h"
 #include <string.h>
 
-#define FCY 16000000UL
-#include <libpic30.h>
-
 // Write verification counter
 static uint16_t write_errors = 0;
 static uint16_t words_written = 0;
@@ -45,7 +43,7 @@ uint8_t EEPROM_WriteWord(uint16_t address, uint16_t data) {
         last_error_type = 3;  // Bounds error
         return 0;
     }
-    if(address >= 0x1000) {
+    if(address >= BOARD_NVM_SIZE) {
         write_errors++;
         last_error_type = 3;  // Bounds error
         return 0;
@@ -54,66 +52,23 @@ uint8_t EEPROM_WriteWord(uint16_t address, uint16_t data) {
     // ==========================================
     // STEP 1: ERASE the word
     // ==========================================
-    TBLPAG = 0x7F;
-    __builtin_tblwtl(0xF000 + address, 0xFFFF);
-    
-    NVMCON = 0x4044;  // Word erase operation
-    
-    asm volatile ("disi #5");
-    asm volatile ("mov #0x55, W0");
-    asm volatile ("mov W0, NVMKEY");
-    asm volatile ("mov #0xAA, W0");
-    asm volatile ("mov W0, NVMKEY");
-    asm volatile ("bset NVMCON, #15");
-    asm volatile ("nop");
-    asm volatile ("nop");
-    
-    uint16_t timeout = 30000;
-    while((NVMCON & 0x8000) && timeout > 0) {
-        timeout--;
-    }
-    
-    if(timeout == 0) {
+    if(!Board_NVMEraseWord(address)) {
         write_errors++;
         last_error_type = 1;  // Timeout on ERASE
         return 0;
     }
     
-    __delay_ms(3);
-    
     // ==========================================
     // STEP 2: WRITE the data
     // ==========================================
-    TBLPAG = 0x7F;
-    __builtin_tblwtl(0xF000 + address, data);
-    
-    NVMCON = 0x4004;  // Word write operation
-    
-    asm volatile ("disi #5");
-    asm volatile ("mov #0x55, W0");
-    asm volatile ("mov W0, NVMKEY");
-    asm volatile ("mov #0xAA, W0");
-    asm volatile ("mov W0, NVMKEY");
-    asm volatile ("bset NVMCON, #15");
-    asm volatile ("nop");
-    asm volatile ("nop");
-    
-    timeout = 30000;
-    while((NVMCON & 0x8000) && timeout > 0) {
-        timeout--;
-    }
-    
-    if(timeout == 0) {
+    if(!Board_NVMProgramWord(address, data)) {
         write_errors++;
         last_error_type = 1;  // Timeout on WRITE
         return 0;
     }
     
-    __delay_ms(3);
-    
     // Verify
-    TBLPAG = 0x7F;
-    uint16_t verify = __builtin_tblrdl(0xF000 + address);
+    uint16_t verify = Board_NVMReadWord(address);
     
     if(verify != data) {
         write_errors++;
@@ -124,6 +79,9 @@ uint8_t EEPROM_WriteWord(uint16_t address, uint16_t data) {
     words_written++;
     last_error_type = 0;  // Success
     
+    // Configuration header bytes are shadowed in RAM
+    EEPROM_Config_ShadowWord(address, data);
+    
     return 1;
 }
 
@@ -183,7 +141,7 @@ void EEPROM_WriteCaseEx(uint16_t address, uint8_t priority, uint16_t pgn,
     // Byte 4: Configuration flags
     case_buffer[4] = config_byte;
     
-    // Bytes 5-6: Reserved (0x00)
+    // Bytes 5-6: Timed mode and duration (0x00 = not timed)
     case_buffer[5] = 0x00;
     case_buffer[6] = 0x00;
     
@@ -266,11 +224,7 @@ void EEPROM_WriteInvalidCase(uint16_t address) {
 
 // Read back a word to verify
 static uint16_t EEPROM_ReadWord(uint16_t address) {
-    if(address >= 0x1000) return 0xFFFF;
-    if(address & 0x01) return 0xFFFF;
-    
-    TBLPAG = 0x7F;
-    return __builtin_tblrdl(0xF000 + address);
+    return Board_NVMReadWord(address);
 }
 
 /**
@@ -314,8 +268,7 @@ eeprom_config_type_t EEPROM_SelectConfiguration(void) {
 uint8_t EEPROM_IsInitialized(void) {
     // Check for init stamp (0xA5) at byte address 7
     // Byte 7 is in word address 0x0006, MSB position
-    TBLPAG = 0x7F;
-    uint16_t word = __builtin_tblrdl(0xF000 + 0x0006);
+    uint16_t word = Board_NVMReadWord(0x0006);
     uint8_t init_stamp = (uint8_t)((word >> 8) & 0xFF);
     
     return (init_stamp == DEFAULT_INIT_STAMP);
@@ -366,8 +319,7 @@ uint8_t EEPROM_Init_WriteByte(uint16_t byte_addr, uint8_t value) {
     uint16_t word_addr = byte_addr & 0xFFFE;  // Clear bit 0
     
     // Read current word value
-    TBLPAG = 0x7F;
-    uint16_t current_word = __builtin_tblrdl(0xF000 + word_addr);
+    uint16_t current_word = Board_NVMReadWord(word_addr);
     
     // Modify the appropriate byte
     uint16_t new_word;
@@ -9,12 +9,10 @@
 #include "eeprom_init.h"
 #include "eeprom_cases.h"
 #include "eeprom_config.h"
+#include "board.h"
 #include <string.h>
 #include <stdio.h>
 
-#define FCY 16000000UL
-#include <libpic30.h>
-
 /*
  * Load Standard Front Engine Configuration
  */
@@ -907,14 +905,13 @@ void EEPROM_LoadFrontEngine(void) {
     EEPROM_WriteInvalidCase(addr);
     addr += 32;
 
-    // IN32 - 2 OFF cases at offset 608 - Window DOWN Stop
+    // IN32 - 1 OFF case at offset 608 - Window DOWN Stop
+    // (0x0FE2-0x0FFF after it holds the debounce and gateway tables)
     ParseCANID("18FF061A", &priority, &pgn, &source_addr);
     memset(data, 0x00, 8);
     data[1] = 0x80;  // Window stop command
     EEPROM_WriteCase(addr, priority, pgn, source_addr, 0x00, 0x00, 0, data);
     addr += 32;
-    EEPROM_WriteInvalidCase(addr);
-    addr += 32;
     
     // End of OFF cases - IN33-IN44 and HSIN01-HSIN06 have no OFF cases
 }
\ No newline at end of file
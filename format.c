@@ -0,0 +1,148 @@
+/*
+ * FILE: format.c
+ * Fixed-Width Text Formatting Implementation
+ * 
+ * Decimal conversion uses repeated divide by 10, which maps onto the
+ * dsPIC30F hardware divide (REPEAT #17 / DIV.U). At most five digits.
+ */
+
+#include "format.h"
+
+static const char hex_digits[16] = {
+    '0', '1', '2', '3', '4', '5', '6', '7',
+    '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'
+};
+
+/**
+ * Convert to decimal digits, least significant first
+ * @return Number of digits (1-5)
+ */
+static uint8_t ToDigits(uint16_t value, char *digits) {
+    uint8_t n = 0;
+    
+    do {
+        digits[n++] = '0' + (value % 10);
+        value /= 10;
+    } while (value != 0);
+    
+    return n;
+}
+
+char* Format_Char(char *p, char c) {
+    *p++ = c;
+    return p;
+}
+
+char* Format_Str(char *p, const char *s) {
+    while (*s) {
+        *p++ = *s++;
+    }
+    return p;
+}
+
+char* Format_StrLeft(char *p, const char *s, uint8_t width) {
+    while (width > 0 && *s) {
+        *p++ = *s++;
+        width--;
+    }
+    while (width > 0) {
+        *p++ = ' ';
+        width--;
+    }
+    return p;
+}
+
+char* Format_StrRight(char *p, const char *s, uint8_t width) {
+    uint8_t len = 0;
+    
+    while (s[len] && len < width) {
+        len++;
+    }
+    for (uint8_t i = len; i < width; i++) {
+        *p++ = ' ';
+    }
+    for (uint8_t i = 0; i < len; i++) {
+        *p++ = s[i];
+    }
+    return p;
+}
+
+char* Format_Hex8(char *p, uint8_t value) {
+    *p++ = hex_digits[value >> 4];
+    *p++ = hex_digits[value & 0x0F];
+    return p;
+}
+
+char* Format_Hex16(char *p, uint16_t value) {
+    p = Format_Hex8(p, (uint8_t)(value >> 8));
+    return Format_Hex8(p, (uint8_t)value);
+}
+
+char* Format_Dec(char *p, uint16_t value) {
+    char digits[5];
+    uint8_t n = ToDigits(value, digits);
+    
+    while (n > 0) {
+        *p++ = digits[--n];
+    }
+    return p;
+}
+
+char* Format_DecSigned(char *p, int16_t value) {
+    if (value < 0) {
+        *p++ = '-';
+        return Format_Dec(p, (uint16_t)(-(int32_t)value));
+    }
+    return Format_Dec(p, (uint16_t)value);
+}
+
+char* Format_DecZero(char *p, uint16_t value, uint8_t width) {
+    char digits[5];
+    uint8_t n = ToDigits(value, digits);
+    
+    for (uint8_t i = n; i < width; i++) {
+        *p++ = '0';
+    }
+    while (n > 0) {
+        *p++ = digits[--n];
+    }
+    return p;
+}
+
+char* Format_DecSpace(char *p, uint16_t value, uint8_t width) {
+    char digits[5];
+    uint8_t n = ToDigits(value, digits);
+    
+    for (uint8_t i = n; i < width; i++) {
+        *p++ = ' ';
+    }
+    while (n > 0) {
+        *p++ = digits[--n];
+    }
+    return p;
+}
+
+char* Format_Fixed1(char *p, uint16_t milli) {
+    p = Format_Dec(p, milli / 1000);
+    *p++ = '.';
+    *p++ = '0' + ((milli % 1000) / 100);
+    return p;
+}
+
+void Format_End(char *p) {
+    *p = '\0';
+}
+
+void Format_PadLine(char *line, char *p, uint8_t size) {
+    if (size == 0) {
+        return;
+    }
+    
+    // Terminate inside the buffer even if it is narrower than a line
+    uint8_t width = (size > FORMAT_LINE_WIDTH) ? FORMAT_LINE_WIDTH : size - 1;
+    
+    while (p < line + width) {
+        *p++ = ' ';
+    }
+    line[width] = '\0';
+}
@@ -0,0 +1,102 @@
+/*
+ * FILE: format.h
+ * Fixed-Width Text Formatting for MASTERCELL NGX
+ * 
+ * Small, allocation-free replacements for the sprintf patterns used
+ * on the 16x4 LCD screens. No varargs, no format-string parsing.
+ * 
+ * Every function writes at p and returns the position after the last
+ * character written, so calls chain into one line buffer:
+ * 
+ *   char line[17];
+ *   char *p = Format_Char(line, '>');
+ *   p = Format_Hex16(p, pgn);
+ *   Format_PadLine(line, p, sizeof(line));  // space-fill to 16, terminate
+ * 
+ * Nothing is NUL-terminated until Format_End or Format_PadLine.
+ */
+
+#ifndef FORMAT_H
+#define FORMAT_H
+
+#include <stdint.h>
+
+// LCD line width (characters)
+#define FORMAT_LINE_WIDTH   16
+
+/**
+ * Write a single character (%c)
+ */
+char* Format_Char(char *p, char c);
+
+/**
+ * Copy a string without padding (%s)
+ */
+char* Format_Str(char *p, const char *s);
+
+/**
+ * Left-justify a string in a field, space padded and truncated (%-Ns)
+ * @param width Field width in characters
+ */
+char* Format_StrLeft(char *p, const char *s, uint8_t width);
+
+/**
+ * Right-justify a string in a field, space padded and truncated (%Ns)
+ * @param width Field width in characters
+ */
+char* Format_StrRight(char *p, const char *s, uint8_t width);
+
+/**
+ * Two uppercase hex digits (%02X)
+ */
+char* Format_Hex8(char *p, uint8_t value);
+
+/**
+ * Four uppercase hex digits (%04X)
+ */
+char* Format_Hex16(char *p, uint16_t value);
+
+/**
+ * Unsigned decimal, no padding (%u)
+ */
+char* Format_Dec(char *p, uint16_t value);
+
+/**
+ * Signed decimal, no padding (%d)
+ */
+char* Format_DecSigned(char *p, int16_t value);
+
+/**
+ * Zero-padded unsigned decimal (%0Nu)
+ * @param width Minimum digits (wider values are not truncated)
+ */
+char* Format_DecZero(char *p, uint16_t value, uint8_t width);
+
+/**
+ * Space-padded unsigned decimal (%Nu)
+ * @param width Minimum field width (wider values are not truncated)
+ */
+char* Format_DecSpace(char *p, uint16_t value, uint8_t width);
+
+/**
+ * Fixed point with one decimal from milli-units: 12345 → "12.3"
+ * Truncates like (milli / 1000).((milli % 1000) / 100).
+ * Used for volts (mV) and amps (mA).
+ */
+char* Format_Fixed1(char *p, uint16_t milli);
+
+/**
+ * NUL-terminate at p
+ */
+void Format_End(char *p);
+
+/**
+ * Space-fill line from p up to FORMAT_LINE_WIDTH and NUL-terminate
+ * Longer text is cut at FORMAT_LINE_WIDTH. A buffer smaller than
+ * FORMAT_LINE_WIDTH + 1 bytes is filled and terminated within size.
+ * @param line Start of the line buffer
+ * @param size Size of the line buffer in bytes
+ */
+void Format_PadLine(char *line, char *p, uint8_t size);
+
+#endif // FORMAT_H
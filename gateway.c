@@ -0,0 +1,303 @@
+/*
+ * FILE: gateway.c
+ * CAN Gateway Between Two Bus Segments Implementation
+ *
+ * Routing costs one table scan per received frame: the first route that
+ * is on, covers the direction and matches (pgn & pgn_mask) == pgn wins.
+ * A rate-limited route adds a scan of the GATEWAY_RATE_SLOTS deadlines.
+ */
+
+#include "gateway.h"
+#include "eeprom_config.h"
+#include "board.h"
+#include <string.h>
+
+typedef struct {
+    uint16_t pgn;
+    uint16_t pgn_mask;          // 0xFF00 matches every destination of a PDU1 PGN
+    uint8_t directions;         // GATEWAY_DIR_xxx
+    uint8_t default_rate;       // GATEWAY_RATE_xxx
+} GatewayRoute;
+
+// Engine data the PowerCell side displays or acts on, diagnostics both
+// ways, requests from our side to the OEM ECUs
+static const GatewayRoute routes[GATEWAY_MAX_ROUTES] = {
+    { 0xF004, 0xFFFF, GATEWAY_DIR_2_TO_1, GATEWAY_RATE_100MS },  // EEC1 engine speed
+    { 0xF005, 0xFFFF, GATEWAY_DIR_2_TO_1, GATEWAY_RATE_100MS },  // ETC2 gear
+    { 0xFEF1, 0xFFFF, GATEWAY_DIR_2_TO_1, GATEWAY_RATE_100MS },  // CCVS vehicle speed
+    { 0xFEEE, 0xFFFF, GATEWAY_DIR_2_TO_1, GATEWAY_RATE_1S },     // ET1 coolant temperature
+    { 0xFEFC, 0xFFFF, GATEWAY_DIR_2_TO_1, GATEWAY_RATE_1S },     // DD fuel level
+    { 0xFECA, 0xFFFF, GATEWAY_DIR_BOTH, GATEWAY_RATE_NONE },     // DM1 active faults
+    { 0xEE00, 0xFF00, GATEWAY_DIR_BOTH, GATEWAY_RATE_NONE },     // Address claim
+    { 0xEA00, 0xFF00, GATEWAY_DIR_1_TO_2, GATEWAY_RATE_NONE },   // Request
+};
+
+// Rate code -> minimum interval (ms)
+static const uint16_t rate_interval_ms[15] = {
+    0, 10, 20, 50, 100, 200, 250, 500, 1000, 2000, 5000, 10000, 20000, 30000, 60000
+};
+
+static uint8_t enabled = 0;
+static uint8_t route_on = 0;                                // Bit n = route n
+static uint16_t route_interval[GATEWAY_MAX_ROUTES];
+
+// Rate limit deadline of one sender on one route and direction
+#define RATE_SLOT_FREE  0xFF
+
+typedef struct {
+    uint8_t route;              // RATE_SLOT_FREE = unused
+    uint8_t from;               // Source bus
+    uint8_t source_addr;
+    uint32_t next_ms;
+} RateSlot;
+
+static RateSlot rate_slots[GATEWAY_RATE_SLOTS];
+
+// Frames waiting for a controller, one queue per destination segment
+typedef struct {
+    uint32_t id;
+    uint8_t dlc;
+    uint8_t data[8];
+} QueuedFrame;
+
+typedef struct {
+    QueuedFrame frames[GATEWAY_TX_QUEUE];
+    uint8_t head;
+    uint8_t count;
+} TxQueue;
+
+static TxQueue tx_queue[2];
+
+// Counts since the last window, and the last window's rates
+typedef struct {
+    uint16_t frames;
+    uint16_t forwarded;
+    uint16_t filtered;
+    uint16_t limited;
+    uint16_t dropped;
+} SegmentWindow;
+
+static SegmentWindow window[2];
+static GatewaySegment segments[2];
+static uint32_t window_start = 0;
+
+static uint8_t bus2_error_state = BOARD_CAN_ERROR_ACTIVE;
+static uint8_t bus2_off_seen = 0;
+static uint16_t bus2_off_count = 0;
+
+void Gateway_Init(void) {
+    memset(window, 0, sizeof(window));
+    memset(segments, 0, sizeof(segments));
+    bus2_off_count = 0;
+    memset(tx_queue, 0, sizeof(tx_queue));
+
+    // The mode byte is only read here - the controller is set up once
+    enabled = (EEPROM_Config_ReadByte(EEPROM_CFG_GATEWAY) == GATEWAY_MODE_ON);
+    Gateway_LoadConfig();
+
+    if (enabled) {
+        J1939_InitBus2();
+    }
+}
+
+void Gateway_LoadConfig(void) {
+    route_on = EEPROM_Config_ReadByte(EEPROM_GATEWAY_ROUTES);
+
+    for (uint8_t i = 0; i < GATEWAY_MAX_ROUTES; i++) {
+        uint8_t code = EEPROM_Config_ReadNibble(EEPROM_GATEWAY_RATES + (i >> 1), i & 0x01);
+        if (code == GATEWAY_RATE_DEFAULT) {
+            code = routes[i].default_rate;
+        }
+        route_interval[i] = rate_interval_ms[code];
+    }
+    for (uint8_t i = 0; i < GATEWAY_RATE_SLOTS; i++) {
+        rate_slots[i].route = RATE_SLOT_FREE;
+    }
+}
+
+uint8_t Gateway_IsEnabled(void) {
+    return enabled;
+}
+
+/*
+ * 1 if the route's interval for this sender has run out (and restart it)
+ * A new sender takes a free slot, else the slot whose deadline is the
+ * oldest - with more senders than slots, some frames pass unlimited
+ */
+static uint8_t RateAllows(uint8_t route, uint8_t from, uint8_t source_addr, uint32_t now_ms) {
+    RateSlot *slot = NULL;
+
+    for (uint8_t i = 0; i < GATEWAY_RATE_SLOTS; i++) {
+        RateSlot *s = &rate_slots[i];
+
+        if (s->route == route && s->from == from && s->source_addr == source_addr) {
+            if ((int32_t)(now_ms - s->next_ms) < 0) {
+                return 0;
+            }
+            slot = s;
+            break;
+        }
+        if (slot == NULL || (slot->route != RATE_SLOT_FREE &&
+            (s->route == RATE_SLOT_FREE || (int32_t)(s->next_ms - slot->next_ms) < 0))) {
+            slot = s;
+        }
+    }
+
+    slot->route = route;
+    slot->from = from;
+    slot->source_addr = source_addr;
+    slot->next_ms = now_ms + route_interval[route];
+    return 1;
+}
+
+/*
+ * Queue a frame for a segment, 0 if its queue is full
+ */
+static uint8_t QueueFrame(uint8_t to, const CAN_RxMessage *msg) {
+    TxQueue *q = &tx_queue[to];
+
+    if (q->count >= GATEWAY_TX_QUEUE) {
+        return 0;
+    }
+
+    QueuedFrame *f = &q->frames[(q->head + q->count) % GATEWAY_TX_QUEUE];
+    f->id = msg->id;
+    f->dlc = msg->dlc;
+    memcpy(f->data, msg->data, 8);
+    q->count++;
+
+    Gateway_ServiceTx();
+    return 1;
+}
+
+/*
+ * Oldest queued frame of a segment, taken off its queue
+ */
+static QueuedFrame *NextFrame(uint8_t to, BoardCANTxImage *image) {
+    TxQueue *q = &tx_queue[to];
+    QueuedFrame *f = &q->frames[q->head];
+
+    Board_CANEncodeLength(f->id, f->dlc, image);
+    q->head = (q->head + 1) % GATEWAY_TX_QUEUE;
+    q->count--;
+    return f;
+}
+
+void Gateway_ServiceTx(void) {
+    BoardCANTxImage image;
+
+    // One frame per free buffer - the next goes on a later pass. Segment 1
+    // shares the normal buffer with our own frames, which wait for it as
+    // they would for any earlier frame of ours.
+    if (tx_queue[CAN_BUS_1].count != 0) {
+        if (J1939_GetErrorState() == BOARD_CAN_BUS_OFF) {
+            tx_queue[CAN_BUS_1].count = 0;      // Stale by the time it recovers
+        } else if (Board_CANTxReady()) {
+            QueuedFrame *f = NextFrame(CAN_BUS_1, &image);
+            Board_CANTransmitImage(&image, f->data);
+        }
+    }
+
+    if (tx_queue[CAN_BUS_2].count != 0 && Board_CAN2TxReady()) {
+        QueuedFrame *f = NextFrame(CAN_BUS_2, &image);
+        Board_CAN2TransmitImage(&image, f->data);
+    }
+}
+
+uint8_t Gateway_Route(CAN_RxMessage *msg, uint32_t now_ms) {
+    if (!enabled) {
+        return 1;
+    }
+
+    uint8_t from = (msg->bus == CAN_BUS_2) ? CAN_BUS_2 : CAN_BUS_1;
+    uint8_t to = (from == CAN_BUS_1) ? CAN_BUS_2 : CAN_BUS_1;
+    uint8_t direction = (from == CAN_BUS_1) ? GATEWAY_DIR_1_TO_2 : GATEWAY_DIR_2_TO_1;
+    uint16_t pgn = (msg->id >> 8) & 0xFFFF;
+
+    window[from].frames++;
+    segments[from].rx_total++;
+
+    for (uint8_t i = 0; i < GATEWAY_MAX_ROUTES; i++) {
+        const GatewayRoute *route = &routes[i];
+
+        if (!(route_on & (1 << i)) || !(route->directions & direction) ||
+            (pgn & route->pgn_mask) != route->pgn) {
+            continue;
+        }
+
+        if (route_interval[i] != 0 && !RateAllows(i, from, msg->id & 0xFF, now_ms)) {
+            window[from].limited++;
+            return from == CAN_BUS_1;
+        }
+
+        if (!QueueFrame(to, msg)) {
+            window[from].dropped++;
+            return from == CAN_BUS_1;
+        }
+        window[from].forwarded++;
+        window[to].frames++;
+        segments[from].forwarded_total++;
+        return 1;
+    }
+
+    window[from].filtered++;
+    return from == CAN_BUS_1;
+}
+
+void Gateway_Service(uint32_t now_ms) {
+    if (!enabled) {
+        return;
+    }
+
+    // Bus-off on the second controller: restart once it was seen on two
+    // services in a row (500ms to 1s), no backoff - it only forwards
+    uint8_t tec, rec;
+    bus2_error_state = Board_CAN2GetErrorState(&tec, &rec);
+    if (bus2_error_state != BOARD_CAN_BUS_OFF) {
+        bus2_off_seen = 0;
+    } else if (!bus2_off_seen) {
+        bus2_off_seen = 1;
+    } else {
+        // Whatever waited is stale by now
+        Board_CAN2Restart();
+        tx_queue[CAN_BUS_2].count = 0;
+        bus2_off_seen = 0;
+        bus2_off_count++;
+    }
+
+    uint32_t elapsed = now_ms - window_start;
+    if (elapsed < 1000) {
+        return;
+    }
+    window_start = now_ms;
+
+    // Counters are only touched from the main loop - no interrupt lock
+    for (uint8_t bus = 0; bus < 2; bus++) {
+        SegmentWindow *w = &window[bus];
+        GatewaySegment *s = &segments[bus];
+
+        s->frames_per_s = (uint32_t)w->frames * 1000 / elapsed;
+        s->forwarded_per_s = (uint32_t)w->forwarded * 1000 / elapsed;
+        s->filtered_per_s = (uint32_t)w->filtered * 1000 / elapsed;
+        s->limited_per_s = (uint32_t)w->limited * 1000 / elapsed;
+        s->dropped_per_s = (uint32_t)w->dropped * 1000 / elapsed;
+
+        // Percent of 250kbit/s
+        uint32_t load = (uint32_t)s->frames_per_s * GATEWAY_FRAME_BITS / 2500;
+        s->load_pct = (load > 100) ? 100 : (uint8_t)load;
+
+        memset(w, 0, sizeof(*w));
+    }
+}
+
+const GatewaySegment *Gateway_GetSegment(uint8_t bus) {
+    return &segments[(bus == CAN_BUS_2) ? CAN_BUS_2 : CAN_BUS_1];
+}
+
+uint8_t Gateway_GetBus2ErrorState(void) {
+    return bus2_error_state;
+}
+
+uint16_t Gateway_GetBus2BusOffCount(void) {
+    return bus2_off_count;
+}
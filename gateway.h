@@ -0,0 +1,106 @@
+/*
+ * FILE: gateway.h
+ * CAN Gateway Between Two Bus Segments for MASTERCELL NGX
+ *
+ * With the gateway on, the second CAN controller runs a separate segment
+ * (OEM / engine ECUs) while the first keeps PowerCells, inMOTION and the
+ * MASTERCELL itself. Frames from both controllers go through the same
+ * receive FIFO and dispatcher; the dispatcher offers each one to
+ * Gateway_Route() first, which forwards it to the other segment when a
+ * route allows it. Only what reaches segment 1 is processed locally, so
+ * a frame from segment 2 that is not forwarded is invisible to us.
+ * Frames the MASTERCELL sends itself stay on segment 1.
+ *
+ * The routes (PGN, PGN mask, directions, default rate) are a table in
+ * gateway.c - the EEPROM has no room for PGN lists. The EEPROM selects
+ * which routes are on and their rate limits:
+ *   EEPROM_CFG_GATEWAY      GATEWAY_MODE_ON to run (read at startup)
+ *   EEPROM_GATEWAY_ROUTES   bit n = route n on (0xFF = all)
+ *   EEPROM_GATEWAY_RATES    4 bits per route: GATEWAY_RATE_xxx code,
+ *                           0xF = the table default
+ * A route's rate limit is a minimum interval per direction and source
+ * address, so two ECUs sending the same PGN are limited separately;
+ * frames inside it are dropped, so rate limit only periodic broadcasts.
+ * GATEWAY_RATE_SLOTS senders are tracked at once - beyond that the one
+ * whose interval ran out longest ago gives up its slot.
+ *
+ * Forwarded frames go into a short queue per destination segment that
+ * Gateway_ServiceTx() hands to that controller whenever its buffer is
+ * free, so the dispatcher never waits for either bus. A frame that finds
+ * the queue full is dropped and counted. The route enables and rate codes
+ * sit in the EEPROM tail after the case slots (EEPROM_CASES_END).
+ */
+
+#ifndef GATEWAY_H
+#define GATEWAY_H
+
+#include <xc.h>
+#include <stdint.h>
+#include "j1939.h"
+
+#define GATEWAY_MODE_ON             0x01
+
+// Route directions
+#define GATEWAY_DIR_1_TO_2          0x01
+#define GATEWAY_DIR_2_TO_1          0x02
+#define GATEWAY_DIR_BOTH            0x03
+
+#define GATEWAY_MAX_ROUTES          8
+#define GATEWAY_RATE_SLOTS          16      // Route / direction / source address deadlines
+#define GATEWAY_TX_QUEUE            8       // Frames waiting, per destination segment
+
+// Rate codes (EEPROM_GATEWAY_RATES) - minimum interval between frames
+#define GATEWAY_RATE_NONE           0x0     // Every frame
+#define GATEWAY_RATE_100MS          0x4
+#define GATEWAY_RATE_1S             0x8
+#define GATEWAY_RATE_DEFAULT        0xF
+
+// Bits on the wire of an 8-byte extended frame, with typical stuffing
+#define GATEWAY_FRAME_BITS          130
+
+// Per-segment counters, the rates over the last second
+typedef struct {
+    uint16_t frames_per_s;      // Received plus forwarded into the segment
+    uint8_t load_pct;           // frames_per_s x GATEWAY_FRAME_BITS at 250kbit/s
+    uint16_t forwarded_per_s;   // Received here and forwarded to the other segment
+    uint16_t filtered_per_s;    // Received here, no route
+    uint16_t limited_per_s;     // Received here, dropped by a rate limit
+    uint16_t dropped_per_s;     // Received here, the other segment's queue full
+    uint32_t rx_total;
+    uint32_t forwarded_total;
+} GatewaySegment;
+
+// Function prototypes
+void Gateway_Init(void);                    // After J1939_Init(), starts the second controller if on
+void Gateway_LoadConfig(void);              // Route enables and rates, also on EEPROM writes
+uint8_t Gateway_IsEnabled(void);
+
+/**
+ * Forward a received frame if a route allows it
+ * @param msg Frame from the receive FIFO
+ * @param now_ms system time
+ * @return 1 if the frame is on segment 1 (received there, or forwarded
+ *         to it) and should be dispatched, 0 to drop it
+ */
+uint8_t Gateway_Route(CAN_RxMessage *msg, uint32_t now_ms);
+
+/**
+ * Hand queued frames to their controllers, never waits
+ * Call on every main loop pass
+ */
+void Gateway_ServiceTx(void);
+
+/**
+ * Per-second counters and second controller bus-off recovery
+ * Call every 500ms (housekeeping)
+ */
+void Gateway_Service(uint32_t now_ms);
+
+/**
+ * @param bus CAN_BUS_1 or CAN_BUS_2
+ */
+const GatewaySegment *Gateway_GetSegment(uint8_t bus);
+uint8_t Gateway_GetBus2ErrorState(void);    // BOARD_CAN_ERROR_xxx / BOARD_CAN_BUS_OFF
+uint16_t Gateway_GetBus2BusOffCount(void);
+
+#endif // GATEWAY_H
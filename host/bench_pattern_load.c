@@ -0,0 +1,136 @@
+/*
+ * FILE: host/bench_pattern_load.c
+ * Bus Load of Pattern Frames
+ *
+ *   make -C host bench
+ *
+ * Hazards (IN08) with 0x44 cases (1s ON / 1s OFF) on several PGNs are
+ * run for a minute of simulated time. Every 250ms the pattern timers
+ * advance and the pattern tick branch of TransmitAggregatedMessages()
+ * runs against the aggregated messages, as main.c does. main.c is not
+ * linked, so that branch is repeated below: a pattern message goes out
+ * at a phase edge, or after the keepalive when unchanged. The old
+ * policy, every pattern message on every tick, is run for comparison.
+ * Frames are counted off the simulated bus.
+ */
+
+#include "test_host.h"
+#include "eeprom_cases.h"
+#include "eeprom_init.h"
+#include "j1939.h"
+#include <string.h>
+
+#define HAZARD_INPUT    7           // IN08
+#define HAZARD_PATTERN  0x44        // 1s ON / 1s OFF
+#define HAZARD_SA       0x1E
+#define RUN_TICKS       240         // 60s of 250ms pattern ticks
+
+#define POLICY_EVERY_TICK   0xFE    // Before: no edge detection
+
+typedef struct {
+    uint16_t pgn;
+    uint8_t source_addr;
+    uint8_t data[8];
+    uint8_t ticks_since_sent;
+    BoardCANTxImage tx_image;
+} Slot;
+
+static Slot slots[MAX_UNIQUE_MESSAGES];
+static uint8_t slot_count;
+
+/*
+ * Pattern tick branch of TransmitAggregatedMessages()
+ */
+static void PatternTick(uint8_t keepalive) {
+    AggregatedMessage messages[MAX_UNIQUE_MESSAGES];
+    uint8_t count = EEPROM_GetAggregatedMessages(messages, MAX_UNIQUE_MESSAGES);
+
+    for (uint8_t i = 0; i < count; i++) {
+        Slot *slot = NULL;
+        uint8_t send;
+
+        if (!messages[i].valid || !messages[i].has_pattern) {
+            continue;
+        }
+        for (uint8_t j = 0; j < slot_count; j++) {
+            if (slots[j].pgn == messages[i].pgn &&
+                slots[j].source_addr == messages[i].source_addr) {
+                slot = &slots[j];
+                break;
+            }
+        }
+
+        if (slot == NULL) {
+            slot = &slots[slot_count++];
+            slot->pgn = messages[i].pgn;
+            slot->source_addr = messages[i].source_addr;
+            J1939_EncodeTxImage(messages[i].priority, messages[i].pgn,
+                                messages[i].source_addr, &slot->tx_image);
+            send = 1;
+        } else {
+            if (slot->ticks_since_sent < 0xFF) {
+                slot->ticks_since_sent++;
+            }
+            send = (keepalive == POLICY_EVERY_TICK) ||
+                   memcmp(slot->data, messages[i].data, 8) != 0 ||
+                   (keepalive != 0 && slot->ticks_since_sent >= keepalive);
+        }
+
+        if (send) {
+            J1939_TransmitImage(&slot->tx_image, messages[i].data);
+            memcpy(slot->data, messages[i].data, 8);
+            slot->ticks_since_sent = 0;
+        }
+    }
+}
+
+static uint16_t CountSent(void) {
+    BoardHostFrame frame;
+    uint16_t count = 0;
+
+    while (Board_HostCANSent(BOARD_HOST_CAN1, &frame)) {
+        count++;
+    }
+    return count;
+}
+
+/*
+ * Frames per second over the run, hazards on across pgns PGNs
+ */
+static double Run(uint8_t pgns, uint8_t keepalive) {
+    uint8_t data[8] = { 0x01, 0, 0, 0, 0, 0, 0, 0 };
+    uint32_t frames = 0;
+
+    Test_Reset();
+    J1939_Init();
+    for (uint8_t c = 0; c < pgns; c++) {
+        EEPROM_WriteCase(EEPROM_GetCaseAddress(HAZARD_INPUT, c, 1), 6, 0xFF40 + c,
+                         HAZARD_SA, 0x00, HAZARD_PATTERN, 0, data);
+    }
+    EEPROM_Cases_Init();
+    slot_count = 0;
+
+    EEPROM_HandleInputChange(HAZARD_INPUT, 1);
+    for (uint16_t tick = 0; tick < RUN_TICKS; tick++) {
+        Board_HostAdvanceUs(250000);
+        EEPROM_Pattern_UpdateTimers();
+        PatternTick(keepalive);
+        Board_HostAdvanceUs(1000);
+        frames += CountSent();
+    }
+    return frames / (RUN_TICKS / 4.0);
+}
+
+int main(void) {
+    static const uint8_t pgn_counts[] = { 1, 2, 4 };
+
+    printf("bench_pattern_load: IN08 0x44 hazards, %u s, frames/s\n", RUN_TICKS / 4);
+    printf("  PGNs  every tick  edges only  keepalive 2  keepalive 8\n");
+    for (uint8_t i = 0; i < sizeof(pgn_counts); i++) {
+        uint8_t n = pgn_counts[i];
+
+        printf("  %4u  %10.2f  %10.2f  %11.2f  %11.2f\n", n,
+               Run(n, POLICY_EVERY_TICK), Run(n, 0), Run(n, 2), Run(n, 8));
+    }
+    return 0;
+}
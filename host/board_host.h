@@ -0,0 +1,87 @@
+/*
+ * FILE: host/board_host.h
+ * Simulated Board - Test Hooks
+ *
+ * board_host.c implements board.h on the host. The functions below are
+ * the other side of it: what a test bench does to the board (time, bus
+ * traffic, faults) and what it can observe (frames on the wire, resets).
+ *
+ * Time only moves when something spends it: Board_HostAdvanceUs(), the
+ * __delay_xx() macros, and each Board_CANTxReady() poll (one busy-wait
+ * iteration, BOARD_HOST_POLL_NS). While it moves, the 1ms tick calls
+ * _T1Interrupt(), transmit buffers go out on their bus one frame at a
+ * time in TXPRI order, and SPI2 shifts queued bytes. Interrupt service
+ * routines run when their enable bit is set and never nest, as on the
+ * part where they all share one priority.
+ */
+
+#ifndef BOARD_HOST_H
+#define BOARD_HOST_H
+
+#include <stdint.h>
+
+// Controller index for the bus arguments (matches CAN_BUS_1 / CAN_BUS_2)
+#define BOARD_HOST_CAN1         0
+#define BOARD_HOST_CAN2         1
+
+// One busy-wait iteration on a transmit buffer (about 8 cycles at 16 MIPS)
+#define BOARD_HOST_POLL_NS      500
+
+// 250kbit/s: 4us per bit. Frame length with worst-case bit stuffing.
+#define BOARD_HOST_BIT_NS       4000
+#define BOARD_HOST_FRAME_BITS(dlc)  (67 + 8 * (dlc) + (34 + 8 * (dlc)) / 4)
+
+// A frame that completed on a simulated bus
+typedef struct {
+    uint32_t id;
+    uint8_t dlc;
+    uint8_t data[8];
+    uint8_t buffer;             // Transmit buffer it was sent from
+    uint64_t queued_ns;         // When TXREQ was set
+    uint64_t sent_ns;           // End of frame
+} BoardHostFrame;
+
+/**
+ * Power-on state: erased NVM and staging flash, empty buses, time 0
+ */
+void Board_HostReset(void);
+
+/**
+ * Let time pass (ticks, bus traffic and SPI shifting happen meanwhile)
+ */
+void Board_HostAdvanceUs(uint32_t us);
+void Board_HostAdvanceNs(uint32_t ns);
+uint64_t Board_HostTimeNs(void);
+
+/**
+ * Deliver a frame to a controller's receive buffers
+ * @return 1 if a buffer took it, 0 if both were full (receive overflow)
+ */
+uint8_t Board_HostCANInject(uint8_t bus, uint32_t id, uint8_t dlc, const uint8_t *data);
+uint16_t Board_HostCANRxOverflows(uint8_t bus);
+
+/**
+ * Take the oldest frame the controller put on the bus
+ * @return 1 if there was one
+ */
+uint8_t Board_HostCANSent(uint8_t bus, BoardHostFrame *frame);
+
+/**
+ * Nobody acknowledges (0): frames stay pending, as on an open bus
+ */
+void Board_HostCANSetAck(uint8_t bus, uint8_t ack);
+
+/**
+ * Force the error counters and fault confinement state
+ * @param state BOARD_CAN_ERROR_xxx / BOARD_CAN_BUS_OFF
+ */
+void Board_HostCANSetErrorState(uint8_t bus, uint8_t state, uint8_t tec, uint8_t rec);
+
+void Board_HostSetResetCause(uint8_t cause);
+uint16_t Board_HostResetCount(void);        // Board_Reset() calls
+
+// Data EEPROM and program flash contents, for checks and for seeding
+uint16_t *Board_HostNVM(void);
+uint8_t *Board_HostFlashRow(uint32_t address);
+
+#endif // BOARD_HOST_H
@@ -0,0 +1,19 @@
+/*
+ * FILE: host/libpic30.h
+ * Host Stand-In for the XC16 Runtime Header
+ *
+ * Busy-wait delays advance the simulated clock instead of spinning
+ * (board_host.c), so code that waits on hardware still sees time pass.
+ */
+
+#ifndef HOST_LIBPIC30_H
+#define HOST_LIBPIC30_H
+
+#include <stdint.h>
+
+void Board_HostDelayUs(uint32_t us);
+
+#define __delay_us(us)  Board_HostDelayUs(us)
+#define __delay_ms(ms)  Board_HostDelayUs((uint32_t)(ms) * 1000)
+
+#endif // HOST_LIBPIC30_H
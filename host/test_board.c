@@ -0,0 +1,125 @@
+/*
+ * FILE: host/test_board.c
+ * Simulated Board Checks
+ *
+ * The behaviour the other host tests rely on: tick, NVM and staging
+ * flash semantics, and frames on the simulated CAN buses.
+ */
+
+#include "test_host.h"
+#include <string.h>
+
+static void TestTick(void) {
+    Test_Reset();
+
+    Board_HostAdvanceUs(10500);
+    CHECK(system_time_ms == 10);
+    CHECK(Board_TickCount() == 500 / BOARD_TICK_US);
+
+    // Masked tick: counted once unmasked, count runs on past the period
+    IEC0bits.T1IE = 0;
+    Board_HostAdvanceUs(600);
+    CHECK(system_time_ms == 10);
+    CHECK(Board_TickCount() == BOARD_TICK_COUNTS + 100 / BOARD_TICK_US);
+    IEC0bits.T1IE = 1;
+    Board_HostAdvanceUs(1);
+    CHECK(system_time_ms == 11);
+}
+
+static void TestNVM(void) {
+    Test_Reset();
+
+    CHECK(Board_NVMReadWord(0x0010) == 0xFFFF);
+    CHECK(Board_NVMProgramWord(0x0010, 0x1234));
+    CHECK(Board_NVMReadWord(0x0010) == 0x1234);
+
+    // Programming without an erase only clears bits
+    CHECK(Board_NVMProgramWord(0x0010, 0x00FF));
+    CHECK(Board_NVMReadWord(0x0010) == 0x0034);
+    CHECK(Board_NVMEraseWord(0x0010));
+    CHECK(Board_NVMReadWord(0x0010) == 0xFFFF);
+
+    CHECK(!Board_NVMProgramWord(0x0011, 0));
+    CHECK(!Board_NVMEraseWord(BOARD_NVM_SIZE));
+}
+
+static void TestFlash(void) {
+    uint8_t row[BOARD_FLASH_ROW_BYTES];
+    uint8_t back[BOARD_FLASH_ROW_BYTES];
+
+    Test_Reset();
+
+    for (uint8_t i = 0; i < BOARD_FLASH_ROW_BYTES; i++) {
+        row[i] = i;
+    }
+
+    CHECK(Board_FlashEraseRow(BOARD_FLASH_STAGING));
+    CHECK(Board_FlashWriteRow(BOARD_FLASH_STAGING, row));
+    Board_FlashReadRow(BOARD_FLASH_STAGING, back);
+    CHECK(memcmp(row, back, sizeof(row)) == 0);
+
+    // Application, boot block and unaligned rows are refused
+    CHECK(!Board_FlashEraseRow(BOARD_FLASH_STAGING - BOARD_FLASH_ROW_PC));
+    CHECK(!Board_FlashEraseRow(BOARD_FLASH_BOOT));
+    CHECK(!Board_FlashWriteRow(BOARD_FLASH_STAGING + 2, row));
+}
+
+static void TestCAN(void) {
+    const uint8_t data[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    BoardCANTxImage image;
+    BoardHostFrame frame;
+    uint32_t id;
+    uint8_t rx[8];
+    uint8_t dlc;
+
+    Test_Reset();
+    Board_CANInit();
+
+    // Transmit: on the wire one frame time later, identifier intact
+    Board_CANEncode(0x18FF0180, &image);
+    CHECK(Board_CANTxReady());
+    Board_CANTransmitImage(&image, data);
+    CHECK(!Board_CANTxReady());
+    Board_HostAdvanceUs(1000);
+    CHECK(Board_CANTxReady());
+    CHECK(Board_HostCANSent(BOARD_HOST_CAN1, &frame));
+    CHECK(frame.id == 0x18FF0180 && frame.dlc == 8);
+    CHECK(memcmp(frame.data, data, 8) == 0);
+    CHECK(frame.sent_ns - frame.queued_ns ==
+          (uint64_t)BOARD_HOST_FRAME_BITS(8) * BOARD_HOST_BIT_NS);
+    CHECK(!Board_HostCANSent(BOARD_HOST_CAN1, &frame));
+
+    // No acknowledge: stays pending
+    Board_HostCANSetAck(BOARD_HOST_CAN1, 0);
+    Board_CANTransmitImage(&image, data);
+    Board_HostAdvanceUs(5000);
+    CHECK(!Board_CANTxReady());
+    Board_HostCANSetAck(BOARD_HOST_CAN1, 1);
+    Board_HostAdvanceUs(1000);
+    CHECK(Board_CANTxReady());
+    CHECK(Board_HostCANSent(BOARD_HOST_CAN1, &frame));
+
+    // Receive: two hardware buffers, the third frame overflows
+    CHECK(Board_HostCANInject(BOARD_HOST_CAN1, 0x18FEEE00, 8, data));
+    CHECK(Board_HostCANInject(BOARD_HOST_CAN1, 0x18FEEF00, 8, data));
+    CHECK(!Board_HostCANInject(BOARD_HOST_CAN1, 0x18FEF000, 8, data));
+    CHECK(Board_HostCANRxOverflows(BOARD_HOST_CAN1) == 1);
+    CHECK(Board_CANReceive(&id, rx, &dlc) && id == 0x18FEEE00);
+    CHECK(Board_CANReceive(&id, rx, &dlc) && id == 0x18FEEF00);
+    CHECK(!Board_CANReceive(&id, rx, &dlc));
+
+    // Second controller is a separate bus
+    Board_CAN2Init();
+    Board_CAN2TransmitImage(&image, data);
+    Board_HostAdvanceUs(1000);
+    CHECK(Board_HostCANSent(BOARD_HOST_CAN2, &frame));
+    CHECK(!Board_HostCANSent(BOARD_HOST_CAN1, &frame));
+}
+
+int main(void) {
+    TestTick();
+    TestNVM();
+    TestFlash();
+    TestCAN();
+    return Test_Done("test_board");
+}
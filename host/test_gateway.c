@@ -0,0 +1,206 @@
+/*
+ * FILE: host/test_gateway.c
+ * Gateway Between the Two Simulated Segments
+ *
+ * Frames are injected on either bus and dispatched the way main.c does
+ * (receive FIFO, Gateway_Route, Gateway_ServiceTx every pass). Checks
+ * routing, the rate limit per source address, and that a busy segment
+ * on either side neither stalls the dispatcher nor reorders what it
+ * forwards.
+ */
+
+#include "test_host.h"
+#include "gateway.h"
+#include "eeprom_config.h"
+#include <string.h>
+
+#define EEC1_ID(sa)     (0x0CF00400UL | (sa))       // Route 0, 100ms
+#define REQUEST_ID(n)   (0x18EAFF00UL | (n))        // Route 7, 1 -> 2, unlimited
+#define DM1_ID          0x18FECA00UL                // Route 5, both ways, unlimited
+#define UNROUTED_ID     0x18FF1000UL
+
+static uint16_t dispatched = 0;
+static uint32_t route_ns_max = 0;
+
+// Per-second counters are taken over [window, window + 1000ms)
+static uint32_t window = 0;
+
+/*
+ * One main loop pass: dispatch what was received, then the TX queue
+ */
+static void Pass(void) {
+    CAN_RxMessage batch[CAN_RX_BATCH_SIZE];
+    uint8_t count;
+
+    while ((count = J1939_ReceiveBatch(batch, CAN_RX_BATCH_SIZE)) > 0) {
+        for (uint8_t i = 0; i < count; i++) {
+            uint64_t start = Board_HostTimeNs();
+
+            if (Gateway_Route(&batch[i], system_time_ms)) {
+                dispatched++;
+            }
+            if (Board_HostTimeNs() - start > route_ns_max) {
+                route_ns_max = Board_HostTimeNs() - start;
+            }
+        }
+    }
+    Gateway_ServiceTx();
+}
+
+static void Inject(uint8_t bus, uint32_t id, uint8_t seq) {
+    uint8_t data[8] = { seq, 0, 0, 0, 0, 0, 0, 0 };
+    Board_HostCANInject(bus, id, 8, data);
+}
+
+static uint16_t CountSent(uint8_t bus, uint32_t id) {
+    BoardHostFrame frame;
+    uint16_t count = 0;
+
+    while (Board_HostCANSent(bus, &frame)) {
+        if (frame.id == id) {
+            count++;
+        }
+    }
+    return count;
+}
+
+static void Setup(void) {
+    Test_Reset();
+    EEPROM_Config_WriteByte(EEPROM_CFG_GATEWAY, GATEWAY_MODE_ON);
+    EEPROM_Config_Load();
+    J1939_Init();
+    Gateway_Init();
+    dispatched = 0;
+    route_ns_max = 0;
+
+    // Start a counter window of its own, well away from the test's clock
+    window += 1000000;
+    Gateway_Service(window);
+}
+
+static void TestRouting(void) {
+    Setup();
+    CHECK(Gateway_IsEnabled() && Board_CAN2Running());
+
+    // Segment 2 frames reach us only through a route
+    Inject(BOARD_HOST_CAN2, EEC1_ID(0x00), 0);
+    Inject(BOARD_HOST_CAN2, UNROUTED_ID, 0);
+    Pass();
+    CHECK(dispatched == 1);
+
+    // Segment 1 frames are always ours, forwarded only through a route
+    Inject(BOARD_HOST_CAN1, REQUEST_ID(0x80), 0);
+    Inject(BOARD_HOST_CAN1, UNROUTED_ID, 0);
+    Pass();
+    Board_HostAdvanceUs(2000);
+    Pass();
+    CHECK(dispatched == 3);
+    CHECK(CountSent(BOARD_HOST_CAN1, EEC1_ID(0x00)) == 1);
+    CHECK(CountSent(BOARD_HOST_CAN2, REQUEST_ID(0x80)) == 1);
+}
+
+static void TestRatePerSource(void) {
+    Setup();
+
+    // Two engines on segment 2 send EEC1 every 10ms for one second: each
+    // gets its own 100ms limit
+    for (uint16_t ms = 0; ms < 1000; ms += 10) {
+        Inject(BOARD_HOST_CAN2, EEC1_ID(0x00), 0);
+        Pass();
+        Inject(BOARD_HOST_CAN2, EEC1_ID(0x01), 0);
+        Pass();
+        Board_HostAdvanceUs(10000);
+        Pass();
+    }
+
+    // 10 each out of 100 each; the log only holds the last 64 frames
+    CHECK(Gateway_GetSegment(CAN_BUS_2)->forwarded_total == 20);
+    CHECK(CountSent(BOARD_HOST_CAN1, EEC1_ID(0x01)) == 10);
+    Gateway_Service(window + 1000);
+    CHECK(Gateway_GetSegment(CAN_BUS_2)->limited_per_s == 180);
+}
+
+static void TestBusyBus2(void) {
+    BoardHostFrame frame;
+    uint8_t in_order = 1;
+    uint8_t next = 0;
+
+    Setup();
+
+    // Segment 2 does not acknowledge: the dispatcher must not wait on it
+    Board_HostCANSetAck(BOARD_HOST_CAN2, 0);
+    for (uint8_t n = 0; n < 20; n++) {
+        Inject(BOARD_HOST_CAN1, REQUEST_ID(n), n);
+        Pass();
+        Board_HostAdvanceUs(200);
+    }
+
+    // Every frame still dispatched locally, none waited for segment 2
+    CHECK(dispatched == 20);
+    CHECK(route_ns_max < 5000);
+    CHECK(Gateway_GetSegment(CAN_BUS_1)->forwarded_total == 1 + GATEWAY_TX_QUEUE);
+
+    // Once it acknowledges, the queue empties in order
+    Board_HostCANSetAck(BOARD_HOST_CAN2, 1);
+    for (uint8_t i = 0; i < 20; i++) {
+        Board_HostAdvanceUs(1000);
+        Pass();
+    }
+    while (Board_HostCANSent(BOARD_HOST_CAN2, &frame)) {
+        if (frame.data[0] != next) {
+            in_order = 0;
+        }
+        next++;
+    }
+    // One frame was in the controller, a full queue behind it, the rest
+    // dropped and counted
+    CHECK(next == 1 + GATEWAY_TX_QUEUE);
+    CHECK(in_order);
+    Gateway_Service(window + 1000);
+    CHECK(Gateway_GetSegment(CAN_BUS_1)->dropped_per_s == 20 - 1 - GATEWAY_TX_QUEUE);
+}
+
+static void TestBusyBus1(void) {
+    BoardHostFrame frame;
+    uint8_t in_order = 1;
+    uint8_t next = 0;
+
+    Setup();
+
+    // Segment 1 does not acknowledge: forwarding into it must not wait
+    Board_HostCANSetAck(BOARD_HOST_CAN1, 0);
+    for (uint8_t n = 0; n < 20; n++) {
+        Inject(BOARD_HOST_CAN2, DM1_ID, n);
+        Pass();
+        Board_HostAdvanceUs(200);
+    }
+
+    // Only what reached segment 1 is dispatched: one frame in the
+    // controller, a full queue behind it
+    CHECK(dispatched == 1 + GATEWAY_TX_QUEUE);
+    CHECK(route_ns_max < 5000);
+
+    Board_HostCANSetAck(BOARD_HOST_CAN1, 1);
+    for (uint8_t i = 0; i < 20; i++) {
+        Board_HostAdvanceUs(1000);
+        Pass();
+    }
+    while (Board_HostCANSent(BOARD_HOST_CAN1, &frame)) {
+        if (frame.data[0] != next) {
+            in_order = 0;
+        }
+        next++;
+    }
+    CHECK(next == 1 + GATEWAY_TX_QUEUE);
+    CHECK(in_order);
+    Gateway_Service(window + 1000);
+    CHECK(Gateway_GetSegment(CAN_BUS_2)->dropped_per_s == 20 - 1 - GATEWAY_TX_QUEUE);
+}
+
+int main(void) {
+    TestRouting();
+    TestRatePerSource();
+    TestBusyBus2();
+    TestBusyBus1();
+    return Test_Done("test_gateway");
+}
@@ -0,0 +1,38 @@
+/*
+ * FILE: host/test_host.c
+ * Host Test Support Implementation
+ */
+
+#include "test_host.h"
+#include "screens.h"
+
+uint16_t test_checks = 0;
+uint16_t test_failures = 0;
+
+// main.c
+volatile uint32_t system_time_ms = 0;
+
+void _T1Interrupt(void) {
+    system_time_ms++;
+}
+
+const uint8_t* FindPreviousBroadcast(uint16_t pgn, uint8_t source_addr) {
+    (void)pgn;
+    (void)source_addr;
+    return NULL;
+}
+
+uint16_t GetBroadcastVersion(void) {
+    return 0;
+}
+
+void Test_Reset(void) {
+    Board_HostReset();
+    system_time_ms = 0;
+    Board_InitTick();
+}
+
+int Test_Done(const char *name) {
+    printf("%s: %u checks, %u failed\n", name, test_checks, test_failures);
+    return test_failures ? 1 : 0;
+}
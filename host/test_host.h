@@ -0,0 +1,44 @@
+/*
+ * FILE: host/test_host.h
+ * Host Test Support
+ *
+ * Each test_xxx.c is one program built against the application modules
+ * and board_host.c. test_host.c stands in for what main.c provides to
+ * the other modules (system tick, broadcast history) so main.c itself
+ * is not linked.
+ */
+
+#ifndef TEST_HOST_H
+#define TEST_HOST_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "board.h"
+#include "board_host.h"
+
+// main.c's tick, advanced by the simulated Timer1 interrupt
+extern volatile uint32_t system_time_ms;
+
+extern uint16_t test_checks;
+extern uint16_t test_failures;
+
+#define CHECK(cond) do {                                                \
+        test_checks++;                                                  \
+        if (!(cond)) {                                                  \
+            test_failures++;                                            \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+        }                                                               \
+    } while (0)
+
+/**
+ * Simulated power-on, tick running at system_time_ms = 0
+ */
+void Test_Reset(void);
+
+/**
+ * Print the summary
+ * @return Exit status for main()
+ */
+int Test_Done(const char *name);
+
+#endif // TEST_HOST_H
@@ -0,0 +1,126 @@
+/*
+ * FILE: host/test_priority_tx.c
+ * Priority Transmit Buffer
+ *
+ * One-button and fast path frames go out of the priority buffer
+ * (Board_CANTransmitPriority) while the aggregated frames use the normal
+ * one. Checks arbitration between the two, that an older frame for the
+ * same identifier cannot follow a newer one, and the one-button bound
+ * from an edge at the start of a scan with the normal buffer busy.
+ */
+
+#include "test_host.h"
+#include "j1939.h"
+#include "inputs.h"
+#include <string.h>
+
+#define AGGREGATED_ID   0x18FF2080
+#define PRIORITY_ID     0x0CFF2180
+
+static BoardCANTxImage aggregated;
+static BoardCANTxImage priority;
+
+static void Setup(void) {
+    Test_Reset();
+    J1939_Init();
+    Board_CANEncode(AGGREGATED_ID, &aggregated);
+    Board_CANEncode(PRIORITY_ID, &priority);
+}
+
+static void TestArbitration(void) {
+    const uint8_t data[8] = { 0 };
+    BoardHostFrame frame;
+
+    Setup();
+
+    // Both waiting for the bus: the priority buffer wins
+    Board_HostCANSetAck(BOARD_HOST_CAN1, 0);
+    Board_CANTransmitImage(&aggregated, data);
+    Board_CANTransmitPriority(&priority, data);
+    Board_HostCANSetAck(BOARD_HOST_CAN1, 1);
+    Board_HostAdvanceUs(2000);
+
+    CHECK(Board_HostCANSent(BOARD_HOST_CAN1, &frame));
+    CHECK(frame.id == PRIORITY_ID && frame.buffer == 2);
+    CHECK(Board_HostCANSent(BOARD_HOST_CAN1, &frame));
+    CHECK(frame.id == AGGREGATED_ID && frame.buffer == 0);
+}
+
+static void TestSupersede(void) {
+    const uint8_t old_data[8] = { 0x01 };
+    const uint8_t new_data[8] = { 0x03 };
+    BoardHostFrame frame;
+
+    Setup();
+
+    // Older frame of the same PGN/SA still waiting: withdrawn, the newer
+    // one carries the whole slot
+    Board_HostCANSetAck(BOARD_HOST_CAN1, 0);
+    Board_CANTransmitImage(&priority, old_data);
+    Board_CANTransmitPriority(&priority, new_data);
+    Board_HostCANSetAck(BOARD_HOST_CAN1, 1);
+    Board_HostAdvanceUs(2000);
+
+    CHECK(Board_HostCANSent(BOARD_HOST_CAN1, &frame));
+    CHECK(frame.data[0] == 0x03);
+    CHECK(!Board_HostCANSent(BOARD_HOST_CAN1, &frame));
+    CHECK(Board_CANTxReady());
+
+    // Already on the wire: it goes first, the newer one follows
+    Board_CANTransmitImage(&priority, old_data);
+    Board_HostAdvanceUs(10);
+    Board_CANTransmitPriority(&priority, new_data);
+    Board_HostAdvanceUs(2000);
+
+    CHECK(Board_HostCANSent(BOARD_HOST_CAN1, &frame) && frame.data[0] == 0x01);
+    CHECK(Board_HostCANSent(BOARD_HOST_CAN1, &frame) && frame.data[0] == 0x03);
+}
+
+static void TestOneButtonBound(void) {
+    uint8_t data[8] = { 0 };
+    BoardHostFrame frame;
+    uint64_t sent_ns = 0;
+    uint8_t position = 0;
+    uint8_t frames = 0;
+
+    Setup();
+    Inputs_Init();
+
+    // Worst case: the edge is taken on the first mux channel, the rest of
+    // the scan runs, and the last pass left the normal buffer busy
+    uint32_t edge_ms = system_time_ms;
+    Inputs_Scan();
+    J1939_TransmitImage(&aggregated, data);
+
+    // SendOneButtonFrames, then the aggregated pass carries on
+    data[0] = 0x01;
+    J1939_TransmitPriority(&priority, data);
+    CHECK(system_time_ms - edge_ms <= ONE_BUTTON_TX_BOUND_MS);
+    Inputs_OneButtonFrameSent(edge_ms);
+    data[0] = 0;
+    for (uint8_t i = 0; i < 8; i++) {
+        J1939_TransmitImage(&aggregated, data);
+    }
+    Board_HostAdvanceUs(5000);
+
+    while (Board_HostCANSent(BOARD_HOST_CAN1, &frame)) {
+        frames++;
+        if (frame.id == PRIORITY_ID) {
+            sent_ns = frame.sent_ns;
+            position = frames;
+        }
+    }
+
+    // Only the frame already on the wire went ahead of it
+    CHECK(frames == 10);
+    CHECK(position == 2);
+    CHECK(sent_ns <= ((uint64_t)edge_ms + ONE_BUTTON_TX_BOUND_MS) * 1000000);
+    CHECK(Inputs_GetOneButtonLateCount() == 0);
+}
+
+int main(void) {
+    TestArbitration();
+    TestSupersede();
+    TestOneButtonBound();
+    return Test_Done("test_priority_tx");
+}
@@ -0,0 +1,225 @@
+/*
+ * FILE: host/test_timed.c
+ * Timed Cases
+ *
+ * Inputs are switched on the simulated mux pins, scanned and their edges
+ * dispatched the way main.c does; the wheel is advanced one 250ms tick
+ * at a time. Each mode is checked against the aggregated payload of its
+ * PGN, and an edited timed case is reloaded while its deadline runs,
+ * next to another one that must not notice.
+ */
+
+#include "test_host.h"
+#include "eeprom_cases.h"
+#include "eeprom_config.h"
+#include "eeprom_init.h"
+#include "inputs.h"
+#include <string.h>
+
+#define TIMED_SA        0x1E
+#define TIMED_PGN       0xFF50
+#define OTHER_PGN       0xFF51
+#define NONE            0xFF
+
+// IN10 is on MUX03 (RD8), IN01 on MUX01 (RD7). The host port does not
+// follow the mux channel, so the rest of each mux switches with it;
+// none of those inputs has a case here.
+#define IN10_PIN        (1 << 8)
+#define IN01_PIN        (1 << 7)
+
+static uint8_t prev_states[INPUT_COUNT];
+
+/*
+ * Switch an input and run the scans to its debounced edge, then hand
+ * every edge to the cases as the main loop does
+ */
+static void Switch(uint16_t pin, uint8_t on) {
+    if (on) {
+        PORTD &= ~pin;
+    } else {
+        PORTD |= pin;
+    }
+    for (uint8_t scan = 0; scan <= DEBOUNCE_SCANS; scan++) {
+        Inputs_Scan();
+    }
+    for (uint8_t i = 0; i < INPUT_COUNT; i++) {
+        uint8_t state = Inputs_GetState(i);
+
+        if (state != prev_states[i]) {
+            prev_states[i] = state;
+            EEPROM_HandleInputChange(i, state);
+        }
+    }
+}
+
+static void Tick(uint8_t ticks) {
+    while (ticks--) {
+        EEPROM_Timed_Tick();
+    }
+}
+
+/*
+ * Byte 0 of what the aggregated pass would send on pgn (NONE if nothing),
+ * then the clearing cases go as they do after a transmit
+ */
+static uint8_t Payload(uint16_t pgn) {
+    AggregatedMessage messages[MAX_UNIQUE_MESSAGES];
+    uint8_t count = EEPROM_GetAggregatedMessages(messages, MAX_UNIQUE_MESSAGES);
+    uint8_t payload = NONE;
+
+    for (uint8_t i = 0; i < count; i++) {
+        if (messages[i].valid && messages[i].pgn == pgn && messages[i].source_addr == TIMED_SA) {
+            payload = messages[i].data[0];
+        }
+    }
+    EEPROM_RemoveMarkedCases();
+    return payload;
+}
+
+static void WriteTimed(uint8_t input, uint16_t pgn, uint8_t mode, uint8_t duration) {
+    uint8_t data[8] = { 0x01, 0, 0, 0, 0, 0, 0, 0 };
+    uint16_t address = EEPROM_GetCaseAddress(input, 0, 1);
+
+    EEPROM_WriteCase(address, 6, pgn, TIMED_SA, CONFIG_TIMED_VALUE, 0x00, 0, data);
+    EEPROM_Config_WriteByte(address + CASE_OFFSET_TIMED_MODE, mode);
+    EEPROM_Config_WriteByte(address + CASE_OFFSET_TIMED_DURATION, duration);
+}
+
+static void Setup(uint8_t mode, uint8_t duration) {
+    Test_Reset();
+    PORTD = 0xFFFF;
+    PORTB = 0xFFFF;
+    PORTC = 0xFFFF;
+    Inputs_Init();
+    memset(prev_states, 0, sizeof(prev_states));
+
+    WriteTimed(IN10, TIMED_PGN, mode, duration);
+    EEPROM_Cases_Init();
+}
+
+static void TestDelayOn(void) {
+    Setup(TIMED_MODE_DELAY_ON, 4);
+
+    // Released before the delay: never on
+    Switch(IN10_PIN, 1);
+    Tick(3);
+    CHECK(Payload(TIMED_PGN) == NONE);
+    Switch(IN10_PIN, 0);
+    Tick(4);
+    CHECK(Payload(TIMED_PGN) == NONE);
+    CHECK(EEPROM_TimedCasesPending() == 0);
+
+    // Held: on at the fourth tick, off with the release
+    Switch(IN10_PIN, 1);
+    Tick(3);
+    CHECK(Payload(TIMED_PGN) == NONE);
+    Tick(1);
+    CHECK(EEPROM_TimedCasesChanged());
+    CHECK(Payload(TIMED_PGN) == 0x01);
+    Switch(IN10_PIN, 0);
+    CHECK(Payload(TIMED_PGN) == 0x00);
+    CHECK(Payload(TIMED_PGN) == NONE);
+}
+
+static void TestDelayOff(void) {
+    Setup(TIMED_MODE_DELAY_OFF, 4);
+
+    // On with the press, held on for the duration after the release
+    Switch(IN10_PIN, 1);
+    CHECK(Payload(TIMED_PGN) == 0x01);
+    Tick(8);
+    CHECK(Payload(TIMED_PGN) == 0x01);
+    Switch(IN10_PIN, 0);
+    Tick(3);
+    CHECK(Payload(TIMED_PGN) == 0x01);
+
+    // Pressed again before it ran out: the deadline goes
+    Switch(IN10_PIN, 1);
+    Tick(4);
+    CHECK(Payload(TIMED_PGN) == 0x01);
+    CHECK(EEPROM_TimedCasesPending() == 0);
+
+    Switch(IN10_PIN, 0);
+    Tick(4);
+    CHECK(Payload(TIMED_PGN) == 0x00);
+    CHECK(Payload(TIMED_PGN) == NONE);
+}
+
+static void TestToggle(void) {
+    Setup(TIMED_MODE_TOGGLE, 0);
+
+    Switch(IN10_PIN, 1);
+    Switch(IN10_PIN, 0);
+    Tick(20);
+    CHECK(Payload(TIMED_PGN) == 0x01);
+
+    Switch(IN10_PIN, 1);
+    CHECK(Payload(TIMED_PGN) == 0x00);
+    Switch(IN10_PIN, 0);
+    CHECK(Payload(TIMED_PGN) == NONE);
+    CHECK(EEPROM_TimedCasesPending() == 0);
+}
+
+static void TestOneShot(void) {
+    // Duration in seconds: 2s = 8 ticks
+    Setup(TIMED_MODE_ONE_SHOT | TIMED_SCALE_SECONDS, 2);
+
+    Switch(IN10_PIN, 1);
+    Switch(IN10_PIN, 0);
+    Tick(5);
+    CHECK(Payload(TIMED_PGN) == 0x01);
+
+    // Not retriggered while it runs
+    Switch(IN10_PIN, 1);
+    Tick(3);
+    CHECK(Payload(TIMED_PGN) == 0x00);
+    Switch(IN10_PIN, 0);
+    CHECK(Payload(TIMED_PGN) == NONE);
+}
+
+static void TestReloadMidDeadline(void) {
+    uint16_t address;
+
+    Setup(TIMED_MODE_DELAY_ON, 8);
+    WriteTimed(IN01, OTHER_PGN, TIMED_MODE_ONE_SHOT, 6);
+    EEPROM_Cases_Init();
+    address = EEPROM_GetCaseAddress(IN10, 0, 1);
+
+    // IN01's pulse and IN10's delay both running
+    Switch(IN01_PIN, 1);
+    Switch(IN10_PIN, 1);
+    Tick(3);
+    CHECK(EEPROM_TimedCasesPending() == 2);
+
+    // The tool shortens IN10's delay to 4 while it is held: the case is
+    // reloaded on its last byte and the delay restarts from the edit
+    EEPROM_Config_WriteByte(address + CASE_OFFSET_TIMED_DURATION, 4);
+    CHECK(EEPROM_Cases_ApplyWrite(address + CASE_OFFSET_TIMED_DURATION) == 0);
+    EEPROM_Cases_ApplyWrite(address + CASE_SIZE - 1);
+    CHECK(EEPROM_TimedCasesPending() == 2);
+
+    Tick(3);
+    CHECK(Payload(OTHER_PGN) == 0x00);      // IN01's pulse ended on time
+    CHECK(Payload(TIMED_PGN) == NONE);
+    Tick(1);
+    CHECK(Payload(TIMED_PGN) == 0x01);
+    CHECK(EEPROM_TimedCasesPending() == 0);
+
+    // Edited to no longer be timed: cleared, and a plain case from then on
+    EEPROM_Config_WriteByte(address + CASE_OFFSET_CONFIG, 0x00);
+    EEPROM_Cases_ApplyWrite(address + CASE_OFFSET_CONFIG);
+    EEPROM_Cases_ApplyWrite(address + CASE_SIZE - 1);
+    CHECK(Payload(TIMED_PGN) == 0x00);
+    Switch(IN10_PIN, 0);
+    Switch(IN10_PIN, 1);
+    CHECK(Payload(TIMED_PGN) == 0x01);
+}
+
+int main(void) {
+    TestDelayOn();
+    TestDelayOff();
+    TestToggle();
+    TestOneShot();
+    TestReloadMidDeadline();
+    return Test_Done("test_timed");
+}
@@ -0,0 +1,246 @@
+/*
+ * FILE: host/test_update.c
+ * Firmware Update - Host Flasher Against the Simulated Node
+ *
+ * Plays the flashing tool: START, blocks over the transport protocol
+ * (RTS, then DT packets for each CTS until the end-of-message
+ * acknowledge), COMMIT. Checks the replies, the staged rows and the
+ * install record, and that the node keeps running - there is no boot
+ * block to reset into. Also prints the frames and bus time a full-size
+ * image takes.
+ */
+
+#include "test_host.h"
+#include "update.h"
+#include "eeprom_config.h"
+#include <string.h>
+
+#define NODE_SA         0x80
+#define TOOL_SA         0xF9
+#define IMAGE_ROWS      6
+
+static uint8_t image[UPDATE_IMAGE_MAX_ROWS][BOARD_FLASH_ROW_BYTES];
+
+// Frames each way, for the update time
+static uint32_t tool_frames = 0;
+static uint32_t node_frames = 0;
+
+static uint32_t Crc32(const uint8_t *data, uint32_t length) {
+    uint32_t value = 0xFFFFFFFFUL;
+
+    while (length--) {
+        value ^= *data++;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            value = (value & 1) ? (value >> 1) ^ 0xEDB88320UL : value >> 1;
+        }
+    }
+    return value ^ 0xFFFFFFFFUL;
+}
+
+static void Send(uint16_t pgn, const uint8_t data[8]) {
+    CAN_RxMessage msg;
+
+    msg.id = (6UL << 26) | ((uint32_t)pgn << 8) | TOOL_SA;
+    msg.dlc = 8;
+    msg.bus = CAN_BUS_1;
+    msg.valid = 1;
+    memcpy(msg.data, data, 8);
+    tool_frames++;
+    Update_ProcessMessage(&msg, system_time_ms);
+}
+
+/*
+ * Next frame the node sent to the tool on pgn, 0 if none
+ */
+static uint8_t Receive(uint16_t pgn, uint8_t data[8]) {
+    BoardHostFrame frame;
+
+    Board_HostAdvanceUs(2000);
+    while (Board_HostCANSent(BOARD_HOST_CAN1, &frame)) {
+        node_frames++;
+        if (((frame.id >> 8) & 0xFFFF) == (pgn | TOOL_SA) && (frame.id & 0xFF) == NODE_SA) {
+            memcpy(data, frame.data, 8);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Single-frame command, returns the reply status (0xFF = no reply)
+ */
+static uint8_t Command(const uint8_t data[8]) {
+    uint8_t reply[8];
+
+    Send(UPDATE_PGN | NODE_SA, data);
+    if (!Receive(UPDATE_PGN, reply) || reply[0] != (data[0] | UPDATE_REPLY)) {
+        return 0xFF;
+    }
+    return reply[1];
+}
+
+static uint8_t Start(uint16_t rows, uint32_t crc) {
+    const uint8_t data[8] = {
+        UPDATE_CMD_START, rows & 0xFF, rows >> 8,
+        crc & 0xFF, (crc >> 8) & 0xFF, (crc >> 16) & 0xFF, crc >> 24, 0xFF
+    };
+    return Command(data);
+}
+
+static uint8_t Commit(void) {
+    const uint8_t data[8] = { UPDATE_CMD_COMMIT, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+    return Command(data);
+}
+
+/*
+ * One block over TP, returns the BLOCK reply status (0xFF = no reply)
+ */
+static uint8_t Block(uint16_t first, uint8_t rows) {
+    static uint8_t message[J1939_TP_MAX_SIZE];
+    uint16_t size = 3 + rows * BOARD_FLASH_ROW_BYTES;
+    uint8_t packets = (size + 6) / 7;
+    uint8_t frame[8];
+
+    message[0] = UPDATE_CMD_BLOCK;
+    message[1] = first & 0xFF;
+    message[2] = first >> 8;
+    memcpy(&message[3], image[first], rows * BOARD_FLASH_ROW_BYTES);
+
+    const uint8_t rts[8] = {
+        J1939_TP_RTS, size & 0xFF, size >> 8, packets, 0xFF,
+        UPDATE_PGN & 0xFF, UPDATE_PGN >> 8, 0x00
+    };
+    Send(J1939_PGN_TP_CM | NODE_SA, rts);
+
+    // Answer every CTS until the node acknowledges or aborts the message
+    while (Receive(J1939_PGN_TP_CM, frame) && frame[0] == J1939_TP_CTS) {
+        for (uint8_t seq = frame[2]; seq < frame[2] + frame[1]; seq++) {
+            uint8_t dt[8];
+            uint16_t offset = (uint16_t)(seq - 1) * 7;
+
+            memset(dt, 0xFF, sizeof(dt));
+            dt[0] = seq;
+            memcpy(&dt[1], &message[offset], (size - offset > 7) ? 7 : size - offset);
+            Send(J1939_PGN_TP_DT | NODE_SA, dt);
+        }
+    }
+
+    // Aborted or not, the reply says why
+    return Receive(UPDATE_PGN, frame) ? frame[1] : 0xFF;
+}
+
+static void Setup(void) {
+    Test_Reset();
+    EEPROM_Config_WriteByte(EEPROM_CFG_HEARTBEAT_SA, NODE_SA);
+    EEPROM_Config_Load();
+    J1939_Init();
+    J1939_LoadHeartbeatConfig();
+
+    for (uint16_t r = 0; r < UPDATE_IMAGE_MAX_ROWS; r++) {
+        for (uint8_t i = 0; i < BOARD_FLASH_ROW_BYTES; i++) {
+            image[r][i] = (uint8_t)(r * 37 + i * 11);
+        }
+    }
+    tool_frames = 0;
+    node_frames = 0;
+}
+
+static const uint8_t *Record(void) {
+    return Board_HostFlashRow(BOARD_FLASH_STAGING +
+                              (uint32_t)UPDATE_IMAGE_MAX_ROWS * BOARD_FLASH_ROW_PC);
+}
+
+static void TestUpdate(void) {
+    uint32_t crc;
+
+    Setup();
+    crc = Crc32(&image[0][0], IMAGE_ROWS * BOARD_FLASH_ROW_BYTES);
+
+    CHECK(Start(IMAGE_ROWS, crc) == UPDATE_STATUS_OK);
+    CHECK(Update_IsActive());
+    CHECK(Block(0, UPDATE_BLOCK_ROWS) == UPDATE_STATUS_OK);
+    CHECK(Block(UPDATE_BLOCK_ROWS, IMAGE_ROWS - UPDATE_BLOCK_ROWS) == UPDATE_STATUS_OK);
+    CHECK(Commit() == UPDATE_STATUS_OK);
+    CHECK(!Update_IsActive());
+
+    // Staged exactly, install record written, and still running
+    for (uint16_t r = 0; r < IMAGE_ROWS; r++) {
+        CHECK(memcmp(Board_HostFlashRow(BOARD_FLASH_STAGING + (uint32_t)r * BOARD_FLASH_ROW_PC),
+                     image[r], BOARD_FLASH_ROW_BYTES) == 0);
+    }
+    CHECK(Record()[0] == (UPDATE_RECORD_MAGIC & 0xFF));
+    CHECK(Record()[1] == (UPDATE_RECORD_MAGIC >> 8));
+    CHECK(Record()[2] == IMAGE_ROWS && Record()[3] == 0);
+    CHECK(Record()[4] == (crc & 0xFF) && Record()[7] == (crc >> 24));
+    CHECK(Board_HostResetCount() == 0);
+}
+
+/*
+ * Largest image the staging area takes, for the update time: every frame
+ * both ways at the worst-case stuffed length of an 8-byte extended frame
+ */
+static void TestUpdateTime(void) {
+    uint8_t ok = 1;
+    uint32_t frames;
+    uint32_t frame_bits = BOARD_HOST_FRAME_BITS(8);
+    uint32_t rows = UPDATE_IMAGE_MAX_ROWS;
+
+    Setup();
+    ok &= Start(rows, Crc32(&image[0][0], rows * BOARD_FLASH_ROW_BYTES)) == UPDATE_STATUS_OK;
+    for (uint32_t first = 0; first < rows; first += UPDATE_BLOCK_ROWS) {
+        uint8_t count = (rows - first < UPDATE_BLOCK_ROWS) ? rows - first : UPDATE_BLOCK_ROWS;
+
+        ok &= Block(first, count) == UPDATE_STATUS_OK;
+    }
+    ok &= Commit() == UPDATE_STATUS_OK;
+    CHECK(ok);
+
+    // RTS, 4 CTS, 56 DT, EOMA and the reply per 4-row block
+    frames = tool_frames + node_frames;
+    CHECK(frames == 11833);
+    printf("test_update: %lu-row image (%lu bytes) = %lu frames (%lu to the node, %lu back)\n",
+           (unsigned long)rows, (unsigned long)rows * BOARD_FLASH_ROW_BYTES,
+           (unsigned long)frames, (unsigned long)tool_frames, (unsigned long)node_frames);
+    printf("test_update: bus time %.2fs at 250kbit/s, %.2fs at 500kbit/s, "
+           "flash programming %.2fs\n",
+           frames * frame_bits / 250000.0, frames * frame_bits / 500000.0,
+           rows * 4.0 / 1000.0);    // 2ms erase + 2ms write per row
+}
+
+static void TestBadCRC(void) {
+    Setup();
+
+    CHECK(Start(IMAGE_ROWS, Crc32(&image[0][0], IMAGE_ROWS * BOARD_FLASH_ROW_BYTES) ^ 1) == UPDATE_STATUS_OK);
+    CHECK(Block(0, UPDATE_BLOCK_ROWS) == UPDATE_STATUS_OK);
+    CHECK(Block(UPDATE_BLOCK_ROWS, IMAGE_ROWS - UPDATE_BLOCK_ROWS) == UPDATE_STATUS_OK);
+    CHECK(Commit() == UPDATE_STATUS_CRC);
+
+    // No install record
+    CHECK(Record()[0] == 0xFF && Record()[1] == 0xFF);
+}
+
+static void TestSequence(void) {
+    Setup();
+
+    // Nothing started
+    CHECK(Block(0, 1) == UPDATE_STATUS_SEQUENCE);
+    CHECK(Commit() == UPDATE_STATUS_SEQUENCE);
+
+    // Rows skipped, then commit before the last row
+    CHECK(Start(IMAGE_ROWS, 0) == UPDATE_STATUS_OK);
+    CHECK(Block(1, 1) == UPDATE_STATUS_SEQUENCE);
+    CHECK(Block(0, 1) == UPDATE_STATUS_OK);
+    CHECK(Commit() == UPDATE_STATUS_SEQUENCE);
+    CHECK(Record()[0] == 0xFF);
+
+    // Too large for the staging area
+    CHECK(Start(UPDATE_IMAGE_MAX_ROWS + 1, 0) == UPDATE_STATUS_REFUSED);
+}
+
+int main(void) {
+    TestUpdate();
+    TestUpdateTime();
+    TestBadCRC();
+    TestSequence();
+    return Test_Done("test_update");
+}
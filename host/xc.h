@@ -0,0 +1,145 @@
+/*
+ * FILE: host/xc.h
+ * Host Stand-In for the XC16 Device Header
+ *
+ * Lets the application modules build under gcc against board_host.c.
+ * Only the special function registers the application modules touch
+ * directly are declared; they are plain variables (defined in
+ * board_host.c) that the simulated board reads and writes like the
+ * peripherals would. Everything else goes through board.h.
+ *
+ * Interrupt service routines keep their names (_C1Interrupt, ...) and
+ * are called by the simulated board when their enable bit is set.
+ */
+
+#ifndef HOST_XC_H
+#define HOST_XC_H
+
+#include <stdint.h>
+#include <stddef.h>     // NULL, as the device header provides it
+
+// ISR attributes have no meaning on the host: __attribute__((interrupt,
+// no_auto_psv)) becomes an empty attribute list
+#define interrupt
+#define no_auto_psv
+
+#define Nop()       ((void)0)
+#define ClrWdt()    ((void)0)
+#define Idle()      ((void)0)
+#define Sleep()     ((void)0)
+
+// ============================================================================
+// INTERRUPT CONTROLLER
+// ============================================================================
+
+typedef struct {
+    unsigned T1IE:1;
+} IEC0BITS;
+
+typedef struct {
+    unsigned SPI2IE:1;
+    unsigned C1IE:1;
+} IEC1BITS;
+
+typedef struct {
+    unsigned C2IE:1;
+} IEC2BITS;
+
+typedef struct {
+    unsigned T1IF:1;
+} IFS0BITS;
+
+typedef struct {
+    unsigned SPI2IF:1;
+    unsigned C1IF:1;
+} IFS1BITS;
+
+typedef struct {
+    unsigned C2IF:1;
+} IFS2BITS;
+
+typedef struct {
+    unsigned SPI2IP:3;
+    unsigned C1IP:3;
+} IPC6BITS;
+
+typedef struct {
+    unsigned C2IP:3;
+} IPC9BITS;
+
+extern volatile IEC0BITS IEC0bits;
+extern volatile IEC1BITS IEC1bits;
+extern volatile IEC2BITS IEC2bits;
+extern volatile IFS0BITS IFS0bits;
+extern volatile IFS1BITS IFS1bits;
+extern volatile IFS2BITS IFS2bits;
+extern volatile IPC6BITS IPC6bits;
+extern volatile IPC9BITS IPC9bits;
+
+// ============================================================================
+// SPI2 (MCP4341 DIGIPOT)
+// ============================================================================
+
+typedef struct {
+    unsigned SPIEN:1;
+} SPI2STATBITS;
+
+typedef struct {
+    unsigned PPRE:2;
+    unsigned SPRE:3;
+    unsigned MSTEN:1;
+    unsigned CKP:1;
+    unsigned SMP:1;
+    unsigned CKE:1;
+    unsigned MODE16:1;
+} SPI2CONBITS;
+
+extern volatile SPI2STATBITS SPI2STATbits;
+extern volatile SPI2CONBITS SPI2CONbits;
+extern volatile uint16_t SPI2BUF;
+
+// ============================================================================
+// I/O PORTS
+// ============================================================================
+// PORTx / LATx / TRISx as words, with the xxxbits views over the same
+// storage as on the part
+
+#define HOST_PORT_BITS(p) \
+    unsigned p##0:1;  unsigned p##1:1;  unsigned p##2:1;  unsigned p##3:1;  \
+    unsigned p##4:1;  unsigned p##5:1;  unsigned p##6:1;  unsigned p##7:1;  \
+    unsigned p##8:1;  unsigned p##9:1;  unsigned p##10:1; unsigned p##11:1; \
+    unsigned p##12:1; unsigned p##13:1; unsigned p##14:1; unsigned p##15:1;
+
+#define HOST_PORT(x) \
+    typedef struct { HOST_PORT_BITS(R##x) } PORT##x##BITS;      \
+    typedef struct { HOST_PORT_BITS(LAT##x) } LAT##x##BITS;     \
+    typedef struct { HOST_PORT_BITS(TRIS##x) } TRIS##x##BITS;   \
+    extern volatile uint16_t PORT##x;                           \
+    extern volatile uint16_t LAT##x;                            \
+    extern volatile uint16_t TRIS##x;
+
+HOST_PORT(B)
+HOST_PORT(C)
+HOST_PORT(D)
+HOST_PORT(F)
+HOST_PORT(G)
+
+#define PORTBbits   (*(volatile PORTBBITS *)&PORTB)
+#define PORTCbits   (*(volatile PORTCBITS *)&PORTC)
+#define PORTDbits   (*(volatile PORTDBITS *)&PORTD)
+#define PORTFbits   (*(volatile PORTFBITS *)&PORTF)
+#define PORTGbits   (*(volatile PORTGBITS *)&PORTG)
+#define LATBbits    (*(volatile LATBBITS *)&LATB)
+#define LATCbits    (*(volatile LATCBITS *)&LATC)
+#define LATDbits    (*(volatile LATDBITS *)&LATD)
+#define LATFbits    (*(volatile LATFBITS *)&LATF)
+#define LATGbits    (*(volatile LATGBITS *)&LATG)
+#define TRISBbits   (*(volatile TRISBBITS *)&TRISB)
+#define TRISCbits   (*(volatile TRISCBITS *)&TRISC)
+#define TRISDbits   (*(volatile TRISDBITS *)&TRISD)
+#define TRISFbits   (*(volatile TRISFBITS *)&TRISF)
+#define TRISGbits   (*(volatile TRISGBITS *)&TRISG)
+
+extern volatile uint16_t ADPCFG;
+
+#endif // HOST_XC_H
@@ -7,6 +7,9 @@
  * - Ignition/starter state is LATCHING (persists until toggled)
  * - Uses EEPROM_SetManualCase() to control CAN broadcasts
  * - Does NOT call EEPROM_HandleInputChange() for one-button start inputs
+ * - Every latch change also queues its frame (Inputs_TakeOneButtonFrame), which
+ *   main.c sends straight after the scan instead of waiting for aggregation
+ * - Press timing uses the 1ms system_time_ms
  * 
  * IGNITION MODE (Byte 4, Bits 0-1):
  * - 0x01 = Set Ignition: This input IS the ignition input (sets ignition flag when ON)
@@ -15,12 +18,12 @@
  */
 
 #include "inputs.h"
+#include "board_inputs.h"
 #include "eeprom_cases.h"
-#include <stdio.h>
-
-// Define FCY for delay macros
-#define FCY 16000000UL
-#include <libpic30.h>
+#include "eeprom_config.h"
+#include "board.h"
+#include "supervisor.h"
+#include <stddef.h>  // For NULL
 
 // ============================================================================
 // ONE-BUTTON START CONFIGURATION - EASY TO MODIFY
@@ -43,6 +46,30 @@ static uint8_t input_raw[INPUT_COUNT];
 // Debounce counters - counts consecutive scans with same reading
 static uint8_t debounce_count[INPUT_COUNT];
 
+// Debounce scans per input: from EEPROM, and in use (plus adaptive additions)
+static uint8_t debounce_base[INPUT_COUNT];
+static uint8_t debounce_scans[INPUT_COUNT];
+static uint8_t debounce_adaptive = 0;
+
+// Bounce statistics (see BOUNCE_WINDOW_MS)
+static uint8_t bounce_window[INPUT_COUNT];      // This window so far
+static uint8_t bounce_rate[INPUT_COUNT];        // Last complete window
+static uint16_t bounce_total[INPUT_COUNT];
+static uint32_t bounce_window_start = 0;
+
+// Stable states packed 8 per byte, bit (input & 7) of byte (input >> 3)
+static uint8_t input_packed[INPUT_PACKED_BYTES];
+
+// Bumped on every stable state change (lets screens skip redundant redraws)
+static uint16_t state_version = 0;
+
+// Last stable change of each input, and how long its frame took to follow
+// (Inputs_EdgeSent - fast path inputs)
+static uint32_t edge_ms[INPUT_COUNT];
+static uint8_t edge_latency_last[INPUT_COUNT];
+static uint8_t edge_latency_max[INPUT_COUNT];
+static uint8_t edge_sent_count[INPUT_COUNT];
+
 // Global ignition flag (RAM-based, resets on power cycle)
 static uint8_t ignition_flag = 0;
 
@@ -64,62 +91,76 @@ typedef struct {
     uint8_t starter_is_on;          // Current starter state
     uint8_t ignition_set_this_press; // Flag: Did we already set ignition during this press?
     uint8_t neutral_was_on;         // Was neutral safety ON when button was pressed? (sequence requirement)
+    uint8_t frame_pending;          // Latch changed, frame not sent yet (Inputs_TakeOneButtonFrame)
+    uint32_t edge_ms;               // When the change that queued it was seen
 } OneButtonStartState;
 
 #define MAX_ONE_BUTTON_INPUTS   8   // Support up to 8 one-button start inputs
 static OneButtonStartState one_button_states[MAX_ONE_BUTTON_INPUTS];
 static uint8_t one_button_count = 0;
 
-// System tick counter (incremented every 10ms by Timer1)
-static volatile uint32_t system_tick_ms = 0;
+// Timer1 millisecond count (main.c)
+extern volatile uint32_t system_time_ms;
 
 // Flag to indicate one-button start state changed (needs CAN transmission)
 static uint8_t one_button_state_changed = 0;
 
+// Edge to one-button frame on the bus (Inputs_OneButtonFrameSent)
+static uint16_t one_button_latency_max = 0;
+static uint8_t one_button_late_count = 0;
+
+// Warm restart copy (Inputs_SaveWarm / Inputs_RestoreWarm)
+typedef struct {
+    uint16_t signature;
+    uint8_t packed[INPUT_PACKED_BYTES];         // Stable input states
+    uint8_t ignition_flag;
+    uint8_t can_ignition_state;
+    uint8_t can_security_state;
+    uint8_t one_button_count;
+    uint8_t one_button_input[MAX_ONE_BUTTON_INPUTS];
+    uint8_t one_button_ignition[MAX_ONE_BUTTON_INPUTS];
+    uint16_t checksum;
+} InputsWarmState;
+
+static InputsWarmState warm BOARD_PERSISTENT;
+
 // ============================================================================
-// INPUT MAPPING TABLE
+// INPUT MAPPING TABLES (generated from board_inputs.h)
 // ============================================================================
 
-// Mapping table: [input_number] = {mux_number, channel}
-typedef struct {
-    uint8_t mux;      // Which MUX (1-6)
-    uint8_t channel;  // Which channel (0-7) corresponding to S1-S8
-} InputMapping;
+// Compile-time check: the array size goes negative if cond is false
+#define INPUT_MAP_ASSERT(cond, tag) typedef char input_map_assert_##tag[(cond) ? 1 : -1]
+
+#define MAP_COUNT(input, mux, channel)      + 1
+#define MAP_INPUT_SUM(input, mux, channel)  + (1ULL << (input))
+#define MAP_INPUT_OR(input, mux, channel)   | (1ULL << (input))
+#define MAP_SLOT(mux, channel)              (((mux) - 1) * MUX_CHANNELS + (channel))
+#define MAP_SLOT_SUM(input, mux, channel)   + (1ULL << MAP_SLOT(mux, channel))
+#define MAP_SLOT_OR(input, mux, channel)    | (1ULL << MAP_SLOT(mux, channel))
+#define MAP_BAD(input, mux, channel)        + ((input) >= INPUT_COUNT || (mux) < 1 || \
+                                               (mux) > MUX_COUNT || (channel) >= MUX_CHANNELS)
+
+// Every entry names a real input on a real mux channel
+INPUT_MAP_ASSERT((0 INPUT_MUX_MAP(MAP_BAD)) == 0, in_range);
+
+// One entry per input, and every input listed (sum == OR only when no bit repeats)
+INPUT_MAP_ASSERT((0 INPUT_MUX_MAP(MAP_COUNT)) == INPUT_COUNT, count);
+INPUT_MAP_ASSERT((0 INPUT_MUX_MAP(MAP_INPUT_SUM)) == (0 INPUT_MUX_MAP(MAP_INPUT_OR)), input_once);
+INPUT_MAP_ASSERT((0 INPUT_MUX_MAP(MAP_INPUT_OR)) == ((1ULL << INPUT_COUNT) - 1), input_all);
+
+// No two inputs on the same mux channel
+INPUT_MAP_ASSERT((0 INPUT_MUX_MAP(MAP_SLOT_SUM)) == (0 INPUT_MUX_MAP(MAP_SLOT_OR)), slot_once);
+
+// Gather order: [channel][mux - 1] = input + 1 (0 = nothing wired to that slot)
+#define MAP_GATHER(input, mux, channel)     [channel][(mux) - 1] = (input) + 1,
+static const uint8_t scan_map[MUX_CHANNELS][MUX_COUNT] = {
+    INPUT_MUX_MAP(MAP_GATHER)
+};
 
-static const InputMapping input_map[INPUT_COUNT] = {
-    // IN01-IN04 on MUX01 S1-S4
-    {1, 0}, {1, 1}, {1, 2}, {1, 3},
-    
-    // IN05-IN08 on MUX02 S4,S2,S7,S8
-    {2, 3}, {2, 1}, {2, 6}, {2, 7},
-    
-    // IN09-IN12 on MUX03 S4,S3,S2,S1
-    {3, 3}, {3, 2}, {3, 1}, {3, 0},
-    
-    // IN13-IN16 on MUX03 S8,S7,S6,S5
-    {3, 7}, {3, 6}, {3, 5}, {3, 4},
-    
-    // IN17-IN20 on MUX01 S5-S8
-    {1, 4}, {1, 5}, {1, 6}, {1, 7},
-    
-    // IN21-IN22 on MUX02 S3,S1
-    {2, 2}, {2, 0},
-    
-    // IN23-IN26 on MUX04 S4,S3,S2,S1 (SWAPPED: IN23 and IN24 reversed in hardware)
-    {4, 2}, {4, 3}, {4, 1}, {4, 0},
-    
-    // IN27-IN30 on MUX06 S5,S6,S7,S8
-    {6, 4}, {6, 5}, {6, 6}, {6, 7},
-    
-    // IN31-IN34 on MUX06 S4,S3,S2,S1
-    {6, 3}, {6, 2}, {6, 1}, {6, 0},
-    
-    // IN35-IN38 on MUX05 S5,S6,S8,S7
-    {5, 4}, {5, 5}, {5, 7}, {5, 6},
-    
-    // HSIN01-HSIN06 on MUX02 S5,S6 and MUX04 S5,S6,S7,S8
-    {2, 4}, {2, 5},
-    {4, 4}, {4, 5}, {4, 6}, {4, 7}
+// Input names, indexed by input
+#define MAP_NAME(input, mux, channel)       [input] = #input,
+static const char * const input_names[INPUT_COUNT] = {
+    INPUT_MUX_MAP(MAP_NAME)
 };
 
 // ============================================================================
@@ -153,6 +194,34 @@ static uint8_t IsIgnitionInput(uint8_t input_num) {
 // ONE-BUTTON START FUNCTIONS
 // ============================================================================
 
+static uint32_t NowMs(void) {
+    IEC0bits.T1IE = 0;
+    uint32_t now = system_time_ms;
+    IEC0bits.T1IE = 1;
+    return now;
+}
+
+/**
+ * Latch changed: queue its frame for main.c, and flag the aggregated
+ * transmit that follows for everything else on the bus
+ */
+static void QueueOneButtonFrame(OneButtonStartState *state, uint32_t now_ms) {
+    state->frame_pending = 1;
+    state->edge_ms = now_ms;
+    one_button_state_changed = 1;
+}
+
+/**
+ * Latched ignition from a one-button input
+ * Track ignition cases are only rescanned when the flag really changes
+ */
+static void SetOneButtonIgnition(uint8_t on) {
+    if(ignition_flag != on) {
+        ignition_flag = on;
+        EEPROM_UpdateIgnitionTrackedCases(ignition_flag);
+    }
+}
+
 /**
  * Find the one-button start state for a given input
  * Returns pointer to state if found, NULL if not found
@@ -170,7 +239,7 @@ static OneButtonStartState* FindOneButtonState(uint8_t input_num) {
  * Handle one-button start state machine for a single input
  * Called when the input state changes or periodically to check timers
  */
-static void HandleOneButtonStart(uint8_t input_num) {
+static void HandleOneButtonStart(uint8_t input_num, uint32_t now_ms) {
     // Find or create state for this input
     OneButtonStartState *state = FindOneButtonState(input_num);
     
@@ -184,6 +253,7 @@ static void HandleOneButtonStart(uint8_t input_num) {
             state->starter_is_on = 0;
             state->active = 0;
             state->ignition_set_this_press = 0;
+            state->frame_pending = 0;
             one_button_count++;
         } else {
             return;  // No room for more one-button inputs
@@ -198,7 +268,7 @@ static void HandleOneButtonStart(uint8_t input_num) {
         // BUTTON JUST PRESSED - Start tracking
         // ====================================================================
         state->active = 1;
-        state->press_start_time = system_tick_ms;
+        state->press_start_time = now_ms;
         state->ignition_was_on = state->ignition_is_on;  // Remember current latching state
         state->ignition_set_this_press = 0;  // Reset flag - haven't set ignition yet for this press
         
@@ -208,7 +278,7 @@ static void HandleOneButtonStart(uint8_t input_num) {
         // ====================================================================
         // BUTTON RELEASED
         // ====================================================================
-        uint32_t press_duration = system_tick_ms - state->press_start_time;
+        uint32_t press_duration = now_ms - state->press_start_time;
         
         if(press_duration < ONE_BUTTON_QUICK_PRESS_MS) {
             // QUICK PRESS - Toggle ignition only (no neutral safety check for ignition)
@@ -218,18 +288,16 @@ static void HandleOneButtonStart(uint8_t input_num) {
                 state->ignition_is_on = 0;
                 state->starter_is_on = 0;
                 EEPROM_ClearManualCase(input_num);
-                ignition_flag = 0;
-                EEPROM_UpdateIgnitionTrackedCases(ignition_flag);  // Update track ignition cases
-                one_button_state_changed = 1;  // Flag for main.c to transmit
+                SetOneButtonIgnition(0);  // Update track ignition cases
+                QueueOneButtonFrame(state, now_ms);  // Flag for main.c to transmit
             } else {
                 // Ignition WAS off when we pressed, so turn it ON
                 // (Ignition always works - no neutral safety requirement)
                 state->ignition_is_on = 1;
                 state->starter_is_on = 0;
                 EEPROM_SetManualCase(input_num, 1, 0);
-                ignition_flag = 1;
-                EEPROM_UpdateIgnitionTrackedCases(ignition_flag);  // Update track ignition cases
-                one_button_state_changed = 1;  // Flag for main.c to transmit
+                SetOneButtonIgnition(1);  // Update track ignition cases
+                QueueOneButtonFrame(state, now_ms);  // Flag for main.c to transmit
             }
         } else {
             // LONG PRESS RELEASED
@@ -238,18 +306,16 @@ static void HandleOneButtonStart(uint8_t input_num) {
                 state->ignition_is_on = 0;
                 state->starter_is_on = 0;
                 EEPROM_ClearManualCase(input_num);
-                ignition_flag = 0;
-                EEPROM_UpdateIgnitionTrackedCases(ignition_flag);  // Update track ignition cases
-                one_button_state_changed = 1;  // Flag for main.c to transmit
+                SetOneButtonIgnition(0);  // Update track ignition cases
+                QueueOneButtonFrame(state, now_ms);  // Flag for main.c to transmit
             } else {
                 // Ignition WAS off - turn off starter, leave ignition on
                 // (Ignition always works - starter was already handled during hold)
                 state->starter_is_on = 0;
                 state->ignition_is_on = 1;
                 EEPROM_SetManualCase(input_num, 1, 0);  // Ignition ON, starter OFF
-                ignition_flag = 1;
-                EEPROM_UpdateIgnitionTrackedCases(ignition_flag);  // Update track ignition cases
-                one_button_state_changed = 1;  // Flag for main.c to transmit
+                SetOneButtonIgnition(1);  // Update track ignition cases
+                QueueOneButtonFrame(state, now_ms);  // Flag for main.c to transmit
             }
         }
         // Reset state
@@ -259,7 +325,7 @@ static void HandleOneButtonStart(uint8_t input_num) {
         // ====================================================================
         // BUTTON STILL HELD - Check if we need to engage starter
         // ====================================================================
-        uint32_t press_duration = system_tick_ms - state->press_start_time;
+        uint32_t press_duration = now_ms - state->press_start_time;
         
         // On the FIRST scan after button press (when starting from ignition OFF),
         // turn on ignition IMMEDIATELY. Only do this ONCE per button press.
@@ -271,9 +337,8 @@ static void HandleOneButtonStart(uint8_t input_num) {
             state->starter_is_on = 0;
             state->ignition_set_this_press = 1;  // Mark that we've set it
             EEPROM_SetManualCase(input_num, 1, 0);
-            ignition_flag = 1;
-            EEPROM_UpdateIgnitionTrackedCases(ignition_flag);  // Update track ignition cases
-            one_button_state_changed = 1;  // Flag for main.c to transmit
+            SetOneButtonIgnition(1);  // Update track ignition cases
+            QueueOneButtonFrame(state, now_ms);  // Flag for main.c to transmit
         }
         
         // After holding for 1000ms (1 second), engage starter
@@ -286,12 +351,61 @@ static void HandleOneButtonStart(uint8_t input_num) {
                 state->starter_is_on = 1;
                 state->ignition_is_on = 1;
                 EEPROM_SetManualCase(input_num, 1, 1);  // Ignition ON, starter ON
-                one_button_state_changed = 1;  // Flag for main.c to transmit
+                QueueOneButtonFrame(state, now_ms);  // Flag for main.c to transmit
+            }
+        }
+    }
+}
+
+// ============================================================================
+// DEBOUNCE AND BOUNCE STATISTICS
+// ============================================================================
+
+/**
+ * End of a bounce window: publish the rates, adapt the debounce scans
+ */
+static void CloseBounceWindow(void) {
+    for(uint8_t i = 0; i < INPUT_COUNT; i++) {
+        bounce_rate[i] = bounce_window[i];
+        bounce_window[i] = 0;
+        
+        if(!debounce_adaptive) {
+            continue;
+        }
+        if(bounce_rate[i] >= BOUNCE_CHATTER_LIMIT) {
+            if(debounce_scans[i] < DEBOUNCE_SCANS_MAX) {
+                debounce_scans[i]++;    // Chattering - filter harder
             }
+        } else if(bounce_rate[i] == 0 && debounce_scans[i] > debounce_base[i]) {
+            debounce_scans[i]--;        // Quiet again - give latency back
         }
     }
 }
 
+void Inputs_LoadDebounce(void) {
+    for(uint8_t i = 0; i < INPUT_COUNT; i++) {
+        uint8_t scans = EEPROM_Config_ReadNibble(EEPROM_DEBOUNCE_START + (i >> 1), i & 0x01);
+        if(scans == 0x0 || scans == 0xF) {
+            scans = DEBOUNCE_SCANS;
+        }
+        debounce_base[i] = scans;
+        debounce_scans[i] = scans;
+    }
+    debounce_adaptive = (EEPROM_Config_ReadByte(EEPROM_DEBOUNCE_MODE) == EEPROM_DEBOUNCE_ADAPTIVE);
+}
+
+uint8_t Inputs_GetDebounceScans(uint8_t input_num) {
+    return (input_num < INPUT_COUNT) ? debounce_scans[input_num] : 0;
+}
+
+uint8_t Inputs_GetBounceRate(uint8_t input_num) {
+    return (input_num < INPUT_COUNT) ? bounce_rate[input_num] : 0;
+}
+
+uint16_t Inputs_GetBounceCount(uint8_t input_num) {
+    return (input_num < INPUT_COUNT) ? bounce_total[input_num] : 0;
+}
+
 // ============================================================================
 // HARDWARE INTERFACE FUNCTIONS
 // ============================================================================
@@ -305,14 +419,10 @@ static void Inputs_SetMuxChannel(uint8_t channel) {
     __delay_ms(1);
 }
 
-// Read all 6 multiplexer outputs
-static void Inputs_ReadMuxOutputs(uint8_t mux_readings[6]) {
-    mux_readings[0] = MUX01MC;
-    mux_readings[1] = MUX02MC;
-    mux_readings[2] = MUX03MC;
-    mux_readings[3] = MUX04MC;
-    mux_readings[4] = MUX05MC;
-    mux_readings[5] = MUX06MC;
+// Read all multiplexer outputs packed into one byte: bit (mux - 1) = MUXxxMC level
+#define MUX_PACK_BIT(mux, port, bit)    | (((PORT##port >> (bit)) & 0x01) << ((mux) - 1))
+static uint8_t Inputs_ReadMuxPacked(void) {
+    return (uint8_t)(0 MUX_OUTPUT_PINS(MUX_PACK_BIT));
 }
 
 // ============================================================================
@@ -342,19 +452,27 @@ void Inputs_Init(void) {
     __delay_ms(10);
     
     // Set MUX output pins as inputs
-    TRISDbits.TRISD7 = 1;   // MUX01MC
-    TRISDbits.TRISD9 = 1;   // MUX02MC
-    TRISDbits.TRISD8 = 1;   // MUX03MC
-    TRISBbits.TRISB14 = 1;  // MUX04MC
-    TRISCbits.TRISC1 = 1;   // MUX05MC
-    TRISCbits.TRISC2 = 1;   // MUX06MC
+#define MUX_PIN_INPUT(mux, port, bit)   TRIS##port |= (1u << (bit));
+    MUX_OUTPUT_PINS(MUX_PIN_INPUT)
     
     // Initialize all states and debounce counters
     for(uint8_t i = 0; i < INPUT_COUNT; i++) {
         input_states[i] = 0;
         input_raw[i] = 0;
-        debounce_count[i] = 0;
+        debounce_count[i] = DEBOUNCE_SCANS_MAX;    // First reading is not a bounce
+        bounce_window[i] = 0;
+        bounce_rate[i] = 0;
+        bounce_total[i] = 0;
+        edge_ms[i] = 0;
+        edge_latency_last[i] = 0;
+        edge_latency_max[i] = 0;
+        edge_sent_count[i] = 0;
     }
+    for(uint8_t i = 0; i < INPUT_PACKED_BYTES; i++) {
+        input_packed[i] = 0;
+    }
+    Inputs_LoadDebounce();
+    bounce_window_start = NowMs();
     
     // Initialize ignition flag to off
     ignition_flag = 0;
@@ -370,65 +488,82 @@ void Inputs_Init(void) {
         one_button_states[i].starter_is_on = 0;
         one_button_states[i].ignition_set_this_press = 0;
         one_button_states[i].neutral_was_on = 0;
+        one_button_states[i].frame_pending = 0;
     }
-    
-    // Initialize system tick
-    system_tick_ms = 0;
+    one_button_latency_max = 0;
+    one_button_late_count = 0;
 }
 
 // Scan all inputs through multiplexers WITH DEBOUNCING
 void Inputs_Scan(void) {
-    uint8_t mux_readings[6];
     uint8_t any_ignition_input_changed = 0;
     
-    // Increment system tick - called every ~30ms in practice (scan_timer = 10, but 1ms timer seems to be 3ms)
-    system_tick_ms += 30;
-    
     // Scan through all 8 channels
-    for(uint8_t channel = 0; channel < 8; channel++) {
+    for(uint8_t channel = 0; channel < MUX_CHANNELS; channel++) {
         // Set all MUXes to this channel
         Inputs_SetMuxChannel(channel);
         
-        // Read all MUX outputs
-        Inputs_ReadMuxOutputs(mux_readings);
+        // Read all MUX outputs at once
+        uint8_t mux_levels = Inputs_ReadMuxPacked();
+        const uint8_t *slots = scan_map[channel];
         
-        // Process all inputs on this channel
-        for(uint8_t input = 0; input < INPUT_COUNT; input++) {
-            if(input_map[input].channel == channel) {
-                uint8_t mux_idx = input_map[input].mux - 1;  // Convert to 0-based
-                
-                // Raw reading: 1 = not pressed/off, 0 = pressed/on
-                // Convert to: 1 = on/active, 0 = off/inactive
-                uint8_t new_reading = (mux_readings[mux_idx] == 0) ? 1 : 0;
+        // Process the inputs wired to this channel
+        for(uint8_t mux_idx = 0; mux_idx < MUX_COUNT; mux_idx++) {
+            if(slots[mux_idx] == 0) {
+                continue;  // Nothing wired to this mux channel
+            }
+            uint8_t input = slots[mux_idx] - 1;
+            
+            // Raw reading: 1 = not pressed/off, 0 = pressed/on
+            // Convert to: 1 = on/active, 0 = off/inactive
+            uint8_t new_reading = (mux_levels & (1 << mux_idx)) ? 0 : 1;
+            
+            // Store previous stable state to detect changes
+            uint8_t prev_state = input_states[input];
+            
+            // DEBOUNCE LOGIC
+            if(new_reading != input_raw[input]) {
+                // Changed again before the last change settled - a bounce
+                if(debounce_count[input] < debounce_scans[input]) {
+                    if(bounce_window[input] < 0xFF) {
+                        bounce_window[input]++;
+                    }
+                    if(bounce_total[input] < 0xFFFF) {
+                        bounce_total[input]++;
+                    }
+                }
                 
-                // Store previous stable state to detect changes
-                uint8_t prev_state = input_states[input];
+                // Reading changed - reset debounce counter and update raw value
+                input_raw[input] = new_reading;
+                debounce_count[input] = 0;
+            } else {
+                // Reading is stable (same as last time)
+                if(debounce_count[input] < debounce_scans[input]) {
+                    debounce_count[input]++;
+                }
                 
-                // DEBOUNCE LOGIC
-                if(new_reading != input_raw[input]) {
-                    // Reading changed - reset debounce counter and update raw value
-                    input_raw[input] = new_reading;
-                    debounce_count[input] = 0;
-                } else {
-                    // Reading is stable (same as last time)
-                    if(debounce_count[input] < DEBOUNCE_SCANS) {
-                        debounce_count[input]++;
-                    }
+                // If stable for required number of scans, update stable state
+                if(debounce_count[input] >= debounce_scans[input]) {
+                    input_states[input] = new_reading;
                     
-                    // If stable for required number of scans, update stable state
-                    if(debounce_count[input] >= DEBOUNCE_SCANS) {
-                        input_states[input] = new_reading;
+                    // Check if state changed
+                    if(input_states[input] != prev_state) {
+                        state_version++;
+                        edge_ms[input] = NowMs();
                         
-                        // Check if state changed
-                        if(input_states[input] != prev_state) {
-                            // Check if this is a one-button start input
-                            if(EEPROM_IsOneButtonStartInput(input)) {
-                                HandleOneButtonStart(input);
-                            }
-                            // Check if this is a regular ignition input
-                            else if(IsIgnitionInput(input)) {
-                                any_ignition_input_changed = 1;
-                            }
+                        if(new_reading) {
+                            input_packed[input >> 3] |= (1 << (input & 7));
+                        } else {
+                            input_packed[input >> 3] &= ~(1 << (input & 7));
+                        }
+                        
+                        // Check if this is a one-button start input
+                        if(EEPROM_IsOneButtonStartInput(input)) {
+                            HandleOneButtonStart(input, NowMs());
+                        }
+                        // Check if this is a regular ignition input
+                        else if(IsIgnitionInput(input)) {
+                            any_ignition_input_changed = 1;
                         }
                     }
                 }
@@ -445,12 +580,39 @@ void Inputs_Scan(void) {
         }
     }
     
+    uint32_t now_ms = NowMs();
+    if(now_ms - bounce_window_start >= BOUNCE_WINDOW_MS) {
+        bounce_window_start = now_ms;
+        CloseBounceWindow();
+    }
+    
     // Process one-button start inputs that are currently active (for timer checks)
     for(uint8_t i = 0; i < one_button_count; i++) {
         if(one_button_states[i].active) {
-            HandleOneButtonStart(one_button_states[i].input_num);
+            HandleOneButtonStart(one_button_states[i].input_num, now_ms);
+        }
+    }
+}
+
+// Read every input once, without debouncing (sleep wake-up check)
+uint8_t Inputs_PollChanged(void) {
+    for(uint8_t channel = 0; channel < MUX_CHANNELS; channel++) {
+        Inputs_SetMuxChannel(channel);
+        
+        uint8_t mux_levels = Inputs_ReadMuxPacked();
+        const uint8_t *slots = scan_map[channel];
+        
+        for(uint8_t mux_idx = 0; mux_idx < MUX_COUNT; mux_idx++) {
+            if(slots[mux_idx] == 0) {
+                continue;
+            }
+            uint8_t reading = (mux_levels & (1 << mux_idx)) ? 0 : 1;
+            if(reading != input_states[slots[mux_idx] - 1]) {
+                return 1;
+            }
         }
     }
+    return 0;
 }
 
 // Get STABLE state of specific input (returns 1 if active/on, 0 if inactive/off)
@@ -461,17 +623,98 @@ uint8_t Inputs_GetState(uint8_t input_num) {
     return input_states[input_num];
 }
 
-// Get name of input
-const char* Inputs_GetName(uint8_t input_num) {
-    static char name_buffer[8];
+// Copy the packed stable states
+void Inputs_GetPacked(uint8_t packed[INPUT_PACKED_BYTES]) {
+    for(uint8_t i = 0; i < INPUT_PACKED_BYTES; i++) {
+        packed[i] = input_packed[i];
+    }
+}
+
+// Save the latched state for a warm restart (after every scan)
+void Inputs_SaveWarm(void) {
+    for(uint8_t i = 0; i < INPUT_PACKED_BYTES; i++) {
+        warm.packed[i] = input_packed[i];
+    }
+    warm.ignition_flag = ignition_flag;
+    warm.can_ignition_state = can_ignition_state;
+    warm.can_security_state = can_security_state;
+    warm.one_button_count = one_button_count;
+    for(uint8_t i = 0; i < MAX_ONE_BUTTON_INPUTS; i++) {
+        warm.one_button_input[i] = one_button_states[i].input_num;
+        warm.one_button_ignition[i] = one_button_states[i].ignition_is_on;
+    }
+    warm.signature = SUPERVISOR_SIGNATURE;
+    warm.checksum = Supervisor_Checksum(&warm, offsetof(InputsWarmState, checksum));
+}
+
+// Restore the state saved before a watchdog reset (after EEPROM_Cases_Init)
+uint8_t Inputs_RestoreWarm(void) {
+    if(warm.signature != SUPERVISOR_SIGNATURE ||
+       warm.checksum != Supervisor_Checksum(&warm, offsetof(InputsWarmState, checksum)) ||
+       warm.one_button_count > MAX_ONE_BUTTON_INPUTS) {
+        return 0;
+    }
+    
+    // Stable states come back already debounced - no edges on the next scan
+    for(uint8_t i = 0; i < INPUT_COUNT; i++) {
+        uint8_t state = (warm.packed[i >> 3] >> (i & 7)) & 0x01;
+        input_states[i] = state;
+        input_raw[i] = state;
+        debounce_count[i] = DEBOUNCE_SCANS_MAX;
+    }
+    for(uint8_t i = 0; i < INPUT_PACKED_BYTES; i++) {
+        input_packed[i] = warm.packed[i];
+    }
+    state_version++;
     
-    if(input_num < 38) {
-        sprintf(name_buffer, "IN%02d", input_num + 1);
-    } else {
-        sprintf(name_buffer, "HSIN%02d", input_num - 37);
+    can_ignition_state = warm.can_ignition_state ? 1 : 0;
+    can_security_state = warm.can_security_state ? 1 : 0;
+    ignition_flag = warm.ignition_flag ? 1 : 0;
+    
+    // One-button latches: ignition stays on, the starter does not
+    // (a running cranking cycle is not resumed after a crash)
+    one_button_count = warm.one_button_count;
+    for(uint8_t i = 0; i < one_button_count; i++) {
+        one_button_states[i].input_num = warm.one_button_input[i];
+        one_button_states[i].ignition_is_on = warm.one_button_ignition[i] ? 1 : 0;
+        one_button_states[i].ignition_was_on = one_button_states[i].ignition_is_on;
+        one_button_states[i].starter_is_on = 0;
+        one_button_states[i].ignition_set_this_press = 0;
+        one_button_states[i].neutral_was_on = 0;
+        one_button_states[i].frame_pending = 0;
+        
+        // A button still held counts as a press from ignition off that
+        // starts now: releasing it keeps the ignition on, and holding it
+        // re-engages the starter only after a fresh fuel pump delay
+        one_button_states[i].active = 0;
+        if(one_button_states[i].input_num < INPUT_COUNT &&
+           input_states[one_button_states[i].input_num]) {
+            one_button_states[i].active = 1;
+            one_button_states[i].ignition_was_on = 0;
+            one_button_states[i].ignition_set_this_press = one_button_states[i].ignition_is_on;
+            one_button_states[i].press_start_time = NowMs();
+        }
+        
+        if(one_button_states[i].ignition_is_on) {
+            EEPROM_SetManualCase(one_button_states[i].input_num, 1, 0);
+        }
     }
     
-    return name_buffer;
+    EEPROM_UpdateIgnitionTrackedCases(Inputs_GetIgnitionState());
+    return 1;
+}
+
+// Get the state change counter
+uint16_t Inputs_GetVersion(void) {
+    return state_version;
+}
+
+// Get name of input
+const char* Inputs_GetName(uint8_t input_num) {
+    if(input_num >= INPUT_COUNT) {
+        return "";
+    }
+    return input_names[input_num];
 }
 
 // Get the ignition flag state
@@ -553,6 +796,71 @@ uint8_t Inputs_IsOneButtonStartInput(uint8_t input_num) {
     return EEPROM_IsOneButtonStartInput(input_num);
 }
 
+// A fast path frame for this input's last edge went out
+void Inputs_EdgeSent(uint8_t input_num) {
+    if(input_num >= INPUT_COUNT) {
+        return;
+    }
+    
+    uint32_t latency = NowMs() - edge_ms[input_num];
+    uint8_t latency_ms = (latency > 0xFF) ? 0xFF : (uint8_t)latency;
+    
+    edge_latency_last[input_num] = latency_ms;
+    if(latency_ms > edge_latency_max[input_num]) {
+        edge_latency_max[input_num] = latency_ms;
+    }
+    if(edge_sent_count[input_num] < 0xFF) {
+        edge_sent_count[input_num]++;
+    }
+}
+
+// Edge-to-frame times of one input, 0 if none recorded yet
+uint8_t Inputs_GetEdgeLatency(uint8_t input_num, uint8_t *last_ms, uint8_t *max_ms) {
+    if(input_num >= INPUT_COUNT || edge_sent_count[input_num] == 0) {
+        return 0;
+    }
+    *last_ms = edge_latency_last[input_num];
+    *max_ms = edge_latency_max[input_num];
+    return edge_sent_count[input_num];
+}
+
+// Take the next queued one-button frame (oldest input first)
+uint8_t Inputs_TakeOneButtonFrame(uint8_t *input_num, uint8_t *ignition_on,
+                                  uint8_t *starter_on, uint32_t *edge_ms) {
+    for(uint8_t i = 0; i < one_button_count; i++) {
+        OneButtonStartState *state = &one_button_states[i];
+        if(state->frame_pending) {
+            state->frame_pending = 0;
+            *input_num = state->input_num;
+            *ignition_on = state->ignition_is_on;
+            *starter_on = state->starter_is_on;
+            *edge_ms = state->edge_ms;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// A queued frame went out - record the edge-to-frame time
+void Inputs_OneButtonFrameSent(uint32_t edge_ms) {
+    uint32_t latency = NowMs() - edge_ms;
+    
+    if(latency > one_button_latency_max) {
+        one_button_latency_max = (latency > 0xFFFF) ? 0xFFFF : (uint16_t)latency;
+    }
+    if(latency > ONE_BUTTON_TX_BOUND_MS && one_button_late_count < 0xFF) {
+        one_button_late_count++;
+    }
+}
+
+uint16_t Inputs_GetOneButtonLatencyMax(void) {
+    return one_button_latency_max;
+}
+
+uint8_t Inputs_GetOneButtonLateCount(void) {
+    return one_button_late_count;
+}
+
 // Check if one-button start state changed (requires CAN transmission)
 // This function returns 1 if changed and automatically clears the flag
 uint8_t Inputs_OneButtonStartStateChanged(void) {
@@ -17,6 +17,22 @@
 //   2 = 20ms, 3 = 30ms, 4 = 40ms, 5 = 50ms, etc.
 #define DEBOUNCE_SCANS  3
 
+// Per-input debounce (Inputs_LoadDebounce): one nibble per input from
+// EEPROM_DEBOUNCE_START, 1-14 scans; 0 and 0xF (erased) use DEBOUNCE_SCANS.
+// A bounce is a raw change before the previous one had settled. With
+// EEPROM_DEBOUNCE_MODE = EEPROM_DEBOUNCE_ADAPTIVE an input that bounced
+// BOUNCE_CHATTER_LIMIT times in a window gets one more scan, up to
+// DEBOUNCE_SCANS_MAX, and gives one back after a window without bounces.
+#define DEBOUNCE_SCANS_MAX      15
+#define BOUNCE_WINDOW_MS        10000   // Bounce rate = bounces in the last window
+#define BOUNCE_CHATTER_LIMIT    4
+
+// One-button start: worst case from the debounced edge (or the fuel pump
+// delay running out) to its frame on the bus - the rest of the scan
+// (8 mux channels, 1ms settle each), the frame already on the wire and
+// its own; the priority TX buffer keeps it ahead of queued frames
+#define ONE_BUTTON_TX_BOUND_MS  10
+
 // Multiplexer control pins (from Appendix 1)
 #define MUX_EN_TRIS     TRISGbits.TRISG15
 #define MUX_EN          LATGbits.LATG15
@@ -30,27 +46,11 @@
 #define MUX_A2_TRIS     TRISGbits.TRISG14
 #define MUX_A2          LATGbits.LATG14
 
-// Multiplexer output pins (readings from each MUX)
-#define MUX01MC_TRIS    TRISDbits.TRISD7
-#define MUX01MC         PORTDbits.RD7
-
-#define MUX02MC_TRIS    TRISDbits.TRISD9
-#define MUX02MC         PORTDbits.RD9
-
-#define MUX03MC_TRIS    TRISDbits.TRISD8
-#define MUX03MC         PORTDbits.RD8
-
-#define MUX04MC_TRIS    TRISBbits.TRISB14
-#define MUX04MC         PORTBbits.RB14
-
-#define MUX05MC_TRIS    TRISCbits.TRISC1
-#define MUX05MC         PORTCbits.RC1
-
-#define MUX06MC_TRIS    TRISCbits.TRISC2
-#define MUX06MC         PORTCbits.RC2
+// Multiplexer output pins and input wiring: see board_inputs.h
 
 // Input array indices (IN01 = index 0, IN38 = index 37, HSIN01 = index 38, etc.)
 #define INPUT_COUNT     44
+#define INPUT_PACKED_BYTES  ((INPUT_COUNT + 7) / 8)   // Inputs_GetPacked() size
 
 // Named input indices for convenience
 #define IN01    0
@@ -124,6 +124,13 @@ void Inputs_Init(void);
  */
 void Inputs_Scan(void);
 
+/**
+ * Read every input once, without debouncing or side effects
+ * Used by the power manager to wake from Sleep on an input change.
+ * @return 1 if any raw reading differs from its stable state
+ */
+uint8_t Inputs_PollChanged(void);
+
 /**
  * Get the stable state of a specific input
  * @param input_num Input number (0-43)
@@ -131,6 +138,34 @@ void Inputs_Scan(void);
  */
 uint8_t Inputs_GetState(uint8_t input_num);
 
+/**
+ * Get all stable input states as a bitmap
+ * Bit (n & 7) of byte (n >> 3) is input n; bits above input 43 are 0.
+ * Maintained as inputs change, so this is a plain copy.
+ * @param packed Destination, INPUT_PACKED_BYTES bytes
+ */
+void Inputs_GetPacked(uint8_t packed[INPUT_PACKED_BYTES]);
+
+/**
+ * Save stable states, ignition / security and one-button ignition latches
+ * to persistent RAM (call after every Inputs_Scan)
+ */
+void Inputs_SaveWarm(void);
+
+/**
+ * Restore the state saved before a watchdog reset
+ * Call after EEPROM_Cases_Init(). Starters are restored OFF.
+ * @return 1 if a valid copy was restored, 0 if the copy was invalid
+ */
+uint8_t Inputs_RestoreWarm(void);
+
+/**
+ * Get the input state version counter
+ * Incremented whenever any stable input state changes.
+ * @return Counter value (compare for inequality only, wraps)
+ */
+uint16_t Inputs_GetVersion(void);
+
 /**
  * Get the name string for an input
  * @param input_num Input number (0-43)
@@ -206,4 +241,50 @@ uint8_t Inputs_IsOneButtonStartInput(uint8_t input_num);
  */
 uint8_t Inputs_OneButtonStartStateChanged(void);
 
+/**
+ * Take the next one-button latch change still to be sent
+ * Call right after Inputs_Scan() and send each frame directly; the
+ * aggregated transmit flagged by Inputs_OneButtonStartStateChanged()
+ * then finds nothing new for these bits.
+ * 
+ * @param input_num One-button input
+ * @param ignition_on Latched ignition bit
+ * @param starter_on Starter bit
+ * @param edge_ms system_time_ms when the change was seen
+ * @return 1 if a frame was taken, 0 if none pending
+ */
+uint8_t Inputs_TakeOneButtonFrame(uint8_t *input_num, uint8_t *ignition_on,
+                                  uint8_t *starter_on, uint32_t *edge_ms);
+
+/**
+ * Report a one-button frame as sent (edge_ms from Inputs_TakeOneButtonFrame)
+ */
+void Inputs_OneButtonFrameSent(uint32_t edge_ms);
+
+/**
+ * Report a fast path frame sent for the input's last stable change
+ * Records the time from the debounced edge (ms, saturated at 255)
+ */
+void Inputs_EdgeSent(uint8_t input_num);
+
+/**
+ * Get the edge-to-frame times recorded by Inputs_EdgeSent()
+ * @return Frames recorded (saturated at 255), 0 = none, last/max untouched
+ */
+uint8_t Inputs_GetEdgeLatency(uint8_t input_num, uint8_t *last_ms, uint8_t *max_ms);
+
+/**
+ * Load the per-input debounce scans and the adaptive switch from EEPROM
+ * Called by Inputs_Init() and when the table is written over CAN
+ * (adaptive additions are dropped)
+ */
+void Inputs_LoadDebounce(void);
+
+uint8_t Inputs_GetDebounceScans(uint8_t input_num);    // Scans in use now
+uint8_t Inputs_GetBounceRate(uint8_t input_num);       // Bounces in the last BOUNCE_WINDOW_MS
+uint16_t Inputs_GetBounceCount(uint8_t input_num);     // Bounces since power-up (saturated)
+
+uint16_t Inputs_GetOneButtonLatencyMax(void);   // Worst edge-to-frame time (ms)
+uint8_t Inputs_GetOneButtonLateCount(void);     // Frames over ONE_BUTTON_TX_BOUND_MS
+
 #endif // INPUTS_H
\ No newline at end of file
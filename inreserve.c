@@ -4,13 +4,30 @@
  * 
  * Monitors PowerCell voltage and activates a latching solenoid output
  * to disconnect the battery after sustained low voltage condition.
+ * 
+ * Telemetry is event driven: each frame from a monitored PowerCell
+ * is pushed through that cell's median window, and the ladder stages
+ * for the cell are only evaluated when a new sample arrives. A short
+ * crank sag is rejected by the median, and each stage has a restore
+ * hysteresis so its timer does not restart on noise around the threshold.
+ * 
+ * Load-Shedding Ladder:
+ *   Stage 0 is the classic single-output config (EEPROM bytes 8-9).
+ *   Stages 1-4 come from EEPROM_INRESERVE_LADDER_START (4 bytes each):
+ *     Byte 0: [Cell ID][Voltage code]          (0xFF / cell 0 = unused)
+ *     Byte 1: Outputs 1-8 (bit 7=out1 ... bit 0=out8)
+ *     Byte 2: [out9][out10][Action][Hysteresis, 50mV units, 0=200mV]
+ *     Byte 3: [Dwell code][Restore dwell code]
+ *   Action 0 = cut (force the outputs OFF), 1 = assert (force ON).
+ *   Shed outputs are applied as masks on the PowerCell command frame
+ *   (PGN FF00 + cell, SA 0x1E) during aggregation, so shed and restore
+ *   go through the same change detection as every other output.
  */
 
 #include "inreserve.h"
 #include "eeprom_config.h"
-#include "j1939.h"
+#include "format.h"
 #include <string.h>
-#include <stdio.h>
 
 // ============================================================================
 // MODULE STATE
@@ -19,6 +36,40 @@
 static InReserveConfig config;
 static InReserveState state;
 
+// Per-cell telemetry filter
+typedef struct {
+    uint8_t cell_id;            // PowerCell ID (0 = slot unused)
+    uint16_t window[INRESERVE_MEDIAN_WINDOW];
+    uint8_t window_pos;
+    uint8_t sample_count;
+    uint16_t filtered_mv;
+    uint32_t last_sample_ms;
+    uint8_t stale;
+} InReserveCell;
+
+// Ladder stage
+typedef struct {
+    uint8_t cell_id;            // PowerCell ID (0 = stage unused)
+    uint8_t action;             // INRESERVE_ACTION_CUT / ASSERT
+    uint8_t mask[2];            // Output bits in CAN bytes 0-1
+    uint16_t voltage_mv;        // Shed at or below this
+    uint16_t hysteresis_mv;     // Restore above voltage_mv + hysteresis_mv
+    uint32_t dwell_ms;          // Time low before shedding
+    uint32_t restore_ms;        // Time recovered before restoring
+    uint8_t shed;               // 1 while stage is shed
+    uint8_t timer_active;       // 1 while a dwell or restore timer runs
+    uint32_t timer_start_ms;
+} InReserveStage;
+
+static InReserveCell cells[INRESERVE_MAX_CELLS];
+static InReserveStage stages[INRESERVE_MAX_STAGES];
+static InReserveShed sheds[INRESERVE_MAX_CELLS];
+
+// PowerCell ID (telemetry PGN - INRESERVE_TELEMETRY_PGN_BASE) → cell slot
+static uint8_t cell_slot[16];
+
+static uint8_t shed_changed = 0;
+
 // System tick (imported from main.c)
 extern volatile uint32_t system_time_ms;
 
@@ -31,10 +82,17 @@ extern volatile uint32_t system_time_ms;
  */
 static uint32_t TimeCodeToSeconds(uint8_t time_code) {
     // 0=30sec (dev), 1=15min, 2=20min
+    // 3-8 are only reachable from ladder stages
     switch (time_code) {
         case 0: return 30;        // 30 seconds (dev/test)
         case 1: return 15 * 60;   // 15 minutes
         case 2: return 20 * 60;   // 20 minutes
+        case 3: return 60;        // 1 minute
+        case 4: return 2 * 60;    // 2 minutes
+        case 5: return 5 * 60;    // 5 minutes
+        case 6: return 10 * 60;   // 10 minutes
+        case 7: return 30 * 60;   // 30 minutes
+        case 8: return 60 * 60;   // 60 minutes
         default: return 15 * 60;  // Default to 15 min
     }
 }
@@ -48,6 +106,215 @@ static uint16_t VoltageCodeToMV(uint8_t voltage_code) {
     return 12100 + (voltage_code * 100);
 }
 
+/**
+ * Set the CAN output bit for an output number (1-10)
+ * Outputs 1-8 are in byte 0: bit 7=out1, bit 6=out2, ..., bit 0=out8
+ * Outputs 9-10 are in byte 1: bit 7=out9, bit 6=out10
+ */
+static void OutputToMask(uint8_t output, uint8_t *mask) {
+    mask[0] = 0;
+    mask[1] = 0;
+    if (output >= 1 && output <= 8) {
+        mask[0] = (1 << (8 - output));
+    } else if (output == 9 || output == 10) {
+        mask[1] = (1 << (16 - output));
+    }
+}
+
+/**
+ * Find or allocate the filter slot for a PowerCell
+ * @return Slot index, or 0xFF if all slots are taken
+ */
+static uint8_t AllocCell(uint8_t cell_id) {
+    if (cell_slot[cell_id] != 0xFF) {
+        return cell_slot[cell_id];
+    }
+    
+    for (uint8_t i = 0; i < INRESERVE_MAX_CELLS; i++) {
+        if (cells[i].cell_id == 0) {
+            cells[i].cell_id = cell_id;
+            cells[i].last_sample_ms = system_time_ms;
+            cell_slot[cell_id] = i;
+            
+            sheds[i].pgn = 0xFF00 + cell_id;
+            sheds[i].source_addr = INRESERVE_COMMAND_SA;
+            return i;
+        }
+    }
+    return 0xFF;
+}
+
+/**
+ * Median of the samples currently in a cell's window
+ */
+static uint16_t MedianOfWindow(InReserveCell *c) {
+    uint16_t sorted[INRESERVE_MEDIAN_WINDOW];
+    uint8_t n = c->sample_count;
+    
+    if (n == 0) {
+        return 0;
+    }
+    
+    // Insertion sort - at most 5 entries
+    for (uint8_t i = 0; i < n; i++) {
+        uint16_t v = c->window[i];
+        uint8_t j = i;
+        while (j > 0 && sorted[j - 1] > v) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = v;
+    }
+    
+    return sorted[n / 2];
+}
+
+/**
+ * Rebuild the shed masks for one cell from its stages
+ */
+static void RebuildShed(uint8_t slot) {
+    InReserveShed *s = &sheds[slot];
+    uint8_t cell_id = cells[slot].cell_id;
+    
+    s->clear_mask[0] = 0;
+    s->clear_mask[1] = 0;
+    s->set_mask[0] = 0;
+    s->set_mask[1] = 0;
+    
+    for (uint8_t i = 0; i < INRESERVE_MAX_STAGES; i++) {
+        InReserveStage *st = &stages[i];
+        if (st->cell_id != cell_id || !st->shed) {
+            continue;
+        }
+        
+        if (st->action == INRESERVE_ACTION_ASSERT) {
+            s->set_mask[0] |= st->mask[0];
+            s->set_mask[1] |= st->mask[1];
+            // Keep contributing (as zeros) after restore so the release is sent
+            s->announce = 1;
+        } else {
+            s->clear_mask[0] |= st->mask[0];
+            s->clear_mask[1] |= st->mask[1];
+        }
+    }
+    
+    shed_changed = 1;
+}
+
+/**
+ * Evaluate one stage against a new filtered sample
+ * @return 1 if the stage shed or restored
+ */
+static uint8_t EvaluateStage(InReserveStage *st, uint16_t filtered_mv) {
+    uint32_t now = system_time_ms;
+    
+    if (!st->shed) {
+        if (filtered_mv <= st->voltage_mv) {
+            if (!st->timer_active) {
+                st->timer_active = 1;
+                st->timer_start_ms = now;
+            }
+            if ((now - st->timer_start_ms) >= st->dwell_ms) {
+                st->shed = 1;
+                st->timer_active = 0;
+                return 1;
+            }
+        } else {
+            st->timer_active = 0;
+        }
+    } else {
+        if (filtered_mv > st->voltage_mv + st->hysteresis_mv) {
+            if (!st->timer_active) {
+                st->timer_active = 1;
+                st->timer_start_ms = now;
+            }
+            if ((now - st->timer_start_ms) >= st->restore_ms) {
+                st->shed = 0;
+                st->timer_active = 0;
+                return 1;
+            }
+        } else {
+            st->timer_active = 0;
+        }
+    }
+    
+    return 0;
+}
+
+/**
+ * Build the ladder from config and EEPROM, resetting all runtime state
+ */
+static void BuildLadder(void) {
+    memset(cells, 0, sizeof(cells));
+    memset(stages, 0, sizeof(stages));
+    memset(sheds, 0, sizeof(sheds));
+    memset(cell_slot, 0xFF, sizeof(cell_slot));
+    
+    // Stage 0: classic single-output config, asserts the disconnect output
+    if (config.enabled) {
+        InReserveStage *st = &stages[0];
+        st->cell_id = config.cell_id;
+        st->action = INRESERVE_ACTION_ASSERT;
+        OutputToMask(config.output, st->mask);
+        st->voltage_mv = config.voltage_mv;
+        st->hysteresis_mv = INRESERVE_HYSTERESIS_MV;
+        st->dwell_ms = config.time_seconds * 1000;
+        st->restore_ms = 0;
+        AllocCell(st->cell_id);
+    }
+    
+    // Stages 1-4 from the ladder table
+    for (uint8_t i = 1; i < INRESERVE_MAX_STAGES; i++) {
+        uint16_t addr = EEPROM_INRESERVE_LADDER_START + (i - 1) * INRESERVE_STAGE_SIZE;
+        uint8_t b0 = EEPROM_Config_ReadByte(addr);
+        uint8_t b1 = EEPROM_Config_ReadByte(addr + 1);
+        uint8_t b2 = EEPROM_Config_ReadByte(addr + 2);
+        uint8_t b3 = EEPROM_Config_ReadByte(addr + 3);
+        
+        uint8_t cell_id = (b0 >> 4) & 0x0F;
+        if (b0 == 0xFF || cell_id == 0 || cell_id > 6) {
+            continue;
+        }
+        if (AllocCell(cell_id) == 0xFF) {
+            continue;
+        }
+        
+        InReserveStage *st = &stages[i];
+        st->cell_id = cell_id;
+        st->voltage_mv = VoltageCodeToMV(b0 & 0x0F);
+        st->mask[0] = b1;
+        st->mask[1] = b2 & 0xC0;
+        st->action = (b2 & 0x20) ? INRESERVE_ACTION_ASSERT : INRESERVE_ACTION_CUT;
+        st->hysteresis_mv = (b2 & 0x1F) ? (uint16_t)(b2 & 0x1F) * 50 : INRESERVE_HYSTERESIS_MV;
+        st->dwell_ms = TimeCodeToSeconds((b3 >> 4) & 0x0F) * 1000;
+        st->restore_ms = (b3 & 0x0F) ? TimeCodeToSeconds(b3 & 0x0F) * 1000 : 0;
+    }
+    
+    memset(&state, 0, sizeof(state));
+    state.last_sample_ms = system_time_ms;
+    
+    // Any previously shed outputs are released by the next aggregation
+    shed_changed = 1;
+}
+
+/**
+ * Mirror the stage 0 cell into the display state
+ */
+static void UpdateDisplayState(void) {
+    if (!config.enabled || cell_slot[config.cell_id] == 0xFF) {
+        return;
+    }
+    
+    InReserveCell *c = &cells[cell_slot[config.cell_id]];
+    state.filtered_mv = c->filtered_mv;
+    state.sample_count = c->sample_count;
+    state.last_sample_ms = c->last_sample_ms;
+    state.stale = c->stale;
+    state.timer_active = stages[0].timer_active && !stages[0].shed;
+    state.timer_start_ms = stages[0].timer_start_ms;
+    state.triggered = stages[0].shed;
+}
+
 // ============================================================================
 // INITIALIZATION
 // ============================================================================
@@ -61,17 +328,11 @@ void InReserve_Init(void) {
 }
 
 void InReserve_LoadConfig(void) {
-    // Read byte 1: [CellID][Output]
-    uint8_t byte1 = EEPROM_Config_ReadByte(EEPROM_CFG_INRESERVE_1);
-    
-    // Read byte 2: [Time][Voltage]
-    uint8_t byte2 = EEPROM_Config_ReadByte(EEPROM_CFG_INRESERVE_2);
-    
-    // Parse configuration
-    config.cell_id = (byte1 >> 4) & 0x0F;
-    config.output = byte1 & 0x0F;
-    config.time_code = (byte2 >> 4) & 0x0F;
-    config.voltage_code = byte2 & 0x0F;
+    // Byte 1: [CellID][Output], byte 2: [Time][Voltage]
+    config.cell_id = EEPROM_Config_ReadNibble(EEPROM_CFG_INRESERVE_1, 1);
+    config.output = EEPROM_Config_ReadNibble(EEPROM_CFG_INRESERVE_1, 0);
+    config.time_code = EEPROM_Config_ReadNibble(EEPROM_CFG_INRESERVE_2, 1);
+    config.voltage_code = EEPROM_Config_ReadNibble(EEPROM_CFG_INRESERVE_2, 0);
     
     // Validate and limit values
     if (config.cell_id > 6) config.cell_id = 0;  // Invalid cell ID, disable
@@ -83,6 +344,8 @@ void InReserve_LoadConfig(void) {
     config.enabled = (config.cell_id != 0) ? 1 : 0;
     config.time_seconds = TimeCodeToSeconds(config.time_code);
     config.voltage_mv = VoltageCodeToMV(config.voltage_code);
+    
+    BuildLadder();
 }
 
 void InReserve_SaveConfig(void) {
@@ -100,6 +363,8 @@ void InReserve_SaveConfig(void) {
     config.enabled = (config.cell_id != 0) ? 1 : 0;
     config.time_seconds = TimeCodeToSeconds(config.time_code);
     config.voltage_mv = VoltageCodeToMV(config.voltage_code);
+    
+    BuildLadder();
 }
 
 // ============================================================================
@@ -151,6 +416,91 @@ void InReserve_SetVoltage(uint8_t voltage_code) {
 // RUNTIME UPDATE
 // ============================================================================
 
+uint8_t InReserve_ProcessMessage(uint32_t can_id, uint8_t *data) {
+    if (data == NULL) {
+        return 0;
+    }
+    
+    // Telemetry PGNs FF11-FF16 index straight into cell_slot
+    uint16_t pgn = (can_id >> 8) & 0xFFFF;
+    uint16_t index = pgn - INRESERVE_TELEMETRY_PGN_BASE;
+    if (index >= 16 || cell_slot[index] == 0xFF) {
+        return 0;
+    }
+    
+    InReserveCell *c = &cells[cell_slot[index]];
+    
+    // Samples from before a telemetry gap say nothing about now
+    if (c->stale) {
+        c->stale = 0;
+        c->window_pos = 0;
+        c->sample_count = 0;
+    }
+    c->last_sample_ms = system_time_ms;
+    
+    // Voltage is in byte 6: raw * 125 = millivolts
+    InReserve_UpdateCell(c->cell_id, (uint16_t)data[6] * 125);
+    return 1;
+}
+
+uint8_t InReserve_CheckStale(uint32_t current_time_ms) {
+    for (uint8_t i = 0; i < INRESERVE_MAX_CELLS; i++) {
+        if (cells[i].cell_id != 0 && !cells[i].stale &&
+            (current_time_ms - cells[i].last_sample_ms) > INRESERVE_STALE_MS) {
+            cells[i].stale = 1;
+            
+            // A dwell or restore timer must not run across the gap
+            for (uint8_t s = 0; s < INRESERVE_MAX_STAGES; s++) {
+                if (stages[s].cell_id == cells[i].cell_id) {
+                    stages[s].timer_active = 0;
+                }
+            }
+        }
+    }
+    
+    state.stale = 0;
+    UpdateDisplayState();
+    
+    return state.stale;
+}
+
+void InReserve_UpdateCell(uint8_t cell_id, uint16_t current_voltage_mv) {
+    if (cell_id >= 16 || cell_slot[cell_id] == 0xFF) {
+        return;
+    }
+    
+    uint8_t slot = cell_slot[cell_id];
+    InReserveCell *c = &cells[slot];
+    
+    // Push into median window
+    c->window[c->window_pos] = current_voltage_mv;
+    c->window_pos = (c->window_pos + 1) % INRESERVE_MEDIAN_WINDOW;
+    if (c->sample_count < INRESERVE_MEDIAN_WINDOW) {
+        c->sample_count++;
+    }
+    c->filtered_mv = MedianOfWindow(c);
+    
+    // Evaluate only this cell's stages, and only on a full window - a
+    // median of fewer samples (startup, after a gap) is not filtered
+    if (c->sample_count == INRESERVE_MEDIAN_WINDOW) {
+        uint8_t changed = 0;
+        for (uint8_t i = 0; i < INRESERVE_MAX_STAGES; i++) {
+            if (stages[i].cell_id == cell_id) {
+                changed |= EvaluateStage(&stages[i], c->filtered_mv);
+            }
+        }
+        if (changed) {
+            RebuildShed(slot);
+        }
+    }
+    
+    // Display shows the stage 0 cell
+    if (config.enabled && cell_id == config.cell_id) {
+        state.last_voltage_mv = current_voltage_mv;
+        UpdateDisplayState();
+    }
+}
+
 void InReserve_Update(uint16_t current_voltage_mv) {
     // Store last voltage for display
     state.last_voltage_mv = current_voltage_mv;
@@ -160,54 +510,35 @@ void InReserve_Update(uint16_t current_voltage_mv) {
         return;
     }
     
-    // Check if voltage is below or equal to threshold
-    if (current_voltage_mv <= config.voltage_mv) {
-        // Voltage is low
-        if (!state.timer_active) {
-            // Start the timer
-            state.timer_active = 1;
-            state.timer_start_ms = system_time_ms;
-        }
-        
-        // Check if time threshold reached
-        uint32_t elapsed_ms = system_time_ms - state.timer_start_ms;
-        uint32_t threshold_ms = config.time_seconds * 1000;
-        
-        if (elapsed_ms >= threshold_ms) {
-            // Time threshold reached - trigger the output!
-            state.triggered = 1;  // Mark that we've triggered (for display)
-            
-            // Send CAN message to activate the PowerCell output
-            // Build message for the configured PowerCell
-            uint8_t data[8] = {0, 0, 0, 0, 0, 0, 0, 0};
-            
-            // Set the output bit
-            // Outputs 1-8 are in byte 0: bit 7=out1, bit 6=out2, ..., bit 0=out8
-            // Outputs 9-10 are in byte 1: bit 7=out9, bit 6=out10
-            if (config.output <= 8) {
-                data[0] = (1 << (8 - config.output));  // Bit 7=out1, bit 0=out8
-            } else {
-                data[1] = (1 << (16 - config.output)); // Bit 7=out9, bit 6=out10
-            }
-            
-            // Determine PGN based on PowerCell ID
-            // Front (cell 1): FF01, Rear (cell 2): FF02, etc.
-            uint16_t pgn = 0xFF00 + config.cell_id;
-            
-            // Transmit the message (priority 6, SA 0x1E like other MASTERCELL messages)
-            J1939_TransmitMessage(6, pgn, 0x1E, data);
-            
-            // Reset timer to try again if still powered
-            state.timer_start_ms = system_time_ms;
-        }
-    } else {
-        // Voltage is OK - reset timer and triggered flag
-        state.timer_active = 0;
-        state.triggered = 0;
+    InReserve_UpdateCell(config.cell_id, current_voltage_mv);
+}
+
+uint8_t InReserve_ShedStateChanged(void) {
+    if (shed_changed) {
+        shed_changed = 0;
+        return 1;
+    }
+    return 0;
+}
+
+InReserveShed* InReserve_GetShed(uint8_t index) {
+    if (index >= INRESERVE_MAX_CELLS || cells[index].cell_id == 0) {
+        return NULL;
     }
+    return &sheds[index];
 }
 
 void InReserve_Reset(void) {
+    for (uint8_t i = 0; i < INRESERVE_MAX_STAGES; i++) {
+        stages[i].shed = 0;
+        stages[i].timer_active = 0;
+    }
+    for (uint8_t i = 0; i < INRESERVE_MAX_CELLS; i++) {
+        if (cells[i].cell_id != 0) {
+            RebuildShed(i);
+        }
+    }
+    
     state.timer_active = 0;
     state.triggered = 0;
     state.timer_start_ms = 0;
@@ -241,10 +572,8 @@ const char* InReserve_GetTimeString(uint8_t time_code) {
 
 void InReserve_GetVoltageString(uint8_t voltage_code, char* buffer) {
     // Calculate voltage: 12.1 + (code * 0.1)
-    uint16_t mv = VoltageCodeToMV(voltage_code);
-    uint8_t volts = mv / 1000;
-    uint8_t tenths = (mv % 1000) / 100;
-    sprintf(buffer, "%d.%dV", volts, tenths);
+    char *p = Format_Fixed1(buffer, VoltageCodeToMV(voltage_code));
+    Format_End(Format_Char(p, 'V'));
 }
 
 uint8_t InReserve_GetMinOutput(uint8_t cell_id) {
@@ -12,6 +12,9 @@
  *   Byte 2: [ZZZZ][QQQQ]
  *     ZZZZ = Time threshold (0=5min, 1=10min, 2=15min, 3=20min)
  *     QQQQ = Voltage threshold (0=11.9V, 1=12.0V, ... 0xB=13.0V)
+ * 
+ * Additional load-shedding stages (multi-cell, multi-output) are read
+ * from EEPROM_INRESERVE_LADDER_START - see inreserve.c for the layout.
  */
 
 #ifndef INRESERVE_H
@@ -42,6 +45,30 @@
 #define INRESERVE_VOLTAGE_12_2V     0x1
 #define INRESERVE_VOLTAGE_12_3V     0x2
 
+// ============================================================================
+// TELEMETRY FILTERING
+// ============================================================================
+
+// PowerCell telemetry PGN = base + cell ID (FF11 = Front, FF12 = Rear)
+#define INRESERVE_TELEMETRY_PGN_BASE    0xFF10
+
+#define INRESERVE_MEDIAN_WINDOW     5       // Samples in median window (odd)
+#define INRESERVE_HYSTERESIS_MV     200     // Must recover this far above threshold
+#define INRESERVE_STALE_MS          5000    // No telemetry for this long = stale
+
+// ============================================================================
+// LOAD-SHEDDING LADDER
+// ============================================================================
+
+#define INRESERVE_MAX_STAGES        5       // Stage 0 (bytes 8-9) + 4 ladder stages
+#define INRESERVE_MAX_CELLS         4       // Distinct PowerCells monitored at once
+#define INRESERVE_STAGE_SIZE        4       // EEPROM bytes per ladder stage
+
+#define INRESERVE_ACTION_CUT        0       // Force stage outputs OFF
+#define INRESERVE_ACTION_ASSERT     1       // Force stage outputs ON (disconnect solenoid)
+
+#define INRESERVE_COMMAND_SA        0x1E    // SA of PowerCell command frames (FF00 + cell)
+
 // ============================================================================
 // CONFIGURATION STRUCTURE
 // ============================================================================
@@ -64,9 +91,23 @@ typedef struct {
     uint8_t timer_active;       // 1 if countdown timer is running
     uint32_t timer_start_ms;    // System time when timer started
     uint8_t triggered;          // 1 if output has been activated
-    uint16_t last_voltage_mv;   // Last read voltage in millivolts
+    uint16_t last_voltage_mv;   // Last raw sample in millivolts
+    uint16_t filtered_mv;       // Median-filtered voltage in millivolts
+    uint8_t sample_count;       // Samples in median window (0-INRESERVE_MEDIAN_WINDOW)
+    uint32_t last_sample_ms;    // System time of last telemetry frame
+    uint8_t stale;              // 1 if configured PowerCell stopped reporting
 } InReserveState;
 
+// Output masks a PowerCell command frame must carry while stages are shed.
+// Applied during aggregation: data = (data & ~clear_mask) | set_mask
+typedef struct {
+    uint16_t pgn;               // PowerCell command PGN (FF00 + cell ID)
+    uint8_t source_addr;        // INRESERVE_COMMAND_SA
+    uint8_t clear_mask[2];      // Cut-stage output bits, CAN bytes 0-1
+    uint8_t set_mask[2];        // Assert-stage output bits, CAN bytes 0-1
+    uint8_t announce;           // 1 = add frame even if no case drives this PGN
+} InReserveShed;
+
 // ============================================================================
 // FUNCTION PROTOTYPES
 // ============================================================================
@@ -100,14 +141,54 @@ InReserveConfig* InReserve_GetConfig(void);
 InReserveState* InReserve_GetState(void);
 
 /**
- * Update inRESERVE state - call periodically from main loop
- * Monitors voltage and manages timer
+ * Update inRESERVE state with a new sample for the stage 0 PowerCell
  * @param current_voltage_mv Current PowerCell voltage in millivolts
  */
 void InReserve_Update(uint16_t current_voltage_mv);
 
+/**
+ * Feed a voltage sample for a PowerCell
+ * Filters the sample and evaluates only the stages on that cell.
+ * Called from InReserve_ProcessMessage, once per telemetry frame.
+ * @param cell_id PowerCell ID
+ * @param current_voltage_mv Voltage in millivolts
+ */
+void InReserve_UpdateCell(uint8_t cell_id, uint16_t current_voltage_mv);
+
+/**
+ * Check if any stage shed or restored since the last call
+ * Main loop uses this to trigger aggregation.
+ * @return 1 if changed, 0 otherwise
+ */
+uint8_t InReserve_ShedStateChanged(void);
+
+/**
+ * Get shed masks for a monitored PowerCell (for aggregation)
+ * @param index Cell slot (0 to INRESERVE_MAX_CELLS-1)
+ * @return Pointer to masks, or NULL if slot unused
+ */
+InReserveShed* InReserve_GetShed(uint8_t index);
+
+/**
+ * Process an incoming CAN message
+ * Telemetry PGNs of monitored PowerCells are found by table index.
+ * @param can_id Full 29-bit CAN ID
+ * @param data Pointer to 8-byte data payload
+ * @return 1 if message was a telemetry sample for inRESERVE, 0 otherwise
+ */
+uint8_t InReserve_ProcessMessage(uint32_t can_id, uint8_t *data);
+
+/**
+ * Check for stale telemetry - call periodically from main loop
+ * Sets state.stale if the configured PowerCell has stopped reporting.
+ * @param current_time_ms Current system time in milliseconds
+ * @return 1 if telemetry is stale, 0 otherwise
+ */
+uint8_t InReserve_CheckStale(uint32_t current_time_ms);
+
 /**
  * Reset the inRESERVE trigger (after battery reconnect)
+ * Restores every shed stage.
  */
 void InReserve_Reset(void);
 
@@ -1,240 +1,223 @@
 /*
  * J1939 CAN Communication Implementation
- * FIXED: Correct bit positions for dsPIC30F6012A
+ * Controller register access is in the board layer (board.h)
  */
 
 #include "j1939.h"
 #include "eeprom_config.h"
 #include "inputs.h"
+#include "outputs.h"
+#include "inreserve.h"
+#include "power.h"
+#include "gateway.h"
+#include "board.h"
 #include <string.h>
 
-#define FCY 16000000UL
-#include <libpic30.h>
+#if (CAN_RX_BUFFER_SIZE & (CAN_RX_BUFFER_SIZE - 1)) || CAN_RX_BUFFER_SIZE > 128
+#error "CAN_RX_BUFFER_SIZE must be a power of two, max 128"
+#endif
+#define RX_INDEX_MASK (CAN_RX_BUFFER_SIZE - 1)
 
+// Receive FIFO - written by _C1Interrupt, read with the CAN interrupt off
 static CAN_RxMessage rx_buffer[CAN_RX_BUFFER_SIZE];
-static uint8_t rx_write_index = 0;
-static uint8_t rx_read_index = 0;
-static uint8_t rx_count = 0;
-static uint8_t rx_overflow_flag = 0;
+static volatile uint8_t rx_write_index = 0;
+static volatile uint8_t rx_read_index = 0;
+static volatile uint8_t rx_count = 0;
+static volatile uint8_t rx_high_water = 0;
+static volatile uint8_t rx_peak = 0;               // High water since the last heartbeat
+static volatile uint8_t rx_overflow_flag = 0;
 
-static uint32_t rx_message_count = 0;
-static uint16_t rx_overflow_count = 0;
+static volatile uint32_t rx_message_count = 0;
+static volatile uint16_t rx_overflow_count = 0;
 
-volatile uint16_t debug_sid_reg = 0;
-volatile uint16_t debug_eid_reg = 0;
-volatile uint16_t debug_dlc_reg = 0;
+// Error state - sampled by the error interrupt and J1939_ServiceErrors()
+static volatile uint8_t error_state = BOARD_CAN_ERROR_ACTIVE;
+static volatile uint8_t error_tec = 0;
+static volatile uint8_t error_rec = 0;
+static volatile uint16_t error_passive_count = 0;
+static volatile uint16_t bus_off_count = 0;
+static volatile uint8_t error_irq_count = 0;        // Error interrupts this second
+
+// Bus-off recovery
+static uint8_t bus_off_waiting = 0;
+static uint16_t bus_off_backoff_ms = CAN_BUSOFF_BACKOFF_MIN_MS;
+static uint32_t bus_off_restart_at = 0;
+static uint32_t bus_last_recovery = 0;
+
+// Error rate over the last full second (diagnostic PGN)
+// Heartbeat identifier, encoded once from config (J1939_LoadHeartbeatConfig)
+static uint16_t heartbeat_pgn = 0;
+static uint8_t heartbeat_sa = 0;
+static BoardCANTxImage heartbeat_image;
+static uint8_t heartbeat_seq = 0;
+static uint16_t heartbeat_overflow_mark = 0;
+
+static uint8_t error_rate = 0;
+static uint32_t error_rate_start = 0;
+
+// Next input for diagnostic pages 3 and 4
+static uint8_t diag_edge_input = 0;
+static uint8_t diag_bounce_input = 0;
+
+// Diagnostic schedule, and the CAN page counters as last sent
+static uint8_t diag_seconds = 0;
+static uint8_t diag_sent_state = BOARD_CAN_ERROR_ACTIVE;
+static uint16_t diag_sent_passive = 0;
+static uint16_t diag_sent_bus_off = 0;
+static uint16_t diag_sent_overflow = 0;
+
+// Transport protocol session (one at a time)
+#define TP_IDLE         0
+#define TP_RECEIVING    1
+#define TP_COMPLETE     2   // Waiting for J1939_TPComplete()
+
+static uint8_t tp_state = TP_IDLE;
+static uint8_t tp_source = 0;
+static uint16_t tp_pgn = 0;
+static uint16_t tp_size = 0;
+static uint8_t tp_packets = 0;
+static uint8_t tp_max_per_cts = 0;
+static uint8_t tp_next = 0;             // Next sequence number expected
+static uint8_t tp_window_end = 0;       // Last sequence number of the current CTS
+static uint32_t tp_deadline = 0;
+static uint8_t tp_buffer[J1939_TP_MAX_SIZE];
+
+/*
+ * Read TEC/REC and the state, counting entries into passive and bus-off
+ * Called from the CAN interrupt and from the main loop (with it disabled)
+ */
+static void SampleErrorState(void) {
+    uint8_t tec, rec;
+    uint8_t state = Board_CANGetErrorState(&tec, &rec);
+
+    if (state != error_state) {
+        if (state == BOARD_CAN_BUS_OFF) {
+            bus_off_count++;
+        } else if (state == BOARD_CAN_ERROR_PASSIVE && error_state < BOARD_CAN_ERROR_PASSIVE) {
+            error_passive_count++;
+        }
+        error_state = state;
+    }
+    error_tec = tec;
+    error_rec = rec;
+}
 
 void J1939_Init(void) {
-    uint16_t timeout;
-    
     memset(rx_buffer, 0, sizeof(rx_buffer));
     rx_write_index = 0;
     rx_read_index = 0;
     rx_count = 0;
+    rx_high_water = 0;
     rx_overflow_flag = 0;
     rx_message_count = 0;
     rx_overflow_count = 0;
     
-    C1CTRLbits.REQOP = 4;
-    timeout = 10000;
-    while(C1CTRLbits.OPMODE != 4 && timeout > 0) timeout--;
-    if (timeout == 0) return;
-    
-    C1CFG1bits.BRP = 7;
-    C1CFG1bits.SJW = 0;
-    
-    C1CFG2bits.PRSEG = 6;
-    C1CFG2bits.SEG1PH = 3;
-    C1CFG2bits.SEG2PHTS = 1;
-    C1CFG2bits.SEG2PH = 3;
-    C1CFG2bits.SAM = 0;
-    
-    C1CTRLbits.CANCKS = 0;
-    
-    C1TX0CONbits.TXPRI = 0b11;
-    
-    // Enable double buffering - RX0 and RX1 work as FIFO
-    // This gives us 2 hardware message slots instead of 1
-    // When RX0 is full, next message goes to RX1
-    // When we read RX0, RX1 shifts to RX0 automatically
-    C1RX0CONbits.DBEN = 1;
-    
-    J1939_SetPromiscuousMode();
-    
-    C1INTEbits.RX0IE = 1;
-    
-    // Disable CAN interrupt - use polling only (interrupt caused boot issues)
-    IFS1bits.C1IF = 0;  // Clear any pending interrupt flag
-    IEC1bits.C1IE = 0;  // DISABLE CAN interrupt - use polling instead
-    
-    C1CTRLbits.REQOP = 0;
-    timeout = 10000;
-    while(C1CTRLbits.OPMODE != 0 && timeout > 0) timeout--;
-    
-    __delay_ms(10);
+    error_state = BOARD_CAN_ERROR_ACTIVE;
+    error_passive_count = 0;
+    bus_off_count = 0;
+    error_irq_count = 0;
+    bus_off_waiting = 0;
+    bus_off_backoff_ms = CAN_BUSOFF_BACKOFF_MIN_MS;
+    
+    diag_seconds = 0;
+    diag_sent_state = BOARD_CAN_ERROR_ACTIVE;
+    diag_sent_passive = 0;
+    diag_sent_bus_off = 0;
+    diag_sent_overflow = 0;
+    
+    Board_CANInit();
+    Board_CANSetRxInterrupt(1);
 }
 
-void __attribute__((interrupt, no_auto_psv)) _C1Interrupt(void) {
-    if (C1RX0CONbits.RXFUL) {
+void J1939_InitBus2(void) {
+    Board_CAN2Init();
+    Board_CANSetRxInterrupt(1);
+}
+
+static uint8_t ReceiveFrom(uint8_t bus, uint32_t *id, uint8_t data[8], uint8_t *dlc) {
+    if (bus == CAN_BUS_2) {
+        return Board_CAN2Receive(id, data, dlc);
+    }
+    return Board_CANReceive(id, data, dlc);
+}
+
+/*
+ * Empty both hardware buffers of a controller into the FIFO - a second
+ * frame may be waiting in RX1. Called from the receive ISRs only.
+ */
+static void QueueFrames(uint8_t bus) {
+    for (;;) {
         if (rx_count >= CAN_RX_BUFFER_SIZE) {
+            CAN_RxMessage discard;
+            if (!ReceiveFrom(bus, &discard.id, discard.data, &discard.dlc)) {
+                break;
+            }
             rx_overflow_flag = 1;
             rx_overflow_count++;
-            C1RX0CONbits.RXFUL = 0;
-            IFS1bits.C1IF = 0;
-            return;
+            continue;
         }
         
-        uint16_t sid_reg = C1RX0SID;
-        uint16_t eid_reg = C1RX0EID;
-        uint16_t dlc_reg = C1RX0DLC;
-        
-        // CORRECT extraction for dsPIC30F6012A:
-        // C1RX0SID[12:2] = EID[28:18] (11 bits)
-        uint16_t eid_28_18 = (sid_reg >> 2) & 0x7FF;
-        
-        // C1RX0EID[11:0] = EID[17:6] (12 bits)
-        uint16_t eid_17_6 = eid_reg & 0xFFF;
-        
-        // C1RX0DLC[15:10] = EID[5:0] (6 bits)
-        uint8_t eid_5_0 = (dlc_reg >> 10) & 0x3F;
-        
-        // Reconstruct 29-bit extended ID
-        uint32_t msg_id = ((uint32_t)eid_28_18 << 18) |
-                          ((uint32_t)eid_17_6 << 6) |
-                          eid_5_0;
-        
-        // C1RX0DLC[3:0] = DLC
-        uint8_t dlc = dlc_reg & 0x0F;
-        if (dlc > 8) dlc = 8;
-        
-        rx_buffer[rx_write_index].id = msg_id;
-        rx_buffer[rx_write_index].dlc = dlc;
-        rx_buffer[rx_write_index].valid = 1;
-        
-        uint16_t data_word;
-        data_word = C1RX0B1;
-        rx_buffer[rx_write_index].data[0] = data_word & 0xFF;
-        rx_buffer[rx_write_index].data[1] = (data_word >> 8) & 0xFF;
-        
-        data_word = C1RX0B2;
-        rx_buffer[rx_write_index].data[2] = data_word & 0xFF;
-        rx_buffer[rx_write_index].data[3] = (data_word >> 8) & 0xFF;
-        
-        data_word = C1RX0B3;
-        rx_buffer[rx_write_index].data[4] = data_word & 0xFF;
-        rx_buffer[rx_write_index].data[5] = (data_word >> 8) & 0xFF;
-        
-        data_word = C1RX0B4;
-        rx_buffer[rx_write_index].data[6] = data_word & 0xFF;
-        rx_buffer[rx_write_index].data[7] = (data_word >> 8) & 0xFF;
-        
-        rx_write_index = (rx_write_index + 1) % CAN_RX_BUFFER_SIZE;
+        CAN_RxMessage *slot = &rx_buffer[rx_write_index];
+        if (!ReceiveFrom(bus, &slot->id, slot->data, &slot->dlc)) {
+            break;
+        }
+        slot->valid = 1;
+        slot->bus = bus;
+        rx_write_index = (rx_write_index + 1) & RX_INDEX_MASK;
         rx_count++;
         rx_message_count++;
         
-        C1RX0CONbits.RXFUL = 0;
+        if (rx_count > rx_high_water) {
+            rx_high_water = rx_count;
+        }
+        if (rx_count > rx_peak) {
+            rx_peak = rx_count;
+        }
     }
-    
-    IFS1bits.C1IF = 0;
 }
 
-uint8_t J1939_ReceiveMessage(CAN_RxMessage *msg) {
-    if (msg == NULL) {
-        return 0;
+void __attribute__((interrupt, no_auto_psv)) _C1Interrupt(void) {
+    IFS1bits.C1IF = 0;
+    
+    if (Board_CANAckErrorInterrupt()) {
+        if (error_irq_count < 0xFF) {
+            error_irq_count++;
+        }
+        SampleErrorState();
     }
     
-    // With DBEN=1, we have two RX buffers working as FIFO
-    // Check RX0 first (primary buffer)
-    if (C1RX0CONbits.RXFUL) {
-        uint16_t sid_reg = C1RX0SID;
-        uint16_t eid_reg = C1RX0EID;
-        uint16_t dlc_reg = C1RX0DLC;
-        
-        debug_sid_reg = sid_reg;
-        debug_eid_reg = eid_reg;
-        debug_dlc_reg = dlc_reg;
-        
-        // CORRECT extraction for dsPIC30F6012A:
-        uint16_t eid_28_18 = (sid_reg >> 2) & 0x7FF;
-        uint16_t eid_17_6 = eid_reg & 0xFFF;
-        uint8_t eid_5_0 = (dlc_reg >> 10) & 0x3F;
-        
-        msg->id = ((uint32_t)eid_28_18 << 18) |
-                  ((uint32_t)eid_17_6 << 6) |
-                  eid_5_0;
-        
-        msg->dlc = dlc_reg & 0x0F;
-        if (msg->dlc > 8) msg->dlc = 8;
-        msg->valid = 1;
-        
-        uint16_t data_word;
-        data_word = C1RX0B1;
-        msg->data[0] = data_word & 0xFF;
-        msg->data[1] = (data_word >> 8) & 0xFF;
-        data_word = C1RX0B2;
-        msg->data[2] = data_word & 0xFF;
-        msg->data[3] = (data_word >> 8) & 0xFF;
-        data_word = C1RX0B3;
-        msg->data[4] = data_word & 0xFF;
-        msg->data[5] = (data_word >> 8) & 0xFF;
-        data_word = C1RX0B4;
-        msg->data[6] = data_word & 0xFF;
-        msg->data[7] = (data_word >> 8) & 0xFF;
-        
-        C1RX0CONbits.RXFUL = 0;
-        rx_message_count++;
-        
-        return 1;
+    QueueFrames(CAN_BUS_1);
+}
+
+void __attribute__((interrupt, no_auto_psv)) _C2Interrupt(void) {
+    IFS2bits.C2IF = 0;
+    
+    // Gateway segment errors are polled by Gateway_Service()
+    Board_CAN2AckErrorInterrupt();
+    
+    QueueFrames(CAN_BUS_2);
+}
+
+uint8_t J1939_ReceiveBatch(CAN_RxMessage *msgs, uint8_t max) {
+    uint8_t n = 0;
+    
+    if (msgs == NULL) {
+        return 0;
     }
     
-    // Check RX1 (overflow buffer when DBEN=1)
-    // Messages go here when RX0 is full
-    if (C1RX1CONbits.RXFUL) {
-        uint16_t sid_reg = C1RX1SID;
-        uint16_t eid_reg = C1RX1EID;
-        uint16_t dlc_reg = C1RX1DLC;
-        
-        debug_sid_reg = sid_reg;
-        debug_eid_reg = eid_reg;
-        debug_dlc_reg = dlc_reg;
-        
-        // CORRECT extraction for dsPIC30F6012A:
-        uint16_t eid_28_18 = (sid_reg >> 2) & 0x7FF;
-        uint16_t eid_17_6 = eid_reg & 0xFFF;
-        uint8_t eid_5_0 = (dlc_reg >> 10) & 0x3F;
-        
-        msg->id = ((uint32_t)eid_28_18 << 18) |
-                  ((uint32_t)eid_17_6 << 6) |
-                  eid_5_0;
-        
-        msg->dlc = dlc_reg & 0x0F;
-        if (msg->dlc > 8) msg->dlc = 8;
-        msg->valid = 1;
-        
-        uint16_t data_word;
-        data_word = C1RX1B1;
-        msg->data[0] = data_word & 0xFF;
-        msg->data[1] = (data_word >> 8) & 0xFF;
-        data_word = C1RX1B2;
-        msg->data[2] = data_word & 0xFF;
-        msg->data[3] = (data_word >> 8) & 0xFF;
-        data_word = C1RX1B3;
-        msg->data[4] = data_word & 0xFF;
-        msg->data[5] = (data_word >> 8) & 0xFF;
-        data_word = C1RX1B4;
-        msg->data[6] = data_word & 0xFF;
-        msg->data[7] = (data_word >> 8) & 0xFF;
-        
-        C1RX1CONbits.RXFUL = 0;
-        rx_message_count++;
-        
-        return 1;
+    Board_CANSetRxInterrupt(0);
+    while (n < max && rx_count > 0) {
+        msgs[n++] = rx_buffer[rx_read_index];
+        rx_read_index = (rx_read_index + 1) & RX_INDEX_MASK;
+        rx_count--;
     }
+    Board_CANSetRxInterrupt(1);
     
-    // No messages available in hardware buffers
-    // Note: rx_buffer (software buffer) is not used in polling mode
-    // since the ISR is disabled and never populates it
-    return 0;
+    return n;
+}
+
+uint8_t J1939_ReceiveMessage(CAN_RxMessage *msg) {
+    return J1939_ReceiveBatch(msg, 1);
 }
 
 void J1939_ConfigureFilters(uint16_t read_pgn, uint8_t read_sa, 
@@ -243,38 +226,51 @@ void J1939_ConfigureFilters(uint16_t read_pgn, uint8_t read_sa,
 }
 
 void J1939_SetPromiscuousMode(void) {
-    uint16_t timeout;
+    Board_CANAcceptAll();
+}
+
+uint8_t J1939_IsTxReady(void) {
+    return Board_CANTxReady();
+}
+
+void J1939_EncodeTxImage(uint8_t priority, uint16_t pgn, uint8_t source_addr, BoardCANTxImage *image) {
+    uint8_t pf = (pgn >> 8) & 0xFF;
+    uint8_t ps = pgn & 0xFF;
     
-    C1CTRLbits.REQOP = 4;
-    timeout = 10000;
-    while(C1CTRLbits.OPMODE != 4 && timeout > 0) timeout--;
-    if (timeout == 0) return;
+    uint32_t msg_id = ((uint32_t)priority << 26) | 
+                      ((uint32_t)pf << 16) | 
+                      ((uint32_t)ps << 8) | 
+                      source_addr;
     
-    C1RXM0SID = 0x0000;
-    C1RXM0EIDH = 0x0000;
-    C1RXM0EIDL = 0x0000;
-    C1RXM1SID = 0x0000;
-    C1RXM1EIDH = 0x0000;
-    C1RXM1EIDL = 0x0000;
+    Board_CANEncode(msg_id, image);
+}
+
+void J1939_TransmitImage(const BoardCANTxImage *image, uint8_t *data) {
+    // Bus-off: TXREQ never clears - drop the frame, state is resent on recovery
+    if (error_state == BOARD_CAN_BUS_OFF) {
+        return;
+    }
     
-    C1RXF0SID = 0x0001;
-    C1RXF0EIDH = 0x0000;
-    C1RXF0EIDL = 0x0000;
+    uint16_t timeout = 10000;
+    while(!Board_CANTxReady() && timeout > 0) {
+        timeout--;
+    }
     
-    C1RXF0SID |= (0 << 1);
+    if(timeout == 0) {
+        return;
+    }
     
-    C1CTRLbits.REQOP = 0;
-    timeout = 10000;
-    while(C1CTRLbits.OPMODE != 0 && timeout > 0) timeout--;
+    Board_CANTransmitImage(image, data);
 }
 
-uint8_t J1939_IsTxReady(void) {
-    return (C1TX0CONbits.TXREQ == 0);
-}
-
-void J1939_TransmitMessage(uint8_t priority, uint16_t pgn, uint8_t source_addr, uint8_t *data) {
+void J1939_TransmitPriority(const BoardCANTxImage *image, uint8_t *data) {
+    if (error_state == BOARD_CAN_BUS_OFF) {
+        return;
+    }
+    
+    // Waits for its own previous frame only, never for the aggregated ones
     uint16_t timeout = 10000;
-    while(C1TX0CONbits.TXREQ && timeout > 0) {
+    while(!Board_CANPriorityTxReady() && timeout > 0) {
         timeout--;
     }
     
@@ -282,70 +278,502 @@ void J1939_TransmitMessage(uint8_t priority, uint16_t pgn, uint8_t source_addr,
         return;
     }
     
-    uint8_t pf = (pgn >> 8) & 0xFF;
-    uint8_t ps = pgn & 0xFF;
+    Board_CANTransmitPriority(image, data);
+}
+
+void J1939_TransmitFrame(uint8_t bus, uint32_t id, uint8_t dlc, uint8_t *data) {
+    BoardCANTxImage image;
     
-    uint32_t msg_id = ((uint32_t)priority << 26) | 
-                      ((uint32_t)pf << 16) | 
-                      ((uint32_t)ps << 8) | 
-                      source_addr;
+    Board_CANEncodeLength(id, dlc, &image);
     
-    uint16_t sid = (msg_id >> 18) & 0x7FF;
-    uint8_t sid_10_6 = (sid >> 6) & 0x1F;
-    uint8_t sid_5_0 = sid & 0x3F;
+    if (bus != CAN_BUS_2) {
+        J1939_TransmitImage(&image, data);
+        return;
+    }
     
-    uint32_t eid = msg_id & 0x3FFFF;
-    uint8_t eid_17_14 = (eid >> 14) & 0x0F;
-    uint8_t eid_13_6 = (eid >> 6) & 0xFF;
-    uint8_t eid_5_0 = eid & 0x3F;
+    uint8_t tec, rec;
+    if (!Board_CAN2Running() || Board_CAN2GetErrorState(&tec, &rec) == BOARD_CAN_BUS_OFF) {
+        return;
+    }
     
-    C1TX0SID = ((uint16_t)sid_10_6 << 11) |
-               ((uint16_t)sid_5_0 << 2) |
-               (1 << 1) |
-               (1 << 0);
+    uint16_t timeout = 10000;
+    while(!Board_CAN2TxReady() && timeout > 0) {
+        timeout--;
+    }
     
-    C1TX0EID = ((uint16_t)eid_17_14 << 12) |
-               ((uint16_t)eid_13_6 << 0);
+    if(timeout == 0) {
+        return;
+    }
     
-    C1TX0DLC = ((uint16_t)eid_5_0 << 10) |
-               (0 << 9) |
-               (0 << 8) |
-               (0 << 7) |
-               (8 << 3);
+    Board_CAN2TransmitImage(&image, data);
+}
+
+void J1939_TransmitMessage(uint8_t priority, uint16_t pgn, uint8_t source_addr, uint8_t *data) {
+    BoardCANTxImage image;
     
-    C1TX0B1 = ((uint16_t)data[1] << 8) | data[0];
-    C1TX0B2 = ((uint16_t)data[3] << 8) | data[2];
-    C1TX0B3 = ((uint16_t)data[5] << 8) | data[4];
-    C1TX0B4 = ((uint16_t)data[7] << 8) | data[6];
+    J1939_EncodeTxImage(priority, pgn, source_addr, &image);
+    J1939_TransmitImage(&image, data);
+}
+
+void J1939_LoadHeartbeatConfig(void) {
+    heartbeat_pgn = EEPROM_Config_ReadPGN(EEPROM_CFG_HEARTBEAT_PGN_A);
+    heartbeat_sa = EEPROM_Config_ReadByte(EEPROM_CFG_HEARTBEAT_SA);
+    J1939_EncodeTxImage(J1939_PRIORITY, heartbeat_pgn, heartbeat_sa, &heartbeat_image);
+}
+
+/*
+ * Saturate a counter into one diagnostic byte
+ */
+static uint8_t DiagByte(uint16_t value) {
+    return (value > 0xFF) ? 0xFF : (uint8_t)value;
+}
+
+/*
+ * Heartbeat load/health byte (page 1, B1)
+ */
+static uint8_t HeartbeatHealth(void) {
+    uint8_t health = error_state & J1939_HB_HEALTH_CAN_MASK;
+    
+    Board_CANSetRxInterrupt(0);
+    uint16_t overflows = rx_overflow_count;
+    uint8_t peak = rx_peak;
+    rx_peak = rx_count;
+    Board_CANSetRxInterrupt(1);
+    
+    if (overflows != heartbeat_overflow_mark) {
+        health |= J1939_HB_HEALTH_RX_OVERFLOW;
+        heartbeat_overflow_mark = overflows;
+    }
     
-    C1TX0CONbits.TXREQ = 1;
+    for (uint8_t i = 0; i < INRESERVE_MAX_CELLS; i++) {
+        InReserveShed *shed = InReserve_GetShed(i);
+        if (shed != NULL && (shed->clear_mask[0] | shed->clear_mask[1] |
+                             shed->set_mask[0] | shed->set_mask[1])) {
+            health |= J1939_HB_HEALTH_SHEDDING;
+            break;
+        }
+    }
+    
+    // RX FIFO peak fill in sixteenths, 15 = full
+    uint8_t load = (uint8_t)(((uint16_t)peak * 16) / CAN_RX_BUFFER_SIZE);
+    if (load > 15) {
+        load = 15;
+    }
+    health |= load << J1939_HB_HEALTH_LOAD_SHIFT;
+    
+    return health;
 }
 
 void J1939_TransmitHeartbeat(void) {
-    // Read heartbeat PGN and SA from EEPROM configuration
-    uint16_t heartbeat_pgn = EEPROM_Config_ReadPGN(EEPROM_CFG_HEARTBEAT_PGN_A);
-    uint8_t heartbeat_sa = EEPROM_Config_ReadByte(EEPROM_CFG_HEARTBEAT_SA);
-    
-    // Build heartbeat data
     uint8_t heartbeat_data[8];
     
-    // Byte 0 (B0): Ignition status in bit 0, rest are 0
-    // Bit 0: 0x00 = ignition off, 0x01 = ignition on
-    // Bits 1-7: 0x00 (reserved for future use)
-    uint8_t ignition_status = Inputs_GetIgnitionState();
-    heartbeat_data[0] = ignition_status & 0x01;  // Only use bit 0
-    
-    // Bytes 1-7: Set to 0x00 for now (can be used for other status info later)
-    heartbeat_data[1] = 0x00;
-    heartbeat_data[2] = 0x00;
-    heartbeat_data[3] = 0x00;
-    heartbeat_data[4] = 0x00;
+    // B0 is common to both pages. Bit 0 keeps its original meaning
+    // (ignition) so older receivers that only look at it still work.
+    uint8_t header = (Inputs_GetIgnitionState() & 0x01) |
+                     ((Inputs_GetSecurityState() & 0x01) << 1) |
+                     ((heartbeat_seq & 0x0F) << 4);
+    heartbeat_seq++;
+    
+    // Page 0: everything a remote display needs to mirror our I/O
+    // B1-B6: input bitmap (IN01 = B1 bit 0 ... HSIN06 = B6 bit 3), B7: OUT1-OUT8
+    heartbeat_data[0] = header | (J1939_HB_PAGE_STATE << 2);
+    Inputs_GetPacked(&heartbeat_data[1]);
+    heartbeat_data[7] = Outputs_GetAll();
+    J1939_TransmitImage(&heartbeat_image, heartbeat_data);
+    
+    // Page 1: load and health
+    heartbeat_data[0] = header | (J1939_HB_PAGE_HEALTH << 2);
+    heartbeat_data[1] = HeartbeatHealth();
+    heartbeat_data[2] = rx_high_water;
+    heartbeat_data[3] = DiagByte(Inputs_GetOneButtonLatencyMax());
+    heartbeat_data[4] = Inputs_GetOneButtonLateCount();
     heartbeat_data[5] = 0x00;
     heartbeat_data[6] = 0x00;
     heartbeat_data[7] = 0x00;
+    J1939_TransmitImage(&heartbeat_image, heartbeat_data);
+}
+
+uint8_t J1939_ServiceErrors(uint32_t now_ms) {
+    Board_CANSetRxInterrupt(0);
+    SampleErrorState();     // Polled too, in case an error interrupt was missed
+    uint8_t state = error_state;
+    Board_CANSetRxInterrupt(1);
+    
+    if (now_ms - error_rate_start >= 1000) {
+        error_rate_start = now_ms;
+        Board_CANSetRxInterrupt(0);
+        error_rate = error_irq_count;
+        error_irq_count = 0;
+        Board_CANSetRxInterrupt(1);
+    }
+    
+    if (state != BOARD_CAN_BUS_OFF) {
+        // A clean run after the last recovery forgets the backoff history
+        if (bus_off_backoff_ms > CAN_BUSOFF_BACKOFF_MIN_MS &&
+            now_ms - bus_last_recovery >= CAN_BUSOFF_STABLE_MS) {
+            bus_off_backoff_ms = CAN_BUSOFF_BACKOFF_MIN_MS;
+        }
+        return 0;
+    }
+    
+    if (!bus_off_waiting) {
+        bus_off_waiting = 1;
+        bus_off_restart_at = now_ms + bus_off_backoff_ms;
+        return 0;
+    }
+    
+    if ((int32_t)(now_ms - bus_off_restart_at) < 0) {
+        return 0;
+    }
+    
+    // Backoff expired - restart the controller
+    Board_CANRestart();
+    bus_off_waiting = 0;
+    bus_last_recovery = now_ms;
+    if (bus_off_backoff_ms < CAN_BUSOFF_BACKOFF_MAX_MS) {
+        bus_off_backoff_ms *= 2;
+    }
+    
+    Board_CANSetRxInterrupt(0);
+    SampleErrorState();
+    Board_CANSetRxInterrupt(1);
+    
+    return 1;
+}
+
+uint8_t J1939_GetErrorState(void) {
+    return error_state;
+}
+
+uint16_t J1939_GetErrorPassiveCount(void) {
+    return error_passive_count;
+}
+
+uint16_t J1939_GetBusOffCount(void) {
+    return bus_off_count;
+}
+
+/*
+ * Diagnostic page 1: CAN health
+ * B0: page, B1: error state, B2: TEC, B3: REC,
+ * B4: error-passive entries, B5: bus-off entries,
+ * B6: RX FIFO overflows, B7: error interrupts in the last second
+ */
+static void TransmitDiagnosticCAN(uint16_t diagnostic_pgn, uint8_t diagnostic_sa) {
+    uint8_t diagnostic_data[8];
+    
+    Board_CANSetRxInterrupt(0);
+    diagnostic_data[0] = J1939_DIAG_PAGE_CAN;
+    diagnostic_data[1] = error_state;
+    diagnostic_data[2] = error_tec;
+    diagnostic_data[3] = error_rec;
+    diagnostic_data[4] = DiagByte(error_passive_count);
+    diagnostic_data[5] = DiagByte(bus_off_count);
+    diagnostic_data[6] = DiagByte(rx_overflow_count);
+    diagnostic_data[7] = error_rate;
+    
+    diag_sent_state = error_state;
+    diag_sent_passive = error_passive_count;
+    diag_sent_bus_off = bus_off_count;
+    diag_sent_overflow = rx_overflow_count;
+    Board_CANSetRxInterrupt(1);
+    
+    J1939_TransmitMessage(J1939_PRIORITY, diagnostic_pgn, diagnostic_sa, diagnostic_data);
+}
+
+void J1939_ServiceDiagnostic(void) {
+    uint8_t period = EEPROM_Config_ReadByte(EEPROM_CFG_DIAGNOSTIC_PERIOD);
+    
+    if (period != 0 && period != 0xFF && ++diag_seconds >= period) {
+        diag_seconds = 0;
+        J1939_TransmitDiagnostic();
+        return;
+    }
+    
+    // Unsolicited otherwise only when the CAN page has news
+    Board_CANSetRxInterrupt(0);
+    uint8_t changed = (error_state != diag_sent_state) ||
+                      (error_passive_count != diag_sent_passive) ||
+                      (bus_off_count != diag_sent_bus_off) ||
+                      (rx_overflow_count != diag_sent_overflow);
+    Board_CANSetRxInterrupt(1);
+    
+    if (changed) {
+        TransmitDiagnosticCAN(EEPROM_Config_ReadPGN(EEPROM_CFG_DIAGNOSTIC_PGN_A),
+                              EEPROM_Config_ReadByte(EEPROM_CFG_DIAGNOSTIC_SA));
+    }
+}
+
+void J1939_TransmitDiagnostic(void) {
+    uint16_t diagnostic_pgn = EEPROM_Config_ReadPGN(EEPROM_CFG_DIAGNOSTIC_PGN_A);
+    uint8_t diagnostic_sa = EEPROM_Config_ReadByte(EEPROM_CFG_DIAGNOSTIC_SA);
+    uint8_t diagnostic_data[8];
+    
+    TransmitDiagnosticCAN(diagnostic_pgn, diagnostic_sa);
+    
+    // Page 2: power
+    // B0: page, B1-B3: run / idle / sleep time share (%),
+    // B4-B5: estimated average current (0.1mA, LSB first),
+    // B6-B7: last wake to first frame (us, LSB first)
+    uint16_t current = Power_GetAverageCurrent();
+    uint16_t latency = Power_GetWakeLatencyUs();
+    diagnostic_data[0] = J1939_DIAG_PAGE_POWER;
+    Power_GetModeShare(&diagnostic_data[1], &diagnostic_data[2], &diagnostic_data[3]);
+    diagnostic_data[4] = current & 0xFF;
+    diagnostic_data[5] = current >> 8;
+    diagnostic_data[6] = latency & 0xFF;
+    diagnostic_data[7] = latency >> 8;
+    
+    J1939_TransmitMessage(J1939_PRIORITY, diagnostic_pgn, diagnostic_sa, diagnostic_data);
+    
+    // Page 3: fast path edge-to-frame, next input with frames recorded
+    // B0: page, B1: input (IN01 = 0), B2: last (ms), B3: worst (ms),
+    // B4: frames sent (saturated), B5-B7: reserved
+    for (uint8_t n = 0; n < INPUT_COUNT; n++) {
+        uint8_t input = diag_edge_input;
+        diag_edge_input = (diag_edge_input + 1) % INPUT_COUNT;
+        
+        uint8_t count = Inputs_GetEdgeLatency(input, &diagnostic_data[2], &diagnostic_data[3]);
+        if (count == 0) {
+            continue;
+        }
+        
+        diagnostic_data[0] = J1939_DIAG_PAGE_EDGE;
+        diagnostic_data[1] = input;
+        diagnostic_data[4] = count;
+        diagnostic_data[5] = 0x00;
+        diagnostic_data[6] = 0x00;
+        diagnostic_data[7] = 0x00;
+        J1939_TransmitMessage(J1939_PRIORITY, diagnostic_pgn, diagnostic_sa, diagnostic_data);
+        break;
+    }
+    
+    // Page 4: bounce rates (bounces per BOUNCE_WINDOW_MS), all inputs in 8 diagnostics
+    // B0: page, B1: first input (IN01 = 0), B2-B7: that input and the next five
+    diagnostic_data[0] = J1939_DIAG_PAGE_BOUNCE;
+    diagnostic_data[1] = diag_bounce_input;
+    for (uint8_t i = 0; i < 6; i++) {
+        diagnostic_data[2 + i] = Inputs_GetBounceRate(diag_bounce_input + i);  // 0 past the last input
+    }
+    diag_bounce_input += 6;
+    if (diag_bounce_input >= INPUT_COUNT) {
+        diag_bounce_input = 0;
+    }
+    
+    J1939_TransmitMessage(J1939_PRIORITY, diagnostic_pgn, diagnostic_sa, diagnostic_data);
+    
+    // Page 5: gateway segments (only with the gateway on)
+    // B0: page, B1-B2: segment 1 / 2 load (%), B3: forwarded 1->2 (frames/s),
+    // B4: forwarded 2->1 (frames/s), B5: no route, B6: rate limited or
+    // segment 2 queue full (both segments, frames/s), B7: segment 2 error state
+    if (Gateway_IsEnabled()) {
+        const GatewaySegment *seg1 = Gateway_GetSegment(CAN_BUS_1);
+        const GatewaySegment *seg2 = Gateway_GetSegment(CAN_BUS_2);
+        
+        diagnostic_data[0] = J1939_DIAG_PAGE_GATEWAY;
+        diagnostic_data[1] = seg1->load_pct;
+        diagnostic_data[2] = seg2->load_pct;
+        diagnostic_data[3] = DiagByte(seg1->forwarded_per_s);
+        diagnostic_data[4] = DiagByte(seg2->forwarded_per_s);
+        diagnostic_data[5] = DiagByte(seg1->filtered_per_s + seg2->filtered_per_s);
+        diagnostic_data[6] = DiagByte(seg1->limited_per_s + seg2->limited_per_s +
+                                      seg1->dropped_per_s);
+        diagnostic_data[7] = Gateway_GetBus2ErrorState();
+        
+        J1939_TransmitMessage(J1939_PRIORITY, diagnostic_pgn, diagnostic_sa, diagnostic_data);
+    }
+}
+
+uint8_t J1939_ParseRequest(CAN_RxMessage *msg, uint16_t *requested_pgn, uint8_t *dest_addr) {
+    if (((msg->id >> 16) & 0xFF) != (J1939_PGN_REQUEST >> 8) || msg->dlc < 3) {
+        return 0;
+    }
+    
+    // Only PGNs in data page 0 exist on this network
+    if (msg->data[2] != 0x00) {
+        return 0;
+    }
+    
+    *requested_pgn = ((uint16_t)msg->data[1] << 8) | msg->data[0];
+    *dest_addr = (msg->id >> 8) & 0xFF;
+    return 1;
+}
+
+uint8_t J1939_AnswerStatusRequest(uint16_t requested_pgn, uint8_t dest_addr) {
+    if (requested_pgn == heartbeat_pgn) {
+        if (dest_addr == J1939_GLOBAL_ADDR || dest_addr == heartbeat_sa) {
+            J1939_TransmitHeartbeat();
+            return 1;
+        }
+    }
+    
+    if (requested_pgn == EEPROM_Config_ReadPGN(EEPROM_CFG_DIAGNOSTIC_PGN_A)) {
+        uint8_t diagnostic_sa = EEPROM_Config_ReadByte(EEPROM_CFG_DIAGNOSTIC_SA);
+        if (dest_addr == J1939_GLOBAL_ADDR || dest_addr == diagnostic_sa) {
+            J1939_TransmitDiagnostic();
+            return 1;
+        }
+    }
+    
+    return 0;
+}
+
+/*
+ * Send a TP.CM frame to the session peer
+ * B0 control byte, B1-B4 control-specific, B5-B7 PGN of the message
+ */
+static void TPSendControl(uint8_t dest_addr, uint8_t control, uint8_t b1, uint8_t b2,
+                          uint8_t b3, uint8_t b4, uint16_t pgn) {
+    uint8_t data[8];
+    
+    data[0] = control;
+    data[1] = b1;
+    data[2] = b2;
+    data[3] = b3;
+    data[4] = b4;
+    data[5] = pgn & 0xFF;
+    data[6] = (pgn >> 8) & 0xFF;
+    data[7] = 0x00;
+    J1939_TransmitMessage(J1939_TP_PRIORITY, J1939_PGN_TP_CM | dest_addr, heartbeat_sa, data);
+}
+
+/*
+ * Grant the next window of packets, starting at tp_next
+ */
+static void TPSendCTS(uint32_t now_ms) {
+    uint8_t count = tp_packets - tp_next + 1;
+    
+    if (count > J1939_TP_WINDOW) {
+        count = J1939_TP_WINDOW;
+    }
+    if (count > tp_max_per_cts) {
+        count = tp_max_per_cts;
+    }
+    
+    tp_window_end = tp_next + count - 1;
+    tp_deadline = now_ms + J1939_TP_TIMEOUT_MS;
+    TPSendControl(tp_source, J1939_TP_CTS, count, tp_next, 0xFF, 0xFF, tp_pgn);
+}
+
+static void TPReceiveRTS(CAN_RxMessage *msg, uint8_t source, uint32_t now_ms) {
+    uint16_t size = ((uint16_t)msg->data[2] << 8) | msg->data[1];
+    uint8_t packets = msg->data[3];
+    uint16_t pgn = ((uint16_t)msg->data[6] << 8) | msg->data[5];
+    
+    // A new RTS from the session peer replaces its old message
+    if (tp_state != TP_IDLE && source != tp_source) {
+        TPSendControl(source, J1939_TP_ABORT, J1939_TP_ABORT_BUSY, 0xFF, 0xFF, 0xFF, pgn);
+        return;
+    }
     
-    // Transmit heartbeat with configured PGN and SA
-    J1939_TransmitMessage(J1939_PRIORITY, heartbeat_pgn, heartbeat_sa, heartbeat_data);
+    if (size < 9 || size > J1939_TP_MAX_SIZE || packets != (size + 6) / 7 ||
+        msg->data[7] != 0x00) {
+        tp_state = TP_IDLE;
+        TPSendControl(source, J1939_TP_ABORT, J1939_TP_ABORT_RESOURCES, 0xFF, 0xFF, 0xFF, pgn);
+        return;
+    }
+    
+    tp_state = TP_RECEIVING;
+    tp_source = source;
+    tp_pgn = pgn;
+    tp_size = size;
+    tp_packets = packets;
+    tp_max_per_cts = (msg->data[4] == 0) ? 0xFF : msg->data[4];
+    tp_next = 1;
+    TPSendCTS(now_ms);
+}
+
+/*
+ * One TP.DT packet - returns 1 when it was the last one
+ */
+static uint8_t TPReceiveData(CAN_RxMessage *msg, uint32_t now_ms) {
+    uint8_t seq = msg->data[0];
+    
+    if (seq != tp_next) {
+        // Lost packet - at the end of the window, ask again from the gap
+        if (seq == tp_window_end) {
+            TPSendCTS(now_ms);
+        }
+        return 0;
+    }
+    
+    uint16_t offset = (uint16_t)(seq - 1) * 7;
+    uint16_t length = tp_size - offset;
+    if (length > 7) {
+        length = 7;
+    }
+    memcpy(&tp_buffer[offset], &msg->data[1], length);
+    
+    tp_next++;
+    tp_deadline = now_ms + J1939_TP_TIMEOUT_MS;
+    
+    if (seq == tp_packets) {
+        tp_state = TP_COMPLETE;
+        return 1;
+    }
+    if (seq == tp_window_end) {
+        TPSendCTS(now_ms);
+    }
+    return 0;
+}
+
+uint8_t J1939_TPProcessMessage(CAN_RxMessage *msg, uint32_t now_ms) {
+    uint8_t pf = (msg->id >> 16) & 0xFF;
+    uint8_t dest = (msg->id >> 8) & 0xFF;
+    uint8_t source = msg->id & 0xFF;
+    
+    if (dest != heartbeat_sa || msg->dlc < 8) {
+        return 0;
+    }
+    
+    if (pf == (J1939_PGN_TP_CM >> 8)) {
+        if (msg->data[0] == J1939_TP_RTS) {
+            TPReceiveRTS(msg, source, now_ms);
+        } else if (msg->data[0] == J1939_TP_ABORT && source == tp_source) {
+            tp_state = TP_IDLE;
+        }
+        return 0;
+    }
+    
+    if (pf == (J1939_PGN_TP_DT >> 8) && tp_state == TP_RECEIVING && source == tp_source) {
+        return TPReceiveData(msg, now_ms);
+    }
+    
+    return 0;
+}
+
+const uint8_t *J1939_TPGetMessage(uint16_t *pgn, uint8_t *source_addr, uint16_t *length) {
+    if (tp_state != TP_COMPLETE) {
+        return NULL;
+    }
+    
+    *pgn = tp_pgn;
+    *source_addr = tp_source;
+    *length = tp_size;
+    return tp_buffer;
+}
+
+void J1939_TPComplete(uint8_t accepted) {
+    if (tp_state != TP_COMPLETE) {
+        return;
+    }
+    
+    if (accepted) {
+        TPSendControl(tp_source, J1939_TP_EOMA, tp_size & 0xFF, tp_size >> 8,
+                      tp_packets, 0xFF, tp_pgn);
+    } else {
+        TPSendControl(tp_source, J1939_TP_ABORT, J1939_TP_ABORT_RESOURCES,
+                      0xFF, 0xFF, 0xFF, tp_pgn);
+    }
+    tp_state = TP_IDLE;
+}
+
+void J1939_TPService(uint32_t now_ms) {
+    if (tp_state == TP_RECEIVING && (int32_t)(now_ms - tp_deadline) >= 0) {
+        TPSendControl(tp_source, J1939_TP_ABORT, J1939_TP_ABORT_TIMEOUT,
+                      0xFF, 0xFF, 0xFF, tp_pgn);
+        tp_state = TP_IDLE;
+    }
 }
 
 uint8_t J1939_HasRxOverflow(void) {
@@ -360,6 +788,10 @@ uint8_t J1939_GetRxCount(void) {
     return rx_count;
 }
 
+uint8_t J1939_GetRxHighWater(void) {
+    return rx_high_water;
+}
+
 uint32_t J1939_GetRxMessageCount(void) {
     return rx_message_count;
 }
@@ -367,15 +799,3 @@ uint32_t J1939_GetRxMessageCount(void) {
 uint16_t J1939_GetRxOverflowCount(void) {
     return rx_overflow_count;
 }
-
-uint16_t J1939_GetDebugSID(void) {
-    return debug_sid_reg;
-}
-
-uint16_t J1939_GetDebugEID(void) {
-    return debug_eid_reg;
-}
-
-uint16_t J1939_GetDebugDLC(void) {
-    return debug_dlc_reg;
-}
\ No newline at end of file
@@ -7,14 +7,81 @@
 
 #include <xc.h>
 #include <stdint.h>
+#include "board.h"
 
 // J1939 Configuration
 #define J1939_SOURCE_ADDR 0x80
 #define J1939_PGN 0xFF00
 #define J1939_PRIORITY 6
 
-// Buffer size for received messages
-#define CAN_RX_BUFFER_SIZE 8
+// Receive FIFO depth (frames). The CAN interrupt moves every frame out of
+// the two hardware buffers into this queue, so the main loop only has to
+// drain it once per pass. Power of two, max 128. At 250kbit/s a frame
+// takes >= 0.5ms, so 32 frames cover a 16ms main loop stall.
+#ifndef CAN_RX_BUFFER_SIZE
+#define CAN_RX_BUFFER_SIZE 32
+#endif
+
+// Frames handed to the dispatcher per J1939_ReceiveBatch() call
+#define CAN_RX_BATCH_SIZE 8
+
+// Bus-off recovery: wait, restart, double the wait on each repeat
+#define CAN_BUSOFF_BACKOFF_MIN_MS   100
+#define CAN_BUSOFF_BACKOFF_MAX_MS   6400
+#define CAN_BUSOFF_STABLE_MS        10000   // Clean run that resets the backoff
+
+// Heartbeat byte 0: bit 0 ignition, bit 1 security disarmed,
+// bits 2-3 page, bits 4-7 sequence counter (bumped once per heartbeat)
+#define J1939_HB_PAGE_STATE         0x00    // B1-B6 inputs IN01-HSIN06, B7 OUT1-OUT8
+#define J1939_HB_PAGE_HEALTH        0x01    // B1 load/health, B2 RX FIFO peak (frames),
+                                            // B3 worst one-button edge-to-frame (ms), B4 frames over bound
+
+// Heartbeat health byte (page 1, B1)
+#define J1939_HB_HEALTH_CAN_MASK    0x03    // Bits 0-1: BOARD_CAN_ERROR_xxx / BOARD_CAN_BUS_OFF
+#define J1939_HB_HEALTH_RX_OVERFLOW 0x04    // RX FIFO overflowed since the last heartbeat
+#define J1939_HB_HEALTH_SHEDDING    0x08    // inRESERVE is shedding load
+#define J1939_HB_HEALTH_LOAD_SHIFT  4       // Bits 4-7: RX FIFO peak fill, sixteenths
+
+// Diagnostic PGN pages (byte 0 of the diagnostic message). All pages are
+// sent when the diagnostic PGN is requested, and every
+// EEPROM_CFG_DIAGNOSTIC_PERIOD seconds if that is set. Otherwise only the
+// CAN page goes out unsolicited, when the error state or a counter changed.
+#define J1939_DIAG_PAGE_CAN         0x01
+#define J1939_DIAG_PAGE_POWER       0x02
+#define J1939_DIAG_PAGE_EDGE        0x03    // Fast path edge-to-frame, one input per diagnostic
+#define J1939_DIAG_PAGE_BOUNCE      0x04    // Bounce rates, six inputs per diagnostic
+#define J1939_DIAG_PAGE_GATEWAY     0x05    // Segment loads and forwarding, gateway on only
+
+// Request PGN (PDU1: PF 0xEA, PS = destination address)
+// Data bytes 0-2 = requested PGN, LSB first
+#define J1939_PGN_REQUEST           0xEA00
+#define J1939_GLOBAL_ADDR           0xFF
+
+// Requested PGN meaning "every output slot" (request-only, never broadcast).
+// 0xFFFF is also a valid proprietary B PGN, so it is reserved: a case with
+// this PGN is rejected by EEPROM_ReadCase() and never sent.
+#define J1939_PGN_ALL_OUTPUTS       0xFFFF
+
+// Transport protocol, connection mode (receive only). TP.CM / TP.DT are
+// PDU1 - the low byte of the PGN is the destination, our heartbeat SA.
+#define J1939_PGN_TP_CM             0xEC00
+#define J1939_PGN_TP_DT             0xEB00
+#define J1939_TP_RTS                16
+#define J1939_TP_CTS                17
+#define J1939_TP_EOMA               19      // End of message acknowledge
+#define J1939_TP_ABORT              255
+#define J1939_TP_ABORT_BUSY         1       // Another session is open
+#define J1939_TP_ABORT_RESOURCES    2       // Too large, or the data was refused
+#define J1939_TP_ABORT_TIMEOUT      3
+#define J1939_TP_MAX_SIZE           400     // Largest message accepted (bytes)
+#define J1939_TP_WINDOW             16      // Packets granted per CTS
+#define J1939_TP_TIMEOUT_MS         1250    // T2: no packet after a CTS / between packets
+#define J1939_TP_PRIORITY           7
+
+// Controller a frame was received on / is sent to. Both controllers
+// feed the one receive FIFO; bus 2 only runs as the gateway segment.
+#define CAN_BUS_1                   0
+#define CAN_BUS_2                   1
 
 // CAN message structure
 typedef struct {
@@ -22,25 +89,49 @@ typedef struct {
     uint8_t data[8];
     uint8_t dlc;
     uint8_t valid;
+    uint8_t bus;            // CAN_BUS_x
 } CAN_RxMessage;
 
 // Function prototypes
 void J1939_Init(void);
 void J1939_TransmitMessage(uint8_t priority, uint16_t pgn, uint8_t source_addr, uint8_t *data);
+void J1939_EncodeTxImage(uint8_t priority, uint16_t pgn, uint8_t source_addr, BoardCANTxImage *image);
+void J1939_TransmitImage(const BoardCANTxImage *image, uint8_t *data);
+void J1939_TransmitPriority(const BoardCANTxImage *image, uint8_t *data);  // Ahead of queued frames (Board_CANTransmitPriority)
+void J1939_TransmitFrame(uint8_t bus, uint32_t id, uint8_t dlc, uint8_t *data);  // Any identifier and length
+void J1939_InitBus2(void);                  // Start the second controller, its frames join the FIFO
+void J1939_LoadHeartbeatConfig(void);
 void J1939_TransmitHeartbeat(void);
 uint8_t J1939_IsTxReady(void);
 uint8_t J1939_ReceiveMessage(CAN_RxMessage *msg);
+uint8_t J1939_ReceiveBatch(CAN_RxMessage *msgs, uint8_t max);
 void J1939_ConfigureFilters(uint16_t read_pgn, uint8_t read_sa, uint16_t write_pgn, uint8_t write_sa);
 void J1939_SetPromiscuousMode(void);
 uint8_t J1939_HasRxOverflow(void);
 void J1939_ClearRxOverflow(void);
 uint8_t J1939_GetRxCount(void);
+uint8_t J1939_GetRxHighWater(void);
 uint32_t J1939_GetRxMessageCount(void);
 uint16_t J1939_GetRxOverflowCount(void);
 
-// DEBUG functions
-uint16_t J1939_GetDebugSID(void);
-uint16_t J1939_GetDebugEID(void);
-uint16_t J1939_GetDebugDLC(void);
+// Error state / bus-off recovery
+uint8_t J1939_ServiceErrors(uint32_t now_ms);   // Returns 1 when the bus was just recovered
+uint8_t J1939_GetErrorState(void);              // BOARD_CAN_ERROR_xxx / BOARD_CAN_BUS_OFF
+uint16_t J1939_GetErrorPassiveCount(void);
+uint16_t J1939_GetBusOffCount(void);
+void J1939_TransmitDiagnostic(void);          // Every page, now
+void J1939_ServiceDiagnostic(void);           // Once per second: periodic pages or CAN page on change
+
+// Request PGN support
+uint8_t J1939_ParseRequest(CAN_RxMessage *msg, uint16_t *requested_pgn, uint8_t *dest_addr);
+uint8_t J1939_AnswerStatusRequest(uint16_t requested_pgn, uint8_t dest_addr);
+
+// Transport protocol - J1939_TPProcessMessage() returns 1 when a message
+// is complete. It stays in the buffer until J1939_TPComplete(), which
+// answers the sender, so the next message waits until it was consumed.
+uint8_t J1939_TPProcessMessage(CAN_RxMessage *msg, uint32_t now_ms);
+const uint8_t *J1939_TPGetMessage(uint16_t *pgn, uint8_t *source_addr, uint16_t *length);
+void J1939_TPComplete(uint8_t accepted);
+void J1939_TPService(uint32_t now_ms);      // Session timeout
 
 #endif
\ No newline at end of file
@@ -4,10 +4,7 @@
  */
 
 #include "lcd.h"
-
-// Define FCY for delay macros
-#define FCY 16000000UL
-#include <libpic30.h>
+#include "board.h"
 
 // Timing delays (in microseconds)
 // HD44780 datasheet specs: commands ~37us, clear/home ~1.52ms
@@ -8,7 +8,7 @@
 
  #include <xc.h>
  #include <stdint.h>
- #include <stdio.h>
+ #include <stddef.h>
  #include "lcd.h"
  #include "buttons.h"
  #include "inputs.h"
@@ -22,63 +22,23 @@
 #include "climate.h"
 #include "outputs.h"
 #include "inreserve.h"
+#include "power.h"
+#include "supervisor.h"
+#include "gateway.h"
+#include "menu.h"
+#include "screens.h"
+#include "board.h"
  
- // Debug variables from eeprom_cases.c
- 
- _FOSC(CSW_FSCM_OFF & XT_PLL8);
- _FWDT(WDT_OFF);
- _FBORPOR(MCLR_EN & PWRT_OFF);
- _FGS(GWRP_OFF);
- _FICD(ICS_PGD);
- 
- #define FCY 16000000UL
- #include <libpic30.h>
+ // Configuration fuses and FCY: see board.h / board_dspic30f6012a.c
  
  #define LED_PIN LATGbits.LATG0
  #define LED_TRIS TRISGbits.TRISG0
  
-// Screen states
-#define SCREEN_MAIN         0
-#define SCREEN_MENU         1
-#define SCREEN_SWITCH       2
-#define SCREEN_INVENTORY    3
-#define SCREEN_SYSTEM_INFO  4
-#define SCREEN_DEBUG        5
-#define SCREEN_CELL_DETAIL  6
-#define SCREEN_INRESERVE    7
-#define SCREEN_INRESERVE_POPUP 8
- 
- // Menu items
- #define MENU_SWITCH_STATES  0
- #define MENU_SYSTEM_INVENTORY 1
- #define MENU_SYSTEM_INFO    2
- #define MENU_INRESERVE      3
- #define MENU_DEBUG          4
- #define MENU_HOME_SCREEN    5
- #define MENU_COUNT          6
-
-// inRESERVE sub-menu states
-#define INRESERVE_FIELD_ENABLE   0
-#define INRESERVE_FIELD_CELL     1
-#define INRESERVE_FIELD_OUTPUT   2
-#define INRESERVE_FIELD_TIME     3
-#define INRESERVE_FIELD_VOLTAGE  4
-#define INRESERVE_FIELD_COUNT    5
-
-// inRESERVE popup types
-#define INRESERVE_POPUP_ENABLE   0
-#define INRESERVE_POPUP_CELL     1
-#define INRESERVE_POPUP_OUTPUT   2
-#define INRESERVE_POPUP_TIME     3
-#define INRESERVE_POPUP_VOLTAGE  4
- 
  volatile uint16_t scan_timer = 10;
- volatile uint16_t display_timer = 500;
+ volatile uint16_t housekeeping_timer = 500;  // Network/inRESERVE timeouts, sleep check
  volatile uint16_t j1939_timer = 1000;
- volatile uint16_t button_debounce_timer = 0;
  volatile uint16_t led_on_timer = 0;
  volatile uint16_t pattern_timer = 0;
- volatile uint16_t backlight_timer = 0;
  volatile uint8_t pattern_changed = 0;
  volatile uint8_t heartbeat_pending = 0;
  volatile uint8_t state_changed = 0;    // PHASE 2: Flag for input/inLINK state changes
@@ -90,61 +50,68 @@
  volatile uint16_t last_rx_pgn = 0;
  
  // PHASE 1: Storage for previous broadcast to detect data changes
+ // Each entry is the output slot for one PGN/SA; its CAN identifier is
+ // encoded into tx_image once, when the slot is learned.
  typedef struct {
      uint16_t pgn;
      uint8_t source_addr;
+     uint8_t priority;
      uint8_t data[8];
      uint8_t valid;
+     uint8_t ticks_since_sent;  // Pattern ticks since last transmission (keepalive)
+     BoardCANTxImage tx_image;
  } PreviousMessage;
  
  PreviousMessage prev_messages[MAX_UNIQUE_MESSAGES];
  uint8_t prev_msg_count = 0;
+ #define NO_SLOT 0xFF
+ uint16_t broadcast_version = 0;       // Bumped whenever prev_messages changes (debug screen)
+ 
+ // "All outputs" request: next prev_messages slot to stream, NO_SLOT = idle
+ uint8_t request_stream_next = NO_SLOT;
+ 
+ // Warm restart copy of prev_messages (SaveTransmitHistory)
+ typedef struct {
+     uint16_t signature;
+     uint8_t count;
+     PreviousMessage messages[MAX_UNIQUE_MESSAGES];
+     uint16_t checksum;
+ } HistoryWarmState;
+ 
+ HistoryWarmState history_warm BOARD_PERSISTENT;
+ 
+ // 1 after a watchdog reset: state comes from persistent RAM, no splash
+ uint8_t warm_start = 0;
+ 
+ // Splash / progress delays - skipped on a warm restart
+ #define STARTUP_DELAY_MS(ms) do { if(!warm_start) __delay_ms(ms); } while(0)
  
-uint8_t current_screen = SCREEN_MAIN;
-uint8_t menu_selection = 0;
-uint8_t menu_scroll_position = 0;
-uint8_t last_button = BTN_ID_NONE;
-uint8_t inventory_scroll_position = 0;
-uint8_t inventory_selection = 0;          // Currently highlighted item in inventory
-uint16_t selected_cell_pgn = 0;           // PGN of selected cell for detail view
-uint8_t selected_cell_type = 0;           // 0=PowerCell, 1=InMotion
-uint8_t detail_current_scroll = 0;        // Scroll position for current display in detail
 volatile uint32_t system_time_ms = 0;
-volatile uint16_t detail_refresh_timer = 0;  // 2-second refresh timer for detail screen
-
-// inRESERVE screen state
-uint8_t inreserve_field_selection = 0;    // Currently selected field (0-4)
-uint8_t inreserve_scroll_position = 0;    // Scroll position for 5 items on 4 lines
-uint8_t inreserve_popup_type = 0;         // Which popup is active
-uint8_t inreserve_popup_selection = 0;    // Selection within popup
-uint8_t inreserve_popup_scroll = 0;       // Scroll position within popup
  
 // PHASE 3: Broadcast reason codes
 #define BROADCAST_REASON_PATTERN_TICK   0
 #define BROADCAST_REASON_STATE_CHANGE   1
+#define BROADCAST_REASON_RESYNC         2   // Resend everything (after bus-off)
 
-void Timer1_Init(void);
 void TransmitAggregatedMessages(uint8_t reason);  // PHASE 3: Added reason parameter
-uint8_t ProcessPendingCANMessages(void);  // Drain CAN FIFO, returns 1 if inLINK detected
-void DisplayMainScreen(void);
-void DisplayMenuScreen(void);
-void DisplaySwitchScreen(void);
-void DisplayInventoryScreen(void);
-void DisplayCellDetailScreen(void);
-void DisplaySystemInfoScreen(void);
-void DisplayDebugScreen(void);
-void DisplayInReserveScreen(void);
-void DisplayInReservePopup(void);
-void HandleButtonPress(uint8_t button);
+uint8_t ProcessPendingCANMessages(void);  // Dispatch queued CAN frames, returns 1 if inLINK detected
+void HandleRequest(CAN_RxMessage *can_msg);
+void ServiceRequestStream(void);
+void SendOneButtonFrames(void);
+void SendFastPathFrames(void);
+void SaveTransmitHistory(void);
+uint8_t RestoreTransmitHistory(void);
 void InitUnusedPins(void);
  
  int main(void) {
-     char display_buffer[17];
      uint16_t read_pgn;
      uint8_t read_sa;
      uint16_t write_pgn;
      uint8_t write_sa;
      
+     // Reset cause first - watchdog reset takes the warm path
+     warm_start = Supervisor_Init();
+     
      // CRITICAL: Initialize unused pins FIRST before anything else
      // This prevents floating MOSFET gates from turning on and drawing excessive current
      InitUnusedPins();
@@ -153,23 +120,37 @@ void InitUnusedPins(void);
      LED_PIN = 0;
      ADPCFG = 0xFFFF;
      
+    // Config header into its RAM shadow before anything reads it
+    EEPROM_Config_Load();
+    
+    // CAN first: after a watchdog reset the last transmitted frames go
+    // straight back out, before anything slower is initialized
+    J1939_Init();
+    if(warm_start) {
+        warm_start = RestoreTransmitHistory();
+    }
+    
     Inputs_Init();
     LCD_Init();
     Buttons_Init();
     Buttons_DetectStuck();  // Detect any stuck buttons (e.g., RB0 without pullup)
-    J1939_Init();
     InLink_Init();
     Network_Init();
     Climate_Init();
     Outputs_Init();
     InReserve_Init();
+    Power_Init();
+    Gateway_Init();         // Second CAN segment, if configured
+    
+    // 1ms tick - also samples the buttons, so start it before any menu
+    Board_InitTick();
      
      LCD_Clear();
      LCD_SetCursor(0, 0);
      LCD_Print("MASTERCELL NGX  ");
      LCD_SetCursor(1, 0);
      LCD_Print("Initializing... ");
-     __delay_ms(1000);
+     STARTUP_DELAY_MS(1000);
      
      // Check if EEPROM needs initialization
      uint8_t needs_init = 0;
@@ -186,7 +167,7 @@ void InitUnusedPins(void);
      }
      
      // REASON 2: SELECT button held during boot (force reinit)
-     if((PORTB & 0x2000) == 0) {
+     if(!warm_start && (PORTB & 0x2000) == 0) {
          LCD_Clear();
          LCD_SetCursor(0, 0);
          LCD_Print("FORCE REINIT!   ");
@@ -209,71 +190,65 @@ void InitUnusedPins(void);
          // Configuration selection menu
         eeprom_config_type_t selected_config = CONFIG_STD_FRONT_ENGINE;
         uint8_t done = 0;
-        uint8_t button_id;
+        uint8_t redraw = 1;
+        uint8_t event;
         
         LCD_Clear();
         LCD_SetCursor(0, 0);
         LCD_Print("Select Config:  ");
+        Buttons_FlushEvents();
         
         while (!done) {
             // Display current selection
-            LCD_SetCursor(1, 0);
-            switch(selected_config) {
-                case CONFIG_STD_FRONT_ENGINE:
-                    LCD_Print(">Front Engine   ");
-                    LCD_SetCursor(2, 0);
-                    LCD_Print(" Rear Engine    ");
-                    LCD_SetCursor(3, 0);
-                    LCD_Print(" Customer       ");
-                    break;
-                case CONFIG_STD_REAR_ENGINE:
-                    LCD_Print(" Front Engine   ");
-                    LCD_SetCursor(2, 0);
-                    LCD_Print(">Rear Engine    ");
-                    LCD_SetCursor(3, 0);
-                    LCD_Print(" Customer       ");
-                    break;
-                case CONFIG_CUSTOMER:
-                    LCD_Print(" Front Engine   ");
-                    LCD_SetCursor(2, 0);
-                    LCD_Print(" Rear Engine    ");
-                    LCD_SetCursor(3, 0);
-                    LCD_Print(">Customer       ");
-                    break;
+            if (redraw) {
+                redraw = 0;
+                LCD_SetCursor(1, 0);
+                switch(selected_config) {
+                    case CONFIG_STD_FRONT_ENGINE:
+                        LCD_Print(">Front Engine   ");
+                        LCD_SetCursor(2, 0);
+                        LCD_Print(" Rear Engine    ");
+                        LCD_SetCursor(3, 0);
+                        LCD_Print(" Customer       ");
+                        break;
+                    case CONFIG_STD_REAR_ENGINE:
+                        LCD_Print(" Front Engine   ");
+                        LCD_SetCursor(2, 0);
+                        LCD_Print(">Rear Engine    ");
+                        LCD_SetCursor(3, 0);
+                        LCD_Print(" Customer       ");
+                        break;
+                    case CONFIG_CUSTOMER:
+                        LCD_Print(" Front Engine   ");
+                        LCD_SetCursor(2, 0);
+                        LCD_Print(" Rear Engine    ");
+                        LCD_SetCursor(3, 0);
+                        LCD_Print(">Customer       ");
+                        break;
+                }
             }
             
-            // Read buttons
-            button_id = Buttons_Scan();
+            // Button events are debounced in the Timer1 tick
+            event = Buttons_GetEvent();
+            if (BTN_EVENT_TYPE(event) != BTN_EVT_PRESS && BTN_EVENT_TYPE(event) != BTN_EVT_REPEAT) {
+                continue;
+            }
             
-            // Process button press
-            if (button_id == BTN_ID_DOWN) {
+            if (BTN_EVENT_ID(event) == BTN_ID_DOWN) {
                 if (selected_config < CONFIG_CUSTOMER) {
                     selected_config++;
+                    redraw = 1;
                 }
-                // Wait for release
-                while(Buttons_Scan() == BTN_ID_DOWN) {
-                    __delay_ms(10);
-                }
-                __delay_ms(50);  // Debounce
             }
-            else if (button_id == BTN_ID_UP) {
+            else if (BTN_EVENT_ID(event) == BTN_ID_UP) {
                 if (selected_config > CONFIG_STD_FRONT_ENGINE) {
                     selected_config--;
+                    redraw = 1;
                 }
-                // Wait for release
-                while(Buttons_Scan() == BTN_ID_UP) {
-                    __delay_ms(10);
-                }
-                __delay_ms(50);  // Debounce
             }
-            else if (button_id == BTN_ID_SELECT) {
+            else if (BTN_EVENT_ID(event) == BTN_ID_SELECT && BTN_EVENT_TYPE(event) == BTN_EVT_PRESS) {
                 done = 1;
-                // Wait for release
-                while(Buttons_Scan() == BTN_ID_SELECT) {
-                    __delay_ms(10);
-                }
             }
-            __delay_ms(10);
         }
         
         // Show loading message
@@ -304,7 +279,7 @@ void InitUnusedPins(void);
      LCD_SetCursor(0, 0);
      LCD_Print("Init CAN Config ");
      CAN_Config_Init();
-     __delay_ms(500);
+     STARTUP_DELAY_MS(500);
      
      LCD_SetCursor(1, 0);
      LCD_Print("Config Filters..");
@@ -314,19 +289,25 @@ void InitUnusedPins(void);
      write_sa = CAN_Config_GetWriteSA();
      
      J1939_ConfigureFilters(read_pgn, read_sa, write_pgn, write_sa);
-     __delay_ms(500);
+     STARTUP_DELAY_MS(500);
      
      LCD_Clear();
      LCD_SetCursor(0, 0);
      LCD_Print("Loading Cases...");
      EEPROM_Cases_Init();
-     __delay_ms(500);
+     STARTUP_DELAY_MS(500);
+     
+     // Warm restart: inputs come back debounced, with the ignition,
+     // security and one-button latches they had before the reset
+     if(warm_start && !Inputs_RestoreWarm()) {
+         warm_start = 0;
+     }
      
      // Scan inputs at startup and broadcast initial state
      LCD_SetCursor(1, 0);
      LCD_Print("Scan Inputs...  ");
      Inputs_Scan();
-     __delay_ms(100);
+     STARTUP_DELAY_MS(100);
      
      // Process any inputs that are already ON at startup
      for(uint8_t i = 0; i < 44; i++) {
@@ -338,102 +319,79 @@ void InitUnusedPins(void);
          }
      }
      
-     // Initialize previous messages and broadcast all active messages once
-     AggregatedMessage initial_messages[MAX_UNIQUE_MESSAGES];
-     uint8_t initial_count = EEPROM_GetAggregatedMessages(initial_messages, MAX_UNIQUE_MESSAGES);
-     
-     // Store as previous (baseline for future comparisons)
-     prev_msg_count = (initial_count < MAX_UNIQUE_MESSAGES) ? initial_count : MAX_UNIQUE_MESSAGES;
-     for(uint8_t i = 0; i < prev_msg_count; i++) {
-         prev_messages[i].pgn = initial_messages[i].pgn;
-         prev_messages[i].source_addr = initial_messages[i].source_addr;
-         for(uint8_t k = 0; k < 8; k++) {
-             prev_messages[i].data[k] = initial_messages[i].data[k];
+     if(warm_start) {
+         // Pick up the flash patterns mid-phase, then send only what
+         // differs from the restored transmit history
+         IEC0bits.T1IE = 0;
+         EEPROM_Pattern_RestoreWarm();
+         IEC0bits.T1IE = 1;
+         TransmitAggregatedMessages(BROADCAST_REASON_STATE_CHANGE);
+     } else {
+         // Initialize previous messages and broadcast all active messages once
+         AggregatedMessage initial_messages[MAX_UNIQUE_MESSAGES];
+         uint8_t initial_count = EEPROM_GetAggregatedMessages(initial_messages, MAX_UNIQUE_MESSAGES);
+     
+         // Store as previous (baseline for future comparisons)
+         prev_msg_count = (initial_count < MAX_UNIQUE_MESSAGES) ? initial_count : MAX_UNIQUE_MESSAGES;
+         for(uint8_t i = 0; i < prev_msg_count; i++) {
+             prev_messages[i].pgn = initial_messages[i].pgn;
+             prev_messages[i].source_addr = initial_messages[i].source_addr;
+             prev_messages[i].priority = initial_messages[i].priority;
+             for(uint8_t k = 0; k < 8; k++) {
+                 prev_messages[i].data[k] = initial_messages[i].data[k];
+             }
+             prev_messages[i].valid = initial_messages[i].valid;
+             prev_messages[i].ticks_since_sent = 0;
+             J1939_EncodeTxImage(prev_messages[i].priority,
+                                 prev_messages[i].pgn,
+                                 prev_messages[i].source_addr,
+                                 &prev_messages[i].tx_image);
          }
-         prev_messages[i].valid = initial_messages[i].valid;
-     }
      
-     // Broadcast all active messages once at startup
-     for(uint8_t i = 0; i < initial_count; i++) {
-         if(initial_messages[i].valid) {
-             J1939_TransmitMessage(initial_messages[i].priority,
-                                  initial_messages[i].pgn,
-                                  initial_messages[i].source_addr,
-                                  initial_messages[i].data);
+         // Broadcast all active messages once at startup
+         for(uint8_t i = 0; i < prev_msg_count; i++) {
+             if(prev_messages[i].valid) {
+                 J1939_TransmitImage(&prev_messages[i].tx_image, prev_messages[i].data);
+             }
          }
+         SaveTransmitHistory();
      }
-     __delay_ms(100);
+     STARTUP_DELAY_MS(100);
      
      LCD_Clear();
      LCD_SetCursor(0, 0);
      LCD_Print("MASTERCELL NGX  ");
      LCD_SetCursor(1, 0);
      LCD_Print("Ready!          ");
-     __delay_ms(1000);
-     
-     Timer1_Init();
+     STARTUP_DELAY_MS(1000);
      
-     // Start on main screen
-     current_screen = SCREEN_MAIN;
+     // Start on main screen (backlight on, 5-second timeout)
      LCD_Clear();
-     LCD_Backlight(1);
-     backlight_timer = 5000;  // Start 5-second timer for main screen at startup
-     DisplayMainScreen();
+     Menu_Init(screen_table, SCREEN_MAIN);
+     Buttons_FlushEvents();
+     
+     // From here on the main loop, the input scan and Timer1 must all
+     // check in within every watchdog period
+     Supervisor_Start();
      
     while(1) {
-        // Process ALL pending CAN messages before doing other work
-        // This drains the hardware FIFO to prevent message loss
-        CAN_RxMessage can_msg;
-        while (J1939_ReceiveMessage(&can_msg)) {
-            last_rx_can_id = can_msg.id;
-            last_rx_pgn = (can_msg.id >> 8) & 0xFFFF;
-            
-            uint8_t rx_sa = can_msg.id & 0xFF;
-            uint16_t rx_pgn = (can_msg.id >> 8) & 0xFFFF;
-            Network_UpdateDevice(rx_sa, rx_pgn, system_time_ms, can_msg.data);
-            
-           if (CAN_Config_ProcessMessage((CAN_Message*)&can_msg)) {
-               IEC0bits.T1IE = 0;
-               if (led_on_timer == 0) {
-                   led_on_timer = 50;
-               }
-               IEC0bits.T1IE = 1;
-           }
-           
-           // Process climate control messages (PGN 0xAF00, bytes 0-2)
-           if (Climate_ProcessMessage(can_msg.id, can_msg.data)) {
-               IEC0bits.T1IE = 0;
-               if (led_on_timer == 0) {
-                   led_on_timer = 50;
-               }
-               IEC0bits.T1IE = 1;
-           }
-           
-           // Process MOSFET output control messages (PGN 0xAF00, byte 3)
-           if (Outputs_ProcessMessage(can_msg.id, can_msg.data)) {
-               IEC0bits.T1IE = 0;
-               if (led_on_timer == 0) {
-                   led_on_timer = 50;
-               }
-               IEC0bits.T1IE = 1;
-           }
-           
-           // Process inLINK messages and trigger immediate broadcast if detected
-            // Check if this is an inLINK message (PGN starting with A, but NOT AF00)
-            // AF00 is handled by Climate/Outputs, only AF01+ are inLINK messages
-            uint16_t pgn = (can_msg.id >> 8) & 0xFFFF;
-            uint8_t pgn_high = (pgn >> 8) & 0xFF;
-            uint8_t inlink_detected = (((pgn_high & 0xF0) == 0xA0) && (pgn != 0xAF00)) ? 1 : 0;
-            
-            InLink_ProcessMessage(can_msg.id, can_msg.data);
-            
-            // Trigger broadcast if this was an inLINK message (AF01, AF02, etc.)
-            if(inlink_detected) {
-                // PHASE 3: Just set flag, remove redundant immediate call
-                IEC0bits.T1IE = 0;
-                state_changed = 1;
-                IEC0bits.T1IE = 1;
-            }
+        Supervisor_CheckIn(SUPERVISOR_TASK_LOOP);
+        
+        // Dispatch every frame the CAN interrupt has queued since the last pass
+        if (ProcessPendingCANMessages()) {
+            // inLINK message (AF01, AF02, etc.) - broadcast the new state
+            IEC0bits.T1IE = 0;
+            state_changed = 1;
+            IEC0bits.T1IE = 1;
+        }
+        Gateway_ServiceTx();
+        
+        // An active case was edited over CAN, or a timed case switched on
+        // the last tick - send its new payload now
+        if (EEPROM_ActiveCasesEdited() | EEPROM_TimedCasesChanged()) {
+            IEC0bits.T1IE = 0;
+            state_changed = 1;
+            IEC0bits.T1IE = 1;
         }
         
         if(led_on_timer > 0) {
@@ -442,25 +400,22 @@ void InitUnusedPins(void);
              LED_PIN = 0;
          }
          
-         if(button_debounce_timer == 0) {
-             uint8_t button = Buttons_Scan();
-             if(button != BTN_ID_NONE && button != last_button) {
-                 HandleButtonPress(button);
-                 button_debounce_timer = 50;
-                 display_timer = 0;
+         // Button events are debounced in the Timer1 tick - never blocks
+         {
+             uint8_t event;
+             while((event = Buttons_GetEvent()) != BTN_EVENT_NONE) {
+                 uint8_t type = BTN_EVENT_TYPE(event);
+                 uint8_t button = BTN_EVENT_ID(event);
+                 
+                 Power_NoteActivity();
                  
-                 // Turn on backlight and start timer for MAIN or MENU screens
-                 if(current_screen == SCREEN_MAIN || current_screen == SCREEN_MENU) {
-                     LCD_Backlight(1);
-                     backlight_timer = 5000;  // 5 seconds
+                 if(type == BTN_EVT_LONG && button == BTN_ID_HOME) {
+                     // Long HOME: straight back to the main screen from anywhere
+                     Menu_Show(SCREEN_MAIN);
+                 } else if(type == BTN_EVT_PRESS || type == BTN_EVT_REPEAT) {
+                     Menu_HandleButton(button);
                  }
              }
-             last_button = button;
-         }
-         
-         // Manage backlight timeout for MAIN and MENU screens
-         if((current_screen == SCREEN_MAIN || current_screen == SCREEN_MENU) && backlight_timer == 0) {
-             LCD_Backlight(0);  // Turn off backlight after timeout
          }
          
         if(pattern_changed) {
@@ -471,15 +426,16 @@ void InitUnusedPins(void);
             // Update turn signal pattern outputs (OUT1/OUT2)
             Outputs_PatternTick();
             
+            // Delay-on/off and one-shot deadlines due this tick
+            EEPROM_Timed_Tick();
+            
+            // Pattern phases for a warm restart (shared with the ISR)
+            IEC0bits.T1IE = 0;
+            EEPROM_Pattern_SaveWarm();
+            IEC0bits.T1IE = 1;
+            
             // PHASE 3: Pass PATTERN_TICK reason
             TransmitAggregatedMessages(BROADCAST_REASON_PATTERN_TICK);
-            
-            // Quick poll after transmission to prevent RX overflow
-            if (ProcessPendingCANMessages()) {
-                IEC0bits.T1IE = 0;
-                state_changed = 1;
-                IEC0bits.T1IE = 1;
-            }
         }
         
         // PHASE 2: Check for state changes (input or inLINK)
@@ -490,13 +446,6 @@ void InitUnusedPins(void);
             
             // PHASE 3: Pass STATE_CHANGE reason
             TransmitAggregatedMessages(BROADCAST_REASON_STATE_CHANGE);
-            
-            // Quick poll after transmission to prevent RX overflow
-            if (ProcessPendingCANMessages()) {
-                IEC0bits.T1IE = 0;
-                state_changed = 1;
-                IEC0bits.T1IE = 1;
-            }
         }
         
         // Check if heartbeat should be sent (set in timer interrupt)
@@ -506,11 +455,27 @@ void InitUnusedPins(void);
             IEC0bits.T1IE = 1;
             
             J1939_TransmitHeartbeat();
+            J1939_ServiceDiagnostic();
+        }
+        
+        // Stream an "all outputs" request, one frame per pass
+        if(request_stream_next != NO_SLOT) {
+            ServiceRequestStream();
+        }
+        
+        // CAN error state - restarts the controller after bus-off with backoff
+        if(J1939_ServiceErrors(system_time_ms)) {
+            TransmitAggregatedMessages(BROADCAST_REASON_RESYNC);
         }
          
          if(scan_timer == 0) {
              Inputs_Scan();
+             SendOneButtonFrames();       // Ignition/starter latch changes first, within ONE_BUTTON_TX_BOUND_MS
+             SendFastPathFrames();        // Then edges of fast path inputs (brake, horn...)
+             Inputs_SaveWarm();
+             Supervisor_CheckIn(SUPERVISOR_TASK_SCAN);
              Outputs_UpdateFromInputs();  // Update hardcoded outputs (OUT3-OUT6) from inputs
+             Climate_Tick();              // Advance climate output ramps
              scan_timer = 10;
              
              if(Inputs_OneButtonStartStateChanged()) {
@@ -520,20 +485,11 @@ void InitUnusedPins(void);
                  IEC0bits.T1IE = 1;
              }
              
-             // inRESERVE voltage monitoring
-             {
-                 InReserveConfig* ir_cfg = InReserve_GetConfig();
-                 if(ir_cfg->enabled) {
-                     // Get voltage from configured PowerCell
-                     // PowerCell 1 = FF11 (Front), PowerCell 2 = FF12 (Rear), etc.
-                     uint16_t target_pgn = 0xFF10 + ir_cfg->cell_id;
-                     NetworkDevice* dev = Network_FindByPGN(target_pgn);
-                     if(dev != NULL && dev->active) {
-                         // Voltage is in byte 6: raw * 125 = millivolts
-                         uint16_t voltage_mv = (uint16_t)dev->data[6] * 125;
-                         InReserve_Update(voltage_mv);
-                     }
-                 }
+             // inRESERVE stage shed/restore goes out with the aggregated frames
+             if(InReserve_ShedStateChanged()) {
+                 IEC0bits.T1IE = 0;
+                 state_changed = 1;
+                 IEC0bits.T1IE = 1;
              }
              
              for(uint8_t i = 0; i < 44; i++) {
@@ -542,6 +498,7 @@ void InitUnusedPins(void);
                  if(current_state != prev_input_states[i]) {
                      prev_input_states[i] = current_state;
                      last_input_triggered = i;
+                     Power_NoteActivity();
                      
                      IEC0bits.T1IE = 0;
                      if(led_on_timer == 0) {
@@ -561,53 +518,38 @@ void InitUnusedPins(void);
              }
          }
          
-        if(display_timer == 0) {
-            display_timer = 500;
+        if(housekeeping_timer == 0) {
+            housekeeping_timer = 500;
             
             Network_CheckTimeouts(system_time_ms);
+            InReserve_CheckStale(system_time_ms);
+            Gateway_Service(system_time_ms);
+            EEPROM_Cases_ServicePending(system_time_ms);
             
-            switch(current_screen) {
-                case SCREEN_MAIN:
-                    DisplayMainScreen();
-                    break;
-                case SCREEN_MENU:
-                    DisplayMenuScreen();
-                    break;
-                case SCREEN_SWITCH:
-                    DisplaySwitchScreen();
-                    break;
-                case SCREEN_INVENTORY:
-                    DisplayInventoryScreen();
-                    break;
-                case SCREEN_SYSTEM_INFO:
-                    DisplaySystemInfoScreen();
-                    break;
-                case SCREEN_DEBUG:
-                    DisplayDebugScreen();
-                    break;
-                case SCREEN_CELL_DETAIL:
-                    // Cell detail screen uses its own 2-second refresh timer
-                    break;
-                case SCREEN_INRESERVE:
-                    DisplayInReserveScreen();
-                    break;
-                case SCREEN_INRESERVE_POPUP:
-                    DisplayInReservePopup();
-                    break;
-            }
-            
-            // Quick poll after display update to prevent RX overflow
-            if (ProcessPendingCANMessages()) {
-                IEC0bits.T1IE = 0;
-                state_changed = 1;
-                IEC0bits.T1IE = 1;
+            // Parked and quiet: sleep until bus activity or an input changes
+            if(Power_SleepDue()) {
+                Power_Sleep();
+                
+                // Heartbeat first - it has a cached identifier and no
+                // aggregation, so it is the quickest proof of life
+                J1939_TransmitHeartbeat();
+                Power_MarkFirstFrame();
+                TransmitAggregatedMessages(BROADCAST_REASON_RESYNC);
+                Menu_Show(SCREEN_MAIN);
+                housekeeping_timer = 500;
             }
         }
         
-        // Cell detail screen has its own 2-second refresh timer
-        if(current_screen == SCREEN_CELL_DETAIL && detail_refresh_timer == 0) {
-            detail_refresh_timer = 2000;  // Reset to 2 seconds
-            DisplayCellDetailScreen();
+        // Redraw changed rows of the current screen (per-screen refresh/version)
+        Menu_Service();
+        
+        Supervisor_Service(system_time_ms);
+        
+        // Nothing pending: halt the CPU until the next tick or CAN frame
+        if(!pattern_changed && !state_changed && !heartbeat_pending &&
+           scan_timer != 0 && housekeeping_timer != 0 &&
+           request_stream_next == NO_SLOT && J1939_GetRxCount() == 0) {
+            Power_Idle();
         }
     }
     
@@ -645,1155 +587,255 @@ void InitUnusedPins(void) {
      TRISBbits.TRISB1 = 1;  // RB1 - Analog input
  }
  
- void HandleButtonPress(uint8_t button) {
-     switch(current_screen) {
-         case SCREEN_MAIN:
-             if(button == BTN_ID_HOME) {
-                 current_screen = SCREEN_MENU;
-                 menu_selection = 0;
-                 menu_scroll_position = 0;
-                 LCD_Clear();
-                 LCD_Backlight(1);
-                 backlight_timer = 5000;  // Start 5-second timer for menu
-                 DisplayMenuScreen();
-             }
-             break;
-             
-         case SCREEN_MENU:
-             if(button == BTN_ID_UP) {
-                 if(menu_selection > 0) {
-                     menu_selection--;
-                     if(menu_selection < menu_scroll_position) {
-                         menu_scroll_position = menu_selection;
-                     }
-                     DisplayMenuScreen();
-                 }
-             } else if(button == BTN_ID_DOWN) {
-                 if(menu_selection < MENU_COUNT - 1) {
-                     menu_selection++;
-                     if(menu_selection >= menu_scroll_position + 3) {
-                         menu_scroll_position = menu_selection - 2;
-                     }
-                     DisplayMenuScreen();
-                 }
-             } else if(button == BTN_ID_SELECT) {
-                 switch(menu_selection) {
-                     case MENU_SWITCH_STATES:
-                         current_screen = SCREEN_SWITCH;
-                         LCD_Clear();
-                         DisplaySwitchScreen();
-                         break;
-                     case MENU_SYSTEM_INVENTORY:
-                         current_screen = SCREEN_INVENTORY;
-                         inventory_scroll_position = 0;
-                         LCD_Clear();
-                         DisplayInventoryScreen();
-                         break;
-                     case MENU_SYSTEM_INFO:
-                         current_screen = SCREEN_SYSTEM_INFO;
-                         LCD_Clear();
-                         DisplaySystemInfoScreen();
-                         break;
-                     case MENU_INRESERVE:
-                         current_screen = SCREEN_INRESERVE;
-                         inreserve_field_selection = 0;
-                         inreserve_scroll_position = 0;
-                         LCD_Clear();
-                         DisplayInReserveScreen();
-                         break;
-                     case MENU_DEBUG:
-                         current_screen = SCREEN_DEBUG;
-                         LCD_Clear();
-                         DisplayDebugScreen();
-                         break;
-                     case MENU_HOME_SCREEN:
-                         current_screen = SCREEN_MAIN;
-                         LCD_Clear();
-                         LCD_Backlight(1);
-                         backlight_timer = 5000;  // Start 5-second timer for main screen
-                         DisplayMainScreen();
-                         break;
-                 }
-             } else if(button == BTN_ID_HOME) {
-                 current_screen = SCREEN_MAIN;
-                 LCD_Clear();
-                 LCD_Backlight(1);
-                 backlight_timer = 5000;  // Start 5-second timer for main screen
-                 DisplayMainScreen();
-             }
-             break;
-             
-        case SCREEN_SWITCH:
-        case SCREEN_SYSTEM_INFO:
-            if(button == BTN_ID_HOME) {
-                current_screen = SCREEN_MENU;
-                LCD_Clear();
-                LCD_Backlight(1);
-                backlight_timer = 5000;  // Start 5-second timer for menu
-                DisplayMenuScreen();
-            }
-            break;
+/**
+ * Drain the CAN receive FIFO in batches and dispatch every frame
+ * Returns 1 if any inLINK message was detected, 0 otherwise
+ */
+uint8_t ProcessPendingCANMessages(void) {
+    CAN_RxMessage batch[CAN_RX_BATCH_SIZE];
+    uint8_t count;
+    uint8_t inlink_found = 0;
+    uint8_t handled = 0;
+    uint8_t received = 0;
+    
+    while ((count = J1939_ReceiveBatch(batch, CAN_RX_BATCH_SIZE)) > 0) {
+        received = 1;
+        for (uint8_t i = 0; i < count; i++) {
+            CAN_RxMessage *can_msg = &batch[i];
             
-        case SCREEN_INVENTORY:
-            if(button == BTN_ID_HOME) {
-                current_screen = SCREEN_MENU;
-                inventory_scroll_position = 0;
-                inventory_selection = 0;
-                LCD_Clear();
-                LCD_Backlight(1);
-                backlight_timer = 5000;  // Start 5-second timer for menu
-                DisplayMenuScreen();
-            } else if(button == BTN_ID_UP) {
-                if(inventory_selection > 0) {
-                    inventory_selection--;
-                    // Adjust scroll if selection goes above visible area
-                    if(inventory_selection < inventory_scroll_position) {
-                        inventory_scroll_position = inventory_selection;
-                    }
-                    DisplayInventoryScreen();
-                }
-            } else if(button == BTN_ID_DOWN) {
-                // Will be bounded by display_count in DisplayInventoryScreen
-                inventory_selection++;
-                // Adjust scroll if selection goes below visible area
-                if(inventory_selection >= inventory_scroll_position + 3) {
-                    inventory_scroll_position = inventory_selection - 2;
-                }
-                DisplayInventoryScreen();
-            } else if(button == BTN_ID_SELECT) {
-                // Enter cell detail view - but not for inLINK (type 2)
-                if(selected_cell_type != 2) {
-                    current_screen = SCREEN_CELL_DETAIL;
-                    detail_current_scroll = 0;
-                    detail_refresh_timer = 0;  // Trigger immediate display
-                    LCD_Clear();
-                    DisplayCellDetailScreen();
-                }
-                // inLINK has no detail screen - SELECT does nothing
+            // Forward to the other segment; frames that stay on segment 2 end here
+            if (!Gateway_Route(can_msg, system_time_ms)) {
+                continue;
             }
-            break;
             
-        case SCREEN_CELL_DETAIL:
-            if(button == BTN_ID_HOME) {
-                current_screen = SCREEN_INVENTORY;
-                detail_current_scroll = 0;
-                LCD_Clear();
-                DisplayInventoryScreen();
-            } else if(button == BTN_ID_UP) {
-                if(detail_current_scroll > 0) {
-                    detail_current_scroll--;
-                    LCD_Clear();
-                    DisplayCellDetailScreen();
-                }
-            } else if(button == BTN_ID_DOWN) {
-                // For PowerCell, scroll through 3 pages: 0=info, 1=I3-I8, 2=I9-I10
-                if(selected_cell_type == 0 && detail_current_scroll < 2) {
-                    detail_current_scroll++;
-                    LCD_Clear();
-                    DisplayCellDetailScreen();
-                }
-            }
-            break;
-             
-         case SCREEN_DEBUG:
-             if(button == BTN_ID_HOME) {
-                 current_screen = SCREEN_MAIN;
-                 LCD_Clear();
-                 LCD_Backlight(1);
-                 backlight_timer = 5000;  // Start 5-second timer for main screen
-                 DisplayMainScreen();
-             }
-             break;
-             
-        case SCREEN_INRESERVE:
-            if(button == BTN_ID_HOME) {
-                current_screen = SCREEN_MENU;
-                LCD_Clear();
-                LCD_Backlight(1);
-                backlight_timer = 5000;
-                DisplayMenuScreen();
-            } else if(button == BTN_ID_UP) {
-                if(inreserve_field_selection > 0) {
-                    inreserve_field_selection--;
-                    // Adjust scroll if needed
-                    if(inreserve_field_selection < inreserve_scroll_position) {
-                        inreserve_scroll_position = inreserve_field_selection;
-                    }
-                    LCD_Clear();
-                    DisplayInReserveScreen();
-                }
-            } else if(button == BTN_ID_DOWN) {
-                InReserveConfig* cfg = InReserve_GetConfig();
-                uint8_t max_field = cfg->enabled ? (INRESERVE_FIELD_COUNT - 1) : 0;
-                if(inreserve_field_selection < max_field) {
-                    inreserve_field_selection++;
-                    // Adjust scroll if needed (4 visible lines, first is title)
-                    if(inreserve_field_selection >= inreserve_scroll_position + 3) {
-                        inreserve_scroll_position = inreserve_field_selection - 2;
-                    }
-                    LCD_Clear();
-                    DisplayInReserveScreen();
-                }
-            } else if(button == BTN_ID_SELECT) {
-                // Open popup for selected field
-                inreserve_popup_type = inreserve_field_selection;
-                InReserveConfig* cfg = InReserve_GetConfig();
-                // Set initial popup selection to current value
-                switch(inreserve_popup_type) {
-                    case INRESERVE_POPUP_ENABLE:
-                        inreserve_popup_selection = cfg->enabled ? 0 : 1;
-                        break;
-                    case INRESERVE_POPUP_CELL:
-                        inreserve_popup_selection = cfg->cell_id > 0 ? cfg->cell_id - 1 : 0;
-                        break;
-                    case INRESERVE_POPUP_OUTPUT: {
-                        uint8_t min_out = InReserve_GetMinOutput(cfg->cell_id);
-                        uint8_t max_out = InReserve_GetMaxOutput(cfg->cell_id);
-                        // Clamp current output to valid range, then convert to selection index
-                        uint8_t clamped = cfg->output;
-                        if(clamped < min_out) clamped = min_out;
-                        if(clamped > max_out) clamped = max_out;
-                        inreserve_popup_selection = clamped - min_out;
-                        break;
-                    }
-                    case INRESERVE_POPUP_TIME:
-                        inreserve_popup_selection = cfg->time_code;
-                        break;
-                    case INRESERVE_POPUP_VOLTAGE:
-                        inreserve_popup_selection = cfg->voltage_code;
-                        break;
-                }
-                // Set scroll position to show the selected item (show 3 items, selection in middle if possible)
-                if(inreserve_popup_selection <= 1) {
-                    inreserve_popup_scroll = 0;
-                } else {
-                    inreserve_popup_scroll = inreserve_popup_selection - 1;
-                }
-                current_screen = SCREEN_INRESERVE_POPUP;
-                LCD_Clear();
-                DisplayInReservePopup();
-            }
-            break;
+            last_rx_can_id = can_msg->id;
+            last_rx_pgn = (can_msg->id >> 8) & 0xFFFF;
             
-        case SCREEN_INRESERVE_POPUP:
-            if(button == BTN_ID_HOME) {
-                // Cancel - return to main inRESERVE screen
-                current_screen = SCREEN_INRESERVE;
-                LCD_Clear();
-                DisplayInReserveScreen();
-            } else if(button == BTN_ID_UP) {
-                if(inreserve_popup_selection > 0) {
-                    inreserve_popup_selection--;
-                    if(inreserve_popup_selection < inreserve_popup_scroll) {
-                        inreserve_popup_scroll = inreserve_popup_selection;
-                    }
-                    DisplayInReservePopup();
-                }
-            } else if(button == BTN_ID_DOWN) {
-                uint8_t max_items = 0;
-                switch(inreserve_popup_type) {
-                    case INRESERVE_POPUP_ENABLE: max_items = 2; break;
-                    case INRESERVE_POPUP_CELL: max_items = 6; break;   // Front, Rear, 3, 4, 5, 6
-                    case INRESERVE_POPUP_OUTPUT: {
-                        InReserveConfig* cfg = InReserve_GetConfig();
-                        max_items = InReserve_GetOutputCount(cfg->cell_id);
-                        break;
-                    }
-                    case INRESERVE_POPUP_TIME: max_items = 3; break;   // 30sec, 15min, 20min
-                    case INRESERVE_POPUP_VOLTAGE: max_items = 3; break;  // 12.1V, 12.2V, 12.3V
-                }
-                if(inreserve_popup_selection < max_items - 1) {
-                    inreserve_popup_selection++;
-                    if(inreserve_popup_selection >= inreserve_popup_scroll + 3) {
-                        inreserve_popup_scroll = inreserve_popup_selection - 2;
-                    }
-                    DisplayInReservePopup();
-                }
-            } else if(button == BTN_ID_SELECT) {
-                // Apply selection
-                switch(inreserve_popup_type) {
-                    case INRESERVE_POPUP_ENABLE:
-                        if(inreserve_popup_selection == 0) {
-                            // Enable - set to default cell if currently disabled
-                            InReserveConfig* cfg = InReserve_GetConfig();
-                            if(cfg->cell_id == 0) {
-                                InReserve_SetCellID(2);  // Default to Rear
-                            }
-                        } else {
-                            InReserve_SetCellID(0);  // Disable
-                        }
-                        break;
-                    case INRESERVE_POPUP_CELL:
-                        InReserve_SetCellID(inreserve_popup_selection + 1);
-                        break;
-                    case INRESERVE_POPUP_OUTPUT: {
-                        InReserveConfig* cfg = InReserve_GetConfig();
-                        uint8_t min_out = InReserve_GetMinOutput(cfg->cell_id);
-                        InReserve_SetOutput(inreserve_popup_selection + min_out);
-                        break;
-                    }
-                    case INRESERVE_POPUP_TIME:
-                        InReserve_SetTime(inreserve_popup_selection);
-                        break;
-                    case INRESERVE_POPUP_VOLTAGE:
-                        InReserve_SetVoltage(inreserve_popup_selection);
-                        break;
-                }
-                // Save to EEPROM
-                InReserve_SaveConfig();
-                // Return to main screen
-                current_screen = SCREEN_INRESERVE;
-                inreserve_field_selection = 0;
-                inreserve_scroll_position = 0;
-                LCD_Clear();
-                DisplayInReserveScreen();
+            uint8_t rx_sa = can_msg->id & 0xFF;
+            uint16_t rx_pgn = (can_msg->id >> 8) & 0xFFFF;
+            Network_UpdateDevice(rx_sa, rx_pgn, system_time_ms, can_msg->data);
+            
+            handled |= CAN_Config_ProcessMessage((CAN_Message*)can_msg);
+            
+            // Climate control (PGN 0xAF00, bytes 0-2) and MOSFET outputs (byte 3)
+            handled |= Climate_ProcessMessage(can_msg->id, can_msg->data);
+            handled |= Outputs_ProcessMessage(can_msg->id, can_msg->data);
+            
+            // inRESERVE voltage monitoring - evaluated only on new PowerCell samples
+            InReserve_ProcessMessage(can_msg->id, can_msg->data);
+            
+            // Check for inLINK message (AF01, AF02, etc. but NOT AF00)
+            // AF00 is handled by Climate/Outputs, only AF01+ are inLINK messages
+            uint8_t pgn_high = (rx_pgn >> 8) & 0xFF;
+            if (((pgn_high & 0xF0) == 0xA0) && (rx_pgn != 0xAF00)) {
+                inlink_found = 1;
             }
-            break;
-     }
- }
- 
- void DisplayMainScreen(void) {
-     LCD_SetCursor(0, 0);
-     LCD_Print("  INFINITYBOX   ");
-     
-     LCD_SetCursor(1, 0);
-     LCD_Print("IPM POWER SYSTEM");
-     
-     LCD_SetCursor(2, 0);
-     uint8_t tx_ok = J1939_IsTxReady();
-     uint8_t rx_ok = !J1939_HasRxOverflow();
-     
-     if(tx_ok && rx_ok) {
-         LCD_Print("CAN: TX-OK RX-OK");
-     } else if(!tx_ok && rx_ok) {
-         LCD_Print("CAN: TX-ER RX-OK");
-     } else if(tx_ok && !rx_ok) {
-         LCD_Print("CAN: TX-OK RX-OV");
-     } else {
-         LCD_Print("CAN: TX-ER RX-OV");
-     }
-     
-     LCD_SetCursor(3, 0);
-     uint8_t ignition = Inputs_GetIgnitionState();
-     uint8_t security_disarmed = Inputs_GetSecurityState();  // 1 = DISARMED, 0 = ARMED
-     
-     if(ignition && security_disarmed) {
-         LCD_Print("IGN: ON  SEC:OFF");
-     } else if(ignition && !security_disarmed) {
-         LCD_Print("IGN: ON  SEC: ON");
-     } else if(!ignition && security_disarmed) {
-         LCD_Print("IGN: OFF SEC:OFF");
-     } else {
-         LCD_Print("IGN: OFF SEC: ON");
-     }
- }
- 
- void DisplayMenuScreen(void) {
-     LCD_SetCursor(0, 0);
-     LCD_Print("--- MAIN MENU --");
-     
-     for(uint8_t line = 0; line < 3; line++) {
-         LCD_SetCursor(line + 1, 0);
-         uint8_t item = menu_scroll_position + line;
-         
-         if(item >= MENU_COUNT) {
-             LCD_Print("                ");
-             continue;
-         }
-         
-         char cursor = (item == menu_selection) ? '>' : ' ';
-         
-         switch(item) {
-             case MENU_SWITCH_STATES:
-                 LCD_Print(cursor == '>' ? ">SWITCH STATES  " : " SWITCH STATES  ");
-                 break;
-             case MENU_SYSTEM_INVENTORY:
-                 LCD_Print(cursor == '>' ? ">SYSTEM INV     " : " SYSTEM INV     ");
-                 break;
-             case MENU_SYSTEM_INFO:
-                 LCD_Print(cursor == '>' ? ">SYSTEM INFO    " : " SYSTEM INFO    ");
-                 break;
-             case MENU_INRESERVE:
-                 LCD_Print(cursor == '>' ? ">inRESERVE      " : " inRESERVE      ");
-                 break;
-             case MENU_DEBUG:
-                 LCD_Print(cursor == '>' ? ">DEBUG          " : " DEBUG          ");
-                 break;
-             case MENU_HOME_SCREEN:
-                 LCD_Print(cursor == '>' ? ">HOME SCREEN    " : " HOME SCREEN    ");
-                 break;
-         }
-     }
- }
- 
- void DisplaySwitchScreen(void) {
-     char display_buffer[17];
-     
-     // Keep backlight on for sub-menu screens
-     LCD_Backlight(1);
-     backlight_timer = 0;  // Disable timer so it stays on
-     
-     LCD_SetCursor(0, 0);
-     LCD_Print("SWITCH STATES   ");
-     
-     LCD_SetCursor(1, 0);
-     for(uint8_t i = 0; i < 16; i++) {
-         display_buffer[i] = Inputs_GetState(i) ? '1' : '0';
-     }
-     display_buffer[16] = '\0';
-     LCD_Print(display_buffer);
-     
-     LCD_SetCursor(2, 0);
-     for(uint8_t i = 16; i < 32; i++) {
-         display_buffer[i-16] = Inputs_GetState(i) ? '1' : '0';
-     }
-     display_buffer[16] = '\0';
-     LCD_Print(display_buffer);
-     
-     LCD_SetCursor(3, 0);
-     for(uint8_t i = 32; i < 38; i++) {
-         display_buffer[i-32] = Inputs_GetState(i) ? '1' : '0';
-     }
-     display_buffer[6] = ' ';
-     for(uint8_t i = 38; i < 44; i++) {
-         display_buffer[i-31] = Inputs_GetState(i) ? '1' : '0';
-     }
-     for(uint8_t i = 13; i < 16; i++) {
-         display_buffer[i] = ' ';
-     }
-     display_buffer[16] = '\0';
-     LCD_Print(display_buffer);
- }
- 
- void DisplayInventoryScreen(void) {
-     char display_buffer[17];
-     uint8_t device_count = Network_GetDeviceCount();
-     
-     // Keep backlight on for sub-menu screens
-     LCD_Backlight(1);
-     backlight_timer = 0;  // Disable timer so it stays on
-     
-     // Build a friendly device list
-     // We'll create "virtual" devices for display purposes
-     typedef struct {
-         uint16_t display_pgn;  // PGN to show (may be virtual like FF01 for POWERCELL)
-         char name[12];         // Friendly name
-         uint8_t valid;         // 1 if this entry should be displayed
-     } DisplayDevice;
-     
-     DisplayDevice display_list[16];
-     uint8_t display_count = 0;
-     
-    // Track which POWERCELLs, inLINK, and inControl we've found
-    uint8_t found_ff11 = 0, found_ff21 = 0;  // Front POWERCELL
-    uint8_t found_ff12 = 0, found_ff22 = 0;  // Rear POWERCELL
-    uint8_t found_af00 = 0;                   // inLINK NGX
-    uint8_t found_bf = 0;                     // inControl 1 (BFxx)
-    uint8_t found_cf = 0;                     // inControl 2 (CFxx)
-    
-    // First pass: identify all devices and check for POWERCELL pairs
-    for(uint8_t i = 0; i < device_count; i++) {
-        NetworkDevice* device = Network_GetDevice(i);
-        if(device != NULL && device->active) {
-            if(device->pgn == 0xFF11) found_ff11 = 1;
-            if(device->pgn == 0xFF21) found_ff21 = 1;
-            if(device->pgn == 0xFF12) found_ff12 = 1;
-            if(device->pgn == 0xFF22) found_ff22 = 1;
-            if(device->pgn == 0xAF00) found_af00 = 1;
-            if((device->pgn & 0xFF00) == 0xBF00) found_bf = 1;
-            if((device->pgn & 0xFF00) == 0xCF00) found_cf = 1;
+            
+            InLink_ProcessMessage(can_msg->id, can_msg->data);
+            
+            // J1939 Request PGN - answer with the current state
+            HandleRequest(can_msg);
         }
     }
     
-    // Build display list in order: AF (inLINK), FF01/02 (PowerCells), FF03-06 (inMotion)
-    
-    // 1. Add inLINK NGX if found (no detail screen, just shows in list)
-    if(found_af00 && display_count < 16) {
-        display_list[display_count].display_pgn = 0xAF00;
-        sprintf(display_list[display_count].name, "inLINK NGX");
-        display_list[display_count].valid = 1;
-        display_count++;
+    // Any bus traffic postpones Sleep
+    if (received) {
+        Power_NoteActivity();
     }
     
-    // 2. Add inControl devices if found (no detail screen)
-    if(found_bf && display_count < 16) {
-        display_list[display_count].display_pgn = 0xBF00;
-        sprintf(display_list[display_count].name, "inC 1");
-        display_list[display_count].valid = 1;
-        display_count++;
-    }
-    if(found_cf && display_count < 16) {
-        display_list[display_count].display_pgn = 0xCF00;
-        sprintf(display_list[display_count].name, "inC 2");
-        display_list[display_count].valid = 1;
-        display_count++;
+    // Flash the LED for configuration / control traffic addressed to us
+    if (handled) {
+        IEC0bits.T1IE = 0;
+        if (led_on_timer == 0) {
+            led_on_timer = 50;
+        }
+        IEC0bits.T1IE = 1;
     }
     
-    // 3. Add Front POWERCELL (FF01) if both FF11 and FF21 found
-    if(found_ff11 && found_ff21 && display_count < 16) {
-        display_list[display_count].display_pgn = 0xFF01;
-        sprintf(display_list[display_count].name, "FRONT PC");
-        display_list[display_count].valid = 1;
-        display_count++;
-    }
+    return inlink_found;
+}
+
+/**
+ * Answer a J1939 Request (PGN 0xEA00)
+ * - heartbeat / diagnostic PGN: send it now
+ * - an output PGN: send the current frame of every slot with that PGN
+ * - J1939_PGN_ALL_OUTPUTS: stream every slot (ServiceRequestStream)
+ * Requests to another node's address are ignored.
+ */
+void HandleRequest(CAN_RxMessage *can_msg) {
+    uint16_t requested_pgn;
+    uint8_t dest_addr;
     
-    // 3. Add Rear POWERCELL (FF02) if both FF12 and FF22 found
-    if(found_ff12 && found_ff22 && display_count < 16) {
-        display_list[display_count].display_pgn = 0xFF02;
-        sprintf(display_list[display_count].name, "REAR PC");
-        display_list[display_count].valid = 1;
-        display_count++;
+    if(!J1939_ParseRequest(can_msg, &requested_pgn, &dest_addr)) {
+        return;
     }
     
-    // 4. Add inMOTION devices (FF03-FF06) - scan for them
-    for(uint8_t i = 0; i < device_count && display_count < 16; i++) {
-        NetworkDevice* device = Network_GetDevice(i);
-        if(device == NULL || !device->active) continue;
-        
-        if(device->pgn == 0xFF33) {
-            display_list[display_count].display_pgn = 0xFF03;
-            sprintf(display_list[display_count].name, "DF inM NGX");
-            display_list[display_count].valid = 1;
-            display_count++;
-        }
-        else if(device->pgn == 0xFF34) {
-            display_list[display_count].display_pgn = 0xFF04;
-            sprintf(display_list[display_count].name, "PF inM NGX");
-            display_list[display_count].valid = 1;
-            display_count++;
-        }
-        else if(device->pgn == 0xFF35) {
-            display_list[display_count].display_pgn = 0xFF05;
-            sprintf(display_list[display_count].name, "DR inM NGX");
-            display_list[display_count].valid = 1;
-            display_count++;
-        }
-        else if(device->pgn == 0xFF36) {
-            display_list[display_count].display_pgn = 0xFF06;
-            sprintf(display_list[display_count].name, "PR inM NGX");
-            display_list[display_count].valid = 1;
-            display_count++;
-        }
-        // Skip all other devices (FF11, FF12, FF21, FF22 already handled above)
-    }
-     
-    // Clamp inventory_selection to valid range
-    if(display_count == 0) {
-        inventory_selection = 0;
-    } else if(inventory_selection >= display_count) {
-        inventory_selection = display_count - 1;
+    if(J1939_AnswerStatusRequest(requested_pgn, dest_addr)) {
+        return;
     }
     
-    // Store selected cell info for detail screen
-    if(display_count > 0 && inventory_selection < display_count) {
-        selected_cell_pgn = display_list[inventory_selection].display_pgn;
-        // Determine cell type: 0=PowerCell, 1=InMotion, 2=no detail (inLINK, inControl)
-        if(selected_cell_pgn == 0xFF01 || selected_cell_pgn == 0xFF02) {
-            selected_cell_type = 0;  // PowerCell
-        } else if(selected_cell_pgn == 0xAF00 || selected_cell_pgn == 0xBF00 || selected_cell_pgn == 0xCF00) {
-            selected_cell_type = 2;  // No detail screen (inLINK, inControl)
-        } else {
-            selected_cell_type = 1;  // InMotion
+    if(requested_pgn == J1939_PGN_ALL_OUTPUTS) {
+        if(dest_addr == J1939_GLOBAL_ADDR ||
+           dest_addr == EEPROM_Config_ReadByte(EEPROM_CFG_HEARTBEAT_SA)) {
+            request_stream_next = 0;
         }
+        return;
     }
     
-    // Display the list
-    LCD_SetCursor(0, 0);
-    sprintf(display_buffer, "SYSTEM INV (%d) ", display_count);
-    LCD_Print(display_buffer);
-    
-    for(uint8_t line = 0; line < 3; line++) {
-        LCD_SetCursor(line + 1, 0);
-        
-        uint8_t device_index = inventory_scroll_position + line;
-        if(device_index < display_count && display_list[device_index].valid) {
-            char cursor = (device_index == inventory_selection) ? '>' : ' ';
-            sprintf(display_buffer, "%c%04X %-10s", 
-                    cursor,
-                    display_list[device_index].display_pgn,
-                    display_list[device_index].name);
-            LCD_Print(display_buffer);
-        } else {
-            LCD_Print("                ");
+    for(uint8_t i = 0; i < prev_msg_count; i++) {
+        PreviousMessage *slot = &prev_messages[i];
+        if(slot->valid && slot->pgn == requested_pgn && slot->pgn != OUTPUTS_LOCAL_PGN &&
+           (dest_addr == J1939_GLOBAL_ADDR || dest_addr == slot->source_addr)) {
+            J1939_TransmitImage(&slot->tx_image, slot->data);
         }
     }
 }
 
-// Helper: Display 2 currents on a line
-static void DisplayCurrentPair(char *buffer, uint8_t idx1, uint8_t idx2, NetworkDevice *dev1, NetworkDevice *dev2) {
-    char *p = buffer;
-    
-    for(uint8_t n = 0; n < 2; n++) {
-        uint8_t idx = (n == 0) ? idx1 : idx2;
-        if(idx >= 10) {
-            // Pad rest of line
-            while(p - buffer < 16) *p++ = ' ';
-            break;
-        }
-        
-        uint8_t current_raw = 0;
-        // Outputs 0-4 (I1-I5) in dev1 bytes 1-5, outputs 5-9 (I6-I10) in dev2 bytes 1-5
-        if(idx < 5 && dev1 != NULL) {
-            current_raw = dev1->data[1 + idx];
-        } else if(idx >= 5 && dev2 != NULL) {
-            current_raw = dev2->data[1 + (idx - 5)];
+/**
+ * Send the next slot of an "all outputs" request if the TX buffer is free
+ * One frame per main loop pass, so other traffic is not held off
+ */
+void ServiceRequestStream(void) {
+    while(request_stream_next < prev_msg_count) {
+        if(!J1939_IsTxReady()) {
+            return;
         }
         
-        uint16_t current_ma = (uint16_t)current_raw * 117;
-        uint8_t amps = current_ma / 1000;
-        uint8_t tenths = (current_ma % 1000) / 100;
-        
-        if(idx < 9) {
-            p += sprintf(p, "I%d=%d.%dA ", idx+1, amps, tenths);
-        } else {
-            p += sprintf(p, "I%d=%d.%d ", idx+1, amps, tenths);
+        PreviousMessage *slot = &prev_messages[request_stream_next++];
+        if(slot->valid && slot->pgn != OUTPUTS_LOCAL_PGN) {
+            J1939_TransmitImage(&slot->tx_image, slot->data);
+            return;
         }
     }
-    while(p - buffer < 16) *p++ = ' ';
-    buffer[16] = '\0';
+    
+    request_stream_next = NO_SLOT;
 }
 
-void DisplayCellDetailScreen(void) {
-    char display_buffer[17];
-    NetworkDevice *dev1 = NULL;  // FF11/FF12: outputs 1-5, currents 1-5, voltage, temp
-    NetworkDevice *dev2 = NULL;  // FF21/FF22: outputs 6-10, currents 6-10, voltage, temp
-    
-    // Keep backlight on for detail screen
-    LCD_Backlight(1);
-    backlight_timer = 0;
+/**
+ * Send the frames of fast path inputs that changed in this scan
+ * Runs before the edge loop below updates prev_input_states and before the
+ * aggregated transmit; both then find these frames already up to date.
+ * Like the one-button frames they use the priority TX buffer.
+ * A PGN/SA with no slot yet is left to the aggregated transmit.
+ */
+void SendFastPathFrames(void) {
+    uint8_t input_num, source_addr;
+    uint16_t pgn;
     
-    // Get device data based on selected cell type
-    if(selected_cell_type == 0) {
-        // PowerCell - need two PGNs for full data
-        // Message format per PowerCell docs:
-        //   Byte 0: bits 4-0 = output states (1-5 in msg1, 6-10 in msg2)
-        //           bit 4 = output 1/6, bit 0 = output 5/10
-        //   Bytes 1-5: current for 5 outputs (count * 0.117A)
-        //   Byte 6: voltage (count * 0.125V)
-        //   Byte 7: temperature in °C
-        
-        if(selected_cell_pgn == 0xFF01) {
-            // Front PowerCell
-            dev1 = Network_FindByPGN(0xFF11);
-            dev2 = Network_FindByPGN(0xFF21);
-            LCD_SetCursor(0, 0);
-            LCD_Print("FRONT POWERCELL ");
-        } else {
-            // Rear PowerCell
-            dev1 = Network_FindByPGN(0xFF12);
-            dev2 = Network_FindByPGN(0xFF22);
-            LCD_SetCursor(0, 0);
-            LCD_Print("REAR POWERCELL  ");
+    for(uint8_t entry = 0; EEPROM_GetFastPathFrame(entry, &input_num, &pgn, &source_addr); entry++) {
+        uint8_t current_state = Inputs_GetState(input_num);
+        if(current_state == prev_input_states[input_num]) {
+            continue;
         }
         
-        // Clamp scroll position: 0=info, 1=currents 3-8, 2=currents 9-10
-        if(detail_current_scroll > 2) detail_current_scroll = 2;
-        
-        // SCROLLABLE CONTENT - Lines 2-4 scroll together
-        // Scroll 0: V/T, Outputs, I1-I2
-        // Scroll 1: I3-I4, I5-I6, I7-I8
-        // Scroll 2: I9-I10, (blank), (blank)
-        
-        if(detail_current_scroll == 0) {
-            // === SCROLL 0: V/T, Outputs, I1-I2 ===
-            
-            // Line 2: Voltage and Temperature
-            LCD_SetCursor(1, 0);
-            if(dev1 != NULL) {
-                uint8_t voltage_raw = dev1->data[6];
-                uint16_t voltage_mv = (uint16_t)voltage_raw * 125;
-                uint8_t voltage_v = voltage_mv / 1000;
-                uint8_t voltage_frac = (voltage_mv % 1000) / 100;
-                int8_t temp_c = (int8_t)dev1->data[7];
-                sprintf(display_buffer, "V=%d.%dV T=%d C ", voltage_v, voltage_frac, temp_c);
-                LCD_Print(display_buffer);
-            } else {
-                LCD_Print("V=--.- T=---    ");
+        for(uint8_t i = 0; i < prev_msg_count; i++) {
+            PreviousMessage *slot = &prev_messages[i];
+            if(!slot->valid || slot->pgn != pgn || slot->source_addr != source_addr) {
+                continue;
             }
             
-            // Line 3: Output states (10 outputs)
-            // Bits 7-3 contain output states: bit 7=out1/6, bit 6=out2/7, ..., bit 3=out5/10
-            LCD_SetCursor(2, 0);
-            if(dev1 != NULL && dev2 != NULL) {
-                uint8_t out1_5 = dev1->data[0];
-                uint8_t out6_10 = dev2->data[0];
-                
-                sprintf(display_buffer, "OUT:");
-                // Outputs 1-5: bit 7=out1, bit 6=out2, bit 5=out3, bit 4=out4, bit 3=out5
-                for(uint8_t i = 0; i < 5; i++) {
-                    display_buffer[4+i] = (out1_5 & (1 << (7-i))) ? '1' : '0';
-                }
-                // Outputs 6-10: bit 7=out6, bit 6=out7, bit 5=out8, bit 4=out9, bit 3=out10
-                for(uint8_t i = 0; i < 5; i++) {
-                    display_buffer[9+i] = (out6_10 & (1 << (7-i))) ? '1' : '0';
-                }
-                display_buffer[14] = ' ';
-                display_buffer[15] = ' ';
-                display_buffer[16] = '\0';
-                LCD_Print(display_buffer);
-            } else if(dev1 != NULL) {
-                uint8_t out1_5 = dev1->data[0];
-                sprintf(display_buffer, "OUT:");
-                for(uint8_t i = 0; i < 5; i++) {
-                    display_buffer[4+i] = (out1_5 & (1 << (7-i))) ? '1' : '0';
-                }
-                for(uint8_t i = 5; i < 10; i++) {
-                    display_buffer[4+i] = '-';
+            uint8_t data[8];
+            uint8_t changed = 0;
+            for(uint8_t k = 0; k < 8; k++) {
+                data[k] = slot->data[k];
+            }
+            EEPROM_FastPathUpdate(entry, current_state, data);
+            for(uint8_t k = 0; k < 8; k++) {
+                if(data[k] != slot->data[k]) {
+                    slot->data[k] = data[k];
+                    changed = 1;
                 }
-                display_buffer[14] = ' ';
-                display_buffer[15] = ' ';
-                display_buffer[16] = '\0';
-                LCD_Print(display_buffer);
-            } else {
-                LCD_Print("OUT:----------  ");
             }
-            
-            // Line 4: I1-I2
-            LCD_SetCursor(3, 0);
-            DisplayCurrentPair(display_buffer, 0, 1, dev1, dev2);
-            LCD_Print(display_buffer);
-            
-        } else if(detail_current_scroll == 1) {
-            // === SCROLL 1: I3-I4, I5-I6, I7-I8 ===
-            LCD_SetCursor(1, 0);
-            DisplayCurrentPair(display_buffer, 2, 3, dev1, dev2);
-            LCD_Print(display_buffer);
-            
-            LCD_SetCursor(2, 0);
-            DisplayCurrentPair(display_buffer, 4, 5, dev1, dev2);
-            LCD_Print(display_buffer);
-            
-            LCD_SetCursor(3, 0);
-            DisplayCurrentPair(display_buffer, 6, 7, dev1, dev2);
-            LCD_Print(display_buffer);
-            
-        } else {
-            // === SCROLL 2: I9-I10 ===
-            LCD_SetCursor(1, 0);
-            DisplayCurrentPair(display_buffer, 8, 9, dev1, dev2);
-            LCD_Print(display_buffer);
-            
-            LCD_SetCursor(2, 0);
-            LCD_Print("                ");
-            
-            LCD_SetCursor(3, 0);
-            LCD_Print("                ");
-        }
-        
-    } else if(selected_cell_type == 1) {
-        // InMotion - single PGN with nibble-packed output states
-        // Message format (7 bytes):
-        //   Bytes 0-3: Output states (4-bit nibbles, bit 0 = ON/OFF)
-        //     Byte 0: Relay 1A (upper), Relay 1B (lower)
-        //     Byte 1: Relay 2A (upper), Relay 2B (lower)
-        //     Byte 2: MOSFET 1 (upper), MOSFET 3 (lower)
-        //     Byte 3: MOSFET 2 (upper), MOSFET 4 (lower)
-        //   Bytes 4-6: Current measurements
-        
-        uint16_t actual_pgn;
-        const char *name;
-        switch(selected_cell_pgn) {
-            case 0xFF03: actual_pgn = 0xFF33; name = "DF inMOTION NGX "; break;
-            case 0xFF04: actual_pgn = 0xFF34; name = "PF inMOTION NGX "; break;
-            case 0xFF05: actual_pgn = 0xFF35; name = "DR inMOTION NGX "; break;
-            case 0xFF06: actual_pgn = 0xFF36; name = "PR inMOTION NGX "; break;
-            default:     actual_pgn = 0xFF33; name = "inMOTION NGX    "; break;
-        }
-        
-        dev1 = Network_FindByPGN(actual_pgn);
-        
-        LCD_SetCursor(0, 0);
-        LCD_Print(name);
-        
-        if(dev1 != NULL) {
-            // Parse relay states from bytes 0-1
-            // Upper nibble bit 0 = state, lower nibble bit 0 = state
-            uint8_t relay1a = (dev1->data[0] >> 4) & 0x01;  // Byte 0 upper
-            uint8_t relay1b = (dev1->data[0]) & 0x01;       // Byte 0 lower
-            uint8_t relay2a = (dev1->data[1] >> 4) & 0x01;  // Byte 1 upper
-            uint8_t relay2b = (dev1->data[1]) & 0x01;       // Byte 1 lower
-            
-            // Parse MOSFET states from bytes 2-3
-            // Byte 2: Out1 (upper nibble), Out2 (lower nibble)
-            // Byte 3: Out3 (upper nibble), Out4 (lower nibble)
-            uint8_t mosfet1 = (dev1->data[2] >> 4) & 0x01;  // Byte 2 upper = Output 1
-            uint8_t mosfet2 = (dev1->data[2]) & 0x01;       // Byte 2 lower = Output 2
-            uint8_t mosfet3 = (dev1->data[3] >> 4) & 0x01;  // Byte 3 upper = Output 3
-            uint8_t mosfet4 = (dev1->data[3]) & 0x01;       // Byte 3 lower = Output 4
-            
-            // Line 2: Relay states (1A, 1B, 2A, 2B)
-            LCD_SetCursor(1, 0);
-            sprintf(display_buffer, "RLY: %c %c %c %c   ",
-                    relay1a ? '1' : '0',
-                    relay1b ? '1' : '0',
-                    relay2a ? '1' : '0',
-                    relay2b ? '1' : '0');
-            LCD_Print(display_buffer);
-            
-            // Line 3: MOSFET output states (1, 2, 3, 4)
-            LCD_SetCursor(2, 0);
-            sprintf(display_buffer, "OUT: %c %c %c %c   ",
-                    mosfet1 ? '1' : '0',
-                    mosfet2 ? '1' : '0',
-                    mosfet3 ? '1' : '0',
-                    mosfet4 ? '1' : '0');
-            LCD_Print(display_buffer);
-            
-            // Line 4: Empty
-            LCD_SetCursor(3, 0);
-            LCD_Print("                ");
-        } else {
-            LCD_SetCursor(1, 0);
-            LCD_Print("RLY: - - - -    ");
-            LCD_SetCursor(2, 0);
-            LCD_Print("OUT: - - - -    ");
-            LCD_SetCursor(3, 0);
-            LCD_Print("                ");
+            if(changed) {
+                slot->ticks_since_sent = 0;
+                J1939_TransmitPriority(&slot->tx_image, slot->data);
+                Inputs_EdgeSent(input_num);
+                broadcast_version++;
+                SaveTransmitHistory();
+            }
+            break;
         }
     }
 }
 
-void DisplaySystemInfoScreen(void) {
-    char display_buffer[17];
-    uint8_t fw_major, fw_minor;
-    uint8_t customer_name[4];
-    
-    // Keep backlight on for sub-menu screens
-    LCD_Backlight(1);
-    backlight_timer = 0;  // Disable timer so it stays on
-    
-    // Read firmware version from EEPROM
-    fw_major = EEPROM_Config_ReadByte(EEPROM_CFG_FW_MAJOR);
-     fw_minor = EEPROM_Config_ReadByte(EEPROM_CFG_FW_MINOR);
-     
-     // Read customer name from EEPROM
-     customer_name[0] = EEPROM_Config_ReadByte(EEPROM_CFG_CUSTOMER_NAME_1);
-     customer_name[1] = EEPROM_Config_ReadByte(EEPROM_CFG_CUSTOMER_NAME_2);
-     customer_name[2] = EEPROM_Config_ReadByte(EEPROM_CFG_CUSTOMER_NAME_3);
-     customer_name[3] = EEPROM_Config_ReadByte(EEPROM_CFG_CUSTOMER_NAME_4);
-     
-     // Line 1: SYSTEM INFO
-     LCD_SetCursor(0, 0);
-     LCD_Print("SYSTEM INFO     ");
-     
-     // Line 2: Software Ver: X
-     LCD_SetCursor(1, 0);
-     sprintf(display_buffer, "Software Ver: %u ", fw_major);
-     LCD_Print(display_buffer);
-     
-     // Line 3: Customer Ver: X
-     LCD_SetCursor(2, 0);
-     sprintf(display_buffer, "Customer Ver: %u ", fw_minor);
-     LCD_Print(display_buffer);
-     
-     // Line 4: CUSTOMER: XXXX
-     LCD_SetCursor(3, 0);
-     sprintf(display_buffer, "CUSTOMER: %c%c%c%c  ",
-             customer_name[0], customer_name[1], 
-             customer_name[2], customer_name[3]);
-     LCD_Print(display_buffer);
- }
- 
- void DisplayDebugScreen(void) {
-     char display_buffer[17];
-     
-     // Keep backlight on for sub-menu screens
-     LCD_Backlight(1);
-     backlight_timer = 0;  // Disable timer so it stays on
-     
-     // Display prev_messages status for FF03-FF06 (inLINK messages)
-     // This helps diagnose the stuck message issue
-     
-     // Line 0: FF03 status
-     LCD_SetCursor(0, 0);
-     sprintf(display_buffer, "FF03:");
-     LCD_Print(display_buffer);
-     
-     // Search for FF03 in prev_messages
-     uint8_t found = 0;
-     for(uint8_t i = 0; i < prev_msg_count; i++) {
-         if(prev_messages[i].valid && 
-            prev_messages[i].pgn == 0xFF03 && 
-            prev_messages[i].source_addr == 0x1A) {
-             LCD_SetCursor(0, 5);
-             sprintf(display_buffer, "%02X %02X %02X", 
-                     prev_messages[i].data[0],
-                     prev_messages[i].data[1],
-                     prev_messages[i].data[2]);
-             LCD_Print(display_buffer);
-             found = 1;
-             break;
-         }
-     }
-     if(!found) {
-         LCD_SetCursor(0, 5);
-         LCD_Print("-- -- --   ");
-     }
-     
-     // Line 1: FF04 status
-     LCD_SetCursor(1, 0);
-     sprintf(display_buffer, "FF04:");
-     LCD_Print(display_buffer);
-     
-     found = 0;
-     for(uint8_t i = 0; i < prev_msg_count; i++) {
-         if(prev_messages[i].valid && 
-            prev_messages[i].pgn == 0xFF04 && 
-            prev_messages[i].source_addr == 0x1A) {
-             LCD_SetCursor(1, 5);
-             sprintf(display_buffer, "%02X %02X %02X", 
-                     prev_messages[i].data[0],
-                     prev_messages[i].data[1],
-                     prev_messages[i].data[2]);
-             LCD_Print(display_buffer);
-             found = 1;
-             break;
-         }
-     }
-     if(!found) {
-         LCD_SetCursor(1, 5);
-         LCD_Print("-- -- --   ");
-     }
-     
-     // Line 2: FF05 status
-     LCD_SetCursor(2, 0);
-     sprintf(display_buffer, "FF05:");
-     LCD_Print(display_buffer);
-     
-     found = 0;
-     for(uint8_t i = 0; i < prev_msg_count; i++) {
-         if(prev_messages[i].valid && 
-            prev_messages[i].pgn == 0xFF05 && 
-            prev_messages[i].source_addr == 0x1A) {
-             LCD_SetCursor(2, 5);
-             sprintf(display_buffer, "%02X %02X %02X", 
-                     prev_messages[i].data[0],
-                     prev_messages[i].data[1],
-                     prev_messages[i].data[2]);
-             LCD_Print(display_buffer);
-             found = 1;
-             break;
-         }
-     }
-     if(!found) {
-         LCD_SetCursor(2, 5);
-         LCD_Print("-- -- --   ");
-     }
-     
-     // Line 3: FF06 status
-     LCD_SetCursor(3, 0);
-     sprintf(display_buffer, "FF06:");
-     LCD_Print(display_buffer);
-     
-     found = 0;
-     for(uint8_t i = 0; i < prev_msg_count; i++) {
-         if(prev_messages[i].valid && 
-            prev_messages[i].pgn == 0xFF06 && 
-            prev_messages[i].source_addr == 0x1A) {
-             LCD_SetCursor(3, 5);
-             sprintf(display_buffer, "%02X %02X %02X", 
-                     prev_messages[i].data[0],
-                     prev_messages[i].data[1],
-                     prev_messages[i].data[2]);
-             LCD_Print(display_buffer);
-             found = 1;
-             break;
-         }
-     }
-     if(!found) {
-         LCD_SetCursor(3, 5);
-         LCD_Print("-- -- --   ");
-     }
-     
-    // Display debug counts on right side
-    LCD_SetCursor(0, 14);
-}
-
-void DisplayInReserveScreen(void) {
-    char display_buffer[17];
-    char voltage_str[8];
-    
-    // Keep backlight on for sub-menu screens
-    LCD_Backlight(1);
-    backlight_timer = 0;
-    
-    InReserveConfig* cfg = InReserve_GetConfig();
-    
-    // If disabled, show simplified screen
-    if(!cfg->enabled) {
-        LCD_SetCursor(0, 0);
-        LCD_Print(inreserve_field_selection == 0 ? ">inRESERVE: OFF " : " inRESERVE: OFF ");
-        
-        LCD_SetCursor(1, 0);
-        LCD_Print("                ");
-        LCD_SetCursor(2, 0);
-        LCD_Print("  --DISABLED--  ");
-        LCD_SetCursor(3, 0);
-        LCD_Print("                ");
-        return;
-    }
-    
-    // Enabled - show all fields with scrolling
-    // 5 fields: Enable, Cell, Output, Time, Voltage
-    // 4 lines available, so we need to scroll
+/**
+ * Send one-button latch changes straight from their output slot
+ * Only the ignition/starter bits of B0 change; the slot is updated so the
+ * aggregated transmit that follows sees no difference for them. A frame
+ * whose PGN/SA has no slot yet is left to that aggregated transmit.
+ * The priority buffer puts the frame ahead of whatever the last pass
+ * left waiting in the normal one.
+ */
+void SendOneButtonFrames(void) {
+    uint8_t input_num, ignition_on, starter_on;
+    uint32_t edge_ms;
     
-    for(uint8_t line = 0; line < 4; line++) {
-        uint8_t field = inreserve_scroll_position + line;
-        LCD_SetCursor(line, 0);
+    while(Inputs_TakeOneButtonFrame(&input_num, &ignition_on, &starter_on, &edge_ms)) {
+        uint16_t pgn;
+        uint8_t source_addr, ignition_mask, starter_mask;
         
-        if(field >= INRESERVE_FIELD_COUNT) {
-            LCD_Print("                ");
+        if(!EEPROM_GetManualFrame(input_num, &pgn, &source_addr, &ignition_mask, &starter_mask)) {
             continue;
         }
         
-        char cursor = (field == inreserve_field_selection) ? '>' : ' ';
-        
-        switch(field) {
-            case INRESERVE_FIELD_ENABLE:
-                sprintf(display_buffer, "%cinRESERVE:  ON ", cursor);
-                break;
-            case INRESERVE_FIELD_CELL:
-                sprintf(display_buffer, "%cCell:   %6s ", cursor, InReserve_GetCellName(cfg->cell_id));
-                break;
-            case INRESERVE_FIELD_OUTPUT:
-                sprintf(display_buffer, "%cOutput:     %02d ", cursor, cfg->output);
-                break;
-            case INRESERVE_FIELD_TIME:
-                sprintf(display_buffer, "%cTime:   %6s ", cursor, InReserve_GetTimeString(cfg->time_code));
-                break;
-            case INRESERVE_FIELD_VOLTAGE:
-                InReserve_GetVoltageString(cfg->voltage_code, voltage_str);
-                sprintf(display_buffer, "%cVoltage: %5s ", cursor, voltage_str);
-                break;
+        for(uint8_t i = 0; i < prev_msg_count; i++) {
+            PreviousMessage *slot = &prev_messages[i];
+            if(!slot->valid || slot->pgn != pgn || slot->source_addr != source_addr) {
+                continue;
+            }
+            
+            uint8_t b0 = (slot->data[0] & ~(ignition_mask | starter_mask)) |
+                         (ignition_on ? ignition_mask : 0) |
+                         (starter_on ? starter_mask : 0);
+            if(b0 != slot->data[0]) {
+                slot->data[0] = b0;
+                slot->ticks_since_sent = 0;
+                J1939_TransmitPriority(&slot->tx_image, slot->data);
+                Inputs_OneButtonFrameSent(edge_ms);
+                broadcast_version++;
+                SaveTransmitHistory();
+            }
+            break;
         }
-        LCD_Print(display_buffer);
     }
 }
 
-void DisplayInReservePopup(void) {
-    char display_buffer[17];
-    char voltage_str[8];
-    
-    // Keep backlight on
-    LCD_Backlight(1);
-    backlight_timer = 0;
-    
-    // Line 0: Title
-    LCD_SetCursor(0, 0);
-    switch(inreserve_popup_type) {
-        case INRESERVE_POPUP_ENABLE:
-            LCD_Print("   inRESERVE    ");
-            break;
-        case INRESERVE_POPUP_CELL:
-            LCD_Print("  Select Cell   ");
-            break;
-        case INRESERVE_POPUP_OUTPUT:
-            LCD_Print(" Select Output  ");
-            break;
-        case INRESERVE_POPUP_TIME:
-            LCD_Print("  Select Time   ");
-            break;
-        case INRESERVE_POPUP_VOLTAGE:
-            LCD_Print("Select Threshold");
-            break;
-    }
-    
-    // Lines 1-3: Options
-    for(uint8_t line = 0; line < 3; line++) {
-        uint8_t item = inreserve_popup_scroll + line;
-        LCD_SetCursor(line + 1, 0);
-        
-        char cursor = (item == inreserve_popup_selection) ? '>' : ' ';
-        
-        switch(inreserve_popup_type) {
-            case INRESERVE_POPUP_ENABLE:
-                if(item == 0) {
-                    sprintf(display_buffer, "%c    ENABLED    ", cursor);
-                } else if(item == 1) {
-                    sprintf(display_buffer, "%c   DISABLED    ", cursor);
-                } else {
-                    LCD_Print("                ");
-                    continue;
-                }
-                break;
-                
-            case INRESERVE_POPUP_CELL:
-                if(item < 6) {
-                    sprintf(display_buffer, "%c  %-12s ", cursor, InReserve_GetCellName(item + 1));
-                } else {
-                    LCD_Print("                ");
-                    continue;
-                }
-                break;
-                
-            case INRESERVE_POPUP_OUTPUT: {
-                InReserveConfig* cfg = InReserve_GetConfig();
-                uint8_t output_count = InReserve_GetOutputCount(cfg->cell_id);
-                uint8_t min_out = InReserve_GetMinOutput(cfg->cell_id);
-                if(item < output_count) {
-                    sprintf(display_buffer, "%c   Output %02d   ", cursor, item + min_out);
-                } else {
-                    LCD_Print("                ");
-                    continue;
-                }
-                break;
-            }
-                
-            case INRESERVE_POPUP_TIME:
-                if(item < 3) {
-                    sprintf(display_buffer, "%c   %-10s  ", cursor, InReserve_GetTimeString(item));
-                } else {
-                    LCD_Print("                ");
-                    continue;
-                }
-                break;
-                
-            case INRESERVE_POPUP_VOLTAGE:
-                if(item < 3) {
-                    InReserve_GetVoltageString(item, voltage_str);
-                    sprintf(display_buffer, "%c     %s       ", cursor, voltage_str);
-                } else {
-                    LCD_Print("                ");
-                    continue;
-                }
-                break;
-        }
-        LCD_Print(display_buffer);
+/**
+ * Copy prev_messages to persistent RAM (after every change)
+ */
+void SaveTransmitHistory(void) {
+    history_warm.count = prev_msg_count;
+    for(uint8_t i = 0; i < MAX_UNIQUE_MESSAGES; i++) {
+        history_warm.messages[i] = prev_messages[i];
     }
+    history_warm.signature = SUPERVISOR_SIGNATURE;
+    history_warm.checksum = Supervisor_Checksum(&history_warm, offsetof(HistoryWarmState, checksum));
 }
 
 /**
- * Quickly drain any pending CAN messages from hardware FIFO
- * Call this after potentially long operations to prevent buffer overflow
- * Returns 1 if any inLINK message was detected, 0 otherwise
+ * After a watchdog reset: put prev_messages back and resend them
+ * Runs before the config is loaded - every slot carries its own
+ * encoded identifier, so nothing else is needed to transmit.
+ * Returns 0 if the saved copy is not valid (cold start instead)
  */
-uint8_t ProcessPendingCANMessages(void) {
-    uint8_t inlink_found = 0;
-    CAN_RxMessage can_msg;
+uint8_t RestoreTransmitHistory(void) {
+    if(history_warm.signature != SUPERVISOR_SIGNATURE ||
+       history_warm.checksum != Supervisor_Checksum(&history_warm, offsetof(HistoryWarmState, checksum)) ||
+       history_warm.count > MAX_UNIQUE_MESSAGES) {
+        return 0;
+    }
     
-    while (J1939_ReceiveMessage(&can_msg)) {
-        last_rx_can_id = can_msg.id;
-        last_rx_pgn = (can_msg.id >> 8) & 0xFFFF;
-        
-        uint8_t rx_sa = can_msg.id & 0xFF;
-        uint16_t rx_pgn = (can_msg.id >> 8) & 0xFFFF;
-        Network_UpdateDevice(rx_sa, rx_pgn, system_time_ms, can_msg.data);
-        
-        CAN_Config_ProcessMessage((CAN_Message*)&can_msg);
-        Climate_ProcessMessage(can_msg.id, can_msg.data);
-        Outputs_ProcessMessage(can_msg.id, can_msg.data);
-        
-        // Check for inLINK message (AF01, AF02, etc. but NOT AF00)
-        uint16_t pgn = (can_msg.id >> 8) & 0xFFFF;
-        uint8_t pgn_high = (pgn >> 8) & 0xFF;
-        if (((pgn_high & 0xF0) == 0xA0) && (pgn != 0xAF00)) {
-            inlink_found = 1;
-        }
-        
-        InLink_ProcessMessage(can_msg.id, can_msg.data);
+    prev_msg_count = history_warm.count;
+    for(uint8_t i = 0; i < MAX_UNIQUE_MESSAGES; i++) {
+        prev_messages[i] = history_warm.messages[i];
     }
     
-    return inlink_found;
+    for(uint8_t i = 0; i < prev_msg_count; i++) {
+        if(prev_messages[i].valid && prev_messages[i].pgn != OUTPUTS_LOCAL_PGN) {
+            J1939_TransmitImage(&prev_messages[i].tx_image, prev_messages[i].data);
+        }
+    }
+    return 1;
 }
 
 void TransmitAggregatedMessages(uint8_t reason) {
@@ -1801,8 +843,18 @@ void TransmitAggregatedMessages(uint8_t reason) {
      uint8_t msg_count = EEPROM_GetAggregatedMessages(messages, MAX_UNIQUE_MESSAGES);
      last_msg_count = msg_count;
      
+     // Output slot in prev_messages for each message (NO_SLOT = new PGN/SA)
+     uint8_t slot_of[MAX_UNIQUE_MESSAGES];
+     
+     // Optional periodic refresh of unchanged pattern frames
+     uint8_t keepalive = EEPROM_Config_ReadByte(EEPROM_CFG_PATTERN_KEEPALIVE);
+     if(keepalive == 0xFF) {
+         keepalive = 0;
+     }
+     
      // Compare with previous messages to detect changes
      for(uint8_t i = 0; i < msg_count; i++) {
+         slot_of[i] = NO_SLOT;
          if(messages[i].valid) {
              // Look for this PGN/SA in previous messages
              uint8_t found_prev = 0;
@@ -1812,6 +864,11 @@ void TransmitAggregatedMessages(uint8_t reason) {
                     prev_messages[j].source_addr == messages[i].source_addr) {
                      // Found matching previous message - compare data
                      found_prev = 1;
+                     slot_of[i] = j;
+                     if(reason == BROADCAST_REASON_PATTERN_TICK &&
+                        prev_messages[j].ticks_since_sent < 0xFF) {
+                         prev_messages[j].ticks_since_sent++;
+                     }
                      uint8_t data_differs = 0;
                      for(uint8_t k = 0; k < 8; k++) {
                          if(prev_messages[j].data[k] != messages[i].data[k]) {
@@ -1840,10 +897,15 @@ void TransmitAggregatedMessages(uint8_t reason) {
              uint8_t should_transmit = 0;
              
             if(reason == BROADCAST_REASON_PATTERN_TICK) {
-                // Pattern timer: Always transmit pattern messages when timer fires
-                // The pattern timer firing IS the trigger to update the output
+                // Pattern timer: transmit pattern messages only at a phase edge
+                // (aggregated payload changed), plus the optional keepalive
                 if(messages[i].has_pattern) {
-                    should_transmit = 1;
+                    if(messages[i].data_changed) {
+                        should_transmit = 1;
+                    } else if(keepalive != 0 && slot_of[i] != NO_SLOT &&
+                              prev_messages[slot_of[i]].ticks_since_sent >= keepalive) {
+                        should_transmit = 1;
+                    }
                 }
             }
              else if(reason == BROADCAST_REASON_STATE_CHANGE) {
@@ -1852,6 +914,10 @@ void TransmitAggregatedMessages(uint8_t reason) {
                      should_transmit = 1;
                  }
              }
+             else if(reason == BROADCAST_REASON_RESYNC) {
+                 // Frames were dropped while off the bus - send the full state
+                 should_transmit = 1;
+             }
              
             if(should_transmit) {
                 // Check if this is a local output message (PGN 0xFF00)
@@ -1860,22 +926,38 @@ void TransmitAggregatedMessages(uint8_t reason) {
                     // OUT1-OUT6 are hardcoded to inputs, not controlled by EEPROM cases
                     Outputs_Set(7, (messages[i].data[OUTPUTS_DATA_BYTE] & 0x40) ? 1 : 0);
                     Outputs_Set(8, (messages[i].data[OUTPUTS_DATA_BYTE] & 0x80) ? 1 : 0);
-                } else {
-                    // Transmit on CAN bus
-                    J1939_TransmitMessage(messages[i].priority, 
-                                         messages[i].pgn, 
-                                         messages[i].source_addr,
-                                         messages[i].data);
                 }
                 
                 // FIX: Store this message as it was actually transmitted/applied
+                // (msg_count <= MAX_UNIQUE_MESSAGES, so there is always room)
                 if(transmitted_count < MAX_UNIQUE_MESSAGES) {
-                    transmitted_this_cycle[transmitted_count].pgn = messages[i].pgn;
-                    transmitted_this_cycle[transmitted_count].source_addr = messages[i].source_addr;
+                    PreviousMessage *sent = &transmitted_this_cycle[transmitted_count];
+                    uint8_t slot = slot_of[i];
+                    
+                    // Known slot: reuse its encoded identifier. New PGN/SA
+                    // (or changed priority): encode once, kept with the slot.
+                    if(slot != NO_SLOT && prev_messages[slot].priority == messages[i].priority) {
+                        sent->tx_image = prev_messages[slot].tx_image;
+                    } else {
+                        J1939_EncodeTxImage(messages[i].priority,
+                                            messages[i].pgn,
+                                            messages[i].source_addr,
+                                            &sent->tx_image);
+                    }
+                    sent->priority = messages[i].priority;
+                    
+                    if(messages[i].pgn != OUTPUTS_LOCAL_PGN) {
+                        // Transmit on CAN bus
+                        J1939_TransmitImage(&sent->tx_image, messages[i].data);
+                    }
+                    
+                    sent->pgn = messages[i].pgn;
+                    sent->source_addr = messages[i].source_addr;
                     for(uint8_t k = 0; k < 8; k++) {
-                        transmitted_this_cycle[transmitted_count].data[k] = messages[i].data[k];
+                        sent->data[k] = messages[i].data[k];
                     }
-                    transmitted_this_cycle[transmitted_count].valid = 1;
+                    sent->valid = 1;
+                    sent->ticks_since_sent = 0;
                     transmitted_count++;
                 }
             }
@@ -1895,6 +977,9 @@ void TransmitAggregatedMessages(uint8_t reason) {
                  for(uint8_t k = 0; k < 8; k++) {
                      prev_messages[j].data[k] = transmitted_this_cycle[i].data[k];
                  }
+                 prev_messages[j].priority = transmitted_this_cycle[i].priority;
+                 prev_messages[j].tx_image = transmitted_this_cycle[i].tx_image;
+                 prev_messages[j].ticks_since_sent = 0;
                  found = 1;
                  break;
              }
@@ -1907,36 +992,50 @@ void TransmitAggregatedMessages(uint8_t reason) {
              for(uint8_t k = 0; k < 8; k++) {
                  prev_messages[prev_msg_count].data[k] = transmitted_this_cycle[i].data[k];
              }
+             prev_messages[prev_msg_count].priority = transmitted_this_cycle[i].priority;
+             prev_messages[prev_msg_count].tx_image = transmitted_this_cycle[i].tx_image;
+             prev_messages[prev_msg_count].ticks_since_sent = 0;
              prev_messages[prev_msg_count].valid = 1;
              prev_msg_count++;
          }
      }
+     if(transmitted_count > 0) {
+         broadcast_version++;
+         Power_NoteActivity();  // Flashing patterns keep us awake
+         SaveTransmitHistory();
+     }
      
      // Remove one-shot cases (OFF/clearing cases) after transmission
      EEPROM_RemoveMarkedCases();
  }
  
- void Timer1_Init(void) {
-     T1CON = 0x0000;
-     T1CONbits.TCKPS = 2;
-     TMR1 = 0;
-     PR1 = 249;
-     IFS0bits.T1IF = 0;
-     IEC0bits.T1IE = 1;
-     T1CONbits.TON = 1;
+ const uint8_t* FindPreviousBroadcast(uint16_t pgn, uint8_t source_addr) {
+     for(uint8_t i = 0; i < prev_msg_count; i++) {
+         if(prev_messages[i].valid &&
+            prev_messages[i].pgn == pgn &&
+            prev_messages[i].source_addr == source_addr) {
+             return prev_messages[i].data;
+         }
+     }
+     return NULL;
+ }
+ 
+ uint16_t GetBroadcastVersion(void) {
+     return broadcast_version;
  }
  
  void __attribute__((interrupt, no_auto_psv)) _T1Interrupt(void) {
      IFS0bits.T1IF = 0;
      
      system_time_ms++;
+     Supervisor_CheckIn(SUPERVISOR_TASK_TICK);
+     
+     Buttons_Tick();
+     Menu_Tick();
      
     if(led_on_timer > 0) led_on_timer--;
     if(scan_timer > 0) scan_timer--;
-    if(display_timer > 0) display_timer--;
-    if(button_debounce_timer > 0) button_debounce_timer--;
-    if(backlight_timer > 0) backlight_timer--;
-    if(detail_refresh_timer > 0) detail_refresh_timer--;
+    if(housekeeping_timer > 0) housekeeping_timer--;
      
      pattern_timer++;
      if(pattern_timer >= 250) {
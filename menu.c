@@ -0,0 +1,226 @@
+/*
+ * FILE: menu.c
+ * Table-Driven LCD Screen Framework Implementation
+ */
+
+#include "menu.h"
+#include "lcd.h"
+#include "buttons.h"
+#include "format.h"
+#include <string.h>
+
+static const MenuScreen *screens;
+static const MenuScreen *screen;
+static uint8_t screen_id;
+
+// Text currently on the glass (not NUL-terminated)
+static char shown[MENU_ROWS][FORMAT_LINE_WIDTH];
+
+static uint8_t dirty;                       // Render on next Menu_Service
+static uint16_t shown_version;              // version() at last render
+static uint8_t backlight_on;
+
+static volatile uint16_t refresh_timer;
+static volatile uint16_t backlight_timer;
+
+/**
+ * Rows available to the list / fixed body
+ */
+static uint8_t BodyRows(void) {
+    return (screen->title != NULL) ? (MENU_ROWS - 1) : MENU_ROWS;
+}
+
+/**
+ * Write a row to the LCD only if its text changed
+ */
+static void PutRow(uint8_t row, char *line) {
+    if (memcmp(shown[row], line, FORMAT_LINE_WIDTH) != 0) {
+        memcpy(shown[row], line, FORMAT_LINE_WIDTH);
+        LCD_SetCursor(row, 0);
+        LCD_Print(line);
+    }
+}
+
+static void SetBacklight(uint8_t on) {
+    if (on != backlight_on) {
+        backlight_on = on;
+        LCD_Backlight(on);
+    }
+}
+
+/**
+ * Keep selection and scroll inside the list after it shrank
+ */
+static void ClampList(MenuList *list, uint8_t count, uint8_t visible) {
+    if (screen->flags & MENU_FLAG_PAGED) {
+        while (list->scroll > 0 && list->scroll >= count) {
+            list->scroll = (list->scroll > visible) ? (list->scroll - visible) : 0;
+        }
+        return;
+    }
+
+    if (count == 0) {
+        list->selection = 0;
+    } else if (list->selection >= count) {
+        list->selection = count - 1;
+    }
+    if (list->scroll > list->selection) {
+        list->scroll = list->selection;
+    } else if (list->selection >= list->scroll + visible) {
+        list->scroll = list->selection - visible + 1;
+    }
+}
+
+/**
+ * Generic UP/DOWN for lists
+ */
+static void MoveList(uint8_t button) {
+    MenuList *list = screen->list;
+    uint8_t count = screen->count();
+    uint8_t visible = BodyRows();
+
+    if (screen->flags & MENU_FLAG_PAGED) {
+        if (button == BTN_ID_DOWN && list->scroll + visible < count) {
+            list->scroll += visible;
+        } else if (button == BTN_ID_UP && list->scroll > 0) {
+            list->scroll = (list->scroll > visible) ? (list->scroll - visible) : 0;
+        }
+        return;
+    }
+
+    if (button == BTN_ID_DOWN && list->selection + 1 < count) {
+        list->selection++;
+        if (list->selection >= list->scroll + visible) {
+            list->scroll = list->selection - visible + 1;
+        }
+    } else if (button == BTN_ID_UP && list->selection > 0) {
+        list->selection--;
+        if (list->selection < list->scroll) {
+            list->scroll = list->selection;
+        }
+    }
+}
+
+static void Render(void) {
+    char line[FORMAT_LINE_WIDTH + 8];   // Slack - Format_PadLine cuts long rows at 16
+    uint8_t row = 0;
+    uint8_t visible = BodyRows();
+    uint8_t count = 0;
+
+    // List model first - it may rebuild itself, and the title may use it
+    if (screen->count != NULL) {
+        count = screen->count();
+        ClampList(screen->list, count, visible);
+    }
+
+    if (screen->title != NULL) {
+        Format_PadLine(line, screen->title(line), sizeof(line));
+        PutRow(row++, line);
+    }
+
+    for (uint8_t i = 0; i < visible; i++, row++) {
+        char *p = line;
+
+        if (screen->count == NULL) {
+            p = screen->row(i, p);
+        } else {
+            uint8_t item = screen->list->scroll + i;
+            if (item < count) {
+                if (!(screen->flags & MENU_FLAG_PAGED)) {
+                    p = Format_Char(p, (item == screen->list->selection) ? '>' : ' ');
+                }
+                p = screen->row(item, p);
+            }
+        }
+        Format_PadLine(line, p, sizeof(line));
+        PutRow(row, line);
+    }
+}
+
+void Menu_Init(const MenuScreen *table, uint8_t initial) {
+    screens = table;
+
+    // Unknown glass contents - force every row out on first render
+    memset(shown, 0, sizeof(shown));
+    backlight_on = 0;
+
+    Menu_Show(initial);
+}
+
+void Menu_Show(uint8_t id) {
+    screen_id = id;
+    screen = &screens[screen_id];
+    dirty = 1;
+
+    SetBacklight(1);
+    backlight_timer = (screen->flags & MENU_FLAG_BACKLIGHT_TIMEOUT) ? MENU_BACKLIGHT_MS : 0;
+}
+
+void Menu_BacklightOff(void) {
+    SetBacklight(0);
+    backlight_timer = 0;
+}
+
+uint8_t Menu_GetScreen(void) {
+    return screen_id;
+}
+
+void Menu_HandleButton(uint8_t button) {
+    uint8_t next = MENU_DEFAULT;
+
+    if (screen->key != NULL) {
+        next = screen->key(button);
+    }
+
+    if (next == MENU_DEFAULT) {
+        next = MENU_STAY;
+        if (button == BTN_ID_HOME) {
+            next = screen->parent;
+        } else if (screen->count != NULL) {
+            MoveList(button);
+        }
+    }
+
+    if (next != MENU_STAY) {
+        Menu_Show(next);
+    } else {
+        // Any press keeps the backlight up
+        SetBacklight(1);
+        if (screen->flags & MENU_FLAG_BACKLIGHT_TIMEOUT) {
+            backlight_timer = MENU_BACKLIGHT_MS;
+        }
+        dirty = 1;
+    }
+}
+
+uint8_t Menu_Service(void) {
+    if ((screen->flags & MENU_FLAG_BACKLIGHT_TIMEOUT) && backlight_timer == 0) {
+        SetBacklight(0);
+    }
+
+    if (!dirty) {
+        if (screen->refresh_ms != 0 && refresh_timer == 0) {
+            dirty = 1;
+        } else if (screen->version != NULL && screen->version() != shown_version) {
+            dirty = 1;
+        }
+    }
+
+    if (!dirty) {
+        return 0;
+    }
+
+    dirty = 0;
+    if (screen->version != NULL) {
+        shown_version = screen->version();
+    }
+    refresh_timer = screen->refresh_ms;
+
+    Render();
+    return 1;
+}
+
+void Menu_Tick(void) {
+    if (refresh_timer > 0) refresh_timer--;
+    if (backlight_timer > 0) backlight_timer--;
+}
@@ -0,0 +1,107 @@
+/*
+ * FILE: menu.h
+ * Table-Driven LCD Screen Framework for MASTERCELL NGX
+ *
+ * Every screen is a const MenuScreen descriptor: an optional title row,
+ * a row renderer, and either fixed rows or a list model. The engine
+ * owns selection, scrolling, HOME navigation and the backlight, so a
+ * screen only describes what to draw and what SELECT does.
+ *
+ * The engine keeps a copy of the text on the glass and only rewrites
+ * rows that changed - no LCD_Clear() on transitions, no flicker.
+ * A screen is re-rendered when:
+ *   - it is shown, or a button was handled
+ *   - its version() counter moves (the data it shows has changed)
+ *   - its refresh_ms period expires (data without a version counter)
+ *
+ * Screens are identified by their index in the table passed to
+ * Menu_Init(). See screens.c for the MASTERCELL screens.
+ */
+
+#ifndef MENU_H
+#define MENU_H
+
+#include <xc.h>
+#include <stdint.h>
+
+#define MENU_ROWS           4       // LCD rows
+#define MENU_BACKLIGHT_MS   5000    // Idle timeout on MENU_FLAG_BACKLIGHT_TIMEOUT screens
+
+// Key handler results (any other value is a screen index to show)
+#define MENU_STAY           0xFF    // Handled - stay on this screen
+#define MENU_DEFAULT        0xFE    // Not handled - apply generic list/HOME behaviour
+
+// Screen flags
+#define MENU_FLAG_BACKLIGHT_TIMEOUT 0x01    // Backlight off when idle (else held on)
+#define MENU_FLAG_PAGED             0x02    // List has no cursor, UP/DOWN move a page
+
+/**
+ * Selection state for a list screen (lives in RAM, one per list)
+ */
+typedef struct {
+    uint8_t selection;      // Highlighted item
+    uint8_t scroll;         // First visible item
+} MenuList;
+
+/**
+ * Screen descriptor (const, lives in program memory)
+ *
+ * Renderers write at p and return the end of the text (Format_* style);
+ * the engine pads each row to 16 characters. On a cursor list the engine
+ * draws the '>' in column 0 and the item renderer starts at column 1.
+ */
+typedef struct {
+    uint8_t flags;                          // MENU_FLAG_xxx
+    uint8_t parent;                         // Screen for HOME, MENU_STAY = none
+    uint16_t refresh_ms;                    // Periodic re-render, 0 = on change only
+    char* (*title)(char *p);                // Row 0, NULL = body uses every row
+    char* (*row)(uint8_t item, char *p);    // Body row (fixed) or list item
+    uint8_t (*count)(void);                 // List length, NULL = fixed rows.
+                                            // Called first on every render, so it
+                                            // may rebuild the list model.
+    MenuList *list;                         // Required when count != NULL
+    uint16_t (*version)(void);              // Data version counter, NULL = none
+    uint8_t (*key)(uint8_t button);         // Returns screen, MENU_STAY or MENU_DEFAULT.
+                                            // NULL = generic behaviour only.
+} MenuScreen;
+
+/**
+ * Install the screen table and show the initial screen
+ * @param table Screen descriptors, indexed by screen ID
+ * @param initial Screen to show first
+ */
+void Menu_Init(const MenuScreen *table, uint8_t initial);
+
+/**
+ * Switch screens (resets backlight timing, forces a render)
+ */
+void Menu_Show(uint8_t screen_id);
+
+/**
+ * Get the screen currently shown
+ */
+uint8_t Menu_GetScreen(void);
+
+/**
+ * Route a debounced button press (or auto-repeat) to the current screen
+ */
+void Menu_HandleButton(uint8_t button);
+
+/**
+ * Re-render the current screen if anything changed - call from main loop
+ * @return 1 if the LCD was written, 0 if nothing was due
+ */
+uint8_t Menu_Service(void);
+
+/**
+ * Switch the backlight off now (power manager, before Sleep)
+ * Menu_Show() or any button press turns it back on.
+ */
+void Menu_BacklightOff(void);
+
+/**
+ * Advance refresh and backlight timers - call every 1ms from the Timer1 ISR
+ */
+void Menu_Tick(void);
+
+#endif // MENU_H
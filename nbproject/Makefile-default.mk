@@ -51,17 +51,17 @@ OBJECTDIR=build/${CND_CONF}/${IMAGE_TYPE}
 DISTDIR=dist/${CND_CONF}/${IMAGE_TYPE}
 
 # Source Files Quoted if spaced
-SOURCEFILES_QUOTED_IF_SPACED=main.c lcd.c buttons.c inputs.c j1939.c eeprom_cases.c eeprom_init.c eeprom_config.c can_config.c network_inventory.c inlink.c eeprom_init_front_engine.c eeprom_init_rear_engine.c eeprom_init_customer.c climate.c outputs.c inreserve.c
+SOURCEFILES_QUOTED_IF_SPACED=main.c lcd.c buttons.c inputs.c j1939.c eeprom_cases.c eeprom_init.c eeprom_config.c can_config.c network_inventory.c inlink.c eeprom_init_front_engine.c eeprom_init_rear_engine.c eeprom_init_customer.c climate.c outputs.c inreserve.c format.c menu.c screens.c board_dspic30f6012a.c power.c supervisor.c update.c gateway.c
 
 # Object Files Quoted if spaced
-OBJECTFILES_QUOTED_IF_SPACED=${OBJECTDIR}/main.o ${OBJECTDIR}/lcd.o ${OBJECTDIR}/buttons.o ${OBJECTDIR}/inputs.o ${OBJECTDIR}/j1939.o ${OBJECTDIR}/eeprom_cases.o ${OBJECTDIR}/eeprom_init.o ${OBJECTDIR}/eeprom_config.o ${OBJECTDIR}/can_config.o ${OBJECTDIR}/network_inventory.o ${OBJECTDIR}/inlink.o ${OBJECTDIR}/eeprom_init_front_engine.o ${OBJECTDIR}/eeprom_init_rear_engine.o ${OBJECTDIR}/eeprom_init_customer.o ${OBJECTDIR}/climate.o ${OBJECTDIR}/outputs.o ${OBJECTDIR}/inreserve.o
-POSSIBLE_DEPFILES=${OBJECTDIR}/main.o.d ${OBJECTDIR}/lcd.o.d ${OBJECTDIR}/buttons.o.d ${OBJECTDIR}/inputs.o.d ${OBJECTDIR}/j1939.o.d ${OBJECTDIR}/eeprom_cases.o.d ${OBJECTDIR}/eeprom_init.o.d ${OBJECTDIR}/eeprom_config.o.d ${OBJECTDIR}/can_config.o.d ${OBJECTDIR}/network_inventory.o.d ${OBJECTDIR}/inlink.o.d ${OBJECTDIR}/eeprom_init_front_engine.o.d ${OBJECTDIR}/eeprom_init_rear_engine.o.d ${OBJECTDIR}/eeprom_init_customer.o.d ${OBJECTDIR}/climate.o.d ${OBJECTDIR}/outputs.o.d ${OBJECTDIR}/inreserve.o.d
+OBJECTFILES_QUOTED_IF_SPACED=${OBJECTDIR}/main.o ${OBJECTDIR}/lcd.o ${OBJECTDIR}/buttons.o ${OBJECTDIR}/inputs.o ${OBJECTDIR}/j1939.o ${OBJECTDIR}/eeprom_cases.o ${OBJECTDIR}/eeprom_init.o ${OBJECTDIR}/eeprom_config.o ${OBJECTDIR}/can_config.o ${OBJECTDIR}/network_inventory.o ${OBJECTDIR}/inlink.o ${OBJECTDIR}/eeprom_init_front_engine.o ${OBJECTDIR}/eeprom_init_rear_engine.o ${OBJECTDIR}/eeprom_init_customer.o ${OBJECTDIR}/climate.o ${OBJECTDIR}/outputs.o ${OBJECTDIR}/inreserve.o ${OBJECTDIR}/format.o ${OBJECTDIR}/menu.o ${OBJECTDIR}/screens.o ${OBJECTDIR}/board_dspic30f6012a.o ${OBJECTDIR}/power.o ${OBJECTDIR}/supervisor.o ${OBJECTDIR}/update.o ${OBJECTDIR}/gateway.o
+POSSIBLE_DEPFILES=${OBJECTDIR}/main.o.d ${OBJECTDIR}/lcd.o.d ${OBJECTDIR}/buttons.o.d ${OBJECTDIR}/inputs.o.d ${OBJECTDIR}/j1939.o.d ${OBJECTDIR}/eeprom_cases.o.d ${OBJECTDIR}/eeprom_init.o.d ${OBJECTDIR}/eeprom_config.o.d ${OBJECTDIR}/can_config.o.d ${OBJECTDIR}/network_inventory.o.d ${OBJECTDIR}/inlink.o.d ${OBJECTDIR}/eeprom_init_front_engine.o.d ${OBJECTDIR}/eeprom_init_rear_engine.o.d ${OBJECTDIR}/eeprom_init_customer.o.d ${OBJECTDIR}/climate.o.d ${OBJECTDIR}/outputs.o.d ${OBJECTDIR}/inreserve.o.d ${OBJECTDIR}/format.o.d ${OBJECTDIR}/menu.o.d ${OBJECTDIR}/screens.o.d ${OBJECTDIR}/board_dspic30f6012a.o.d ${OBJECTDIR}/power.o.d ${OBJECTDIR}/supervisor.o.d ${OBJECTDIR}/update.o.d ${OBJECTDIR}/gateway.o.d
 
 # Object Files
-OBJECTFILES=${OBJECTDIR}/main.o ${OBJECTDIR}/lcd.o ${OBJECTDIR}/buttons.o ${OBJECTDIR}/inputs.o ${OBJECTDIR}/j1939.o ${OBJECTDIR}/eeprom_cases.o ${OBJECTDIR}/eeprom_init.o ${OBJECTDIR}/eeprom_config.o ${OBJECTDIR}/can_config.o ${OBJECTDIR}/network_inventory.o ${OBJECTDIR}/inlink.o ${OBJECTDIR}/eeprom_init_front_engine.o ${OBJECTDIR}/eeprom_init_rear_engine.o ${OBJECTDIR}/eeprom_init_customer.o ${OBJECTDIR}/climate.o ${OBJECTDIR}/outputs.o ${OBJECTDIR}/inreserve.o
+OBJECTFILES=${OBJECTDIR}/main.o ${OBJECTDIR}/lcd.o ${OBJECTDIR}/buttons.o ${OBJECTDIR}/inputs.o ${OBJECTDIR}/j1939.o ${OBJECTDIR}/eeprom_cases.o ${OBJECTDIR}/eeprom_init.o ${OBJECTDIR}/eeprom_config.o ${OBJECTDIR}/can_config.o ${OBJECTDIR}/network_inventory.o ${OBJECTDIR}/inlink.o ${OBJECTDIR}/eeprom_init_front_engine.o ${OBJECTDIR}/eeprom_init_rear_engine.o ${OBJECTDIR}/eeprom_init_customer.o ${OBJECTDIR}/climate.o ${OBJECTDIR}/outputs.o ${OBJECTDIR}/inreserve.o ${OBJECTDIR}/format.o ${OBJECTDIR}/menu.o ${OBJECTDIR}/screens.o ${OBJECTDIR}/board_dspic30f6012a.o ${OBJECTDIR}/power.o ${OBJECTDIR}/supervisor.o ${OBJECTDIR}/update.o ${OBJECTDIR}/gateway.o
 
 # Source Files
-SOURCEFILES=main.c lcd.c buttons.c inputs.c j1939.c eeprom_cases.c eeprom_init.c eeprom_config.c can_config.c network_inventory.c inlink.c eeprom_init_front_engine.c eeprom_init_rear_engine.c eeprom_init_customer.c climate.c outputs.c inreserve.c
+SOURCEFILES=main.c lcd.c buttons.c inputs.c j1939.c eeprom_cases.c eeprom_init.c eeprom_config.c can_config.c network_inventory.c inlink.c eeprom_init_front_engine.c eeprom_init_rear_engine.c eeprom_init_customer.c climate.c outputs.c inreserve.c format.c menu.c screens.c board_dspic30f6012a.c power.c supervisor.c update.c gateway.c
 
 
 
@@ -191,6 +191,54 @@ ${OBJECTDIR}/inreserve.o: inreserve.c  .generated_files/flags/default/7684f1e449
 	@${RM} ${OBJECTDIR}/inreserve.o 
 	${MP_CC} $(MP_EXTRA_CC_PRE)  inreserve.c  -o ${OBJECTDIR}/inreserve.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/inreserve.o.d"      -g -D__DEBUG     -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -msmall-data -O0 -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
 	
+${OBJECTDIR}/gateway.o: gateway.c  .generated_files/flags/default/24ef270472e492d397ced7188799bca7438c1b80 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/gateway.o.d 
+	@${RM} ${OBJECTDIR}/gateway.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  gateway.c  -o ${OBJECTDIR}/gateway.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/gateway.o.d"      -g -D__DEBUG     -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -msmall-data -O0 -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
+${OBJECTDIR}/format.o: format.c  .generated_files/flags/default/b31e6f5bc8b2508bf0475150bc70c21bdf51d053 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/format.o.d 
+	@${RM} ${OBJECTDIR}/format.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  format.c  -o ${OBJECTDIR}/format.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/format.o.d"      -g -D__DEBUG     -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -msmall-data -O0 -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
+${OBJECTDIR}/menu.o: menu.c  .generated_files/flags/default/569f0282face8bc9e6d7cc07df92070d13849b25 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/menu.o.d 
+	@${RM} ${OBJECTDIR}/menu.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  menu.c  -o ${OBJECTDIR}/menu.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/menu.o.d"      -g -D__DEBUG     -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -msmall-data -O0 -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
+${OBJECTDIR}/screens.o: screens.c  .generated_files/flags/default/00e55e0e083f7e9e50aa3ddfc385bb72be3ff6e6 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/screens.o.d 
+	@${RM} ${OBJECTDIR}/screens.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  screens.c  -o ${OBJECTDIR}/screens.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/screens.o.d"      -g -D__DEBUG     -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -msmall-data -O0 -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
+${OBJECTDIR}/board_dspic30f6012a.o: board_dspic30f6012a.c  .generated_files/flags/default/ae925bb633a1701fffd936834cbf3269902f2513 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/board_dspic30f6012a.o.d 
+	@${RM} ${OBJECTDIR}/board_dspic30f6012a.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  board_dspic30f6012a.c  -o ${OBJECTDIR}/board_dspic30f6012a.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/board_dspic30f6012a.o.d"      -g -D__DEBUG     -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -msmall-data -O0 -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
+${OBJECTDIR}/power.o: power.c  .generated_files/flags/default/3a02e811c8b8dc6f8fbd7fa3f505e2c9d84d3591 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/power.o.d 
+	@${RM} ${OBJECTDIR}/power.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  power.c  -o ${OBJECTDIR}/power.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/power.o.d"      -g -D__DEBUG     -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -msmall-data -O0 -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
+${OBJECTDIR}/supervisor.o: supervisor.c  .generated_files/flags/default/76f353b46999b039aea7a3f660ffc3bf602eede3 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/supervisor.o.d 
+	@${RM} ${OBJECTDIR}/supervisor.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  supervisor.c  -o ${OBJECTDIR}/supervisor.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/supervisor.o.d"      -g -D__DEBUG     -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -msmall-data -O0 -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
+${OBJECTDIR}/update.o: update.c  .generated_files/flags/default/32819711cd91f7216bbdc296144f66db0ee69896 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/update.o.d 
+	@${RM} ${OBJECTDIR}/update.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  update.c  -o ${OBJECTDIR}/update.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/update.o.d"      -g -D__DEBUG     -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -msmall-data -O0 -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
 else
 ${OBJECTDIR}/main.o: main.c  .generated_files/flags/default/a3deb946f30e57cf93bd36ab405dd1431d774f5 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
 	@${MKDIR} "${OBJECTDIR}" 
@@ -294,6 +342,54 @@ ${OBJECTDIR}/inreserve.o: inreserve.c  .generated_files/flags/default/3d390de663
 	@${RM} ${OBJECTDIR}/inreserve.o 
 	${MP_CC} $(MP_EXTRA_CC_PRE)  inreserve.c  -o ${OBJECTDIR}/inreserve.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/inreserve.o.d"        -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -msmall-data -O0 -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
 	
+${OBJECTDIR}/gateway.o: gateway.c  .generated_files/flags/default/5c29f2b8d84f86f6ecbf02537f8ee4825e4d91dc .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/gateway.o.d 
+	@${RM} ${OBJECTDIR}/gateway.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  gateway.c  -o ${OBJECTDIR}/gateway.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/gateway.o.d"        -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -msmall-data -O0 -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
+${OBJECTDIR}/format.o: format.c  .generated_files/flags/default/78a6915ff381da667242c3d4b9fa4aa7318b622f .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/format.o.d 
+	@${RM} ${OBJECTDIR}/format.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  format.c  -o ${OBJECTDIR}/format.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/format.o.d"        -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -msmall-data -O0 -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
+${OBJECTDIR}/menu.o: menu.c  .generated_files/flags/default/d32d97fafc6ca4cdf90688064c786c836533792d .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/menu.o.d 
+	@${RM} ${OBJECTDIR}/menu.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  menu.c  -o ${OBJECTDIR}/menu.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/menu.o.d"        -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -msmall-data -O0 -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
+${OBJECTDIR}/screens.o: screens.c  .generated_files/flags/default/9a67d258580584df557d35453e54ac962d6dc3e9 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/screens.o.d 
+	@${RM} ${OBJECTDIR}/screens.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  screens.c  -o ${OBJECTDIR}/screens.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/screens.o.d"        -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -msmall-data -O0 -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
+${OBJECTDIR}/board_dspic30f6012a.o: board_dspic30f6012a.c  .generated_files/flags/default/1ce07eed36b05ce0cc9111728c4f97de20cc88a4 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/board_dspic30f6012a.o.d 
+	@${RM} ${OBJECTDIR}/board_dspic30f6012a.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  board_dspic30f6012a.c  -o ${OBJECTDIR}/board_dspic30f6012a.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/board_dspic30f6012a.o.d"        -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -msmall-data -O0 -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
+${OBJECTDIR}/power.o: power.c  .generated_files/flags/default/33c7d85b14444b8f5b685f8aa32cbfa7f0f1bff7 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/power.o.d 
+	@${RM} ${OBJECTDIR}/power.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  power.c  -o ${OBJECTDIR}/power.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/power.o.d"        -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -msmall-data -O0 -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
+${OBJECTDIR}/supervisor.o: supervisor.c  .generated_files/flags/default/7ff95a4d2848b62916f5a0b3167ee2e67f03c934 .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/supervisor.o.d 
+	@${RM} ${OBJECTDIR}/supervisor.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  supervisor.c  -o ${OBJECTDIR}/supervisor.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/supervisor.o.d"        -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -msmall-data -O0 -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
+${OBJECTDIR}/update.o: update.c  .generated_files/flags/default/bdc9fe192ab28b59847dac58fc451ae473745dba .generated_files/flags/default/da39a3ee5e6b4b0d3255bfef95601890afd80709
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/update.o.d 
+	@${RM} ${OBJECTDIR}/update.o 
+	${MP_CC} $(MP_EXTRA_CC_PRE)  update.c  -o ${OBJECTDIR}/update.o  -c -mcpu=$(MP_PROCESSOR_OPTION)  -MP -MMD -MF "${OBJECTDIR}/update.o.d"        -g -omf=elf -DXPRJ_default=$(CND_CONF)    $(COMPARISON_BUILD)  -msmall-data -O0 -msmart-io=1 -Wall -msfr-warn=off    -mdfp="${DFP_DIR}/xc16"
+	
 endif
 
 # ------------------------------------------------------------------------------------
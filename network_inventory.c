@@ -8,6 +8,7 @@
 
 static NetworkDevice devices[MAX_NETWORK_DEVICES];
 static uint8_t device_count = 0;
+static uint16_t inventory_version = 0;  // Bumped on every join/timeout
 
 void Network_Init(void) {
     // Explicitly initialize all device slots
@@ -58,6 +59,7 @@ void Network_UpdateDevice(uint8_t sa, uint16_t pgn, uint32_t timestamp_ms, uint8
                 }
             }
             device_count++;
+            inventory_version++;
             return;
         }
     }
@@ -83,6 +85,7 @@ void Network_CheckTimeouts(uint32_t current_time_ms) {
                 // Device has timed out - remove it
                 devices[i].active = 0;
                 device_count--;
+                inventory_version++;
             }
         }
     }
@@ -117,7 +120,12 @@ NetworkDevice* Network_FindByPGN(uint16_t pgn) {
     return NULL;  // Not found
 }
 
+uint16_t Network_GetVersion(void) {
+    return inventory_version;
+}
+
 void Network_Clear(void) {
     memset(devices, 0, sizeof(devices));
     device_count = 0;
+    inventory_version++;
 }
\ No newline at end of file
@@ -28,6 +28,7 @@ void Network_CheckTimeouts(uint32_t current_time_ms);
 uint8_t Network_GetDeviceCount(void);
 NetworkDevice* Network_GetDevice(uint8_t index);
 NetworkDevice* Network_FindByPGN(uint16_t pgn);
+uint16_t Network_GetVersion(void);  // Bumped when a device joins or times out
 void Network_Clear(void);
 
 #endif // NETWORK_INVENTORY_H
\ No newline at end of file
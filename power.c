@@ -0,0 +1,184 @@
+/*
+ * FILE: power.c
+ * Power Manager Implementation
+ *
+ * Idle: the main loop calls Power_Idle() when a pass found nothing to do.
+ * The next Timer1 tick or CAN frame ends it, so every ms timer still runs
+ * on time; the CPU core just stops clocking between them.
+ *
+ * Sleep: the CAN controller is put in disable mode with wake-up enabled
+ * and the CPU sleeps with the watchdog running as a wake-up timer. Every
+ * BOARD_SLEEP_WAKE_MS the inputs are read once (no debounce); any input
+ * that differs from its stable state, or any bus activity, ends Sleep.
+ * Timer1 stops while asleep, so system_time_ms is advanced by the slept
+ * periods on the way out (a CAN wake counts a whole period).
+ */
+
+#include "power.h"
+#include "board.h"
+#include "eeprom_config.h"
+#include "eeprom_cases.h"
+#include "inputs.h"
+#include "outputs.h"
+#include "menu.h"
+
+extern volatile uint32_t system_time_ms;
+
+static uint32_t last_activity_ms = 0;
+
+// Time spent per mode (run = system_time_ms - idle - sleep)
+static uint32_t idle_ms = 0;
+static uint16_t idle_counts = 0;            // Sub-ms remainder, Timer1 counts
+static uint32_t sleep_ms = 0;
+
+// Wake-up to first frame
+static uint8_t wake_source = POWER_WAKE_NONE;
+static uint32_t wake_stamp = 0;
+static uint8_t latency_pending = 0;
+static uint16_t wake_latency_us = 0;
+
+/*
+ * Timestamp in Timer1 counts (wraps - use differences only)
+ */
+static uint32_t NowCounts(void) {
+    IEC0bits.T1IE = 0;
+    uint32_t counts = system_time_ms * BOARD_TICK_COUNTS + Board_TickCount();
+    IEC0bits.T1IE = 1;
+    return counts;
+}
+
+/*
+ * Share of total, in 1/1000
+ */
+static uint16_t PerMille(uint32_t part, uint32_t total) {
+    uint32_t share;
+
+    if (total == 0) {
+        return 0;
+    }
+    if (total < 1000) {
+        share = (part * 1000) / total;
+    } else {
+        share = part / (total / 1000);
+    }
+    return (share > 1000) ? 1000 : (uint16_t)share;
+}
+
+void Power_Init(void) {
+    last_activity_ms = system_time_ms;
+    idle_ms = 0;
+    idle_counts = 0;
+    sleep_ms = 0;
+    wake_source = POWER_WAKE_NONE;
+    latency_pending = 0;
+    wake_latency_us = 0;
+}
+
+void Power_NoteActivity(void) {
+    last_activity_ms = system_time_ms;
+}
+
+uint8_t Power_SleepDue(void) {
+    uint8_t delay_min = EEPROM_Config_ReadByte(EEPROM_CFG_SLEEP_DELAY);
+
+    if (delay_min == 0x00) {
+        return 0;
+    }
+    if (delay_min == 0xFF) {
+        delay_min = POWER_SLEEP_DEFAULT_MIN;
+    }
+
+    // The delay starts when the ignition goes off, the outputs drop and
+    // no timed case is waiting for its deadline
+    if (Inputs_GetIgnitionState() || Outputs_GetAll() != 0 || EEPROM_TimedCasesPending()) {
+        last_activity_ms = system_time_ms;
+        return 0;
+    }
+
+    return (system_time_ms - last_activity_ms) >= (uint32_t)delay_min * 60000UL;
+}
+
+uint8_t Power_Sleep(void) {
+    uint8_t source;
+    uint8_t input_changed = 0;
+
+    Menu_BacklightOff();
+    Board_CANSetSleep(1);
+
+    do {
+        source = Board_Sleep();
+
+        IEC0bits.T1IE = 0;
+        system_time_ms += BOARD_SLEEP_WAKE_MS;
+        IEC0bits.T1IE = 1;
+        sleep_ms += BOARD_SLEEP_WAKE_MS;
+
+        wake_stamp = NowCounts();
+
+        if (source == BOARD_WAKE_TIMER) {
+            input_changed = Inputs_PollChanged();
+        }
+    } while (source == BOARD_WAKE_TIMER && !input_changed);
+
+    Board_CANSetSleep(0);
+
+    wake_source = (source == BOARD_WAKE_CAN) ? POWER_WAKE_CAN : POWER_WAKE_INPUT;
+    latency_pending = 1;
+    last_activity_ms = system_time_ms;
+
+    return wake_source;
+}
+
+void Power_Idle(void) {
+    uint32_t start = NowCounts();
+
+    Board_Idle();
+
+    idle_counts += (uint16_t)(NowCounts() - start);
+    while (idle_counts >= BOARD_TICK_COUNTS) {
+        idle_counts -= BOARD_TICK_COUNTS;
+        idle_ms++;
+    }
+}
+
+void Power_MarkFirstFrame(void) {
+    if (!latency_pending) {
+        return;
+    }
+    latency_pending = 0;
+
+    uint32_t us = (NowCounts() - wake_stamp) * BOARD_TICK_US;
+    wake_latency_us = (us > 0xFFFF) ? 0xFFFF : (uint16_t)us;
+}
+
+uint8_t Power_GetWakeSource(void) {
+    return wake_source;
+}
+
+uint16_t Power_GetWakeLatencyUs(void) {
+    return wake_latency_us;
+}
+
+void Power_GetModeShare(uint8_t *run_pct, uint8_t *idle_pct, uint8_t *sleep_pct) {
+    uint32_t total = system_time_ms;
+    uint16_t idle = PerMille(idle_ms, total);
+    uint16_t sleep = PerMille(sleep_ms, total);
+    uint16_t run = (idle + sleep >= 1000) ? 0 : 1000 - idle - sleep;
+
+    *run_pct = (run + 5) / 10;
+    *idle_pct = (idle + 5) / 10;
+    *sleep_pct = (sleep + 5) / 10;
+}
+
+uint16_t Power_GetAverageCurrent(void) {
+    uint32_t total = system_time_ms;
+    uint16_t idle = PerMille(idle_ms, total);
+    uint16_t sleep = PerMille(sleep_ms, total);
+    uint16_t run = (idle + sleep >= 1000) ? 0 : 1000 - idle - sleep;
+
+    uint32_t average_ua = ((uint32_t)run * BOARD_IDD_RUN_UA +
+                           (uint32_t)idle * BOARD_IDD_IDLE_UA +
+                           (uint32_t)sleep * BOARD_IPD_SLEEP_UA) / 1000;
+
+    return (uint16_t)(average_ua / 100);
+}
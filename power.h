@@ -0,0 +1,44 @@
+/*
+ * FILE: power.h
+ * Power Manager for MASTERCELL NGX
+ *
+ * Three modes:
+ *   RUN   - main loop doing work
+ *   IDLE  - CPU halted between 1ms ticks when the main loop has nothing
+ *           pending (Power_Idle); Timer1 and CAN keep running
+ *   SLEEP - ignition off, no outputs on, no timed case pending, and no
+ *           bus / input / button activity for the configured delay
+ *           (EEPROM_CFG_SLEEP_DELAY).
+ *           The CAN controller waits for bus activity, and the CPU wakes
+ *           every BOARD_SLEEP_WAKE_MS to poll the inputs.
+ *
+ * Time spent in each mode is accumulated so an average supply current
+ * can be estimated from the BOARD_IDD_xxx figures (diagnostic page 2).
+ */
+
+#ifndef POWER_H
+#define POWER_H
+
+#include <xc.h>
+#include <stdint.h>
+
+#define POWER_SLEEP_DEFAULT_MIN     30      // EEPROM_CFG_SLEEP_DELAY = 0xFF
+
+// Wake reasons (Power_GetWakeSource)
+#define POWER_WAKE_NONE             0       // Not slept since power-up
+#define POWER_WAKE_CAN              1
+#define POWER_WAKE_INPUT            2
+
+// Function prototypes
+void Power_Init(void);
+void Power_NoteActivity(void);              // Bus frame, input change, button, frame sent
+uint8_t Power_SleepDue(void);               // Sleep conditions met (call from housekeeping)
+uint8_t Power_Sleep(void);                  // Sleep until woken, returns POWER_WAKE_xxx
+void Power_Idle(void);                      // CPU Idle until the next interrupt
+void Power_MarkFirstFrame(void);            // First frame queued after a wake
+uint8_t Power_GetWakeSource(void);
+uint16_t Power_GetWakeLatencyUs(void);      // Wake to first frame, 0xFFFF = saturated
+void Power_GetModeShare(uint8_t *run_pct, uint8_t *idle_pct, uint8_t *sleep_pct);
+uint16_t Power_GetAverageCurrent(void);     // Estimated, 0.1mA units
+
+#endif // POWER_H
@@ -0,0 +1,730 @@
+/*
+ * FILE: screens.c
+ * LCD Screens for MASTERCELL NGX
+ *
+ * Each screen is a set of small renderers plus a descriptor in
+ * screen_table. Renderers only format text - the menu engine decides
+ * when to call them and writes only the rows that changed.
+ */
+
+#include "screens.h"
+#include "format.h"
+#include "buttons.h"
+#include "inputs.h"
+#include "j1939.h"
+#include "network_inventory.h"
+#include "eeprom_config.h"
+#include "inreserve.h"
+#include <stddef.h>  // For NULL
+
+// Main menu items
+#define MENU_SWITCH_STATES      0
+#define MENU_SYSTEM_INVENTORY   1
+#define MENU_SYSTEM_INFO        2
+#define MENU_INRESERVE          3
+#define MENU_DEBUG              4
+#define MENU_BOUNCE             5
+#define MENU_HOME_SCREEN        6
+#define MENU_COUNT              7
+
+// inRESERVE sub-menu fields
+#define INRESERVE_FIELD_ENABLE   0
+#define INRESERVE_FIELD_CELL     1
+#define INRESERVE_FIELD_OUTPUT   2
+#define INRESERVE_FIELD_TIME     3
+#define INRESERVE_FIELD_VOLTAGE  4
+#define INRESERVE_FIELD_COUNT    5
+
+// inRESERVE popup types (one per field)
+#define INRESERVE_POPUP_ENABLE   0
+#define INRESERVE_POPUP_CELL     1
+#define INRESERVE_POPUP_OUTPUT   2
+#define INRESERVE_POPUP_TIME     3
+#define INRESERVE_POPUP_VOLTAGE  4
+
+#define INVENTORY_MAX_ENTRIES   16
+
+// Cell detail types
+#define CELL_TYPE_POWERCELL     0
+#define CELL_TYPE_INMOTION      1
+#define CELL_TYPE_NO_DETAIL     2   // inLINK, inControl
+
+static MenuList menu_list;
+static MenuList inventory_list;
+static MenuList detail_list;
+static MenuList inreserve_list;
+static MenuList popup_list;
+static MenuList bounce_list;
+
+// ============================================================================
+// MAIN SCREEN
+// ============================================================================
+
+static char* MainRow(uint8_t row, char *p) {
+    switch(row) {
+        case 0:
+            return Format_Str(p, "  INFINITYBOX");
+        case 1:
+            return Format_Str(p, "IPM POWER SYSTEM");
+        case 2: {
+            static const char * const tx_state[] = { "CAN: TX-OK", "CAN: TX-WN", "CAN: TX-EP", "CAN: TX-BO" };
+            uint8_t rx_ok = !J1939_HasRxOverflow();
+            p = Format_Str(p, tx_state[J1939_GetErrorState() & 0x03]);
+            return Format_Str(p, rx_ok ? " RX-OK" : " RX-OV");
+        }
+        default: {
+            uint8_t ignition = Inputs_GetIgnitionState();
+            uint8_t security_disarmed = Inputs_GetSecurityState();  // 1 = DISARMED, 0 = ARMED
+            p = Format_Str(p, ignition ? "IGN: ON  " : "IGN: OFF ");
+            return Format_Str(p, security_disarmed ? "SEC:OFF" : "SEC: ON");
+        }
+    }
+}
+
+static uint8_t MainKey(uint8_t button) {
+    if(button == BTN_ID_HOME) {
+        menu_list.selection = 0;
+        menu_list.scroll = 0;
+        return SCREEN_MENU;
+    }
+    return MENU_STAY;
+}
+
+// ============================================================================
+// MAIN MENU
+// ============================================================================
+
+static const struct {
+    const char *name;
+    uint8_t screen;
+} menu_items[MENU_COUNT] = {
+    { "SWITCH STATES", SCREEN_SWITCH      },   // MENU_SWITCH_STATES
+    { "SYSTEM INV",    SCREEN_INVENTORY   },   // MENU_SYSTEM_INVENTORY
+    { "SYSTEM INFO",   SCREEN_SYSTEM_INFO },   // MENU_SYSTEM_INFO
+    { "inRESERVE",     SCREEN_INRESERVE   },   // MENU_INRESERVE
+    { "DEBUG",         SCREEN_DEBUG       },   // MENU_DEBUG
+    { "INPUT BOUNCE",  SCREEN_BOUNCE      },   // MENU_BOUNCE
+    { "HOME SCREEN",   SCREEN_MAIN        },   // MENU_HOME_SCREEN
+};
+
+static char* MenuTitle(char *p) {
+    return Format_Str(p, "--- MAIN MENU --");
+}
+
+static char* MenuRow(uint8_t item, char *p) {
+    return Format_Str(p, menu_items[item].name);
+}
+
+static uint8_t MenuCount(void) {
+    return MENU_COUNT;
+}
+
+static uint8_t MenuKey(uint8_t button) {
+    if(button == BTN_ID_SELECT) {
+        if(menu_list.selection == MENU_INRESERVE) {
+            inreserve_list.selection = 0;
+            inreserve_list.scroll = 0;
+        }
+        if(menu_list.selection == MENU_BOUNCE) {
+            bounce_list.scroll = 0;
+        }
+        return menu_items[menu_list.selection].screen;
+    }
+    return MENU_DEFAULT;
+}
+
+// ============================================================================
+// SWITCH STATES
+// ============================================================================
+
+static char* SwitchTitle(char *p) {
+    return Format_Str(p, "SWITCH STATES");
+}
+
+static char* SwitchRow(uint8_t row, char *p) {
+    if(row < 2) {
+        // IN01-IN16, IN17-IN32
+        for(uint8_t i = row * 16; i < (row + 1) * 16; i++) {
+            p = Format_Char(p, Inputs_GetState(i) ? '1' : '0');
+        }
+    } else {
+        // IN33-IN38, then HSIN01-HSIN06
+        for(uint8_t i = 32; i < 38; i++) {
+            p = Format_Char(p, Inputs_GetState(i) ? '1' : '0');
+        }
+        p = Format_Char(p, ' ');
+        for(uint8_t i = 38; i < 44; i++) {
+            p = Format_Char(p, Inputs_GetState(i) ? '1' : '0');
+        }
+    }
+    return p;
+}
+
+// ============================================================================
+// SYSTEM INVENTORY
+// ============================================================================
+
+// We'll create "virtual" devices for display purposes
+typedef struct {
+    uint16_t display_pgn;  // PGN to show (may be virtual like FF01 for POWERCELL)
+    const char *name;      // Friendly name (string literal, no copy)
+} DisplayDevice;
+
+static DisplayDevice display_list[INVENTORY_MAX_ENTRIES];
+static uint8_t display_count = 0;
+
+static uint16_t selected_cell_pgn = 0;     // PGN of selected cell for detail view
+static uint8_t selected_cell_type = 0;     // CELL_TYPE_xxx
+
+static void AddDisplayDevice(uint16_t display_pgn, const char *name) {
+    if(display_count < INVENTORY_MAX_ENTRIES) {
+        display_list[display_count].display_pgn = display_pgn;
+        display_list[display_count].name = name;
+        display_count++;
+    }
+}
+
+/**
+ * Rebuild the display list from the network inventory
+ */
+static uint8_t InventoryCount(void) {
+    uint8_t device_count = Network_GetDeviceCount();
+    uint8_t found_af00 = 0;
+    uint8_t found_bf = 0, found_cf = 0;
+    uint8_t found_ff11 = 0, found_ff21 = 0;  // Front PowerCell
+    uint8_t found_ff12 = 0, found_ff22 = 0;  // Rear PowerCell
+
+    // First pass: identify what devices we have
+    for(uint8_t i = 0; i < device_count; i++) {
+        NetworkDevice *device = Network_GetDevice(i);
+        if(device == NULL) continue;
+
+        uint8_t pgn_high = (device->pgn >> 8) & 0xFF;
+        if(device->pgn == 0xAF00) found_af00 = 1;
+        else if(pgn_high == 0xBF) found_bf = 1;
+        else if(pgn_high == 0xCF) found_cf = 1;
+        else if(device->pgn == 0xFF11) found_ff11 = 1;
+        else if(device->pgn == 0xFF21) found_ff21 = 1;
+        else if(device->pgn == 0xFF12) found_ff12 = 1;
+        else if(device->pgn == 0xFF22) found_ff22 = 1;
+    }
+
+    display_count = 0;
+
+    // 1. inLINK NGX (no detail screen, just shows in list)
+    if(found_af00) AddDisplayDevice(0xAF00, "inLINK NGX");
+
+    // 2. inControl devices (no detail screen)
+    if(found_bf) AddDisplayDevice(0xBF00, "inC 1");
+    if(found_cf) AddDisplayDevice(0xCF00, "inC 2");
+
+    // 3. PowerCells - need both FF1x and FF2x
+    if(found_ff11 && found_ff21) AddDisplayDevice(0xFF01, "FRONT PC");
+    if(found_ff12 && found_ff22) AddDisplayDevice(0xFF02, "REAR PC");
+
+    // 4. inMOTION modules
+    for(uint8_t i = 0; i < device_count; i++) {
+        NetworkDevice *device = Network_GetDevice(i);
+        if(device == NULL) continue;
+
+        switch(device->pgn) {
+            case 0xFF33: AddDisplayDevice(0xFF03, "DF inM NGX"); break;
+            case 0xFF34: AddDisplayDevice(0xFF04, "PF inM NGX"); break;
+            case 0xFF35: AddDisplayDevice(0xFF05, "DR inM NGX"); break;
+            case 0xFF36: AddDisplayDevice(0xFF06, "PR inM NGX"); break;
+            default: break;  // FF11, FF12, FF21, FF22 already handled above
+        }
+    }
+
+    return display_count;
+}
+
+static char* InventoryTitle(char *p) {
+    p = Format_Str(p, "SYSTEM INV (");
+    p = Format_Dec(p, display_count);
+    return Format_Char(p, ')');
+}
+
+static char* InventoryRow(uint8_t item, char *p) {
+    p = Format_Hex16(p, display_list[item].display_pgn);
+    p = Format_Char(p, ' ');
+    return Format_StrLeft(p, display_list[item].name, 10);
+}
+
+static uint8_t InventoryKey(uint8_t button) {
+    if(button == BTN_ID_HOME) {
+        inventory_list.selection = 0;
+        inventory_list.scroll = 0;
+        return SCREEN_MENU;
+    }
+    if(button == BTN_ID_SELECT && inventory_list.selection < display_count) {
+        selected_cell_pgn = display_list[inventory_list.selection].display_pgn;
+        // Determine cell type: PowerCell, InMotion, or no detail (inLINK, inControl)
+        if(selected_cell_pgn == 0xFF01 || selected_cell_pgn == 0xFF02) {
+            selected_cell_type = CELL_TYPE_POWERCELL;
+        } else if(selected_cell_pgn == 0xAF00 || selected_cell_pgn == 0xBF00 || selected_cell_pgn == 0xCF00) {
+            selected_cell_type = CELL_TYPE_NO_DETAIL;
+        } else {
+            selected_cell_type = CELL_TYPE_INMOTION;
+        }
+
+        if(selected_cell_type == CELL_TYPE_NO_DETAIL) {
+            return MENU_STAY;  // inLINK has no detail screen - SELECT does nothing
+        }
+        detail_list.scroll = 0;
+        return SCREEN_CELL_DETAIL;
+    }
+    return MENU_DEFAULT;
+}
+
+// ============================================================================
+// CELL DETAIL
+// ============================================================================
+// PowerCell rows (paged 3 at a time):
+//   0: V/T  1: Outputs  2: I1-I2 | 3: I3-I4  4: I5-I6  5: I7-I8 | 6: I9-I10
+// inMOTION rows: 0: relays  1: MOSFETs
+
+#define DETAIL_POWERCELL_ROWS   7
+#define DETAIL_INMOTION_ROWS    2
+
+static NetworkDevice *detail_dev1;  // FF11/FF12 or inMOTION: outputs 1-5, currents 1-5, voltage, temp
+static NetworkDevice *detail_dev2;  // FF21/FF22: outputs 6-10, currents 6-10, voltage, temp
+static const char *detail_name;
+
+/**
+ * Look up the selected cell's devices (runs first on every render)
+ */
+static uint8_t DetailCount(void) {
+    if(selected_cell_type == CELL_TYPE_POWERCELL) {
+        // PowerCell - need two PGNs for full data
+        // Message format per PowerCell docs:
+        //   Byte 0: bits 7-3 = output states (1-5 in msg1, 6-10 in msg2)
+        //   Bytes 1-5: current for 5 outputs (count * 0.117A)
+        //   Byte 6: voltage (count * 0.125V)
+        //   Byte 7: temperature in °C
+        if(selected_cell_pgn == 0xFF01) {
+            detail_dev1 = Network_FindByPGN(0xFF11);
+            detail_dev2 = Network_FindByPGN(0xFF21);
+            detail_name = "FRONT POWERCELL";
+        } else {
+            detail_dev1 = Network_FindByPGN(0xFF12);
+            detail_dev2 = Network_FindByPGN(0xFF22);
+            detail_name = "REAR POWERCELL";
+        }
+        return DETAIL_POWERCELL_ROWS;
+    }
+
+    // InMotion - single PGN with nibble-packed output states
+    // Message format (7 bytes):
+    //   Bytes 0-3: Output states (4-bit nibbles, bit 0 = ON/OFF)
+    //     Byte 0: Relay 1A (upper), Relay 1B (lower)
+    //     Byte 1: Relay 2A (upper), Relay 2B (lower)
+    //     Byte 2: MOSFET 1 (upper), MOSFET 2 (lower)
+    //     Byte 3: MOSFET 3 (upper), MOSFET 4 (lower)
+    //   Bytes 4-6: Current measurements
+    uint16_t actual_pgn;
+    switch(selected_cell_pgn) {
+        case 0xFF03: actual_pgn = 0xFF33; detail_name = "DF inMOTION NGX"; break;
+        case 0xFF04: actual_pgn = 0xFF34; detail_name = "PF inMOTION NGX"; break;
+        case 0xFF05: actual_pgn = 0xFF35; detail_name = "DR inMOTION NGX"; break;
+        case 0xFF06: actual_pgn = 0xFF36; detail_name = "PR inMOTION NGX"; break;
+        default:     actual_pgn = 0xFF33; detail_name = "inMOTION NGX";    break;
+    }
+    detail_dev1 = Network_FindByPGN(actual_pgn);
+    detail_dev2 = NULL;
+    return DETAIL_INMOTION_ROWS;
+}
+
+static char* DetailTitle(char *p) {
+    return Format_Str(p, detail_name);
+}
+
+/**
+ * Two output currents on one line, 8 characters each: "I1=1.2A I2=0.0A"
+ */
+static char* CurrentPair(char *p, uint8_t idx1) {
+    for(uint8_t idx = idx1; idx < idx1 + 2; idx++) {
+        char field[12];
+        char *f;
+        uint8_t current_raw = 0;
+        // Outputs 0-4 (I1-I5) in dev1 bytes 1-5, outputs 5-9 (I6-I10) in dev2 bytes 1-5
+        if(idx < 5 && detail_dev1 != NULL) {
+            current_raw = detail_dev1->data[1 + idx];
+        } else if(idx >= 5 && detail_dev2 != NULL) {
+            current_raw = detail_dev2->data[1 + (idx - 5)];
+        }
+
+        f = Format_Char(field, 'I');
+        f = Format_Dec(f, idx + 1);
+        f = Format_Char(f, '=');
+        f = Format_Fixed1(f, (uint16_t)current_raw * 117);
+        f = Format_Char(f, 'A');
+        Format_End(f);
+        
+        // Unit is cut when it doesn't fit (I10, or 10A and over)
+        p = Format_StrLeft(p, field, 8);
+    }
+    return p;
+}
+
+/**
+ * Five output state bits (7-3) as '1'/'0', or '-' if no data
+ */
+static char* OutputBits(char *p, NetworkDevice *dev) {
+    for(uint8_t i = 0; i < 5; i++) {
+        if(dev == NULL) {
+            p = Format_Char(p, '-');
+        } else {
+            p = Format_Char(p, (dev->data[0] & (1 << (7 - i))) ? '1' : '0');
+        }
+    }
+    return p;
+}
+
+static char* PowerCellRow(uint8_t item, char *p) {
+    if(item == 0) {
+        // Voltage and temperature
+        if(detail_dev1 == NULL) {
+            return Format_Str(p, "V=--.- T=---");
+        }
+        p = Format_Str(p, "V=");
+        p = Format_Fixed1(p, (uint16_t)detail_dev1->data[6] * 125);
+        p = Format_Str(p, "V T=");
+        p = Format_DecSigned(p, (int8_t)detail_dev1->data[7]);
+        return Format_Str(p, " C");
+    }
+    if(item == 1) {
+        // Output states - outputs 6-10 only shown when outputs 1-5 are known
+        p = Format_Str(p, "OUT:");
+        p = OutputBits(p, detail_dev1);
+        return OutputBits(p, (detail_dev1 != NULL) ? detail_dev2 : NULL);
+    }
+    // Currents: row 2 = I1-I2 ... row 6 = I9-I10
+    return CurrentPair(p, (item - 2) * 2);
+}
+
+static char* InMotionRow(uint8_t item, char *p) {
+    // Upper nibble bit 0 = first output, lower nibble bit 0 = second output
+    const uint8_t *data = (detail_dev1 != NULL) ? detail_dev1->data : NULL;
+    uint8_t first = (item == 0) ? 0 : 2;  // Relays in bytes 0-1, MOSFETs in bytes 2-3
+
+    p = Format_Str(p, (item == 0) ? "RLY:" : "OUT:");
+    for(uint8_t i = first; i < first + 2; i++) {
+        p = Format_Char(Format_Char(p, ' '), (data == NULL) ? '-' : (((data[i] >> 4) & 0x01) ? '1' : '0'));
+        p = Format_Char(Format_Char(p, ' '), (data == NULL) ? '-' : ((data[i] & 0x01) ? '1' : '0'));
+    }
+    return p;
+}
+
+static char* DetailRow(uint8_t item, char *p) {
+    if(selected_cell_type == CELL_TYPE_POWERCELL) {
+        return PowerCellRow(item, p);
+    }
+    return InMotionRow(item, p);
+}
+
+static uint8_t DetailKey(uint8_t button) {
+    if(button == BTN_ID_HOME) {
+        detail_list.scroll = 0;
+        return SCREEN_INVENTORY;
+    }
+    return MENU_DEFAULT;
+}
+
+// ============================================================================
+// SYSTEM INFO
+// ============================================================================
+
+static char* SystemInfoTitle(char *p) {
+    return Format_Str(p, "SYSTEM INFO");
+}
+
+static char* SystemInfoRow(uint8_t row, char *p) {
+    switch(row) {
+        case 0:
+            p = Format_Str(p, "Software Ver: ");
+            return Format_Dec(p, EEPROM_Config_ReadByte(EEPROM_CFG_FW_MAJOR));
+        case 1:
+            p = Format_Str(p, "Customer Ver: ");
+            return Format_Dec(p, EEPROM_Config_ReadByte(EEPROM_CFG_FW_MINOR));
+        default:
+            p = Format_Str(p, "CUSTOMER: ");
+            for(uint8_t i = 0; i < 4; i++) {
+                p = Format_Char(p, EEPROM_Config_ReadByte(EEPROM_CFG_CUSTOMER_NAME_1 + i));
+            }
+            return p;
+    }
+}
+
+// ============================================================================
+// DEBUG
+// ============================================================================
+// Last broadcast payload for FF03-FF06 (inLINK messages) from SA 0x1A.
+// This helps diagnose the stuck message issue.
+
+static char* DebugRow(uint8_t row, char *p) {
+    uint16_t pgn = 0xFF03 + row;
+    const uint8_t *data = FindPreviousBroadcast(pgn, 0x1A);
+
+    p = Format_Hex16(p, pgn);
+    p = Format_Char(p, ':');
+    if(data == NULL) {
+        return Format_Str(p, "-- -- --");
+    }
+    p = Format_Hex8(p, data[0]);
+    p = Format_Hex8(Format_Char(p, ' '), data[1]);
+    return Format_Hex8(Format_Char(p, ' '), data[2]);
+}
+
+// ============================================================================
+// INPUT BOUNCE
+// ============================================================================
+// One input per row (paged): debounce scans in use, bounces in the last
+// BOUNCE_WINDOW_MS, bounces since power-up. Shows which inputs chatter
+// and what the adaptive debounce did about it.
+
+static char* BounceTitle(char *p) {
+    return Format_Str(p, "IN   DB 10S  ALL");
+}
+
+static char* BounceRow(uint8_t input, char *p) {
+    uint16_t total = Inputs_GetBounceCount(input);
+
+    if(input < HSIN01) {
+        p = Format_Str(p, "IN");
+        p = Format_DecZero(p, input + 1, 2);
+    } else {
+        p = Format_Str(p, "HS");
+        p = Format_DecZero(p, input - HSIN01 + 1, 2);
+    }
+    p = Format_DecSpace(Format_Char(p, ' '), Inputs_GetDebounceScans(input), 2);
+    p = Format_DecSpace(Format_Char(p, ' '), Inputs_GetBounceRate(input), 3);
+    return Format_DecSpace(Format_Char(p, ' '), (total > 9999) ? 9999 : total, 4);
+}
+
+static uint8_t BounceCount(void) {
+    return INPUT_COUNT;
+}
+
+// ============================================================================
+// inRESERVE
+// ============================================================================
+
+static uint8_t InReserveCount(void) {
+    if(!InReserve_GetConfig()->enabled) {
+        // Disabled - enable line plus the "--DISABLED--" notice
+        inreserve_list.selection = 0;
+        inreserve_list.scroll = 0;
+        return 3;
+    }
+    return INRESERVE_FIELD_COUNT;
+}
+
+static char* InReserveRow(uint8_t item, char *p) {
+    InReserveConfig* cfg = InReserve_GetConfig();
+    char voltage_str[8];
+
+    if(!cfg->enabled) {
+        if(item == 0) return Format_Str(p, "inRESERVE: OFF");
+        if(item == 2) return Format_Str(p, " --DISABLED--");
+        return p;
+    }
+
+    switch(item) {
+        case INRESERVE_FIELD_ENABLE:
+            // Flag a PowerCell that has stopped sending telemetry
+            return Format_Str(p, InReserve_GetState()->stale ? "inRESERVE:STALE" : "inRESERVE:  ON");
+        case INRESERVE_FIELD_CELL:
+            p = Format_Str(p, "Cell:   ");
+            return Format_StrRight(p, InReserve_GetCellName(cfg->cell_id), 6);
+        case INRESERVE_FIELD_OUTPUT:
+            p = Format_Str(p, "Output:     ");
+            return Format_DecZero(p, cfg->output, 2);
+        case INRESERVE_FIELD_TIME:
+            p = Format_Str(p, "Time:   ");
+            return Format_StrRight(p, InReserve_GetTimeString(cfg->time_code), 6);
+        default:
+            InReserve_GetVoltageString(cfg->voltage_code, voltage_str);
+            p = Format_Str(p, "Voltage: ");
+            return Format_StrRight(p, voltage_str, 5);
+    }
+}
+
+static uint8_t InReserveKey(uint8_t button) {
+    InReserveConfig* cfg = InReserve_GetConfig();
+
+    if(button == BTN_ID_SELECT) {
+        // Open popup for selected field, starting at the current value
+        switch(inreserve_list.selection) {
+            case INRESERVE_POPUP_ENABLE:
+                popup_list.selection = cfg->enabled ? 0 : 1;
+                break;
+            case INRESERVE_POPUP_CELL:
+                popup_list.selection = cfg->cell_id > 0 ? cfg->cell_id - 1 : 0;
+                break;
+            case INRESERVE_POPUP_OUTPUT: {
+                uint8_t min_out = InReserve_GetMinOutput(cfg->cell_id);
+                uint8_t max_out = InReserve_GetMaxOutput(cfg->cell_id);
+                // Clamp current output to valid range, then convert to selection index
+                uint8_t clamped = cfg->output;
+                if(clamped < min_out) clamped = min_out;
+                if(clamped > max_out) clamped = max_out;
+                popup_list.selection = clamped - min_out;
+                break;
+            }
+            case INRESERVE_POPUP_TIME:
+                popup_list.selection = cfg->time_code;
+                break;
+            case INRESERVE_POPUP_VOLTAGE:
+                popup_list.selection = cfg->voltage_code;
+                break;
+        }
+        // Show the selected item with one item above it where possible
+        popup_list.scroll = (popup_list.selection <= 1) ? 0 : popup_list.selection - 1;
+        return SCREEN_INRESERVE_POPUP;
+    }
+
+    if(!cfg->enabled && (button == BTN_ID_UP || button == BTN_ID_DOWN)) {
+        return MENU_STAY;  // Only the enable line is selectable
+    }
+    return MENU_DEFAULT;
+}
+
+// ============================================================================
+// inRESERVE POPUP
+// ============================================================================
+// Popup type is the inRESERVE field that opened it (inreserve_list.selection)
+
+static char* PopupTitle(char *p) {
+    switch(inreserve_list.selection) {
+        case INRESERVE_POPUP_ENABLE:  return Format_Str(p, "   inRESERVE");
+        case INRESERVE_POPUP_CELL:    return Format_Str(p, "  Select Cell");
+        case INRESERVE_POPUP_OUTPUT:  return Format_Str(p, " Select Output");
+        case INRESERVE_POPUP_TIME:    return Format_Str(p, "  Select Time");
+        default:                      return Format_Str(p, "Select Threshold");
+    }
+}
+
+static uint8_t PopupCount(void) {
+    switch(inreserve_list.selection) {
+        case INRESERVE_POPUP_ENABLE:  return 2;
+        case INRESERVE_POPUP_CELL:    return 6;    // Front, Rear, 3, 4, 5, 6
+        case INRESERVE_POPUP_OUTPUT:  return InReserve_GetOutputCount(InReserve_GetConfig()->cell_id);
+        case INRESERVE_POPUP_TIME:    return 3;    // 30sec, 15min, 20min
+        default:                      return 3;    // 12.1V, 12.2V, 12.3V
+    }
+}
+
+static char* PopupRow(uint8_t item, char *p) {
+    char voltage_str[8];
+
+    switch(inreserve_list.selection) {
+        case INRESERVE_POPUP_ENABLE:
+            return Format_Str(p, (item == 0) ? "    ENABLED" : "   DISABLED");
+        case INRESERVE_POPUP_CELL:
+            p = Format_Str(p, "  ");
+            return Format_StrLeft(p, InReserve_GetCellName(item + 1), 12);
+        case INRESERVE_POPUP_OUTPUT:
+            p = Format_Str(p, "   Output ");
+            return Format_DecZero(p, item + InReserve_GetMinOutput(InReserve_GetConfig()->cell_id), 2);
+        case INRESERVE_POPUP_TIME:
+            p = Format_Str(p, "   ");
+            return Format_StrLeft(p, InReserve_GetTimeString(item), 10);
+        default:
+            InReserve_GetVoltageString(item, voltage_str);
+            p = Format_Str(p, "     ");
+            return Format_Str(p, voltage_str);
+    }
+}
+
+static uint8_t PopupKey(uint8_t button) {
+    if(button != BTN_ID_SELECT) {
+        return MENU_DEFAULT;  // HOME cancels back to the inRESERVE screen
+    }
+
+    // Apply selection
+    switch(inreserve_list.selection) {
+        case INRESERVE_POPUP_ENABLE:
+            if(popup_list.selection == 0) {
+                // Enable - set to default cell if currently disabled
+                if(InReserve_GetConfig()->cell_id == 0) {
+                    InReserve_SetCellID(2);  // Default to Rear
+                }
+            } else {
+                InReserve_SetCellID(0);  // Disable
+            }
+            break;
+        case INRESERVE_POPUP_CELL:
+            InReserve_SetCellID(popup_list.selection + 1);
+            break;
+        case INRESERVE_POPUP_OUTPUT:
+            InReserve_SetOutput(popup_list.selection + InReserve_GetMinOutput(InReserve_GetConfig()->cell_id));
+            break;
+        case INRESERVE_POPUP_TIME:
+            InReserve_SetTime(popup_list.selection);
+            break;
+        case INRESERVE_POPUP_VOLTAGE:
+            InReserve_SetVoltage(popup_list.selection);
+            break;
+    }
+    // Save to EEPROM
+    InReserve_SaveConfig();
+
+    // Return to the top of the inRESERVE screen
+    inreserve_list.selection = 0;
+    inreserve_list.scroll = 0;
+    return SCREEN_INRESERVE;
+}
+
+// ============================================================================
+// SCREEN TABLE
+// ============================================================================
+
+const MenuScreen screen_table[SCREEN_COUNT] = {
+    [SCREEN_MAIN] = {
+        .flags = MENU_FLAG_BACKLIGHT_TIMEOUT, .parent = MENU_STAY, .refresh_ms = 500,
+        .row = MainRow, .key = MainKey,
+    },
+    [SCREEN_MENU] = {
+        .flags = MENU_FLAG_BACKLIGHT_TIMEOUT, .parent = SCREEN_MAIN,
+        .title = MenuTitle, .row = MenuRow, .count = MenuCount, .list = &menu_list,
+        .key = MenuKey,
+    },
+    [SCREEN_SWITCH] = {
+        .parent = SCREEN_MENU,
+        .title = SwitchTitle, .row = SwitchRow, .version = Inputs_GetVersion,
+    },
+    [SCREEN_INVENTORY] = {
+        .parent = SCREEN_MENU,
+        .title = InventoryTitle, .row = InventoryRow, .count = InventoryCount,
+        .list = &inventory_list, .version = Network_GetVersion, .key = InventoryKey,
+    },
+    [SCREEN_SYSTEM_INFO] = {
+        .parent = SCREEN_MENU, .refresh_ms = 1000,
+        .title = SystemInfoTitle, .row = SystemInfoRow,
+    },
+    [SCREEN_DEBUG] = {
+        .parent = SCREEN_MAIN,
+        .row = DebugRow, .version = GetBroadcastVersion,
+    },
+    [SCREEN_CELL_DETAIL] = {
+        .flags = MENU_FLAG_PAGED, .parent = SCREEN_INVENTORY, .refresh_ms = 2000,
+        .title = DetailTitle, .row = DetailRow, .count = DetailCount,
+        .list = &detail_list, .key = DetailKey,
+    },
+    [SCREEN_INRESERVE] = {
+        .parent = SCREEN_MENU, .refresh_ms = 500,
+        .row = InReserveRow, .count = InReserveCount, .list = &inreserve_list,
+        .key = InReserveKey,
+    },
+    [SCREEN_INRESERVE_POPUP] = {
+        .parent = SCREEN_INRESERVE,
+        .title = PopupTitle, .row = PopupRow, .count = PopupCount,
+        .list = &popup_list, .key = PopupKey,
+    },
+    [SCREEN_BOUNCE] = {
+        .flags = MENU_FLAG_PAGED, .parent = SCREEN_MENU, .refresh_ms = 1000,
+        .title = BounceTitle, .row = BounceRow, .count = BounceCount,
+        .list = &bounce_list,
+    },
+};
@@ -0,0 +1,47 @@
+/*
+ * FILE: screens.h
+ * LCD Screens for MASTERCELL NGX
+ *
+ * Screen descriptors for the menu framework (menu.h). To add a screen,
+ * give it an ID here, write its renderers in screens.c and add its
+ * entry to screen_table - main.c does not change.
+ */
+
+#ifndef SCREENS_H
+#define SCREENS_H
+
+#include <xc.h>
+#include <stdint.h>
+#include "menu.h"
+
+// Screen IDs (index into screen_table)
+#define SCREEN_MAIN             0
+#define SCREEN_MENU             1
+#define SCREEN_SWITCH           2
+#define SCREEN_INVENTORY        3
+#define SCREEN_SYSTEM_INFO      4
+#define SCREEN_DEBUG            5
+#define SCREEN_CELL_DETAIL      6
+#define SCREEN_INRESERVE        7
+#define SCREEN_INRESERVE_POPUP  8
+#define SCREEN_BOUNCE           9
+#define SCREEN_COUNT            10
+
+extern const MenuScreen screen_table[SCREEN_COUNT];
+
+// ============================================================================
+// PROVIDED BY main.c (debug screen)
+// ============================================================================
+
+/**
+ * Find the last broadcast payload for a PGN/SA
+ * @return Pointer to 8 data bytes, or NULL if not broadcast yet
+ */
+const uint8_t* FindPreviousBroadcast(uint16_t pgn, uint8_t source_addr);
+
+/**
+ * Counter bumped whenever a broadcast payload is stored
+ */
+uint16_t GetBroadcastVersion(void);
+
+#endif // SCREENS_H
@@ -0,0 +1,89 @@
+/*
+ * FILE: supervisor.c
+ * Watchdog Supervision and Warm Restart Implementation
+ */
+
+#include "supervisor.h"
+#include "board.h"
+
+// Survives the watchdog reset that it counts
+typedef struct {
+    uint16_t signature;
+    uint16_t watchdog_resets;       // Total since power-up
+    uint8_t warm_in_a_row;          // Warm restarts without a stable run
+} SupervisorState;
+
+static SupervisorState persist BOARD_PERSISTENT;
+
+static volatile uint8_t checkins = 0;
+static uint8_t warm_start = 0;
+static uint8_t stable = 0;
+
+uint8_t Supervisor_Init(void) {
+    uint8_t cause = Board_ResetCause();
+
+    if (cause == BOARD_RESET_COLD || persist.signature != SUPERVISOR_SIGNATURE) {
+        persist.signature = SUPERVISOR_SIGNATURE;
+        persist.watchdog_resets = 0;
+        persist.warm_in_a_row = 0;
+    }
+
+    warm_start = 0;
+    if (cause == BOARD_RESET_WATCHDOG) {
+        persist.watchdog_resets++;
+        if (persist.warm_in_a_row < SUPERVISOR_MAX_WARM) {
+            persist.warm_in_a_row++;
+            warm_start = 1;
+        }
+    } else {
+        persist.warm_in_a_row = 0;
+    }
+
+    checkins = 0;
+    stable = 0;
+    return warm_start;
+}
+
+void Supervisor_Start(void) {
+    checkins = 0;
+    Board_WatchdogEnable();
+}
+
+void Supervisor_CheckIn(uint8_t task) {
+    checkins |= task;
+}
+
+void Supervisor_Service(uint32_t now_ms) {
+    if ((checkins & SUPERVISOR_TASKS_ALL) != SUPERVISOR_TASKS_ALL) {
+        return;
+    }
+
+    Board_WatchdogKick();
+    checkins = 0;
+
+    if (!stable && now_ms >= SUPERVISOR_STABLE_MS) {
+        stable = 1;
+        persist.warm_in_a_row = 0;
+    }
+}
+
+uint8_t Supervisor_IsWarmStart(void) {
+    return warm_start;
+}
+
+uint16_t Supervisor_GetWatchdogResets(void) {
+    return persist.watchdog_resets;
+}
+
+uint16_t Supervisor_Checksum(const void *data, uint16_t length) {
+    const uint8_t *p = (const uint8_t *)data;
+    uint8_t sum1 = 0x5A;
+    uint8_t sum2 = 0xC3;
+
+    // Fletcher-16 (mod 256) - position sensitive, cheap on a 16-bit core
+    for (uint16_t i = 0; i < length; i++) {
+        sum1 += p[i];
+        sum2 += sum1;
+    }
+    return ((uint16_t)sum2 << 8) | sum1;
+}
@@ -0,0 +1,48 @@
+/*
+ * FILE: supervisor.h
+ * Watchdog Supervision and Warm Restart for MASTERCELL NGX
+ *
+ * The watchdog is only kicked once every task below has checked in since
+ * the last kick, so a hang in the main loop, a stalled input scan or a
+ * dead Timer1 all end in a watchdog reset within BOARD_SLEEP_WAKE_MS.
+ *
+ * After a watchdog reset the firmware takes the warm path: modules put
+ * back the state they saved in BOARD_PERSISTENT RAM (each block carries
+ * SUPERVISOR_SIGNATURE and a checksum), the last transmitted frames go
+ * straight back on the bus, and the splash delays are skipped.
+ * Repeated watchdog resets without a stable run in between fall back to
+ * a cold start, in case the saved state is what keeps crashing us.
+ */
+
+#ifndef SUPERVISOR_H
+#define SUPERVISOR_H
+
+#include <xc.h>
+#include <stdint.h>
+
+// Check-in bits - all must be set between two watchdog kicks
+#define SUPERVISOR_TASK_TICK        0x01    // Timer1 ISR
+#define SUPERVISOR_TASK_LOOP        0x02    // Main loop pass
+#define SUPERVISOR_TASK_SCAN        0x04    // Input scan (every 10ms)
+#define SUPERVISOR_TASKS_ALL        0x07
+
+#define SUPERVISOR_SIGNATURE        0x5AC3  // Valid persistent block
+#define SUPERVISOR_MAX_WARM         3       // Warm restarts in a row before going cold
+#define SUPERVISOR_STABLE_MS        10000   // Run time that resets the warm restart run
+
+// Function prototypes
+uint8_t Supervisor_Init(void);              // First thing in main, returns 1 for a warm start
+void Supervisor_Start(void);                // Enable the watchdog (main loop entry)
+void Supervisor_CheckIn(uint8_t task);      // SUPERVISOR_TASK_xxx, ISR safe
+void Supervisor_Service(uint32_t now_ms);   // Kick the watchdog once all tasks checked in
+uint8_t Supervisor_IsWarmStart(void);
+uint16_t Supervisor_GetWatchdogResets(void);
+
+/**
+ * Checksum for persistent blocks
+ * @param data Block contents, excluding the checksum field
+ * @param length Bytes
+ */
+uint16_t Supervisor_Checksum(const void *data, uint16_t length);
+
+#endif // SUPERVISOR_H
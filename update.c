@@ -0,0 +1,203 @@
+/*
+ * FILE: update.c
+ * Firmware Update over CAN Implementation
+ */
+
+#include "update.h"
+#include "j1939.h"
+#include "eeprom_config.h"
+#include "inputs.h"
+#include "board.h"
+#include <string.h>
+
+#if 3 + UPDATE_BLOCK_ROWS * BOARD_FLASH_ROW_BYTES > J1939_TP_MAX_SIZE
+#error "UPDATE_BLOCK_ROWS does not fit in J1939_TP_MAX_SIZE"
+#endif
+
+#define RECORD_ADDRESS  (BOARD_FLASH_STAGING + (uint32_t)UPDATE_IMAGE_MAX_ROWS * BOARD_FLASH_ROW_PC)
+
+static uint8_t active = 0;
+static uint16_t image_rows = 0;
+static uint32_t image_crc = 0;
+static uint16_t next_row = 0;
+static uint32_t crc = 0;
+
+static uint8_t row_buffer[BOARD_FLASH_ROW_BYTES];
+
+/*
+ * CRC-32 (IEEE 802.3, reflected), bitwise - about 0.4ms per row
+ */
+static uint32_t Crc32(uint32_t value, const uint8_t *data, uint16_t length) {
+    for (uint16_t i = 0; i < length; i++) {
+        value ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            value = (value >> 1) ^ (0xEDB88320UL & (0UL - (value & 1)));
+        }
+    }
+    return value;
+}
+
+static void Reply(uint8_t dest_addr, uint8_t command, uint8_t status) {
+    uint8_t data[8];
+    uint32_t crc_out = crc ^ 0xFFFFFFFFUL;
+
+    data[0] = command | UPDATE_REPLY;
+    data[1] = status;
+    data[2] = next_row & 0xFF;
+    data[3] = next_row >> 8;
+    data[4] = crc_out & 0xFF;
+    data[5] = (crc_out >> 8) & 0xFF;
+    data[6] = (crc_out >> 16) & 0xFF;
+    data[7] = (crc_out >> 24) & 0xFF;
+    J1939_TransmitMessage(J1939_TP_PRIORITY, UPDATE_PGN | dest_addr,
+                          EEPROM_Config_ReadByte(EEPROM_CFG_HEARTBEAT_SA), data);
+}
+
+/*
+ * Erase, write and read back one row
+ * Returns 1 if flash now holds exactly the given row image
+ */
+static uint8_t ProgramRow(uint32_t address, const uint8_t *row) {
+    if (!Board_FlashEraseRow(address) || !Board_FlashWriteRow(address, row)) {
+        return 0;
+    }
+
+    Board_FlashReadRow(address, row_buffer);
+    return memcmp(row_buffer, row, BOARD_FLASH_ROW_BYTES) == 0;
+}
+
+static uint8_t Start(const uint8_t *data) {
+    uint16_t rows = ((uint16_t)data[2] << 8) | data[1];
+
+    active = 0;
+    if (Inputs_GetIgnitionState() || rows == 0 || rows > UPDATE_IMAGE_MAX_ROWS) {
+        return UPDATE_STATUS_REFUSED;
+    }
+
+    // Invalidate whatever was staged before
+    if (!Board_FlashEraseRow(RECORD_ADDRESS)) {
+        return UPDATE_STATUS_FLASH;
+    }
+
+    image_rows = rows;
+    image_crc = ((uint32_t)data[6] << 24) | ((uint32_t)data[5] << 16) |
+                ((uint32_t)data[4] << 8) | data[3];
+    next_row = 0;
+    crc = 0xFFFFFFFFUL;
+    active = 1;
+    return UPDATE_STATUS_OK;
+}
+
+static uint8_t Block(const uint8_t *data, uint16_t length) {
+    uint16_t first = ((uint16_t)data[2] << 8) | data[1];
+    uint16_t payload = length - 3;
+    uint16_t rows = payload / BOARD_FLASH_ROW_BYTES;
+
+    if (!active || first != next_row) {
+        return UPDATE_STATUS_SEQUENCE;
+    }
+    if (rows == 0 || rows * BOARD_FLASH_ROW_BYTES != payload || first + rows > image_rows) {
+        return UPDATE_STATUS_REFUSED;
+    }
+
+    data += 3;
+    for (uint16_t i = 0; i < rows; i++) {
+        uint32_t address = BOARD_FLASH_STAGING + (uint32_t)next_row * BOARD_FLASH_ROW_PC;
+        if (!ProgramRow(address, data)) {
+            active = 0;
+            return UPDATE_STATUS_FLASH;
+        }
+        crc = Crc32(crc, row_buffer, BOARD_FLASH_ROW_BYTES);
+        next_row++;
+        data += BOARD_FLASH_ROW_BYTES;
+    }
+    return UPDATE_STATUS_OK;
+}
+
+static uint8_t Commit(void) {
+    if (!active || next_row != image_rows) {
+        return UPDATE_STATUS_SEQUENCE;
+    }
+
+    active = 0;
+    if ((crc ^ 0xFFFFFFFFUL) != image_crc) {
+        return UPDATE_STATUS_CRC;
+    }
+
+    // Install record: magic, row count, CRC-32 (LSB first)
+    memset(row_buffer, 0xFF, sizeof(row_buffer));
+    row_buffer[0] = UPDATE_RECORD_MAGIC & 0xFF;
+    row_buffer[1] = UPDATE_RECORD_MAGIC >> 8;
+    row_buffer[2] = image_rows & 0xFF;
+    row_buffer[3] = image_rows >> 8;
+    row_buffer[4] = image_crc & 0xFF;
+    row_buffer[5] = (image_crc >> 8) & 0xFF;
+    row_buffer[6] = (image_crc >> 16) & 0xFF;
+    row_buffer[7] = (image_crc >> 24) & 0xFF;
+
+    if (!Board_FlashWriteRow(RECORD_ADDRESS, row_buffer)) {
+        return UPDATE_STATUS_FLASH;
+    }
+    return UPDATE_STATUS_OK;
+}
+
+uint8_t Update_ProcessMessage(CAN_RxMessage *msg, uint32_t now_ms) {
+    uint8_t own_addr = EEPROM_Config_ReadByte(EEPROM_CFG_HEARTBEAT_SA);
+    uint8_t source = msg->id & 0xFF;
+
+    // Blocks
+    if (J1939_TPProcessMessage(msg, now_ms)) {
+        uint16_t pgn;
+        uint16_t length;
+        const uint8_t *data = J1939_TPGetMessage(&pgn, &source, &length);
+
+        if ((pgn & 0xFF00) != UPDATE_PGN || data[0] != UPDATE_CMD_BLOCK) {
+            J1939_TPComplete(0);
+            return 1;
+        }
+
+        uint8_t status = Block(data, length);
+        J1939_TPComplete(status == UPDATE_STATUS_OK);
+        Reply(source, UPDATE_CMD_BLOCK, status);
+        return 1;
+    }
+
+    // Single-frame commands
+    if (((msg->id >> 16) & 0xFF) != (UPDATE_PGN >> 8) ||
+        ((msg->id >> 8) & 0xFF) != own_addr || msg->dlc < 1) {
+        return 0;
+    }
+
+    switch (msg->data[0]) {
+        case UPDATE_CMD_START:
+            Reply(source, UPDATE_CMD_START, (msg->dlc >= 7) ? Start(msg->data) : UPDATE_STATUS_REFUSED);
+            break;
+
+        case UPDATE_CMD_COMMIT:
+            // No reset into the boot block until there is one - see update.h
+            Reply(source, UPDATE_CMD_COMMIT, Commit());
+            break;
+
+        case UPDATE_CMD_ABORT:
+            active = 0;
+            Reply(source, UPDATE_CMD_ABORT, UPDATE_STATUS_OK);
+            break;
+
+        default:
+            break;
+    }
+    return 1;
+}
+
+void Update_Service(uint32_t now_ms) {
+    J1939_TPService(now_ms);
+
+    // Ignition on ends the update - the staged rows are simply left unused
+    if (active && Inputs_GetIgnitionState()) {
+        active = 0;
+    }
+}
+
+uint8_t Update_IsActive(void) {
+    return active;
+}
@@ -0,0 +1,81 @@
+/*
+ * FILE: update.h
+ * Firmware Update over CAN for MASTERCELL NGX
+ *
+ * A new image arrives in blocks over the J1939 transport protocol and is
+ * written row by row into the staging area of program flash (board.h).
+ * The running application is never touched: every row is read back after
+ * programming and the CRC-32 is computed over what is actually in flash.
+ * COMMIT checks it against the CRC announced at START and writes the
+ * install record into the last staging row. The application keeps
+ * running. A transfer that fails, is abandoned or does not verify leaves
+ * no install record.
+ *
+ * NOT IN SERVICE: nothing installs a staged image yet. That needs a boot
+ * block at BOARD_FLASH_BOOT that owns the reset vector, survives a power
+ * loss part way through the copy, and keeps the previous image. Keeping
+ * the previous image needs a third flash area, and there is no room for
+ * one beside the application and staging. The request has gone back to
+ * its owner for that design. Until then main.c does not dispatch update
+ * frames. This module and host/test_update.c are the transfer half, and
+ * the staging area stays reserved so the application layout does not
+ * move when the boot block arrives.
+ *
+ * Update time for the largest image (UPDATE_IMAGE_MAX_ROWS = 751 rows,
+ * 72096 bytes), from host/test_update.c: 11833 frames (RTS, 4 CTS, 56 DT,
+ * EOMA and the reply per 4-row block). That is 7.3s of bus time at
+ * 250kbit/s or 3.7s at 500kbit/s, with worst-case bit stuffing. Add 3.0s
+ * of row programming, 2ms erase plus 2ms write per row, which the sender
+ * waits out at each end-of-message acknowledge.
+ *
+ * All update frames use UPDATE_PGN (proprietary A, destination = our
+ * heartbeat SA). Single-frame commands, B0 = command:
+ *   START   B1-B2 image rows, B3-B6 CRC-32 of the row images (LSB first)
+ *   COMMIT  verify, write the install record (no reset)
+ *   ABORT
+ * Each block is one TP message: B0 BLOCK, B1-B2 first row, then 1 to
+ * UPDATE_BLOCK_ROWS row images of BOARD_FLASH_ROW_BYTES. The sender waits
+ * for the end-of-message acknowledge before the next block, which is what
+ * paces the transfer to the flash programming time.
+ * Every command and block is answered with B0 = command | UPDATE_REPLY,
+ * B1 status, B2-B3 next row expected, B4-B7 CRC-32 so far.
+ *
+ * Updates are refused with the ignition on: programming stalls the CPU,
+ * so inputs, outputs and other bus traffic are not serviced meanwhile.
+ */
+
+#ifndef UPDATE_H
+#define UPDATE_H
+
+#include <xc.h>
+#include <stdint.h>
+#include "j1939.h"
+
+#define UPDATE_PGN                  0xEF00  // PDU1, PS = destination
+
+// Commands (B0)
+#define UPDATE_CMD_START            0x01
+#define UPDATE_CMD_BLOCK            0x02    // TP only
+#define UPDATE_CMD_COMMIT           0x03
+#define UPDATE_CMD_ABORT            0x04
+#define UPDATE_REPLY                0x80
+
+// Reply status (B1)
+#define UPDATE_STATUS_OK            0x00
+#define UPDATE_STATUS_REFUSED       0x01    // Ignition on, bad size or row count
+#define UPDATE_STATUS_SEQUENCE      0x02    // No START, or rows out of order / missing
+#define UPDATE_STATUS_FLASH         0x03    // Erase, write or read-back failed
+#define UPDATE_STATUS_CRC           0x04    // Image does not match the START CRC
+
+#define UPDATE_BLOCK_ROWS           4       // Rows per TP message (387 bytes)
+
+// Install record (first bytes of the last staging row), for the boot block
+#define UPDATE_RECORD_MAGIC         0xB007
+#define UPDATE_IMAGE_MAX_ROWS       (BOARD_FLASH_STAGING_ROWS - 1)
+
+// Function prototypes
+uint8_t Update_ProcessMessage(CAN_RxMessage *msg, uint32_t now_ms);  // Returns 1 if addressed to us
+void Update_Service(uint32_t now_ms);       // TP timeout, ignition interlock
+uint8_t Update_IsActive(void);
+
+#endif // UPDATE_H